@@ -1,15 +1,23 @@
 #include <iostream>
 #include <iomanip>
 #include <vector>
+#include <map>
+#include <set>
+#include <algorithm>
 #include <exception>
 
 #include <boost/program_options.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/fstream.hpp>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/crc.hpp>
 
 #include <components/bsa/bsa_file.hpp>
+#include <components/bsa/bsa_writer.hpp>
+#include <components/misc/stringops.hpp>
 
-#define BSATOOL_VERSION 1.1
+#define BSATOOL_VERSION 1.2
 
 // Create local aliases for brevity
 namespace bpo = boost::program_options;
@@ -21,6 +29,11 @@ struct Arguments
     std::string filename;
     std::string extractfile;
     std::string outdir;
+    std::string indir;
+    std::string tracefile;
+    std::string manifest;
+
+    unsigned int threads;
 
     bool longformat;
     bool fullpath;
@@ -38,14 +51,20 @@ void replaceAll(std::string& str, const std::string& needle, const std::string&
 
 bool parseOptions (int argc, char** argv, Arguments &info)
 {
-    bpo::options_description desc("Inspect and extract files from Bethesda BSA archives\n\n"
+    bpo::options_description desc("Inspect, extract and create Bethesda BSA archives\n\n"
             "Usages:\n"
             "  bsatool list [-l] archivefile\n"
             "      List the files presents in the input archive.\n\n"
             "  bsatool extract [-f] archivefile [file_to_extract] [output_directory]\n"
             "      Extract a file from the input archive.\n\n"
-            "  bsatool extractall archivefile [output_directory]\n"
+            "  bsatool extractall [-j threads] [-c manifest] archivefile [output_directory]\n"
             "      Extract all files from the input archive.\n\n"
+            "  bsatool verify [-j threads] archivefile directory\n"
+            "      Compare the files in the input archive with the files in a directory.\n\n"
+            "  bsatool pack [-t tracefile] archivefile input_directory\n"
+            "      Create an archive from the files in the input directory.\n"
+            "      Files listed in the trace file (one path per line, as written by openmw --vfs-trace)\n"
+            "      are stored first, in the listed order, followed by the remaining files sorted by path.\n\n"
             "Allowed options");
 
     desc.add_options()
@@ -54,6 +73,11 @@ bool parseOptions (int argc, char** argv, Arguments &info)
         ("long,l", "Include extra information in archive listing.")
         ("full-path,f", "Create directory hierarchy on file extraction "
          "(always true for extractall).")
+        ("trace,t", bpo::value<std::string>(), "File access trace deciding the file order when packing.")
+        ("threads,j", bpo::value<unsigned int>()->default_value(0),
+         "Number of threads for extractall and verify (0 for one per CPU core).")
+        ("checksums,c", bpo::value<std::string>(), "Write a CRC32 checksum manifest of the extracted files "
+         "(extractall).")
         ;
 
     // input-file is hidden and used as a positional argument
@@ -105,7 +129,8 @@ bool parseOptions (int argc, char** argv, Arguments &info)
     }
 
     info.mode = variables["mode"].as<std::string>();
-    if (!(info.mode == "list" || info.mode == "extract" || info.mode == "extractall"))
+    if (!(info.mode == "list" || info.mode == "extract" || info.mode == "extractall" || info.mode == "pack"
+          || info.mode == "verify"))
     {
         std::cout << std::endl << "ERROR: invalid mode \"" << info.mode << "\"\n\n"
             << desc << std::endl;
@@ -136,9 +161,28 @@ bool parseOptions (int argc, char** argv, Arguments &info)
         if (variables["input-file"].as< std::vector<std::string> >().size() > 2)
             info.outdir = variables["input-file"].as< std::vector<std::string> >()[2];
     }
+    else if (info.mode == "pack" || info.mode == "verify")
+    {
+        if (variables["input-file"].as< std::vector<std::string> >().size() < 2)
+        {
+            std::cout << "\nERROR: input directory unspecified\n\n"
+                << desc << std::endl;
+            return false;
+        }
+        info.indir = variables["input-file"].as< std::vector<std::string> >()[1];
+    }
     else if (variables["input-file"].as< std::vector<std::string> >().size() > 1)
         info.outdir = variables["input-file"].as< std::vector<std::string> >()[1];
 
+    if (variables.count("trace"))
+        info.tracefile = variables["trace"].as<std::string>();
+    if (variables.count("checksums"))
+        info.manifest = variables["checksums"].as<std::string>();
+
+    info.threads = variables["threads"].as<unsigned int>();
+    if (info.threads == 0)
+        info.threads = std::max(boost::thread::hardware_concurrency(), 1u);
+
     info.longformat = variables.count("long") != 0;
     info.fullpath = variables.count("full-path") != 0;
 
@@ -148,6 +192,8 @@ bool parseOptions (int argc, char** argv, Arguments &info)
 int list(Bsa::BSAFile& bsa, Arguments& info);
 int extract(Bsa::BSAFile& bsa, Arguments& info);
 int extractAll(Bsa::BSAFile& bsa, Arguments& info);
+int verify(Bsa::BSAFile& bsa, Arguments& info);
+int pack(Arguments& info);
 
 int main(int argc, char** argv)
 {
@@ -157,6 +203,9 @@ int main(int argc, char** argv)
         if(!parseOptions (argc, argv, info))
             return 1;
 
+        if (info.mode == "pack")
+            return pack(info);
+
         // Open file
         Bsa::BSAFile bsa;
         bsa.open(info.filename);
@@ -167,6 +216,8 @@ int main(int argc, char** argv)
             return extract(bsa, info);
         else if (info.mode == "extractall")
             return extractAll(bsa, info);
+        else if (info.mode == "verify")
+            return verify(bsa, info);
         else
         {
             std::cout << "Unsupported mode. That is not supposed to happen." << std::endl;
@@ -251,23 +302,183 @@ int extract(Bsa::BSAFile& bsa, Arguments& info)
     return 0;
 }
 
-int extractAll(Bsa::BSAFile& bsa, Arguments& info)
+/// Target path of an archived file, relative to the output directory
+bfs::path getExtractPath(const char* archivePath)
 {
-    // Get the list of files present in the archive
-    Bsa::BSAFile::FileList list = bsa.getList();
+    std::string extractPath (archivePath);
+    replaceAll(extractPath, "\\", "/");
+    return bfs::path(extractPath);
+}
+
+/// @brief Hands out the files of an archive to worker threads, in the order they are stored.
+class FileJobs
+{
+public:
+    struct Result
+    {
+        Result() : mChecksum(0) {}
+
+        boost::crc_32_type::value_type mChecksum;
+        std::string mError;
+    };
+
+    FileJobs(const Bsa::BSAFile::FileList& files)
+        : mFiles(files), mResults(files.size()), mNext(0)
+    {
+        for (size_t i=0; i<files.size(); ++i)
+            mOrder.push_back(std::make_pair(files[i].offset, i));
+
+        // Read the archive front to back, rather than in directory order
+        std::sort(mOrder.begin(), mOrder.end());
+    }
+
+    /// Get the index of the next file to work on, or -1 if done.
+    int next()
+    {
+        boost::mutex::scoped_lock lock(mMutex);
+        if (mNext >= mOrder.size())
+            return -1;
+        return static_cast<int>(mOrder[mNext++].second);
+    }
+
+    /// Serialize output of the worker threads
+    void print(const std::string& message)
+    {
+        boost::mutex::scoped_lock lock(mMutex);
+        std::cout << message << std::endl;
+    }
+
+    const Bsa::BSAFile::FileList& mFiles;
+
+    /// One per file, each only accessed by the thread working on the file
+    std::vector<Result> mResults;
+
+private:
+    std::vector<std::pair<uint32_t, size_t> > mOrder;
+    size_t mNext;
+    boost::mutex mMutex;
+};
+
+/// Copy buffer size; large, so that the archive is read in few big chunks
+const size_t sBlockSize = 1024*1024;
+
+void extractFiles(const Arguments* info, FileJobs* jobs)
+{
+    // Each thread reads the archive through its own stream
+    bfs::ifstream archive (bfs::path(info->filename), std::ios::binary);
+    std::vector<char> buffer (sBlockSize);
+
+    int index;
+    while ((index = jobs->next()) != -1)
+    {
+        const Bsa::BSAFile::FileStruct& file = jobs->mFiles[index];
+        FileJobs::Result& result = jobs->mResults[index];
+
+        bfs::path target = bfs::path(info->outdir) / getExtractPath(file.name);
+
+        boost::crc_32_type checksum;
+
+        bfs::ofstream out (target, std::ios::binary);
+        archive.seekg(file.offset);
+
+        uint32_t remaining = file.fileSize;
+        while (remaining > 0 && archive.good() && out.good())
+        {
+            std::streamsize chunk = std::min(remaining, static_cast<uint32_t>(buffer.size()));
+            archive.read(&buffer[0], chunk);
+            chunk = archive.gcount();
+            out.write(&buffer[0], chunk);
+            checksum.process_bytes(&buffer[0], static_cast<size_t>(chunk));
+            remaining -= static_cast<uint32_t>(chunk);
+        }
+        out.close();
+
+        if (remaining > 0 || !archive.good())
+        {
+            result.mError = "unable to read from archive";
+            archive.clear();
+        }
+        else if (out.fail())
+            result.mError = "unable to write " + target.string();
+        else
+            jobs->print("Extracting " + target.string());
+
+        result.mChecksum = checksum.checksum();
+    }
+}
+
+void verifyFiles(const Arguments* info, FileJobs* jobs)
+{
+    bfs::ifstream archive (bfs::path(info->filename), std::ios::binary);
+    std::vector<char> buffer (sBlockSize);
+    std::vector<char> fileBuffer (sBlockSize);
+
+    int index;
+    while ((index = jobs->next()) != -1)
+    {
+        const Bsa::BSAFile::FileStruct& file = jobs->mFiles[index];
+        FileJobs::Result& result = jobs->mResults[index];
+
+        bfs::path path = bfs::path(info->indir) / getExtractPath(file.name);
+
+        boost::system::error_code ec;
+        uintmax_t size = bfs::file_size(path, ec);
+        if (ec)
+        {
+            result.mError = "missing";
+            continue;
+        }
+        if (size != file.fileSize)
+        {
+            result.mError = "size differs";
+            continue;
+        }
+
+        bfs::ifstream stream (path, std::ios::binary);
+        archive.seekg(file.offset);
+
+        uint32_t remaining = file.fileSize;
+        while (remaining > 0 && result.mError.empty())
+        {
+            std::streamsize chunk = std::min(remaining, static_cast<uint32_t>(buffer.size()));
+            archive.read(&buffer[0], chunk);
+            stream.read(&fileBuffer[0], chunk);
+            if (archive.gcount() != chunk)
+            {
+                result.mError = "unable to read from archive";
+                archive.clear();
+            }
+            else if (stream.gcount() != chunk)
+                result.mError = "unable to read";
+            else if (!std::equal(buffer.begin(), buffer.begin() + chunk, fileBuffer.begin()))
+                result.mError = "content differs";
+            remaining -= static_cast<uint32_t>(chunk);
+        }
+    }
+}
 
-    // Iter on the list
-    for(Bsa::BSAFile::FileList::iterator it = list.begin(); it != list.end(); ++it) {
-        const char* archivePath = it->name;
+/// Run \a work on info.threads threads
+void runJobs(void (*work)(const Arguments*, FileJobs*), const Arguments& info, FileJobs& jobs)
+{
+    boost::thread_group threads;
+    for (unsigned int i=0; i<info.threads; ++i)
+        threads.create_thread(boost::bind(work, &info, &jobs));
+    threads.join_all();
+}
 
-        std::string extractPath (archivePath);
-        replaceAll(extractPath, "\\", "/");
+int extractAll(Bsa::BSAFile& bsa, Arguments& info)
+{
+    // Get the list of files present in the archive
+    const Bsa::BSAFile::FileList& list = bsa.getList();
 
-        // Get the target path (the path the file will be extracted to)
-        bfs::path target (info.outdir);
-        target /= extractPath;
+    // Create the directory hierarchy up front, rather than racing for it in the worker threads
+    std::set<bfs::path> directories;
+    for(Bsa::BSAFile::FileList::const_iterator it = list.begin(); it != list.end(); ++it)
+    {
+        bfs::path target = bfs::path(info.outdir) / getExtractPath(it->name);
+        if (!directories.insert(target.parent_path()).second)
+            continue;
 
-        // Create the directory hierarchy
         bfs::create_directories(target.parent_path());
 
         bfs::file_status s = bfs::status(target.parent_path());
@@ -276,17 +487,144 @@ int extractAll(Bsa::BSAFile& bsa, Arguments& info)
             std::cout << "ERROR: " << target.parent_path() << " is not a directory." << std::endl;
             return 3;
         }
+    }
 
-        // Get a stream for the file to extract
-        // (inefficient because getFile iter on the list again)
-        Files::IStreamPtr data = bsa.getFile(archivePath);
-        bfs::ofstream out(target, std::ios::binary);
+    FileJobs jobs (list);
+    runJobs(&extractFiles, info, jobs);
 
-        // Write the file to disk
-        std::cout << "Extracting " << target << std::endl;
-        out << data->rdbuf();
-        out.close();
+    int ret = 0;
+    for (size_t i=0; i<list.size(); ++i)
+    {
+        if (!jobs.mResults[i].mError.empty())
+        {
+            std::cout << "ERROR: extracting " << list[i].name << ": " << jobs.mResults[i].mError << std::endl;
+            ret = 3;
+        }
+    }
+
+    if (!info.manifest.empty())
+    {
+        // One line per file, in directory order: checksum, size, path in the archive
+        bfs::ofstream manifest (bfs::path(info.manifest));
+        manifest << std::hex << std::setfill('0');
+        for (size_t i=0; i<list.size(); ++i)
+            manifest << std::setw(8) << jobs.mResults[i].mChecksum << " " << std::dec << list[i].fileSize
+                     << std::hex << " " << list[i].name << "\n";
+
+        manifest.close();
+        if (manifest.fail())
+        {
+            std::cout << "ERROR: unable to write checksum manifest " << info.manifest << std::endl;
+            ret = 3;
+        }
+    }
+
+    return ret;
+}
+
+int verify(Bsa::BSAFile& bsa, Arguments& info)
+{
+    const Bsa::BSAFile::FileList& list = bsa.getList();
+
+    FileJobs jobs (list);
+    runJobs(&verifyFiles, info, jobs);
+
+    size_t mismatches = 0;
+    for (size_t i=0; i<list.size(); ++i)
+    {
+        if (!jobs.mResults[i].mError.empty())
+        {
+            std::cout << list[i].name << ": " << jobs.mResults[i].mError << std::endl;
+            ++mismatches;
+        }
+    }
+
+    std::cout << "Verified " << list.size() << " files, " << mismatches << " mismatches" << std::endl;
+
+    return mismatches ? 4 : 0;
+}
+
+/// Normalize a path the way the VFS does, to match paths from an access trace
+std::string normalizeTracePath(const std::string& path)
+{
+    std::string normalized = Misc::StringUtils::lowerCase(path);
+    replaceAll(normalized, "\\", "/");
+    return normalized;
+}
+
+int pack(Arguments& info)
+{
+    bfs::path root (info.indir);
+    if (!bfs::is_directory(root))
+    {
+        std::cout << "ERROR: " << root << " is not a directory." << std::endl;
+        return 3;
     }
 
+    // Collect the files, keyed by normalized path relative to the input directory
+    std::map<std::string, bfs::path> files;
+
+    size_t rootDepth = std::distance(root.begin(), root.end());
+    for (bfs::recursive_directory_iterator it (root), end; it != end; ++it)
+    {
+        if (!bfs::is_regular_file(it->status()))
+            continue;
+
+        bfs::path::iterator element = it->path().begin();
+        std::advance(element, rootDepth);
+
+        bfs::path relPath;
+        for (; element != it->path().end(); ++element)
+            relPath /= *element;
+
+        std::string name = normalizeTracePath(relPath.generic_string());
+        if (!files.insert(std::make_pair(name, it->path())).second)
+        {
+            std::cout << "ERROR: " << it->path() << " only differs in case from another file." << std::endl;
+            return 3;
+        }
+    }
+
+    Bsa::BSAWriter writer;
+    std::set<std::string> added;
+
+    // Files in the order they were used first, so that files loaded together are stored together
+    if (!info.tracefile.empty())
+    {
+        bfs::ifstream trace (bfs::path(info.tracefile));
+        if (!trace.is_open())
+        {
+            std::cout << "ERROR: unable to open trace file " << info.tracefile << std::endl;
+            return 3;
+        }
+
+        std::string line;
+        while (std::getline(trace, line))
+        {
+            if (!line.empty() && line[line.size()-1] == '\r')
+                line.erase(line.size()-1);
+
+            std::string name = normalizeTracePath(line);
+            std::map<std::string, bfs::path>::const_iterator found = files.find(name);
+            if (found == files.end() || !added.insert(name).second)
+                continue;
+
+            writer.addFile(found->first, found->second.string());
+        }
+    }
+    size_t traced = writer.getFileCount();
+
+    // The rest by path, which keeps the files of a directory together
+    for (std::map<std::string, bfs::path>::const_iterator it = files.begin(); it != files.end(); ++it)
+    {
+        if (added.find(it->first) == added.end())
+            writer.addFile(it->first, it->second.string());
+    }
+
+    writer.write(info.filename);
+
+    std::cout << "Packed " << writer.getFileCount() << " files (" << traced << " in trace order) into "
+              << info.filename << std::endl;
+
     return 0;
 }
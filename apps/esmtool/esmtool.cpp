@@ -5,9 +5,12 @@
 #include <map>
 #include <set>
 #include <fstream>
+#include <limits>
 
 #include <boost/program_options.hpp>
 
+#include <osg/Timer>
+
 #include <components/esm/esmreader.hpp>
 #include <components/esm/esmwriter.hpp>
 #include <components/esm/records.hpp>
@@ -53,6 +56,9 @@ struct Arguments
     bool quiet_given;
     bool loadcells_given;
     bool plain_given;
+    bool csv_given;
+
+    int repeat;
 
     std::string mode;
     std::string encoding;
@@ -69,7 +75,7 @@ struct Arguments
 
 bool parseOptions (int argc, char** argv, Arguments &info)
 {
-    bpo::options_description desc("Inspect and extract from Morrowind ES files (ESM, ESP, ESS)\nSyntax: esmtool [options] mode infile [outfile]\nAllowed modes:\n  dump\t Dumps all readable data from the input file.\n  clone\t Clones the input file to the output file.\n  comp\t Compares the given files.\n\nAllowed options");
+    bpo::options_description desc("Inspect and extract from Morrowind ES files (ESM, ESP, ESS)\nSyntax: esmtool [options] mode infile [outfile]\nAllowed modes:\n  dump\t Dumps all readable data from the input file.\n  clone\t Clones the input file to the output file.\n  comp\t Compares the given files.\n  stats\t Shows record counts and sizes, and subrecord sizes per record type.\n  bench\t Times reading, loading and string conversion of the input file, with comma separated output.\n\nAllowed options");
 
     desc.add_options()
         ("help,h", "print help message.")
@@ -87,6 +93,9 @@ bool parseOptions (int argc, char** argv, Arguments &info)
          "Only affects dump mode.")
         ("quiet,q", "Supress all record information. Useful for speed tests.")
         ("loadcells,C", "Browse through contents of all cells.")
+        ("csv", "Print comma separated values. Only affects stats mode.")
+        ("repeat", bpo::value<int>()->default_value(3),
+         "Number of passes, the fastest one is reported. Only affects bench mode.")
 
         ( "encoding,e", bpo::value<std::string>(&(info.encoding))->
           default_value("win1252"),
@@ -157,7 +166,8 @@ bool parseOptions (int argc, char** argv, Arguments &info)
         info.name = variables["name"].as<std::string>();
 
     info.mode = variables["mode"].as<std::string>();
-    if (!(info.mode == "dump" || info.mode == "clone" || info.mode == "comp"))
+    if (!(info.mode == "dump" || info.mode == "clone" || info.mode == "comp"
+          || info.mode == "stats" || info.mode == "bench"))
     {
         std::cout << std::endl << "ERROR: invalid mode \"" << info.mode << "\"" << std::endl << std::endl
                   << desc << finalText << std::endl;
@@ -187,6 +197,8 @@ bool parseOptions (int argc, char** argv, Arguments &info)
     info.quiet_given = variables.count ("quiet") != 0;
     info.loadcells_given = variables.count ("loadcells") != 0;
     info.plain_given = variables.count("plain") != 0;
+    info.csv_given = variables.count("csv") != 0;
+    info.repeat = std::max(variables["repeat"].as<int>(), 1);
 
     // Font encoding settings
     info.encoding = variables["encoding"].as<std::string>();
@@ -195,7 +207,9 @@ bool parseOptions (int argc, char** argv, Arguments &info)
         std::cout << info.encoding << " is not a valid encoding option." << std::endl;
         info.encoding = "win1252";
     }
-    std::cout << ToUTF8::encodingUsingMessage(info.encoding) << std::endl;
+    // Keep the output of the profiling modes machine-readable
+    if (info.mode != "stats" && info.mode != "bench")
+        std::cout << ToUTF8::encodingUsingMessage(info.encoding) << std::endl;
 
     return true;
 }
@@ -206,6 +220,8 @@ void loadCell(ESM::Cell &cell, ESM::ESMReader &esm, Arguments& info);
 int load(Arguments& info);
 int clone(Arguments& info);
 int comp(Arguments& info);
+int stats(Arguments& info);
+int bench(Arguments& info);
 
 int main(int argc, char**argv)
 {
@@ -221,6 +237,10 @@ int main(int argc, char**argv)
             return clone(info);
         else if (info.mode == "comp")
             return comp(info);
+        else if (info.mode == "stats")
+            return stats(info);
+        else if (info.mode == "bench")
+            return bench(info);
         else
         {
             std::cout << "Invalid or no mode specified, dying horribly. Have a nice day." << std::endl;
@@ -581,5 +601,254 @@ int comp(Arguments& info)
 
 
 
+    return 0;
+}
+
+struct SubRecordStats
+{
+    SubRecordStats() : mCount(0), mBytes(0), mMaxSize(0) {}
+
+    size_t mCount;
+    size_t mBytes; // without subrecord headers
+    size_t mMaxSize;
+};
+
+struct RecordStats
+{
+    RecordStats() : mCount(0), mBytes(0) {}
+
+    size_t mCount;
+    size_t mBytes; // including record and subrecord headers
+    std::map<int, SubRecordStats> mSubRecords;
+};
+
+bool compareBytes(const std::pair<int, RecordStats>& left, const std::pair<int, RecordStats>& right)
+{
+    return left.second.mBytes > right.second.mBytes;
+}
+
+int stats(Arguments& info)
+{
+    ESM::ESMReader& esm = info.reader;
+    esm.openRaw(info.filename);
+
+    std::map<int, RecordStats> records;
+    size_t recordCount = 0;
+
+    while(esm.hasMoreRecs())
+    {
+        size_t start = esm.getFileOffset();
+
+        ESM::NAME n = esm.getRecName();
+        esm.getRecHeader();
+
+        RecordStats& record = records[n.val];
+        while(esm.hasMoreSubs())
+        {
+            esm.getSubName();
+            esm.skipHSub();
+
+            SubRecordStats& sub = record.mSubRecords[esm.retSubName().val];
+            ++sub.mCount;
+            sub.mBytes += esm.getSubSize();
+            sub.mMaxSize = std::max(sub.mMaxSize, static_cast<size_t>(esm.getSubSize()));
+        }
+
+        ++record.mCount;
+        record.mBytes += esm.getFileOffset() - start;
+        ++recordCount;
+    }
+
+    // Biggest record types first
+    std::vector<std::pair<int, RecordStats> > sorted (records.begin(), records.end());
+    std::stable_sort(sorted.begin(), sorted.end(), compareBytes);
+
+    if (info.csv_given)
+        std::cout << "record,subrecord,count,bytes,max_size" << std::endl;
+    else
+        std::cout << info.filename << ": " << recordCount << " records, " << esm.getFileSize() << " bytes" << std::endl;
+
+    for (std::vector<std::pair<int, RecordStats> >::const_iterator it = sorted.begin(); it != sorted.end(); ++it)
+    {
+        ESM::NAME name;
+        name.val = it->first;
+        const RecordStats& record = it->second;
+
+        if (info.csv_given)
+            std::cout << name.toString() << ",," << record.mCount << "," << record.mBytes << "," << std::endl;
+        else
+            std::cout << std::endl << name.toString() << ": " << record.mCount << " records, " << record.mBytes << " bytes ("
+                      << std::fixed << std::setprecision(1) << 100.0 * record.mBytes / std::max(esm.getFileSize(), size_t(1))
+                      << "%)" << std::endl;
+
+        for (std::map<int, SubRecordStats>::const_iterator sub = record.mSubRecords.begin(); sub != record.mSubRecords.end(); ++sub)
+        {
+            ESM::NAME subName;
+            subName.val = sub->first;
+
+            if (info.csv_given)
+                std::cout << name.toString() << "," << subName.toString() << "," << sub->second.mCount << ","
+                          << sub->second.mBytes << "," << sub->second.mMaxSize << std::endl;
+            else
+                std::cout << "    " << subName.toString() << std::setw(10) << sub->second.mCount << " x, "
+                          << std::setw(10) << sub->second.mBytes << " bytes, up to " << sub->second.mMaxSize << std::endl;
+        }
+    }
+
+    return 0;
+}
+
+struct LoadTimes
+{
+    LoadTimes() : mCount(0), mSeconds(0) {}
+
+    size_t mCount;
+    double mSeconds;
+};
+
+int bench(Arguments& info)
+{
+    ToUTF8::Utf8Encoder encoder (ToUTF8::calculateEncoding(info.encoding));
+    osg::Timer* timer = osg::Timer::instance();
+
+    // Subrecords holding strings converted by the loaders
+    std::set<int> stringSubRecords;
+    const char* stringNames[] = { "NAME", "FNAM", "MODL", "ITEX", "TEXT", "DESC", "SCTX", "BNAM", "SCRI", "INAM" };
+    for (size_t i=0; i<sizeof(stringNames)/sizeof(stringNames[0]); ++i)
+    {
+        ESM::NAME name;
+        name.assign(stringNames[i]);
+        stringSubRecords.insert(name.val);
+    }
+
+    std::vector<std::string> strings;
+    size_t fileSize = 0;
+    size_t recordCount = 0;
+    double readTime = std::numeric_limits<double>::max();
+
+    // Raw reading of all subrecords
+    for (int pass=0; pass<info.repeat; ++pass)
+    {
+        ESM::ESMReader esm;
+        std::vector<char> buffer;
+
+        osg::Timer_t start = timer->tick();
+
+        esm.openRaw(info.filename);
+        fileSize = esm.getFileSize();
+        recordCount = 0;
+        while(esm.hasMoreRecs())
+        {
+            esm.getRecName();
+            esm.getRecHeader();
+            while(esm.hasMoreSubs())
+            {
+                esm.getSubName();
+                esm.getSubHeader();
+                buffer.resize(std::max(buffer.size(), static_cast<size_t>(esm.getSubSize())));
+                uint32_t size = esm.getSubSize();
+                if (size)
+                    esm.getExact(&buffer[0], size);
+
+                if (pass == 0 && size && stringSubRecords.count(esm.retSubName().val))
+                {
+                    // Without the terminator, like ESMReader::getHString
+                    std::string string (&buffer[0], size);
+                    string.erase(string.find_last_not_of('\0') + 1);
+                    strings.push_back(string);
+                }
+            }
+            ++recordCount;
+        }
+
+        readTime = std::min(readTime, timer->delta_s(start, timer->tick()));
+    }
+
+    // Loading records, as in dump mode
+    std::map<int, LoadTimes> loadTimes;
+    for (int pass=0; pass<info.repeat; ++pass)
+    {
+        ESM::ESMReader esm;
+        esm.setEncoder(&encoder);
+        esm.open(info.filename);
+
+        std::map<int, LoadTimes> passTimes;
+        while(esm.hasMoreRecs())
+        {
+            osg::Timer_t start = timer->tick();
+
+            ESM::NAME n = esm.getRecName();
+            uint32_t flags;
+            esm.getRecHeader(flags);
+
+            std::string id = esm.getHNOString("NAME");
+            if (id.empty())
+                id = esm.getHNOString("INAM");
+
+            EsmTool::RecordBase *record = EsmTool::RecordBase::create(n);
+            if (record == 0)
+                esm.skipRecord();
+            else
+            {
+                if (record->getType().val == ESM::REC_GMST)
+                    record->cast<ESM::GameSetting>()->get().mId = id;
+                record->setId(id);
+                record->setFlags((int) flags);
+                record->load(esm);
+                delete record;
+            }
+
+            LoadTimes& times = passTimes[n.val];
+            ++times.mCount;
+            times.mSeconds += timer->delta_s(start, timer->tick());
+        }
+
+        for (std::map<int, LoadTimes>::const_iterator it = passTimes.begin(); it != passTimes.end(); ++it)
+        {
+            std::map<int, LoadTimes>::iterator found = loadTimes.find(it->first);
+            if (found == loadTimes.end() || it->second.mSeconds < found->second.mSeconds)
+                loadTimes[it->first] = it->second;
+        }
+    }
+
+    // String conversion
+    size_t stringBytes = 0;
+    size_t convertedBytes = 0;
+    double encodeTime = std::numeric_limits<double>::max();
+    for (int pass=0; pass<info.repeat; ++pass)
+    {
+        stringBytes = 0;
+        convertedBytes = 0;
+
+        osg::Timer_t start = timer->tick();
+        for (std::vector<std::string>::const_iterator it = strings.begin(); it != strings.end(); ++it)
+        {
+            stringBytes += it->size();
+            convertedBytes += encoder.getUtf8(*it).size();
+        }
+        encodeTime = std::min(encodeTime, timer->delta_s(start, timer->tick()));
+    }
+
+    std::cout << "benchmark,type,count,bytes,seconds" << std::endl;
+    std::cout << "read,," << recordCount << "," << fileSize << "," << readTime << std::endl;
+
+    double loadTime = 0;
+    size_t loadCount = 0;
+    for (std::map<int, LoadTimes>::const_iterator it = loadTimes.begin(); it != loadTimes.end(); ++it)
+    {
+        ESM::NAME name;
+        name.val = it->first;
+        std::cout << "load," << name.toString() << "," << it->second.mCount << ",," << it->second.mSeconds << std::endl;
+        loadTime += it->second.mSeconds;
+        loadCount += it->second.mCount;
+    }
+    std::cout << "load,," << loadCount << "," << fileSize << "," << loadTime << std::endl;
+
+    std::cout << "to_utf8,," << strings.size() << "," << stringBytes << "," << encodeTime << std::endl;
+
+    // Keep the conversion from being optimized out
+    if (convertedBytes < stringBytes)
+        std::cerr << "Warning: conversion lost " << (stringBytes - convertedBytes) << " bytes" << std::endl;
+
     return 0;
 }
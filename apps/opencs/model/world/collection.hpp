@@ -44,7 +44,7 @@ namespace CSMWorld
     class Collection : public CollectionBase
     {
             std::vector<Record<ESXRecordT> > mRecords;
-            std::map<std::string, int> mIndex;
+            std::map<std::string, int, Misc::StringUtils::CiLess> mIndex;
             std::vector<Column<ESXRecordT> *> mColumns;
 
             // not implemented
@@ -53,7 +53,7 @@ namespace CSMWorld
 
         protected:
 
-            const std::map<std::string, int>& getIdMap() const;
+            const std::map<std::string, int, Misc::StringUtils::CiLess>& getIdMap() const;
 
             const std::vector<Record<ESXRecordT> >& getRecords() const;
 
@@ -153,7 +153,7 @@ namespace CSMWorld
     };
 
     template<typename ESXRecordT, typename IdAccessorT>
-    const std::map<std::string, int>& Collection<ESXRecordT, IdAccessorT>::getIdMap() const
+    const std::map<std::string, int, Misc::StringUtils::CiLess>& Collection<ESXRecordT, IdAccessorT>::getIdMap() const
     {
         return mIndex;
     }
@@ -190,7 +190,7 @@ namespace CSMWorld
             std::copy (buffer.begin(), buffer.end(), mRecords.begin()+baseIndex);
 
             // adjust index
-            for (std::map<std::string, int>::iterator iter (mIndex.begin()); iter!=mIndex.end();
+            for (std::map<std::string, int, Misc::StringUtils::CiLess>::iterator iter (mIndex.begin()); iter!=mIndex.end();
                  ++iter)
                 if (iter->second>=baseIndex && iter->second<baseIndex+size)
                     iter->second = newOrder.at (iter->second-baseIndex)+baseIndex;
@@ -228,7 +228,7 @@ namespace CSMWorld
     {
         std::string id = Misc::StringUtils::lowerCase (IdAccessorT().getId (record));
 
-        std::map<std::string, int>::iterator iter = mIndex.find (id);
+        std::map<std::string, int, Misc::StringUtils::CiLess>::iterator iter = mIndex.find (id);
 
         if (iter==mIndex.end())
         {
@@ -334,7 +334,7 @@ namespace CSMWorld
     {
         mRecords.erase (mRecords.begin()+index, mRecords.begin()+index+count);
 
-        typename std::map<std::string, int>::iterator iter = mIndex.begin();
+        typename std::map<std::string, int, Misc::StringUtils::CiLess>::iterator iter = mIndex.begin();
 
         while (iter!=mIndex.end())
         {
@@ -373,9 +373,7 @@ namespace CSMWorld
     template<typename ESXRecordT, typename IdAccessorT>
     int Collection<ESXRecordT, IdAccessorT>::searchId (const std::string& id) const
     {
-        std::string id2 = Misc::StringUtils::lowerCase(id);
-
-        std::map<std::string, int>::const_iterator iter = mIndex.find (id2);
+        std::map<std::string, int, Misc::StringUtils::CiLess>::const_iterator iter = mIndex.find (id);
 
         if (iter==mIndex.end())
             return -1;
@@ -410,7 +408,7 @@ namespace CSMWorld
     {
         std::vector<std::string> ids;
 
-        for (typename std::map<std::string, int>::const_iterator iter = mIndex.begin();
+        for (typename std::map<std::string, int, Misc::StringUtils::CiLess>::const_iterator iter = mIndex.begin();
             iter!=mIndex.end(); ++iter)
         {
             if (listDeleted || !mRecords[iter->second].isDeleted())
@@ -446,7 +444,7 @@ namespace CSMWorld
 
         if (index<static_cast<int> (mRecords.size())-1)
         {
-            for (std::map<std::string, int>::iterator iter (mIndex.begin()); iter!=mIndex.end();
+            for (std::map<std::string, int, Misc::StringUtils::CiLess>::iterator iter (mIndex.begin()); iter!=mIndex.end();
                 ++iter)
                  if (iter->second>=index)
                      ++(iter->second);
@@ -151,7 +151,7 @@ CSMWorld::InfoCollection::Range CSMWorld::InfoCollection::getTopicRange (const s
 {
     std::string topic2 = Misc::StringUtils::lowerCase (topic);
 
-    std::map<std::string, int>::const_iterator iter = getIdMap().lower_bound (topic2);
+    std::map<std::string, int, Misc::StringUtils::CiLess>::const_iterator iter = getIdMap().lower_bound (topic2);
 
     // Skip invalid records: The beginning of a topic string could be identical to another topic
     // string.
@@ -96,7 +96,8 @@ bool CSMWorld::ScriptContext::isId (const std::string& name) const
     {
         mIds = mData.getIds();
 
-        std::for_each (mIds.begin(), mIds.end(), &Misc::StringUtils::toLower);
+        for (std::vector<std::string>::iterator iter (mIds.begin()); iter!=mIds.end(); ++iter)
+            Misc::StringUtils::toLower (*iter);
         std::sort (mIds.begin(), mIds.end());
 
         mIdsUpdated = true;
@@ -0,0 +1,230 @@
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include <osg/Math>
+#include <osg/Stats>
+#include <osg/Timer>
+
+#include "mwbase/environment.hpp"
+#include "mwbase/world.hpp"
+
+#include "mwworld/ptr.hpp"
+#include "mwworld/refdata.hpp"
+#include "mwworld/cellstore.hpp"
+
+namespace
+{
+    /// Quote \a value for a CSV field
+    std::string quote(const std::string& value)
+    {
+        std::string quoted = "\"";
+        for (std::string::const_iterator it = value.begin(); it != value.end(); ++it)
+        {
+            if (*it == '"')
+                quoted += '"';
+            quoted += *it;
+        }
+        return quoted + "\"";
+    }
+
+    double getTimeTaken(osg::Stats* stats, unsigned int frameNumber, const std::string& name)
+    {
+        double value = 0;
+        stats->getAttribute(frameNumber, name, value);
+        return value;
+    }
+}
+
+namespace OMW
+{
+
+void BenchmarkPath::load(const boost::filesystem::path &file)
+{
+    boost::filesystem::ifstream stream (file);
+    if (!stream.is_open())
+        throw std::runtime_error("Unable to open benchmark path " + file.string());
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(stream, line))
+    {
+        ++lineNumber;
+
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos || line[start] == '#')
+            continue;
+
+        std::istringstream lineStream (line);
+        KeyFrame keyFrame;
+        keyFrame.mRotX = 0;
+        if (!(lineStream >> keyFrame.mTime >> keyFrame.mPosition.x() >> keyFrame.mPosition.y()
+              >> keyFrame.mPosition.z() >> keyFrame.mRotZ))
+        {
+            std::ostringstream error;
+            error << "Invalid key frame in " << file.string() << ", line " << lineNumber;
+            throw std::runtime_error(error.str());
+        }
+        lineStream >> keyFrame.mRotX;
+
+        if (!mKeyFrames.empty() && keyFrame.mTime < mKeyFrames.back().mTime)
+        {
+            std::ostringstream error;
+            error << "Key frames out of order in " << file.string() << ", line " << lineNumber;
+            throw std::runtime_error(error.str());
+        }
+
+        mKeyFrames.push_back(keyFrame);
+    }
+
+    if (mKeyFrames.empty())
+        throw std::runtime_error("No key frames in benchmark path " + file.string());
+}
+
+BenchmarkPath::KeyFrame BenchmarkPath::get(double time) const
+{
+    if (time <= mKeyFrames.front().mTime)
+        return mKeyFrames.front();
+
+    for (size_t i=1; i<mKeyFrames.size(); ++i)
+    {
+        const KeyFrame& next = mKeyFrames[i];
+        if (time > next.mTime)
+            continue;
+
+        const KeyFrame& previous = mKeyFrames[i-1];
+        float factor = 1.f;
+        if (next.mTime > previous.mTime)
+            factor = static_cast<float>((time - previous.mTime) / (next.mTime - previous.mTime));
+
+        KeyFrame result;
+        result.mTime = time;
+        result.mPosition = previous.mPosition + (next.mPosition - previous.mPosition) * factor;
+
+        // Turn the short way round
+        float rotZ = next.mRotZ - previous.mRotZ;
+        while (rotZ > 180.f) rotZ -= 360.f;
+        while (rotZ < -180.f) rotZ += 360.f;
+        result.mRotZ = previous.mRotZ + rotZ * factor;
+
+        result.mRotX = previous.mRotX + (next.mRotX - previous.mRotX) * factor;
+        return result;
+    }
+
+    return mKeyFrames.back();
+}
+
+double BenchmarkPath::getDuration() const
+{
+    return mKeyFrames.back().mTime - mKeyFrames.front().mTime;
+}
+
+const float Benchmark::sFrameDuration = 1.f/60.f;
+
+Benchmark::Benchmark(const boost::filesystem::path &pathFile, const boost::filesystem::path &output)
+    : mMoveTime(0)
+    , mCell(NULL)
+    , mCellLoadsBefore(0)
+    , mCellLoadTimeBefore(0)
+    , mFrames(0)
+    , mTotalFrameTime(0)
+    , mMaxFrameTime(0)
+    , mTotalCellLoadTime(0)
+    , mCellLoads(0)
+{
+    mPath.load(pathFile);
+
+    mOutput.open(output);
+    if (!mOutput.is_open())
+        throw std::runtime_error("Unable to create benchmark output " + output.string());
+
+    mOutput << "frame,time,frame_time,script_time,mechanics_time,physics_time,move_time,cell_changed,cell_load_time,cell" << std::endl;
+}
+
+bool Benchmark::update(double time)
+{
+    if (time > mPath.getDuration())
+        return false;
+
+    BenchmarkPath::KeyFrame keyFrame = mPath.get(mPath.mKeyFrames.front().mTime + time);
+
+    MWBase::World* world = MWBase::Environment::get().getWorld();
+
+    // Exterior cells are not necessarily loaded while moving the player, but later in the frame when the
+    // scene is updated, so the loads are counted by the scene itself
+    world->getCellLoadStats(mCellLoadsBefore, mCellLoadTimeBefore);
+
+    osg::Timer_t start = osg::Timer::instance()->tick();
+
+    MWWorld::Ptr player = world->getPlayerPtr();
+    world->rotateObject(player, keyFrame.mRotX, 0, keyFrame.mRotZ);
+    world->moveObject(player, keyFrame.mPosition.x(), keyFrame.mPosition.y(), keyFrame.mPosition.z());
+
+    mMoveTime = osg::Timer::instance()->delta_s(start, osg::Timer::instance()->tick());
+
+    mCell = world->getPlayerPtr().getCell();
+
+    return true;
+}
+
+void Benchmark::recordFrame(unsigned int frameNumber, double time, double frameTime, osg::Stats *stats)
+{
+    unsigned int cellLoads;
+    double cellLoadTime;
+    MWBase::Environment::get().getWorld()->getCellLoadStats(cellLoads, cellLoadTime);
+    bool cellChanged = cellLoads != mCellLoadsBefore;
+    cellLoadTime -= mCellLoadTimeBefore;
+
+    mOutput << frameNumber << "," << time << "," << frameTime << ","
+            << getTimeTaken(stats, frameNumber, "script_time_taken") << ","
+            << getTimeTaken(stats, frameNumber, "mechanics_time_taken") << ","
+            << getTimeTaken(stats, frameNumber, "physics_time_taken") << ","
+            << mMoveTime << "," << cellChanged << "," << cellLoadTime << ","
+            << quote(MWBase::Environment::get().getWorld()->getCellName(mCell)) << "\n";
+
+    ++mFrames;
+    mTotalFrameTime += frameTime;
+    mMaxFrameTime = std::max(mMaxFrameTime, frameTime);
+    mCellLoads += cellLoads - mCellLoadsBefore;
+    mTotalCellLoadTime += cellLoadTime;
+}
+
+void Benchmark::printSummary() const
+{
+    std::cout << "Benchmark finished: " << mFrames << " frames";
+    if (mFrames)
+        std::cout << ", average frame time " << 1000.0 * mTotalFrameTime / mFrames << " ms"
+                  << ", maximum " << 1000.0 * mMaxFrameTime << " ms";
+    std::cout << ", " << mCellLoads << " cell changes taking " << 1000.0 * mTotalCellLoadTime << " ms" << std::endl;
+}
+
+const double BenchmarkRecorder::sInterval = 0.5;
+
+BenchmarkRecorder::BenchmarkRecorder(const boost::filesystem::path &pathFile)
+    : mOutput(pathFile)
+    , mStartTime(-1)
+    , mLastTime(-1)
+{
+    if (!mOutput.is_open())
+        throw std::runtime_error("Unable to create benchmark path " + pathFile.string());
+
+    mOutput << "# time x y z rotation_z rotation_x" << std::endl;
+}
+
+void BenchmarkRecorder::update(double time)
+{
+    if (mStartTime < 0)
+        mStartTime = time;
+    else if (time - mLastTime < sInterval)
+        return;
+    mLastTime = time;
+
+    const ESM::Position& position = MWBase::Environment::get().getWorld()->getPlayerPtr().getRefData().getPosition();
+    mOutput << (time - mStartTime) << " " << position.pos[0] << " " << position.pos[1] << " " << position.pos[2] << " "
+            << osg::RadiansToDegrees(position.rot[2]) << " " << osg::RadiansToDegrees(position.rot[0]) << std::endl;
+}
+
+}
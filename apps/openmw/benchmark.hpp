@@ -0,0 +1,107 @@
+#ifndef OPENMW_BENCHMARK_H
+#define OPENMW_BENCHMARK_H
+
+#include <vector>
+
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <osg/Vec3f>
+
+namespace osg
+{
+    class Stats;
+}
+
+namespace MWWorld
+{
+    class CellStore;
+}
+
+namespace OMW
+{
+    /// @brief Camera path for the benchmark mode.
+    /// @par One key frame per line: time in seconds, position (x y z), rotation around the z axis and
+    /// optionally around the x axis in degrees. Empty lines and lines starting with # are ignored.
+    struct BenchmarkPath
+    {
+        struct KeyFrame
+        {
+            double mTime;
+            osg::Vec3f mPosition;
+            float mRotZ;
+            float mRotX;
+        };
+
+        std::vector<KeyFrame> mKeyFrames;
+
+        /// @note Throws an exception if the file can not be read or contains no key frames.
+        void load(const boost::filesystem::path& file);
+
+        /// Interpolate between the key frames
+        KeyFrame get(double time) const;
+
+        double getDuration() const;
+    };
+
+    /// @brief Drives the player along a BenchmarkPath and writes per-frame timings to a CSV file.
+    class Benchmark
+    {
+    public:
+        /// Simulated duration of each frame, so that runs on different machines do the same work
+        static const float sFrameDuration;
+
+        Benchmark(const boost::filesystem::path& pathFile, const boost::filesystem::path& output);
+
+        /// Move the player to its position on the path at benchmark time \a time (0 is the first
+        /// frame of the game running). Returns false once the end of the path has been passed.
+        bool update(double time);
+
+        /// Write the timings of a finished frame. Script, mechanics and physics times are taken from \a stats.
+        void recordFrame(unsigned int frameNumber, double time, double frameTime, osg::Stats* stats);
+
+        /// Print a summary to stdout
+        void printSummary() const;
+
+    private:
+        BenchmarkPath mPath;
+
+        boost::filesystem::ofstream mOutput;
+
+        /// Time spent moving the player this frame, which includes loading interior cells
+        double mMoveTime;
+
+        const MWWorld::CellStore* mCell;
+
+        /// Cell load statistics of the scene at the start of the frame
+        unsigned int mCellLoadsBefore;
+        double mCellLoadTimeBefore;
+
+        unsigned int mFrames;
+        double mTotalFrameTime;
+        double mMaxFrameTime;
+        double mTotalCellLoadTime;
+        unsigned int mCellLoads;
+    };
+
+    /// @brief Records the player's movement as a BenchmarkPath.
+    class BenchmarkRecorder
+    {
+    public:
+        /// Interval between key frames, in seconds
+        static const double sInterval;
+
+        BenchmarkRecorder(const boost::filesystem::path& pathFile);
+
+        /// @param time Simulation time
+        void update(double time);
+
+    private:
+        boost::filesystem::ofstream mOutput;
+
+        double mStartTime;
+        double mLastTime;
+    };
+}
+
+#endif
@@ -12,8 +12,10 @@
 #include <SDL.h>
 
 #include <components/misc/rng.hpp>
+#include <components/misc/profiler.hpp>
 
 #include <components/vfs/manager.hpp>
+#include <components/vfs/accesstrace.hpp>
 #include <components/vfs/registerarchives.hpp>
 
 #include <components/sdlutil/sdlgraphicswindow.hpp>
@@ -53,6 +55,8 @@
 
 #include "mwmechanics/mechanicsmanagerimp.hpp"
 
+#include "benchmark.hpp"
+
 #include "mwstate/statemanagerimp.hpp"
 
 namespace
@@ -84,6 +88,9 @@ void OMW::Engine::executeLocalScripts()
 
 void OMW::Engine::frame(float frametime)
 {
+    Misc::Profiler::flush();
+    Misc::ProfileZone zone("Engine::frame");
+
     try
     {
         mStartTick = mViewer->getStartTick();
@@ -210,6 +217,7 @@ OMW::Engine::Engine(Files::ConfigurationManager& configurationManager)
   , mFSStrict (false)
   , mScriptBlacklistUse (true)
   , mNewGame (false)
+  , mBenchmarkDraw(true)
   , mCfgMgr(configurationManager)
 {
     Misc::Rng::init();
@@ -440,6 +448,9 @@ void OMW::Engine::prepareEngine (Settings::Manager & settings)
     mEnvironment.setStateManager (
         new MWState::StateManager (mCfgMgr.getUserDataPath() / "saves", mContentFiles.at (0)));
 
+    Misc::Profiler::setTraceDirectory(mCfgMgr.getUserDataPath().string());
+    Misc::Profiler::setThreadName("Main");
+
     createWindow(settings);
 
     osg::ref_ptr<osg::Group> rootNode (new osg::Group);
@@ -447,6 +458,12 @@ void OMW::Engine::prepareEngine (Settings::Manager & settings)
 
     mVFS.reset(new VFS::Manager(mFSStrict));
 
+    if (!mVFSTraceFile.empty())
+    {
+        mVFSTrace.reset(new VFS::AccessTrace(mVFSTraceFile));
+        mVFS->setAccessListener(mVFSTrace.get());
+    }
+
     VFS::registerArchives(mVFS.get(), mFileCollections, mArchives, true);
 
     mResourceSystem.reset(new Resource::ResourceSystem(mVFS.get()));
@@ -543,22 +560,32 @@ void OMW::Engine::prepareEngine (Settings::Manager & settings)
     // scripts
     if (mCompileAll)
     {
-        std::pair<int, int> result = MWBase::Environment::get().getScriptManager()->compileAll();
+        osg::Timer timer;
+        int threads = 0;
+        std::pair<int, int> result = MWBase::Environment::get().getScriptManager()->compileAll(threads);
+        double seconds = timer.time_s();
         if (result.first)
             std::cout
                 << "compiled " << result.second << " of " << result.first << " scripts ("
                 << 100*static_cast<double> (result.second)/result.first
-                << "%)"
+                << "%) in " << seconds << " s ("
+                << (seconds > 0 ? result.first / seconds : 0) << " scripts/s on "
+                << threads << (threads > 1 ? " threads)" : " thread)")
                 << std::endl;
     }
     if (mCompileAllDialogue)
     {
-        std::pair<int, int> result = MWDialogue::ScriptTest::compileAll(&mExtensions, mWarningsMode);
+        osg::Timer timer;
+        int threads = 0;
+        std::pair<int, int> result = MWDialogue::ScriptTest::compileAll(&mExtensions, mWarningsMode, threads);
+        double seconds = timer.time_s();
         if (result.first)
             std::cout
-                << "compiled " << result.second << " of " << result.first << " dialogue script/actor combinations a("
+                << "compiled " << result.second << " of " << result.first << " dialogue script/actor combinations ("
                 << 100*static_cast<double> (result.second)/result.first
-                << "%)"
+                << "%) in " << seconds << " s ("
+                << (seconds > 0 ? result.first / seconds : 0) << " scripts/s on "
+                << threads << (threads > 1 ? " threads)" : " thread)")
                 << std::endl;
     }
 }
@@ -670,6 +697,15 @@ void OMW::Engine::go()
         MWBase::Environment::get().getStateManager()->newGame (!mNewGame);
     }
 
+    std::auto_ptr<Benchmark> benchmark;
+    if (!mBenchmarkPath.empty())
+        benchmark.reset(new Benchmark(mBenchmarkPath, mBenchmarkOutput));
+    double benchmarkTime = 0.0;
+
+    std::auto_ptr<BenchmarkRecorder> benchmarkRecorder;
+    if (!mBenchmarkRecordPath.empty())
+        benchmarkRecorder.reset(new BenchmarkRecorder(mBenchmarkRecordPath));
+
     // Start the main rendering loop
     osg::Timer frameTimer;
     double simulationTime = 0.0;
@@ -679,6 +715,16 @@ void OMW::Engine::go()
         frameTimer.setStartTick();
         dt = std::min(dt, 0.2);
 
+        bool running = MWBase::Environment::get().getStateManager()->getState() == MWBase::StateManager::State_Running;
+        bool benchmarkFrame = benchmark.get() && running;
+        if (benchmarkFrame)
+        {
+            if (!benchmark->update(benchmarkTime))
+                break;
+            // Simulate the same amount of time in each frame, regardless of how long it took
+            dt = Benchmark::sFrameDuration;
+        }
+
         bool guiActive = MWBase::Environment::get().getWindowManager()->isGuiMode();
         if (!guiActive)
             simulationTime += dt;
@@ -687,11 +733,29 @@ void OMW::Engine::go()
 
         frame(dt);
 
+        if (benchmarkRecorder.get() && running && !guiActive)
+            benchmarkRecorder->update(simulationTime);
+
         mViewer->eventTraversal();
         mViewer->updateTraversal();
-        mViewer->renderingTraversals();
+        if (!benchmarkFrame || mBenchmarkDraw)
+            mViewer->renderingTraversals();
+
+        if (benchmarkFrame)
+        {
+            benchmark->recordFrame(mViewer->getFrameStamp()->getFrameNumber(), benchmarkTime,
+                                   frameTimer.time_s(), mViewer->getViewerStats());
+            benchmarkTime += dt;
+        }
     }
 
+    if (benchmark.get())
+        benchmark->printSummary();
+
+    // Finish the trace file, if the profiler was left on
+    if (Misc::Profiler::isEnabled())
+        Misc::Profiler::toggle();
+
     // Save user settings
     settings.saveUser(settingspath);
 
@@ -793,6 +857,23 @@ void OMW::Engine::enableFontExport(bool exportFonts)
     mExportFonts = exportFonts;
 }
 
+void OMW::Engine::setBenchmark(const std::string &path, const std::string &output, bool draw)
+{
+    mBenchmarkPath = path;
+    mBenchmarkOutput = output;
+    mBenchmarkDraw = draw;
+}
+
+void OMW::Engine::setBenchmarkRecordPath(const std::string &path)
+{
+    mBenchmarkRecordPath = path;
+}
+
+void OMW::Engine::setVFSTraceFile(const std::string &file)
+{
+    mVFSTraceFile = file;
+}
+
 void OMW::Engine::setSaveGameFile(const std::string &savegame)
 {
     mSaveGameFile = savegame;
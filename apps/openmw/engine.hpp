@@ -21,6 +21,7 @@ namespace Resource
 namespace VFS
 {
     class Manager;
+    class AccessTrace;
 }
 
 namespace Compiler
@@ -66,6 +67,8 @@ namespace OMW
     class Engine
     {
             SDL_Window* mWindow;
+            boost::filesystem::path mVFSTraceFile;
+            std::auto_ptr<VFS::AccessTrace> mVFSTrace; // must outlive mVFS
             std::auto_ptr<VFS::Manager> mVFS;
             std::auto_ptr<Resource::ResourceSystem> mResourceSystem;
             MWBase::Environment mEnvironment;
@@ -107,6 +110,11 @@ namespace OMW
 
             osg::Timer_t mStartTick;
 
+            std::string mBenchmarkPath;
+            std::string mBenchmarkOutput;
+            bool mBenchmarkDraw;
+            std::string mBenchmarkRecordPath;
+
             // not implemented
             Engine (const Engine&);
             Engine& operator= (const Engine&);
@@ -206,6 +214,18 @@ namespace OMW
             /// Set the save game file to load after initialising the engine.
             void setSaveGameFile(const std::string& savegame);
 
+            /// Drive the player along the camera path in \a path once the game is running, write per-frame
+            /// timings to \a output and quit at the end of the path (see OMW::Benchmark).
+            /// @param draw Draw the frames? If disabled, only the simulation is timed. The window is
+            /// created either way.
+            void setBenchmark(const std::string& path, const std::string& output, bool draw);
+
+            /// Record the player's movement to \a path, for use with setBenchmark.
+            void setBenchmarkRecordPath(const std::string& path);
+
+            /// Record the names of all files opened through the VFS to \a file (see VFS::AccessTrace).
+            void setVFSTraceFile(const std::string& file);
+
         private:
             Files::ConfigurationManager& mCfgMgr;
     };
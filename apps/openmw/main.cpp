@@ -182,7 +182,24 @@ bool parseOptions (int argc, char** argv, OMW::Engine& engine, Files::Configurat
         ("export-fonts", bpo::value<bool>()->implicit_value(true)
             ->default_value(false), "Export Morrowind .fnt fonts to PNG image and XML file in current directory")
 
-        ("activate-dist", bpo::value <int> ()->default_value (-1), "activation distance override");
+        ("activate-dist", bpo::value <int> ()->default_value (-1), "activation distance override")
+
+        ("benchmark", bpo::value<std::string>()->default_value(""),
+            "drive the player along the camera path in this file once the game is running, write per-frame timings "
+            "and quit at the end of the path (use with load-savegame, or with skip-menu and start)")
+
+        ("benchmark-output", bpo::value<std::string>()->default_value("benchmark.csv"),
+            "CSV file to write benchmark timings to")
+
+        ("benchmark-skip-drawing", bpo::value<bool>()->implicit_value(true)
+            ->default_value(false), "skip drawing the frames while benchmarking, to time only the simulation "
+            "(the game window is still created, as input and the GUI need it)")
+
+        ("benchmark-record", bpo::value<std::string>()->default_value(""),
+            "record the player's movement to this file, as a camera path for benchmark")
+
+        ("vfs-trace", bpo::value<std::string>()->default_value(""),
+            "write the names of all opened resource files to this file, in the order they were first used (see bsatool pack)");
 
     bpo::parsed_options valid_opts = bpo::command_line_parser(argc, argv)
         .options(desc).allow_unregistered().run();
@@ -277,6 +294,10 @@ bool parseOptions (int argc, char** argv, OMW::Engine& engine, Files::Configurat
     engine.setFallbackValues(variables["fallback"].as<FallbackMap>().mMap);
     engine.setActivationDistanceOverride (variables["activate-dist"].as<int>());
     engine.enableFontExport(variables["export-fonts"].as<bool>());
+    engine.setVFSTraceFile(variables["vfs-trace"].as<std::string>());
+    engine.setBenchmark(variables["benchmark"].as<std::string>(), variables["benchmark-output"].as<std::string>(),
+                        !variables["benchmark-skip-drawing"].as<bool>());
+    engine.setBenchmarkRecordPath(variables["benchmark-record"].as<std::string>());
 
     return true;
 }
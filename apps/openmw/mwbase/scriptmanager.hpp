@@ -42,8 +42,9 @@ namespace MWBase
             ///< Compile script with the given namen
             /// \return Success?
 
-            virtual std::pair<int, int> compileAll() = 0;
+            virtual std::pair<int, int> compileAll (int& threads) = 0;
             ///< Compile all scripts
+            /// \param threads Set to the number of threads the scripts were compiled on
             /// \return count, success
 
             virtual const Compiler::Locals& getLocals (const std::string& name) = 0;
@@ -48,9 +48,15 @@ namespace MWRender
     class Animation;
 }
 
+namespace Resource
+{
+    struct CacheStats;
+}
+
 namespace MWMechanics
 {
     struct Movement;
+    class HierarchicalPathgrid;
 }
 
 namespace MWWorld
@@ -125,6 +131,9 @@ namespace MWBase
 
             virtual const MWWorld::ESMStore& getStore() const = 0;
 
+            virtual MWMechanics::HierarchicalPathgrid& getHierarchicalPathgrid() = 0;
+            ///< Pathgrids of all exterior cells, linked at the cell borders
+
             virtual std::vector<ESM::ESMReader>& getEsmReader() = 0;
 
             virtual MWWorld::LocalScripts& getLocalScripts() = 0;
@@ -132,6 +141,10 @@ namespace MWBase
             virtual bool hasCellChanged() const = 0;
             ///< Has the set of active cells changed, since the last frame?
 
+            virtual void getCellLoadStats (unsigned int& count, double& time) const = 0;
+            ///< Get the number of times the set of active cells was changed and the total time spent changing
+            /// it, in seconds.
+
             virtual bool isCellExterior() const = 0;
 
             virtual bool isCellQuasiExterior() const = 0;
@@ -174,6 +187,11 @@ namespace MWBase
             ///< Return a pointer to a liveCellRef with the given name.
             /// \param activeOnly do non search inactive cells.
 
+            virtual unsigned int getReferenceGeneration() const = 0;
+            ///< Changes whenever the result of searchPtr for a reference in a cell may change,
+            /// i.e. when cells are loaded or unloaded, or references are added, removed or moved
+            /// between cells. Can be used to cache searchPtr results.
+
             virtual MWWorld::Ptr searchPtrViaActorId (int actorId) = 0;
             ///< Search is limited to the active cells.
 
@@ -347,6 +365,9 @@ namespace MWBase
 
             virtual void update (float duration, bool paused) = 0;
 
+            virtual void getResourceCacheStats (std::map<std::string, Resource::CacheStats>& stats) const = 0;
+            ///< Get the statistics of the mesh, texture, animation and collision shape caches, by cache name.
+
             virtual MWWorld::Ptr placeObject (const MWWorld::Ptr& object, float cursorX, float cursorY, int amount) = 0;
             ///< copy and place an object into the gameworld at the specified cursor position
             /// @param object
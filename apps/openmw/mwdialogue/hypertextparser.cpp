@@ -53,7 +53,7 @@ namespace MWDialogue
             std::list<std::string> keywordList;
             for (MWWorld::Store<ESM::Dialogue>::iterator it = dialogs.begin(); it != dialogs.end(); ++it)
                 keywordList.push_back(Misc::StringUtils::lowerCase(it->mId));
-            keywordList.sort(Misc::StringUtils::ciLess);
+            keywordList.sort(Misc::StringUtils::CiLess());
 
             KeywordSearch<std::string, int /*unused*/> keywordSearch;
 
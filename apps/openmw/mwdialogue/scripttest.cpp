@@ -11,28 +11,28 @@
 #include "../mwbase/scriptmanager.hpp"
 
 #include "../mwscript/compilercontext.hpp"
+#include "../mwscript/parallelcompiler.hpp"
 
-#include <components/compiler/exception.hpp>
-#include <components/compiler/streamerrorhandler.hpp>
-#include <components/compiler/scanner.hpp>
 #include <components/compiler/locals.hpp>
-#include <components/compiler/output.hpp>
-#include <components/compiler/scriptparser.hpp>
 
 #include "filter.hpp"
 
 namespace
 {
 
-void test(const MWWorld::Ptr& actor, int &compiled, int &total, const Compiler::Extensions* extensions, int warningsMode)
+/// Queue the dialogue result scripts that \a actor may run, to be compiled with the locals of its script
+void addJobs(const MWWorld::Ptr& actor, std::vector<MWScript::CompileJob>& jobs, const Compiler::Locals* noLocals)
 {
     MWDialogue::Filter filter(actor, 0, false);
 
-    MWScript::CompilerContext compilerContext(MWScript::CompilerContext::Type_Dialogue);
-    compilerContext.setExtensions(extensions);
-    std::ostream errorStream(std::cout.rdbuf());
-    Compiler::StreamErrorHandler errorHandler(errorStream);
-    errorHandler.setWarningsMode (warningsMode);
+    const Compiler::Locals* locals = noLocals;
+
+    std::string actorScript = actor.getClass().getScript(actor);
+    if (!actorScript.empty())
+    {
+        // grab local variables from actor's script, if available.
+        locals = &MWBase::Environment::get().getScriptManager()->getLocals (actorScript);
+    }
 
     const MWWorld::Store<ESM::Dialogue>& dialogues = MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>();
     for (MWWorld::Store<ESM::Dialogue>::iterator it = dialogues.begin(); it != dialogues.end(); ++it)
@@ -43,55 +43,7 @@ void test(const MWWorld::Ptr& actor, int &compiled, int &total, const Compiler::
         {
             const ESM::DialInfo* info = *it;
             if (!info->mResultScript.empty())
-            {
-                bool success = true;
-                ++total;
-                try
-                {
-                    errorHandler.reset();
-
-                    std::istringstream input (info->mResultScript + "\n");
-
-                    Compiler::Scanner scanner (errorHandler, input, extensions);
-
-                    Compiler::Locals locals;
-
-                    std::string actorScript = actor.getClass().getScript(actor);
-
-                    if (!actorScript.empty())
-                    {
-                        // grab local variables from actor's script, if available.
-                        locals = MWBase::Environment::get().getScriptManager()->getLocals (actorScript);
-                    }
-
-                    Compiler::ScriptParser parser(errorHandler, compilerContext, locals, false);
-
-                    scanner.scan (parser);
-
-                    if (!errorHandler.isGood())
-                        success = false;
-
-                    ++compiled;
-                }
-                catch (const Compiler::SourceException& /* error */)
-                {
-                    // error has already been reported via error handler
-                    success = false;
-                }
-                catch (const std::exception& error)
-                {
-                    std::cerr << std::string ("Dialogue error: An exception has been thrown: ") + error.what() << std::endl;
-                    success = false;
-                }
-
-                if (!success)
-                {
-                    std::cerr
-                        << "compiling failed (dialogue script)" << std::endl
-                        << info->mResultScript
-                        << std::endl << std::endl;
-                }
-            }
+                jobs.push_back(MWScript::CompileJob(info->mId, info->mResultScript + "\n", locals));
         }
     }
 }
@@ -104,23 +56,48 @@ namespace MWDialogue
 namespace ScriptTest
 {
 
-    std::pair<int, int> compileAll(const Compiler::Extensions *extensions, int warningsMode)
+    std::pair<int, int> compileAll(const Compiler::Extensions *extensions, int warningsMode, int& threads)
     {
-        int compiled = 0, total = 0;
+        // Filtering the infos needs the world, so only the compiling itself is done in parallel
+        Compiler::Locals noLocals;
+        std::vector<MWScript::CompileJob> jobs;
+
         const MWWorld::Store<ESM::NPC>& npcs = MWBase::Environment::get().getWorld()->getStore().get<ESM::NPC>();
         for (MWWorld::Store<ESM::NPC>::iterator it = npcs.begin(); it != npcs.end(); ++it)
         {
             MWWorld::ManualRef ref(MWBase::Environment::get().getWorld()->getStore(), it->mId);
-            test(ref.getPtr(), compiled, total, extensions, warningsMode);
+            addJobs(ref.getPtr(), jobs, &noLocals);
         }
 
         const MWWorld::Store<ESM::Creature>& creatures = MWBase::Environment::get().getWorld()->getStore().get<ESM::Creature>();
         for (MWWorld::Store<ESM::Creature>::iterator it = creatures.begin(); it != creatures.end(); ++it)
         {
             MWWorld::ManualRef ref(MWBase::Environment::get().getWorld()->getStore(), it->mId);
-            test(ref.getPtr(), compiled, total, extensions, warningsMode);
+            addJobs(ref.getPtr(), jobs, &noLocals);
         }
-        return std::make_pair(total, compiled);
+
+        MWScript::CompilerContext compilerContext(MWScript::CompilerContext::Type_Dialogue);
+        compilerContext.setExtensions(extensions);
+
+        threads = MWScript::compileInParallel(jobs, compilerContext, warningsMode, MWScript::getCompilerThreads());
+
+        int compiled = 0;
+        for (std::vector<MWScript::CompileJob>::const_iterator job = jobs.begin(); job != jobs.end(); ++job)
+        {
+            std::cout << job->mMessages;
+
+            if (job->mSuccess)
+                ++compiled;
+            else
+            {
+                std::cerr
+                    << "compiling failed (dialogue script)" << std::endl
+                    << job->mText
+                    << std::endl;
+            }
+        }
+
+        return std::make_pair(static_cast<int>(jobs.size()), compiled);
     }
 
 }
@@ -10,8 +10,9 @@ namespace ScriptTest
 {
 
 /// Attempt to compile all dialogue scripts, use for verification purposes
+/// @param threads Set to the number of threads the scripts were compiled on
 /// @return A pair containing <total number of scripts, number of successfully compiled scripts>
-std::pair<int, int> compileAll(const Compiler::Extensions* extensions, int warningsMode);
+std::pair<int, int> compileAll(const Compiler::Extensions* extensions, int warningsMode, int& threads);
 
 }
 
@@ -1,6 +1,8 @@
 #ifndef MWGUI_ITEM_MODEL_H
 #define MWGUI_ITEM_MODEL_H
 
+#include <vector>
+
 #include "../mwworld/ptr.hpp"
 
 namespace MWGui
@@ -61,6 +63,11 @@ namespace MWGui
         /// Rebuild the item model, this will invalidate existing model indices
         virtual void update() = 0;
 
+        /// Get the indices (in ascending order) whose item stack differs from the one at the same index
+        /// before the last call to update(), including any indices past the previous item count.
+        /// @return false if the model does not keep track of changes, i.e. any item may have changed.
+        virtual bool getChangedItems (std::vector<ModelIndex>& changed) { return false; }
+
         /// Move items from this model to \a otherModel.
         /// @note Derived implementations may return an empty Ptr if the move was unsuccessful.
         virtual MWWorld::Ptr moveItem (const ItemStack& item, size_t count, ItemModel* otherModel);
@@ -1,5 +1,6 @@
 #include "itemview.hpp"
 
+#include <algorithm>
 #include <cmath>
 
 #include <MyGUI_FactoryManager.h>
@@ -20,6 +21,8 @@ namespace MWGui
 ItemView::ItemView()
     : mModel(NULL)
     , mScrollView(NULL)
+    , mDragArea(NULL)
+    , mRows(1)
 {
 }
 
@@ -32,6 +35,14 @@ void ItemView::setModel(ItemModel *model)
 {
     delete mModel;
     mModel = model;
+
+    // Nothing displayed so far is known to be valid for the new model
+    for (std::vector<Cell>::iterator it = mCells.begin(); it != mCells.end(); ++it)
+    {
+        releaseCell(*it);
+        it->mBase = MWWorld::Ptr();
+    }
+
     update();
 }
 
@@ -44,41 +55,40 @@ void ItemView::initialiseOverride()
         throw std::runtime_error("Item view needs a scroll view");
 
     mScrollView->setCanvasAlign(MyGUI::Align::Left | MyGUI::Align::Top);
+
+    mDragArea = mScrollView->createWidget<MyGUI::Widget>("",0,0,mScrollView->getWidth(),mScrollView->getHeight(),
+                                                         MyGUI::Align::Stretch);
+    mDragArea->setNeedMouseFocus(true);
+    mDragArea->eventMouseButtonClick += MyGUI::newDelegate(this, &ItemView::onSelectedBackground);
+    mDragArea->eventMouseWheel += MyGUI::newDelegate(this, &ItemView::onMouseWheelMoved);
+
+    // The scroll view has no event for its view offset changing, e.g. when dragging the scrollbar
+    MyGUI::Gui::getInstance().eventFrameStart += MyGUI::newDelegate(this, &ItemView::onFrame);
+}
+
+void ItemView::shutdownOverride()
+{
+    MyGUI::Gui::getInstance().eventFrameStart -= MyGUI::newDelegate(this, &ItemView::onFrame);
+
+    Base::shutdownOverride();
 }
 
 void ItemView::layoutWidgets()
 {
-    if (!mScrollView->getChildCount())
-        return;
+    int count = mModel ? static_cast<int>(mModel->getItemCount()) : 0;
 
-    int x = 0;
-    int y = 0;
-    MyGUI::Widget* dragArea = mScrollView->getChildAt(0);
     int maxHeight = mScrollView->getHeight();
 
     int rows = maxHeight/42;
     rows = std::max(rows, 1);
-    bool showScrollbar = int(std::ceil(dragArea->getChildCount()/float(rows))) > mScrollView->getWidth()/42;
+    bool showScrollbar = int(std::ceil(count/float(rows))) > mScrollView->getWidth()/42;
     if (showScrollbar)
         maxHeight -= 18;
 
-    for (unsigned int i=0; i<dragArea->getChildCount(); ++i)
-    {
-        MyGUI::Widget* w = dragArea->getChildAt(i);
-
-        w->setPosition(x, y);
+    mRows = std::max(maxHeight/42, 1);
+    int columns = std::max((count + mRows - 1) / mRows, 1);
 
-        y += 42;
-
-        if (y > maxHeight-42 && i < dragArea->getChildCount()-1)
-        {
-            x += 42;
-            y = 0;
-        }
-    }
-    x += 42;
-
-    MyGUI::IntSize size = MyGUI::IntSize(std::max(mScrollView->getSize().width, x), mScrollView->getSize().height);
+    MyGUI::IntSize size = MyGUI::IntSize(std::max(mScrollView->getSize().width, columns*42), mScrollView->getSize().height);
 
     // Canvas size must be expressed with VScroll disabled, otherwise MyGUI would expand the scroll area when the scrollbar is hidden
     mScrollView->setVisibleVScroll(false);
@@ -86,43 +96,138 @@ void ItemView::layoutWidgets()
     mScrollView->setCanvasSize(size);
     mScrollView->setVisibleVScroll(true);
     mScrollView->setVisibleHScroll(true);
-    dragArea->setSize(size);
+    mDragArea->setSize(size);
+
+    updateVisibleItems();
 }
 
-void ItemView::update()
+void ItemView::updateVisibleItems()
+{
+    mViewOffset = mScrollView->getViewOffset();
+
+    int count = mModel ? static_cast<int>(mModel->getItemCount()) : 0;
+
+    // Include partially visible columns
+    int left = -mViewOffset.left;
+    int firstColumn = std::max(left / 42, 0);
+    int lastColumn = (left + mScrollView->getWidth()) / 42;
+
+    int first = std::min(firstColumn * mRows, count);
+    int end = std::min((lastColumn + 1) * mRows, count);
+
+    std::vector<bool> bound (end - first, false);
+    std::vector<size_t> unused;
+    for (size_t i=0; i<mCells.size(); ++i)
+    {
+        Cell& cell = mCells[i];
+        if (cell.mIndex >= first && cell.mIndex < end)
+            bound[cell.mIndex - first] = true;
+        else
+        {
+            releaseCell(cell);
+            unused.push_back(i);
+        }
+    }
+
+    for (int index = first; index < end; ++index)
+    {
+        if (bound[index - first])
+            continue;
+
+        if (unused.empty())
+        {
+            createCell();
+            unused.push_back(mCells.size()-1);
+        }
+
+        bindCell(mCells[unused.back()], index);
+        unused.pop_back();
+    }
+
+    for (std::vector<Cell>::iterator it = mCells.begin(); it != mCells.end(); ++it)
+    {
+        if (it->mIndex != -1)
+            it->mWidget->setPosition((it->mIndex / mRows) * 42, (it->mIndex % mRows) * 42);
+    }
+}
+
+ItemView::Cell& ItemView::createCell()
 {
-    while (mScrollView->getChildCount())
-        MyGUI::Gui::getInstance().destroyWidget(mScrollView->getChildAt(0));
+    Cell cell;
+    cell.mWidget = mDragArea->createWidget<ItemWidget>("MW_ItemIcon",
+        MyGUI::IntCoord(0, 0, 42, 42), MyGUI::Align::Default);
+    cell.mWidget->setUserString("ToolTipType", "ItemModelIndex");
+    cell.mWidget->eventMouseButtonClick += MyGUI::newDelegate(this, &ItemView::onSelectedItem);
+    cell.mWidget->eventMouseWheel += MyGUI::newDelegate(this, &ItemView::onMouseWheelMoved);
+    cell.mWidget->setVisible(false);
+    cell.mIndex = -1;
+    cell.mState = ItemWidget::None;
+    cell.mCount = 0;
+
+    mCells.push_back(cell);
+    return mCells.back();
+}
+
+void ItemView::bindCell(Cell& cell, ItemModel::ModelIndex index)
+{
+    ItemStack item = mModel->getItem(index);
+
+    ItemWidget::ItemState state = ItemWidget::None;
+    if (item.mType == ItemStack::Type_Barter)
+        state = ItemWidget::Barter;
+    if (item.mType == ItemStack::Type_Equipped)
+        state = ItemWidget::Equip;
+
+    if (item.mBase != cell.mBase || state != cell.mState)
+    {
+        cell.mWidget->setItem(item.mBase, state);
+        cell.mBase = item.mBase;
+        cell.mState = state;
+    }
+    if (item.mCount != cell.mCount)
+    {
+        cell.mWidget->setCount(item.mCount);
+        cell.mCount = item.mCount;
+    }
 
+    cell.mIndex = index;
+    cell.mWidget->setUserData(std::make_pair(index, mModel));
+    cell.mWidget->setVisible(true);
+}
+
+void ItemView::releaseCell(Cell& cell)
+{
+    if (cell.mIndex == -1)
+        return;
+
+    cell.mIndex = -1;
+    cell.mWidget->setVisible(false);
+}
+
+void ItemView::update()
+{
     if (!mModel)
+    {
+        layoutWidgets();
         return;
+    }
 
     mModel->update();
 
-    MyGUI::Widget* dragArea = mScrollView->createWidget<MyGUI::Widget>("",0,0,mScrollView->getWidth(),mScrollView->getHeight(),
-                                                                       MyGUI::Align::Stretch);
-    dragArea->setNeedMouseFocus(true);
-    dragArea->eventMouseButtonClick += MyGUI::newDelegate(this, &ItemView::onSelectedBackground);
-    dragArea->eventMouseWheel += MyGUI::newDelegate(this, &ItemView::onMouseWheelMoved);
+    std::vector<ItemModel::ModelIndex> changed;
+    bool changesKnown = mModel->getChangedItems(changed);
+    int count = static_cast<int>(mModel->getItemCount());
 
-    for (ItemModel::ModelIndex i=0; i<static_cast<int>(mModel->getItemCount()); ++i)
+    // Refresh the displayed items that changed, the newly visible ones are bound by layoutWidgets
+    for (std::vector<Cell>::iterator it = mCells.begin(); it != mCells.end(); ++it)
     {
-        const ItemStack& item = mModel->getItem(i);
-
-        ItemWidget* itemWidget = dragArea->createWidget<ItemWidget>("MW_ItemIcon",
-            MyGUI::IntCoord(0, 0, 42, 42), MyGUI::Align::Default);
-        itemWidget->setUserString("ToolTipType", "ItemModelIndex");
-        itemWidget->setUserData(std::make_pair(i, mModel));
-        ItemWidget::ItemState state = ItemWidget::None;
-        if (item.mType == ItemStack::Type_Barter)
-            state = ItemWidget::Barter;
-        if (item.mType == ItemStack::Type_Equipped)
-            state = ItemWidget::Equip;
-        itemWidget->setItem(item.mBase, state);
-        itemWidget->setCount(item.mCount);
-
-        itemWidget->eventMouseButtonClick += MyGUI::newDelegate(this, &ItemView::onSelectedItem);
-        itemWidget->eventMouseWheel += MyGUI::newDelegate(this, &ItemView::onMouseWheelMoved);
+        if (it->mIndex == -1)
+            // The item this widget displayed may no longer exist
+            it->mBase = MWWorld::Ptr();
+        else if (it->mIndex >= count)
+            releaseCell(*it);
+        else if (!changesKnown || std::binary_search(changed.begin(), changed.end(), it->mIndex))
+            bindCell(*it, it->mIndex);
     }
 
     layoutWidgets();
@@ -131,6 +236,13 @@ void ItemView::update()
 void ItemView::resetScrollBars()
 {
     mScrollView->setViewOffset(MyGUI::IntPoint(0, 0));
+    updateVisibleItems();
+}
+
+void ItemView::onFrame(float dt)
+{
+    if (mScrollView->getViewOffset() != mViewOffset)
+        updateVisibleItems();
 }
 
 void ItemView::onSelectedItem(MyGUI::Widget *sender)
@@ -150,6 +262,8 @@ void ItemView::onMouseWheelMoved(MyGUI::Widget *_sender, int _rel)
         mScrollView->setViewOffset(MyGUI::IntPoint(0, 0));
     else
         mScrollView->setViewOffset(MyGUI::IntPoint(static_cast<int>(mScrollView->getViewOffset().left + _rel*0.3f), 0));
+
+    updateVisibleItems();
 }
 
 void ItemView::setSize(const MyGUI::IntSize &_value)
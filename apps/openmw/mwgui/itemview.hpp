@@ -4,10 +4,14 @@
 #include <MyGUI_Widget.h>
 
 #include "itemmodel.hpp"
+#include "itemwidget.hpp"
 
 namespace MWGui
 {
 
+    /// @brief Displays the items of an ItemModel in columns of icons, scrolling horizontally.
+    /// @note Only the items in the visible columns get a widget. Widgets are pooled and rebound to other
+    /// items as the view scrolls or the model changes.
     class ItemView : public MyGUI::Widget
     {
     MYGUI_RTTI_DERIVED(ItemView)
@@ -28,15 +32,40 @@ namespace MWGui
         /// Fired when the background was clicked (useful for drag and drop)
         EventHandle_Void eventBackgroundClicked;
 
+        /// Update the model and refresh the widgets of items that changed.
         void update();
 
         void resetScrollBars();
 
     private:
+        struct Cell
+        {
+            ItemWidget* mWidget;
+
+            /// Index of the displayed item, -1 if the widget is unused
+            ItemModel::ModelIndex mIndex;
+
+            /// What the widget currently displays, to skip redundant widget updates
+            MWWorld::Ptr mBase;
+            ItemWidget::ItemState mState;
+            size_t mCount;
+        };
+
         virtual void initialiseOverride();
+        virtual void shutdownOverride();
 
+        /// Resize the canvas to the item count and lay out the visible items.
         void layoutWidgets();
 
+        /// Bind widgets to the items in the visible columns and release the others.
+        void updateVisibleItems();
+
+        void bindCell (Cell& cell, ItemModel::ModelIndex index);
+        void releaseCell (Cell& cell);
+        Cell& createCell();
+
+        void onFrame(float dt);
+
         virtual void setSize(const MyGUI::IntSize& _value);
         virtual void setCoord(const MyGUI::IntCoord& _value);
 
@@ -46,6 +75,15 @@ namespace MWGui
 
         ItemModel* mModel;
         MyGUI::ScrollView* mScrollView;
+        MyGUI::Widget* mDragArea;
+
+        std::vector<Cell> mCells;
+
+        /// Items per column
+        int mRows;
+
+        /// View offset the visible items were last laid out for
+        MyGUI::IntPoint mViewOffset;
 
     };
 
@@ -183,6 +183,9 @@ namespace MWGui
 
     void MainMenu::update(float dt)
     {
+        if (mSaveGameDialog)
+            mSaveGameDialog->onFrame(dt);
+
         if (mVideo)
         {
             if (!mVideo->update())
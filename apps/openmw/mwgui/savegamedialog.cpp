@@ -7,6 +7,7 @@
 
 #include <osgDB/ReadFile>
 #include <osg/Texture2D>
+#include <OpenThreads/Atomic>
 
 #include <components/myguiplatform/myguitexture.hpp>
 
@@ -16,6 +17,11 @@
 
 #include <components/files/memorystream.hpp>
 
+#include <components/esm/esmreader.hpp>
+#include <components/esm/defs.hpp>
+
+#include <components/sceneutil/workqueue.hpp>
+
 #include "../mwbase/statemanager.hpp"
 #include "../mwbase/environment.hpp"
 #include "../mwbase/world.hpp"
@@ -29,6 +35,102 @@
 
 namespace MWGui
 {
+    struct ScreenshotRequest : public osg::Referenced
+    {
+        ScreenshotRequest()
+        {
+            setThreadSafeRefUnref(true);
+        }
+
+        void cancel()
+        {
+            mCancelled.exchange(1);
+        }
+
+        bool isCancelled() const
+        {
+            return mCancelled > 0;
+        }
+
+        boost::filesystem::path mPath;
+
+        /// Encoded screenshot. If empty, it is read from the saved game file.
+        std::vector<char> mData;
+
+        /// Set by the ScreenshotLoader on success
+        osg::ref_ptr<osg::Image> mImage;
+
+    private:
+        OpenThreads::Atomic mCancelled;
+    };
+
+    class ScreenshotLoader : public SceneUtil::WorkItem
+    {
+    public:
+        ScreenshotLoader(ScreenshotRequest* request)
+            : mRequest(request)
+        {
+        }
+
+        virtual void doWork()
+        {
+            // Skip requests that were superseded before we got to them
+            if (!mRequest->isCancelled())
+            {
+                try
+                {
+                    load();
+                }
+                catch (const std::exception& e)
+                {
+                    std::cerr << "Failed to read savegame screenshot: " << e.what() << std::endl;
+                }
+            }
+
+            mTicket->signalDone();
+        }
+
+    private:
+        void load()
+        {
+            if (mRequest->mData.empty())
+            {
+                ESM::ESMReader reader;
+                reader.open(mRequest->mPath.string());
+                if (reader.getRecName() != ESM::REC_SAVE)
+                    return;
+                reader.getRecHeader();
+
+                ESM::SavedGame profile;
+                profile.load(reader);
+                mRequest->mData.swap(profile.mScreenshot);
+            }
+
+            if (mRequest->mData.empty())
+                return;
+
+            Files::IMemStream instream (&mRequest->mData[0], mRequest->mData.size());
+
+            osgDB::ReaderWriter* readerwriter = osgDB::Registry::instance()->getReaderWriterForExtension("jpg");
+            if (!readerwriter)
+            {
+                std::cerr << "Can't open savegame screenshot, no jpg readerwriter found" << std::endl;
+                return;
+            }
+
+            osgDB::ReaderWriter::ReadResult result = readerwriter->readImage(instream);
+            if (!result.success())
+            {
+                std::cerr << "Failed to read savegame screenshot: " << result.message() << std::endl;
+                return;
+            }
+
+            mRequest->mImage = result.getImage();
+        }
+
+        osg::ref_ptr<ScreenshotRequest> mRequest;
+    };
+
     SaveGameDialog::SaveGameDialog()
         : WindowModal("openmw_savegame_dialog.layout")
         , mSaving(true)
@@ -56,6 +158,10 @@ namespace MWGui
         mSaveNameEdit->eventEditTextChange += MyGUI::newDelegate(this, &SaveGameDialog::onSaveNameChanged);
     }
 
+    SaveGameDialog::~SaveGameDialog()
+    {
+    }
+
     void SaveGameDialog::onSlotActivated(MyGUI::ListBox *sender, size_t pos)
     {
         onSlotSelected(sender, pos);
@@ -140,26 +246,28 @@ namespace MWGui
         {
             if (it->begin()!=it->end())
             {
+                const ESM::SavedGame signature = it->getSignature();
+
                 std::stringstream title;
-                title << it->getSignature().mPlayerName;
+                title << signature.mPlayerName;
 
                 // For a custom class, we will not find it in the store (unless we loaded the savegame first).
                 // Fall back to name stored in savegame header in that case.
                 std::string className;
-                if (it->getSignature().mPlayerClassId.empty())
-                    className = it->getSignature().mPlayerClassName;
+                if (signature.mPlayerClassId.empty())
+                    className = signature.mPlayerClassName;
                 else
                 {
                     // Find the localised name for this class from the store
                     const ESM::Class* class_ = MWBase::Environment::get().getWorld()->getStore().get<ESM::Class>().search(
-                                it->getSignature().mPlayerClassId);
+                                signature.mPlayerClassId);
                     if (class_)
                         className = class_->mName;
                     else
                         className = "?"; // From an older savegame format that did not support custom classes properly.
                 }
 
-                title << " (Level " << it->getSignature().mPlayerLevel << " " << className << ")";
+                title << " (Level " << signature.mPlayerLevel << " " << className << ")";
 
                 mCharacterSelection->addItem (title.str());
 
@@ -319,6 +427,7 @@ namespace MWGui
             mCurrentSlot = NULL;
             mInfoText->setCaption("");
             mScreenshot->setImageTexture("");
+            cancelScreenshot();
             return;
         }
 
@@ -364,26 +473,52 @@ namespace MWGui
         mInfoText->setCaptionWithReplacing(text.str());
 
 
-        // Decode screenshot
-        const std::vector<char>& data = mCurrentSlot->mProfile.mScreenshot;
-        Files::IMemStream instream (&data[0], data.size());
+        requestScreenshot(mCurrentSlot);
+    }
 
-        osgDB::ReaderWriter* readerwriter = osgDB::Registry::instance()->getReaderWriterForExtension("jpg");
-        if (!readerwriter)
-        {
-            std::cerr << "Can't open savegame screenshot, no jpg readerwriter found" << std::endl;
+    void SaveGameDialog::requestScreenshot(const MWState::Slot *slot)
+    {
+        // Keep showing the previous screenshot until the new one is ready, to avoid flickering
+        // while scrolling through the list
+
+        if (!mScreenshotQueue.get())
+            mScreenshotQueue.reset(new SceneUtil::WorkQueue(1));
+
+        cancelScreenshot();
+
+        mScreenshotRequest = new ScreenshotRequest;
+        mScreenshotRequest->mPath = slot->mPath;
+        mScreenshotRequest->mData = slot->mProfile.mScreenshot;
+
+        mScreenshotTicket = mScreenshotQueue->addWorkItem(new ScreenshotLoader(mScreenshotRequest.get()));
+    }
+
+    void SaveGameDialog::cancelScreenshot()
+    {
+        if (mScreenshotRequest)
+            mScreenshotRequest->cancel();
+
+        mScreenshotRequest = NULL;
+        mScreenshotTicket = NULL;
+    }
+
+    void SaveGameDialog::onFrame(float dt)
+    {
+        if (!mScreenshotTicket || !mScreenshotTicket->isDone())
             return;
-        }
 
-        osgDB::ReaderWriter::ReadResult result = readerwriter->readImage(instream);
-        if (!result.success())
+        osg::ref_ptr<osg::Image> image = mScreenshotRequest->mImage;
+        mScreenshotRequest = NULL;
+        mScreenshotTicket = NULL;
+
+        if (!image)
         {
-            std::cerr << "Failed to read savegame screenshot: " << result.message() << std::endl;
+            mScreenshot->setImageTexture("");
             return;
         }
 
         osg::ref_ptr<osg::Texture2D> texture (new osg::Texture2D);
-        texture->setImage(result.getImage());
+        texture->setImage(image.get());
         texture->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP_TO_EDGE);
         texture->setWrap(osg::Texture::WRAP_T, osg::Texture::CLAMP_TO_EDGE);
         texture->setFilter(osg::Texture::MIN_FILTER, osg::Texture::LINEAR);
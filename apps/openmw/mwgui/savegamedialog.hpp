@@ -1,6 +1,10 @@
 #ifndef OPENMW_MWGUI_SAVEGAMEDIALOG_H
 #define OPENMW_MWGUI_SAVEGAMEDIALOG_H
 
+#include <memory>
+
+#include <osg/ref_ptr>
+
 #include "windowbase.hpp"
 
 namespace MWState
@@ -9,13 +13,21 @@ namespace MWState
     struct Slot;
 }
 
+namespace SceneUtil
+{
+    class WorkQueue;
+    class WorkTicket;
+}
+
 namespace MWGui
 {
+    struct ScreenshotRequest;
 
     class SaveGameDialog : public MWGui::WindowModal
     {
     public:
         SaveGameDialog();
+        ~SaveGameDialog();
 
         virtual void open();
 
@@ -23,6 +35,8 @@ namespace MWGui
 
         void setLoadOrSave(bool load);
 
+        void onFrame(float dt);
+
     private:
         void confirmDeleteSave();
 
@@ -48,6 +62,16 @@ namespace MWGui
 
         void fillSaveList();
 
+        /// Decode the screenshot of \a slot in the background, reading it from the file if necessary.
+        void requestScreenshot(const MWState::Slot* slot);
+
+        /// Drop the pending screenshot request, if any, so it is skipped if it has not been started yet.
+        void cancelScreenshot();
+
+        std::auto_ptr<SceneUtil::WorkQueue> mScreenshotQueue;
+        osg::ref_ptr<ScreenshotRequest> mScreenshotRequest;
+        osg::ref_ptr<SceneUtil::WorkTicket> mScreenshotTicket;
+
         std::auto_ptr<MyGUI::ITexture> mScreenshotTexture;
         MyGUI::ImageBox* mScreenshot;
         bool mSaving;
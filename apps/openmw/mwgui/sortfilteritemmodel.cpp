@@ -1,5 +1,9 @@
 #include "sortfilteritemmodel.hpp"
 
+#include <algorithm>
+#include <cassert>
+#include <map>
+
 #include <components/misc/stringops.hpp>
 
 #include <components/esm/loadalch.hpp>
@@ -20,47 +24,53 @@
 
 namespace
 {
-    bool compareType(const std::string& type1, const std::string& type2)
+    /// Sorting order of types, types with a lower rank appear before other types.
+    int getTypeRank(const std::string& type)
     {
-        // this defines the sorting order of types. types that are first in the vector appear before other types.
-        std::vector<std::string> mapping;
-        mapping.push_back( typeid(ESM::Weapon).name() );
-        mapping.push_back( typeid(ESM::Armor).name() );
-        mapping.push_back( typeid(ESM::Clothing).name() );
-        mapping.push_back( typeid(ESM::Potion).name() );
-        mapping.push_back( typeid(ESM::Ingredient).name() );
-        mapping.push_back( typeid(ESM::Apparatus).name() );
-        mapping.push_back( typeid(ESM::Book).name() );
-        mapping.push_back( typeid(ESM::Light).name() );
-        mapping.push_back( typeid(ESM::Miscellaneous).name() );
-        mapping.push_back( typeid(ESM::Lockpick).name() );
-        mapping.push_back( typeid(ESM::Repair).name() );
-        mapping.push_back( typeid(ESM::Probe).name() );
-
-        assert( std::find(mapping.begin(), mapping.end(), type1) != mapping.end() );
-        assert( std::find(mapping.begin(), mapping.end(), type2) != mapping.end() );
-
-        return std::find(mapping.begin(), mapping.end(), type1) < std::find(mapping.begin(), mapping.end(), type2);
+        static std::vector<std::string> mapping;
+        if (mapping.empty())
+        {
+            mapping.push_back( typeid(ESM::Weapon).name() );
+            mapping.push_back( typeid(ESM::Armor).name() );
+            mapping.push_back( typeid(ESM::Clothing).name() );
+            mapping.push_back( typeid(ESM::Potion).name() );
+            mapping.push_back( typeid(ESM::Ingredient).name() );
+            mapping.push_back( typeid(ESM::Apparatus).name() );
+            mapping.push_back( typeid(ESM::Book).name() );
+            mapping.push_back( typeid(ESM::Light).name() );
+            mapping.push_back( typeid(ESM::Miscellaneous).name() );
+            mapping.push_back( typeid(ESM::Lockpick).name() );
+            mapping.push_back( typeid(ESM::Repair).name() );
+            mapping.push_back( typeid(ESM::Probe).name() );
+        }
+
+        std::vector<std::string>::const_iterator found = std::find(mapping.begin(), mapping.end(), type);
+        assert (found != mapping.end());
+        return static_cast<int>(found - mapping.begin());
     }
 
+    /// Everything the sorting order depends on, evaluated once per item rather than once per comparison
+    struct SortKey
+    {
+        int mType;
+        int mTypeRank;
+        std::string mName;
+        size_t mIndex;
+    };
+
     struct Compare
     {
         bool mSortByType;
         Compare() : mSortByType(true) {}
-        bool operator() (const MWGui::ItemStack& left, const MWGui::ItemStack& right)
+        bool operator() (const SortKey& left, const SortKey& right) const
         {
             if (mSortByType && left.mType != right.mType)
                 return left.mType < right.mType;
 
-            if (left.mBase.getTypeName() == right.mBase.getTypeName())
-            {
-                std::string leftName = Misc::StringUtils::lowerCase(left.mBase.getClass().getName(left.mBase));
-                std::string rightName = Misc::StringUtils::lowerCase(right.mBase.getClass().getName(right.mBase));
+            if (left.mTypeRank != right.mTypeRank)
+                return left.mTypeRank < right.mTypeRank;
 
-                return leftName.compare(rightName) < 0;
-            }
-            else
-                return compareType(left.mBase.getTypeName(), right.mBase.getTypeName());
+            return left.mName.compare(right.mName) < 0;
         }
     };
 }
@@ -167,34 +177,81 @@ namespace MWGui
         mFilter = filter;
     }
 
+    bool SortFilterItemModel::getChangedItems (std::vector<ModelIndex>& changed)
+    {
+        changed.insert(changed.end(), mChangedItems.begin(), mChangedItems.end());
+        return true;
+    }
+
     void SortFilterItemModel::update()
     {
         mSourceModel->update();
 
         size_t count = mSourceModel->getItemCount();
 
-        mItems.clear();
+        std::vector<ItemStack> previousItems;
+        previousItems.swap(mItems);
+
+        // Sum up dragged counts once, rather than searching the dragged items for every item in the model
+        typedef std::map<MWWorld::Ptr, size_t> DragCounts;
+        DragCounts dragCounts;
+        for (std::vector<std::pair<MWWorld::Ptr, size_t> >::const_iterator it = mDragItems.begin(); it != mDragItems.end(); ++it)
+            dragCounts[it->first] += it->second;
+
+        std::vector<ItemStack> items;
+        items.reserve(count);
         for (size_t i=0; i<count; ++i)
         {
-            ItemStack item = mSourceModel->getItem(i);
+            items.push_back(mSourceModel->getItem(i));
+            ItemStack& item = items.back();
 
-            for (std::vector<std::pair<MWWorld::Ptr, size_t> >::iterator it = mDragItems.begin(); it != mDragItems.end(); ++it)
+            if (!dragCounts.empty())
             {
-                if (item.mBase == it->first)
+                DragCounts::const_iterator found = dragCounts.find(item.mBase);
+                if (found != dragCounts.end())
                 {
-                    if (item.mCount < it->second)
+                    if (item.mCount < found->second)
                         throw std::runtime_error("Dragging more than present in the model");
-                    item.mCount -= it->second;
+                    item.mCount -= found->second;
                 }
             }
 
-            if (item.mCount > 0 && filterAccepts(item))
-                mItems.push_back(item);
+            if (item.mCount == 0 || !filterAccepts(item))
+                items.pop_back();
+        }
+
+        std::vector<SortKey> keys (items.size());
+        for (size_t i=0; i<items.size(); ++i)
+        {
+            const MWWorld::Ptr& base = items[i].mBase;
+            keys[i].mType = items[i].mType;
+            keys[i].mTypeRank = getTypeRank(base.getTypeName());
+            keys[i].mName = Misc::StringUtils::lowerCase(base.getClass().getName(base));
+            keys[i].mIndex = i;
         }
 
         Compare cmp;
         cmp.mSortByType = mSortByType;
-        std::sort(mItems.begin(), mItems.end(), cmp);
+        std::sort(keys.begin(), keys.end(), cmp);
+
+        mItems.reserve(items.size());
+        for (std::vector<SortKey>::const_iterator it = keys.begin(); it != keys.end(); ++it)
+            mItems.push_back(items[it->mIndex]);
+
+        mChangedItems.clear();
+        for (size_t i=0; i<mItems.size(); ++i)
+        {
+            if (i >= previousItems.size())
+                mChangedItems.push_back(static_cast<ModelIndex>(i));
+            else
+            {
+                const ItemStack& item = mItems[i];
+                const ItemStack& previous = previousItems[i];
+                if (item.mBase != previous.mBase || item.mCount != previous.mCount
+                        || item.mType != previous.mType || item.mFlags != previous.mFlags)
+                    mChangedItems.push_back(static_cast<ModelIndex>(i));
+            }
+        }
     }
 
 }
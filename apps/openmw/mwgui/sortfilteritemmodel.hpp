@@ -13,6 +13,9 @@ namespace MWGui
 
         virtual void update();
 
+        /// @note Changes are relative to the previous update() of this model, so it should only be updated by the view displaying it.
+        virtual bool getChangedItems (std::vector<ModelIndex>& changed);
+
         bool filterAccepts (const ItemStack& item);
 
         virtual ItemStack getItem (ModelIndex index);
@@ -45,6 +48,8 @@ namespace MWGui
     private:
         std::vector<ItemStack> mItems;
 
+        std::vector<ModelIndex> mChangedItems;
+
         std::vector<std::pair<MWWorld::Ptr, size_t> > mDragItems;
 
         int mCategory;
@@ -189,6 +189,7 @@ namespace MWGui
                     std::pair<ItemModel::ModelIndex, ItemModel*> pair = *focus->getUserData<std::pair<ItemModel::ModelIndex, ItemModel*> >();
                     mFocusObject = pair.second->getItem(pair.first).mBase;
                     // HACK: To get the correct count for multiple item stack sources
+                    // The tooltip does not query the container, so its cached totals stay valid.
                     int oldCount = mFocusObject.getRefData().getCount();
                     mFocusObject.getRefData().setCount(pair.second->getItem(pair.first).mCount);
                     tooltipSize = getToolTipViaPtr(false);
@@ -1,5 +1,7 @@
 #include "activespells.hpp"
 
+#include <limits>
+
 #include <components/misc/rng.hpp>
 
 #include <components/misc/stringops.hpp>
@@ -18,10 +20,16 @@ namespace MWMechanics
         bool rebuild = false;
 
         MWWorld::TimeStamp now = MWBase::Environment::get().getWorld()->getTimeStamp();
+        float timeScale = MWBase::Environment::get().getWorld()->getTimeScaleFactor();
+
+        if (mSpellsChanged)
+            mExpiryUpToDate = false;
 
         // Erase no longer active spells and effects
-        if (mLastUpdate!=now)
+        if (mLastUpdate!=now && (!mExpiryUpToDate || timeScale!=mExpiryTimeScale || mNextExpiry<=now))
         {
+            bool haveExpiry = false;
+
             TContainer::iterator iter (mSpells.begin());
             while (iter!=mSpells.end())
             {
@@ -36,22 +44,42 @@ namespace MWMechanics
                     for (std::vector<ActiveEffect>::iterator effectIt = effects.begin(); effectIt != effects.end();)
                     {
                         MWWorld::TimeStamp start = iter->second.mTimeStamp;
-                        MWWorld::TimeStamp end = start + static_cast<double>(effectIt->mDuration)*MWBase::Environment::get().getWorld()->getTimeScaleFactor()/(60*60);
+                        MWWorld::TimeStamp end = start + static_cast<double>(effectIt->mDuration)*timeScale/(60*60);
                         if (end <= now)
                         {
                             effectIt = effects.erase(effectIt);
                             rebuild = true;
                         }
                         else
+                        {
+                            if (!haveExpiry || end < mNextExpiry)
+                                mNextExpiry = end;
+                            haveExpiry = true;
                             ++effectIt;
+                        }
                     }
+
+                    // a spell without effects left expires with the next update
+                    if (effects.empty())
+                    {
+                        mNextExpiry = now;
+                        haveExpiry = true;
+                    }
+
                     ++iter;
                 }
             }
 
-            mLastUpdate = now;
+            // nothing to expire until the spell list changes
+            if (!haveExpiry)
+                mNextExpiry = MWWorld::TimeStamp(0, std::numeric_limits<int>::max());
+
+            mExpiryTimeScale = timeScale;
+            mExpiryUpToDate = true;
         }
 
+        mLastUpdate = now;
+
         if (mSpellsChanged)
         {
             mSpellsChanged = false;
@@ -90,6 +118,8 @@ namespace MWMechanics
     ActiveSpells::ActiveSpells()
         : mSpellsChanged (false)
         , mLastUpdate (MWBase::Environment::get().getWorld()->getTimeStamp())
+        , mExpiryTimeScale (0)
+        , mExpiryUpToDate (false)
     {}
 
     const MagicEffects& ActiveSpells::getMagicEffects() const
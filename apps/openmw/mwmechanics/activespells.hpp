@@ -51,6 +51,12 @@ namespace MWMechanics
             mutable bool mSpellsChanged;
             mutable MWWorld::TimeStamp mLastUpdate;
 
+            // Earliest time at which an effect expires, so that the effect list only needs to be
+            // checked once something actually expires
+            mutable MWWorld::TimeStamp mNextExpiry;
+            mutable float mExpiryTimeScale;
+            mutable bool mExpiryUpToDate;
+
             void update() const;
             
             void rebuildEffects() const;
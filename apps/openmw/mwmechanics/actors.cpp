@@ -8,6 +8,8 @@
 #include <components/esm/esmwriter.hpp>
 #include <components/esm/loadnpc.hpp>
 
+#include <components/misc/profiler.hpp>
+
 #include "../mwworld/esmstore.hpp"
 #include "../mwworld/class.hpp"
 #include "../mwworld/inventorystore.hpp"
@@ -123,7 +125,7 @@ void adjustCommandedActor (const MWWorld::Ptr& actor)
 void getRestorationPerHourOfSleep (const MWWorld::Ptr& ptr, float& health, float& magicka)
 {
     MWMechanics::CreatureStats& stats = ptr.getClass().getCreatureStats (ptr);
-    const MWWorld::Store<ESM::GameSetting>& settings = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>();
+    const MWWorld::GameSettings& settings = MWBase::Environment::get().getWorld()->getStore().getGameSettings();
 
     bool stunted = stats.getMagicEffects ().get(ESM::MagicEffect::StuntedMagicka).getMagnitude() > 0;
     int endurance = stats.getAttribute (ESM::Attribute::Endurance).getModified ();
@@ -133,7 +135,7 @@ void getRestorationPerHourOfSleep (const MWWorld::Ptr& ptr, float& health, float
     magicka = 0;
     if (!stunted)
     {
-        float fRestMagicMult = settings.find("fRestMagicMult")->getFloat ();
+        float fRestMagicMult = settings.get(MWWorld::GameSettings::fRestMagicMult);
         magicka = fRestMagicMult * stats.getAttribute(ESM::Attribute::Intelligence).getModified();
     }
 }
@@ -166,7 +168,7 @@ namespace MWMechanics
             if (caster.isEmpty() || !caster.getClass().isActor())
                 return;
 
-            static const float fSoulgemMult = world->getStore().get<ESM::GameSetting>().find("fSoulgemMult")->getFloat();
+            const float fSoulgemMult = world->getStore().getGameSettings().get(MWWorld::GameSettings::fSoulgemMult);
 
             int creatureSoulValue = mCreature.get<ESM::Creature>()->mBase->mData.mSoul;
             if (creatureSoulValue == 0)
@@ -230,10 +232,8 @@ namespace MWMechanics
     void Actors::updateHeadTracking(const MWWorld::Ptr& actor, const MWWorld::Ptr& targetActor,
                                     MWWorld::Ptr& headTrackTarget, float& sqrHeadTrackDistance)
     {
-        static const float fMaxHeadTrackDistance = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>()
-                .find("fMaxHeadTrackDistance")->getFloat();
-        static const float fInteriorHeadTrackMult = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>()
-                .find("fInteriorHeadTrackMult")->getFloat();
+        const float fMaxHeadTrackDistance = MWBase::Environment::get().getWorld()->getStore().getGameSettings().get(MWWorld::GameSettings::fMaxHeadTrackDistance);
+        const float fInteriorHeadTrackMult = MWBase::Environment::get().getWorld()->getStore().getGameSettings().get(MWWorld::GameSettings::fInteriorHeadTrackMult);
         float maxDistance = fMaxHeadTrackDistance;
         const ESM::Cell* currentCell = actor.getCell()->getCell();
         if (!currentCell->isExterior() && !(currentCell->mData.mFlags & ESM::Cell::QuasiEx))
@@ -396,9 +396,9 @@ namespace MWMechanics
 
         float base = 1.f;
         if (ptr == MWBase::Environment::get().getWorld()->getPlayerPtr())
-            base = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>().find("fPCbaseMagickaMult")->getFloat();
+            base = MWBase::Environment::get().getWorld()->getStore().getGameSettings().get(MWWorld::GameSettings::fPCbaseMagickaMult);
         else
-            base = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>().find("fNPCbaseMagickaMult")->getFloat();
+            base = MWBase::Environment::get().getWorld()->getStore().getGameSettings().get(MWWorld::GameSettings::fNPCbaseMagickaMult);
 
         double magickaFactor = base +
             creatureStats.getMagicEffects().get (EffectKey (ESM::MagicEffect::FortifyMaximumMagicka)).getMagnitude() * 0.1;
@@ -415,7 +415,7 @@ namespace MWMechanics
             return;
 
         MWMechanics::CreatureStats& stats = ptr.getClass().getCreatureStats (ptr);
-        const MWWorld::Store<ESM::GameSetting>& settings = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>();
+        const MWWorld::GameSettings& settings = MWBase::Environment::get().getWorld()->getStore().getGameSettings();
 
         if (sleep)
         {
@@ -438,9 +438,9 @@ namespace MWMechanics
             normalizedEncumbrance = 1;
 
         // restore fatigue
-        float fFatigueReturnBase = settings.find("fFatigueReturnBase")->getFloat ();
-        float fFatigueReturnMult = settings.find("fFatigueReturnMult")->getFloat ();
-        float fEndFatigueMult = settings.find("fEndFatigueMult")->getFloat ();
+        float fFatigueReturnBase = settings.get(MWWorld::GameSettings::fFatigueReturnBase);
+        float fFatigueReturnMult = settings.get(MWWorld::GameSettings::fFatigueReturnMult);
+        float fEndFatigueMult = settings.get(MWWorld::GameSettings::fEndFatigueMult);
 
         float x = fFatigueReturnBase + fFatigueReturnMult * (1 - normalizedEncumbrance);
         x *= fEndFatigueMult * endurance;
@@ -460,9 +460,9 @@ namespace MWMechanics
         int endurance = stats.getAttribute (ESM::Attribute::Endurance).getModified ();
 
         // restore fatigue
-        const MWWorld::Store<ESM::GameSetting>& settings = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>();
-        static const float fFatigueReturnBase = settings.find("fFatigueReturnBase")->getFloat ();
-        static const float fFatigueReturnMult = settings.find("fFatigueReturnMult")->getFloat ();
+        const MWWorld::GameSettings& settings = MWBase::Environment::get().getWorld()->getStore().getGameSettings();
+        const float fFatigueReturnBase = settings.get(MWWorld::GameSettings::fFatigueReturnBase);
+        const float fFatigueReturnMult = settings.get(MWWorld::GameSettings::fFatigueReturnMult);
 
         float x = fFatigueReturnBase + fFatigueReturnMult * endurance;
 
@@ -480,7 +480,7 @@ namespace MWMechanics
 
         // tickable effects (i.e. effects having a lasting impact after expiry)
         // these effects can be applied as "instant" (handled in spellcasting.cpp) or with a duration, handled here
-        for (MagicEffects::Collection::const_iterator it = effects.begin(); it != effects.end(); ++it)
+        for (MagicEffects::const_iterator it = effects.begin(); it != effects.end(); ++it)
         {
             effectTick(creatureStats, ptr, it->first, it->second.getMagnitude() * duration);
         }
@@ -698,7 +698,7 @@ namespace MWMechanics
             if(timeLeft == 0.0f)
             {
                 // If drowning, apply 3 points of damage per second
-                static const float fSuffocationDamage = world->getStore().get<ESM::GameSetting>().find("fSuffocationDamage")->getFloat();
+                const float fSuffocationDamage = world->getStore().getGameSettings().get(MWWorld::GameSettings::fSuffocationDamage);
                 DynamicStat<float> health = stats.getHealth();
                 health.setCurrent(health.getCurrent() - fSuffocationDamage*duration);
                 stats.setHealth(health);
@@ -714,7 +714,7 @@ namespace MWMechanics
         }
         else
         {
-            static const float fHoldBreathTime = world->getStore().get<ESM::GameSetting>().find("fHoldBreathTime")->getFloat();
+            const float fHoldBreathTime = world->getStore().getGameSettings().get(MWWorld::GameSettings::fHoldBreathTime);
             stats.setTimeToStartDrowning(fHoldBreathTime);
         }
     }
@@ -731,15 +731,7 @@ namespace MWMechanics
          */
         if (!isPlayer)
         {
-            MWWorld::ContainerStoreIterator torch = inventoryStore.end();
-            for (MWWorld::ContainerStoreIterator it = inventoryStore.begin(); it != inventoryStore.end(); ++it)
-            {
-                if (it->getTypeName() == typeid(ESM::Light).name())
-                {
-                    torch = it;
-                    break;
-                }
-            }
+            MWWorld::ContainerStoreIterator torch = inventoryStore.begin(MWWorld::ContainerStore::Type_Light);
 
             if (MWBase::Environment::get().getWorld()->isDark())
             {
@@ -831,7 +823,7 @@ namespace MWMechanics
             if (ptr.getClass().isClass(ptr, "Guard") && creatureStats.getAiSequence().getTypeId() != AiPackage::TypeIdPursue && !creatureStats.getAiSequence().isInCombat())
             {
                 const MWWorld::ESMStore& esmStore = MWBase::Environment::get().getWorld()->getStore();
-                int cutoff = esmStore.get<ESM::GameSetting>().find("iCrimeThreshold")->getInt();
+                int cutoff = esmStore.getGameSettings().get(MWWorld::GameSettings::iCrimeThreshold);
                 // Force dialogue on sight if bounty is greater than the cutoff
                 // In vanilla morrowind, the greeting dialogue is scripted to either arrest the player (< 5000 bounty) or attack (>= 5000 bounty)
                 if (   player.getClass().getNpcStats(player).getBounty() >= cutoff
@@ -839,7 +831,7 @@ namespace MWMechanics
                     && MWBase::Environment::get().getWorld()->getLOS(ptr, player)
                     && MWBase::Environment::get().getMechanicsManager()->awarenessCheck(player, ptr))
                 {
-                    static int iCrimeThresholdMultiplier = esmStore.get<ESM::GameSetting>().find("iCrimeThresholdMultiplier")->getInt();
+                    int iCrimeThresholdMultiplier = esmStore.getGameSettings().get(MWWorld::GameSettings::iCrimeThresholdMultiplier);
                     if (player.getClass().getNpcStats(player).getBounty() >= cutoff * iCrimeThresholdMultiplier)
                         MWBase::Environment::get().getMechanicsManager()->startCombat(ptr, player);
                     else
@@ -931,6 +923,7 @@ namespace MWMechanics
 
     void Actors::update (float duration, bool paused)
     {
+        Misc::ProfileZone zone("Actors::update");
         if(!paused)
         {
             static float timerUpdateAITargets = 0;
@@ -1093,9 +1086,9 @@ namespace MWMechanics
                 static float sneakSkillTimer = 0.f; // times sneak skill progress from "avoid notice"
 
                 const MWWorld::ESMStore& esmStore = MWBase::Environment::get().getWorld()->getStore();
-                const int radius = esmStore.get<ESM::GameSetting>().find("fSneakUseDist")->getInt();
+                const int radius = static_cast<int>(esmStore.getGameSettings().get(MWWorld::GameSettings::fSneakUseDist));
 
-                static float fSneakUseDelay = esmStore.get<ESM::GameSetting>().find("fSneakUseDelay")->getFloat();
+                float fSneakUseDelay = esmStore.getGameSettings().get(MWWorld::GameSettings::fSneakUseDelay);
 
                 if (sneakTimer >= fSneakUseDelay)
                     sneakTimer = 0.f;
@@ -1336,7 +1329,7 @@ namespace MWMechanics
         std::vector<MWWorld::Ptr> neighbors;
         osg::Vec3f position (actor.getRefData().getPosition().asVec3());
         getObjectsInRange(position,
-            MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>().find("fAlarmRadius")->getFloat(),
+            MWBase::Environment::get().getWorld()->getStore().getGameSettings().get(MWWorld::GameSettings::fAlarmRadius),
             neighbors); //only care about those within the alarm disance
         for(std::vector<MWWorld::Ptr>::iterator iter(neighbors.begin());iter != neighbors.end();++iter)
         {
@@ -285,7 +285,7 @@ namespace MWMechanics
             if (weaptype == WeapType_HandToHand)
             {
                 static float fHandToHandReach =
-                    world->getStore().get<ESM::GameSetting>().find("fHandToHandReach")->getFloat();
+                    world->getStore().getGameSettings().get(MWWorld::GameSettings::fHandToHandReach);
                 weapRange = fHandToHandReach;
             }
             else if (weaptype != WeapType_PickProbe && weaptype != WeapType_Spell && weaptype != WeapType_None)
@@ -345,15 +345,15 @@ namespace MWMechanics
                 //say a provoking combat phrase
                 if (actor.getClass().isNpc())
                 {
-                    int chance = store.get<ESM::GameSetting>().find("iVoiceAttackOdds")->getInt();
+                    int chance = store.getGameSettings().get(MWWorld::GameSettings::iVoiceAttackOdds);
                     if (Misc::Rng::roll0to99() < chance)
                     {
                         MWBase::Environment::get().getDialogueManager()->say(actor, "attack");
                     }
                 }
-                float baseDelay = store.get<ESM::GameSetting>().find("fCombatDelayCreature")->getFloat();
+                float baseDelay = store.getGameSettings().get(MWWorld::GameSettings::fCombatDelayCreature);
                 if (actor.getClass().isNpc())
-                    baseDelay = store.get<ESM::GameSetting>().find("fCombatDelayNPC")->getFloat();
+                    baseDelay = store.getGameSettings().get(MWWorld::GameSettings::fCombatDelayNPC);
                 storage.mAttackCooldown = std::min(baseDelay + 0.01 * Misc::Rng::roll0to99(), baseDelay + 0.9);
             }
             else
@@ -721,20 +721,20 @@ osg::Vec3f AimDirToMovingTarget(const MWWorld::Ptr& actor, const MWWorld::Ptr& t
     // get projectile speed (depending on weapon type)
     if (weapType == ESM::Weapon::MarksmanThrown)
     {
-        static float fThrownWeaponMinSpeed = 
-            MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>().find("fThrownWeaponMinSpeed")->getFloat();
-        static float fThrownWeaponMaxSpeed = 
-            MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>().find("fThrownWeaponMaxSpeed")->getFloat();
+        float fThrownWeaponMinSpeed = 
+            MWBase::Environment::get().getWorld()->getStore().getGameSettings().get(MWWorld::GameSettings::fThrownWeaponMinSpeed);
+        float fThrownWeaponMaxSpeed = 
+            MWBase::Environment::get().getWorld()->getStore().getGameSettings().get(MWWorld::GameSettings::fThrownWeaponMaxSpeed);
 
         projSpeed = 
             fThrownWeaponMinSpeed + (fThrownWeaponMaxSpeed - fThrownWeaponMinSpeed) * strength;
     }
     else
     {
-        static float fProjectileMinSpeed = 
-            MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>().find("fProjectileMinSpeed")->getFloat();
-        static float fProjectileMaxSpeed = 
-            MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>().find("fProjectileMaxSpeed")->getFloat();
+        float fProjectileMinSpeed = 
+            MWBase::Environment::get().getWorld()->getStore().getGameSettings().get(MWWorld::GameSettings::fProjectileMinSpeed);
+        float fProjectileMaxSpeed = 
+            MWBase::Environment::get().getWorld()->getStore().getGameSettings().get(MWWorld::GameSettings::fProjectileMaxSpeed);
 
         projSpeed = 
             fProjectileMinSpeed + (fProjectileMaxSpeed - fProjectileMinSpeed) * strength;
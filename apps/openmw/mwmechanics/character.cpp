@@ -29,9 +29,12 @@
 #include "security.hpp"
 
 #include <components/misc/rng.hpp>
+#include <components/misc/profiler.hpp>
 
 #include <components/settings/settings.hpp>
 
+#include <components/nifosg/textkeys.hpp>
+
 #include "../mwrender/animation.hpp"
 
 #include "../mwbase/environment.hpp"
@@ -117,18 +120,18 @@ MWMechanics::CharacterState runStateToWalkState (MWMechanics::CharacterState sta
 float getFallDamage(const MWWorld::Ptr& ptr, float fallHeight)
 {
     MWBase::World *world = MWBase::Environment::get().getWorld();
-    const MWWorld::Store<ESM::GameSetting> &store = world->getStore().get<ESM::GameSetting>();
+    const MWWorld::GameSettings &gmst = world->getStore().getGameSettings();
 
-    const float fallDistanceMin = store.find("fFallDamageDistanceMin")->getFloat();
+    const float fallDistanceMin = gmst.get(MWWorld::GameSettings::fFallDamageDistanceMin);
 
     if (fallHeight >= fallDistanceMin)
     {
         const float acrobaticsSkill = static_cast<float>(ptr.getClass().getSkill(ptr, ESM::Skill::Acrobatics));
         const float jumpSpellBonus = ptr.getClass().getCreatureStats(ptr).getMagicEffects().get(ESM::MagicEffect::Jump).getMagnitude();
-        const float fallAcroBase = store.find("fFallAcroBase")->getFloat();
-        const float fallAcroMult = store.find("fFallAcroMult")->getFloat();
-        const float fallDistanceBase = store.find("fFallDistanceBase")->getFloat();
-        const float fallDistanceMult = store.find("fFallDistanceMult")->getFloat();
+        const float fallAcroBase = gmst.get(MWWorld::GameSettings::fFallAcroBase);
+        const float fallAcroMult = gmst.get(MWWorld::GameSettings::fFallAcroMult);
+        const float fallDistanceBase = gmst.get(MWWorld::GameSettings::fFallDistanceBase);
+        const float fallDistanceMult = gmst.get(MWWorld::GameSettings::fFallDistanceMult);
 
         float x = fallHeight - fallDistanceMin;
         x -= (1.5f * acrobaticsSkill) + jumpSpellBonus;
@@ -715,82 +718,47 @@ CharacterController::~CharacterController()
         mAnimation->setTextKeyListener(NULL);
 }
 
-void split(const std::string &s, char delim, std::vector<std::string> &elems) {
-    std::stringstream ss(s);
-    std::string item;
-    while (std::getline(ss, item, delim)) {
-        elems.push_back(item);
-    }
-}
-
-void CharacterController::handleTextKey(const std::string &groupname, const std::multimap<float, std::string>::const_iterator &key, const std::multimap<float, std::string> &map)
+void CharacterController::handleTextKey(const std::string &groupname, const NifOsg::TextKeyEvents &keys, size_t key)
 {
-    const std::string &evt = key->second;
+    const NifOsg::TextKeyEvent &evt = keys.getEvents()[key];
 
-    if(evt.compare(0, 7, "sound: ") == 0)
+    switch (evt.mType)
+    {
+    case NifOsg::TextKeyEvent::Type_Sound:
     {
         MWBase::SoundManager *sndMgr = MWBase::Environment::get().getSoundManager();
-        sndMgr->playSound3D(mPtr, evt.substr(7), 1.0f, 1.0f);
-        return;
+        sndMgr->playSound3D(mPtr, evt.mName, 1.0f, 1.0f);
+        break;
     }
-    if(evt.compare(0, 10, "soundgen: ") == 0)
+    case NifOsg::TextKeyEvent::Type_SoundGen:
     {
-        std::string soundgen = evt.substr(10);
-
-        // The event can optionally contain volume and pitch modifiers
-        float volume=1.f, pitch=1.f;
-        if (soundgen.find(" ") != std::string::npos)
-        {
-            std::vector<std::string> tokens;
-            split(soundgen, ' ', tokens);
-            soundgen = tokens[0];
-            if (tokens.size() >= 2)
-            {
-                std::stringstream stream;
-                stream << tokens[1];
-                stream >> volume;
-            }
-            if (tokens.size() >= 3)
-            {
-                std::stringstream stream;
-                stream << tokens[2];
-                stream >> pitch;
-            }
-        }
-
-        std::string sound = mPtr.getClass().getSoundIdFromSndGen(mPtr, soundgen);
+        std::string sound = mPtr.getClass().getSoundIdFromSndGen(mPtr, evt.mName);
         if(!sound.empty())
         {
             MWBase::SoundManager *sndMgr = MWBase::Environment::get().getSoundManager();
             MWBase::SoundManager::PlayType type = MWBase::SoundManager::Play_TypeSfx;
-            if(evt.compare(10, evt.size()-10, "left") == 0 || evt.compare(10, evt.size()-10, "right") == 0 || evt.compare(10, evt.size()-10, "land") == 0)
+            if(evt.mFootstep)
                 type = MWBase::SoundManager::Play_TypeFoot;
-            sndMgr->playSound3D(mPtr, sound, volume, pitch, type);
+            sndMgr->playSound3D(mPtr, sound, evt.mVolume, evt.mPitch, type);
         }
-        return;
-    }
-
-    if(evt.compare(0, groupname.size(), groupname) != 0 ||
-       evt.compare(groupname.size(), 2, ": ") != 0)
-    {
-        // Not ours, skip it
-        return;
+        break;
     }
-    size_t off = groupname.size()+2;
-    size_t len = evt.size() - off;
-
-    if(evt.compare(off, len, "equip attach") == 0)
+    case NifOsg::TextKeyEvent::Type_EquipAttach:
         mAnimation->showWeapons(true);
-    else if(evt.compare(off, len, "unequip detach") == 0)
+        break;
+    case NifOsg::TextKeyEvent::Type_UnequipDetach:
         mAnimation->showWeapons(false);
-    else if(evt.compare(off, len, "chop hit") == 0)
+        break;
+    case NifOsg::TextKeyEvent::Type_ChopHit:
         mPtr.getClass().hit(mPtr, mAttackStrength, ESM::Weapon::AT_Chop);
-    else if(evt.compare(off, len, "slash hit") == 0)
+        break;
+    case NifOsg::TextKeyEvent::Type_SlashHit:
         mPtr.getClass().hit(mPtr, mAttackStrength, ESM::Weapon::AT_Slash);
-    else if(evt.compare(off, len, "thrust hit") == 0)
+        break;
+    case NifOsg::TextKeyEvent::Type_ThrustHit:
         mPtr.getClass().hit(mPtr, mAttackStrength, ESM::Weapon::AT_Thrust);
-    else if(evt.compare(off, len, "hit") == 0)
-    {
+        break;
+    case NifOsg::TextKeyEvent::Type_Hit:
         if (groupname == "attack1")
             mPtr.getClass().hit(mPtr, mAttackStrength, ESM::Weapon::AT_Chop);
         else if (groupname == "attack2")
@@ -799,52 +767,57 @@ void CharacterController::handleTextKey(const std::string &groupname, const std:
             mPtr.getClass().hit(mPtr, mAttackStrength, ESM::Weapon::AT_Thrust);
         else
             mPtr.getClass().hit(mPtr, mAttackStrength);
-    }
-    else if (!groupname.empty() && groupname.compare(0, groupname.size()-1, "attack") == 0
-             && evt.compare(off, len, "start") == 0)
-    {
-        std::multimap<float, std::string>::const_iterator hitKey = key;
-
-        // Not all animations have a hit key defined. If there is none, the hit happens with the start key.
-        bool hasHitKey = false;
-        while (hitKey != map.end())
+        break;
+    case NifOsg::TextKeyEvent::Type_Start:
+        if (!groupname.empty() && groupname.compare(0, groupname.size()-1, "attack") == 0)
         {
-            if (hitKey->second == groupname + ": hit")
+            const std::vector<NifOsg::TextKeyEvent> &events = keys.getEvents();
+
+            // Not all animations have a hit key defined. If there is none, the hit happens with the start key.
+            bool hasHitKey = false;
+            for (size_t hitKey = key; hitKey < events.size(); ++hitKey)
             {
-                hasHitKey = true;
-                break;
+                if (events[hitKey].mGroup != evt.mGroup)
+                    continue;
+                if (events[hitKey].mType == NifOsg::TextKeyEvent::Type_Hit)
+                {
+                    hasHitKey = true;
+                    break;
+                }
+                if (events[hitKey].mType == NifOsg::TextKeyEvent::Type_Stop)
+                    break;
+            }
+            if (!hasHitKey)
+            {
+                if (groupname == "attack1")
+                    mPtr.getClass().hit(mPtr, mAttackStrength, ESM::Weapon::AT_Chop);
+                else if (groupname == "attack2")
+                    mPtr.getClass().hit(mPtr, mAttackStrength, ESM::Weapon::AT_Slash);
+                else if (groupname == "attack3")
+                    mPtr.getClass().hit(mPtr, mAttackStrength, ESM::Weapon::AT_Thrust);
             }
-            if (hitKey->second == groupname + ": stop")
-                break;
-            ++hitKey;
-        }
-        if (!hasHitKey)
-        {
-            if (groupname == "attack1")
-                mPtr.getClass().hit(mPtr, mAttackStrength, ESM::Weapon::AT_Chop);
-            else if (groupname == "attack2")
-                mPtr.getClass().hit(mPtr, mAttackStrength, ESM::Weapon::AT_Slash);
-            else if (groupname == "attack3")
-                mPtr.getClass().hit(mPtr, mAttackStrength, ESM::Weapon::AT_Thrust);
         }
-    }
-    else if (evt.compare(off, len, "shoot attach") == 0)
+        break;
+    case NifOsg::TextKeyEvent::Type_ShootAttach:
+    case NifOsg::TextKeyEvent::Type_ShootFollowAttach:
         mAnimation->attachArrow();
-    else if (evt.compare(off, len, "shoot release") == 0)
+        break;
+    case NifOsg::TextKeyEvent::Type_ShootRelease:
         mAnimation->releaseArrow(mAttackStrength);
-    else if (evt.compare(off, len, "shoot follow attach") == 0)
-        mAnimation->attachArrow();
-
-    else if (groupname == "spellcast" && evt.substr(evt.size()-7, 7) == "release"
-             // Make sure this key is actually for the RangeType we are casting. The flame atronach has
-             // the same animation for all range types, so there are 3 "release" keys on the same time, one for each range type.
-             && evt.compare(off, len, mAttackType + " release") == 0)
-    {
-        MWBase::Environment::get().getWorld()->castSpell(mPtr);
+        break;
+    case NifOsg::TextKeyEvent::Type_Release:
+        // Make sure this key is actually for the RangeType we are casting. The flame atronach has
+        // the same animation for all range types, so there are 3 "release" keys on the same time, one for each range type.
+        if (groupname == "spellcast" && evt.mName == mAttackType + " release")
+            MWBase::Environment::get().getWorld()->castSpell(mPtr);
+        break;
+    case NifOsg::TextKeyEvent::Type_BlockHit:
+        if (groupname == "shield")
+            mPtr.getClass().block(mPtr);
+        break;
+    default:
+        break;
     }
-
-    else if (groupname == "shield" && evt.compare(off, len, "block hit") == 0)
-        mPtr.getClass().block(mPtr);
 }
 
 void CharacterController::updatePtr(const MWWorld::Ptr &ptr)
@@ -1470,6 +1443,7 @@ bool CharacterController::updateWeaponState()
 
 void CharacterController::update(float duration)
 {
+    Misc::ProfileZone zone("CharacterController::update");
     MWBase::World *world = MWBase::Environment::get().getWorld();
     const MWWorld::Class &cls = mPtr.getClass();
     osg::Vec3f movement(0.f, 0.f, 0.f);
@@ -1576,16 +1550,16 @@ void CharacterController::update(float duration)
         }
 
         // reduce fatigue
-        const MWWorld::Store<ESM::GameSetting> &gmst = world->getStore().get<ESM::GameSetting>();
+        const MWWorld::GameSettings &gmst = world->getStore().getGameSettings();
         float fatigueLoss = 0;
-        static const float fFatigueRunBase = gmst.find("fFatigueRunBase")->getFloat();
-        static const float fFatigueRunMult = gmst.find("fFatigueRunMult")->getFloat();
-        static const float fFatigueSwimWalkBase = gmst.find("fFatigueSwimWalkBase")->getFloat();
-        static const float fFatigueSwimRunBase = gmst.find("fFatigueSwimRunBase")->getFloat();
-        static const float fFatigueSwimWalkMult = gmst.find("fFatigueSwimWalkMult")->getFloat();
-        static const float fFatigueSwimRunMult = gmst.find("fFatigueSwimRunMult")->getFloat();
-        static const float fFatigueSneakBase = gmst.find("fFatigueSneakBase")->getFloat();
-        static const float fFatigueSneakMult = gmst.find("fFatigueSneakMult")->getFloat();
+        const float fFatigueRunBase = gmst.get(MWWorld::GameSettings::fFatigueRunBase);
+        const float fFatigueRunMult = gmst.get(MWWorld::GameSettings::fFatigueRunMult);
+        const float fFatigueSwimWalkBase = gmst.get(MWWorld::GameSettings::fFatigueSwimWalkBase);
+        const float fFatigueSwimRunBase = gmst.get(MWWorld::GameSettings::fFatigueSwimRunBase);
+        const float fFatigueSwimWalkMult = gmst.get(MWWorld::GameSettings::fFatigueSwimWalkMult);
+        const float fFatigueSwimRunMult = gmst.get(MWWorld::GameSettings::fFatigueSwimRunMult);
+        const float fFatigueSneakBase = gmst.get(MWWorld::GameSettings::fFatigueSneakBase);
+        const float fFatigueSneakMult = gmst.get(MWWorld::GameSettings::fFatigueSneakMult);
 
         const float encumbrance = cls.getEncumbrance(mPtr) / cls.getCapacity(mPtr);
         if (encumbrance < 1)
@@ -1630,8 +1604,8 @@ void CharacterController::update(float duration)
             forcestateupdate = (mJumpState != JumpState_InAir);
             jumpstate = JumpState_InAir;
 
-            static const float fJumpMoveBase = gmst.find("fJumpMoveBase")->getFloat();
-            static const float fJumpMoveMult = gmst.find("fJumpMoveMult")->getFloat();
+            const float fJumpMoveBase = gmst.get(MWWorld::GameSettings::fJumpMoveBase);
+            const float fJumpMoveMult = gmst.get(MWWorld::GameSettings::fJumpMoveMult);
             float factor = fJumpMoveBase + fJumpMoveMult * mPtr.getClass().getSkill(mPtr, ESM::Skill::Acrobatics)/100.f;
             factor = std::min(1.f, factor);
             vec.x() *= factor;
@@ -1658,9 +1632,9 @@ void CharacterController::update(float duration)
                     cls.skillUsageSucceeded(mPtr, ESM::Skill::Acrobatics, 0);
 
                 // decrease fatigue
-                const MWWorld::Store<ESM::GameSetting> &gmst = world->getStore().get<ESM::GameSetting>();
-                const float fatigueJumpBase = gmst.find("fFatigueJumpBase")->getFloat();
-                const float fatigueJumpMult = gmst.find("fFatigueJumpMult")->getFloat();
+                const MWWorld::GameSettings &gmst = world->getStore().getGameSettings();
+                const float fatigueJumpBase = gmst.get(MWWorld::GameSettings::fFatigueJumpBase);
+                const float fatigueJumpMult = gmst.get(MWWorld::GameSettings::fFatigueJumpMult);
                 float normalizedEncumbrance = mPtr.getClass().getNormalizedEncumbrance(mPtr);
                 if (normalizedEncumbrance > 1)
                     normalizedEncumbrance = 1;
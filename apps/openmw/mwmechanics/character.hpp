@@ -215,8 +215,7 @@ public:
     CharacterController(const MWWorld::Ptr &ptr, MWRender::Animation *anim);
     virtual ~CharacterController();
 
-    virtual void handleTextKey(const std::string &groupname, const std::multimap<float, std::string>::const_iterator &key,
-                       const std::multimap<float, std::string>& map);
+    virtual void handleTextKey(const std::string &groupname, const NifOsg::TextKeyEvents &keys, size_t key);
 
     // Be careful when to call this, see comment in Actors
     void updateContinuousVfx();
@@ -80,10 +80,10 @@ namespace MWMechanics
                     blocker.getRefData().getBaseNode()->getAttitude() * osg::Vec3f(0,1,0),
                     osg::Vec3f(0,0,1)));
 
-        const MWWorld::Store<ESM::GameSetting>& gmst = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>();
-        if (angleDegrees < gmst.find("fCombatBlockLeftAngle")->getFloat())
+        const MWWorld::GameSettings& gmst = MWBase::Environment::get().getWorld()->getStore().getGameSettings();
+        if (angleDegrees < gmst.get(MWWorld::GameSettings::fCombatBlockLeftAngle))
             return false;
-        if (angleDegrees > gmst.find("fCombatBlockRightAngle")->getFloat())
+        if (angleDegrees > gmst.get(MWWorld::GameSettings::fCombatBlockRightAngle))
             return false;
 
         MWMechanics::CreatureStats& attackerStats = attacker.getClass().getCreatureStats(attacker);
@@ -91,11 +91,11 @@ namespace MWMechanics
         float blockTerm = blocker.getClass().getSkill(blocker, ESM::Skill::Block) + 0.2f * blockerStats.getAttribute(ESM::Attribute::Agility).getModified()
             + 0.1f * blockerStats.getAttribute(ESM::Attribute::Luck).getModified();
         float enemySwing = attackStrength;
-        float swingTerm = enemySwing * gmst.find("fSwingBlockMult")->getFloat() + gmst.find("fSwingBlockBase")->getFloat();
+        float swingTerm = enemySwing * gmst.get(MWWorld::GameSettings::fSwingBlockMult) + gmst.get(MWWorld::GameSettings::fSwingBlockBase);
 
         float blockerTerm = blockTerm * swingTerm;
         if (blocker.getClass().getMovementSettings(blocker).mPosition[1] <= 0)
-            blockerTerm *= gmst.find("fBlockStillBonus")->getFloat();
+            blockerTerm *= gmst.get(MWWorld::GameSettings::fBlockStillBonus);
         blockerTerm *= blockerStats.getFatigueTerm();
 
         int attackerSkill = 0;
@@ -108,8 +108,8 @@ namespace MWMechanics
         attackerTerm *= attackerStats.getFatigueTerm();
 
         int x = int(blockerTerm - attackerTerm);
-        int iBlockMaxChance = gmst.find("iBlockMaxChance")->getInt();
-        int iBlockMinChance = gmst.find("iBlockMinChance")->getInt();
+        int iBlockMaxChance = gmst.get(MWWorld::GameSettings::iBlockMaxChance);
+        int iBlockMinChance = gmst.get(MWWorld::GameSettings::iBlockMinChance);
         x = std::min(iBlockMaxChance, std::max(iBlockMinChance, x));
 
         if (Misc::Rng::roll0to99() < x)
@@ -123,9 +123,9 @@ namespace MWMechanics
                 inv.unequipItem(*shield, blocker);
 
             // Reduce blocker fatigue
-            const float fFatigueBlockBase = gmst.find("fFatigueBlockBase")->getFloat();
-            const float fFatigueBlockMult = gmst.find("fFatigueBlockMult")->getFloat();
-            const float fWeaponFatigueBlockMult = gmst.find("fWeaponFatigueBlockMult")->getFloat();
+            const float fFatigueBlockBase = gmst.get(MWWorld::GameSettings::fFatigueBlockBase);
+            const float fFatigueBlockMult = gmst.get(MWWorld::GameSettings::fFatigueBlockMult);
+            const float fWeaponFatigueBlockMult = gmst.get(MWWorld::GameSettings::fWeaponFatigueBlockMult);
             MWMechanics::DynamicStat<float> fatigue = blockerStats.getFatigue();
             float normalizedEncumbrance = blocker.getClass().getNormalizedEncumbrance(blocker);
             normalizedEncumbrance = std::min(1.f, normalizedEncumbrance);
@@ -159,7 +159,7 @@ namespace MWMechanics
 
         if ((weapon.get<ESM::Weapon>()->mBase->mData.mFlags & ESM::Weapon::Silver)
                 && actor.getClass().isNpc() && actor.getClass().getNpcStats(actor).isWerewolf())
-            damage *= MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>().find("fWereWolfSilverWeaponDamageMult")->getFloat();
+            damage *= MWBase::Environment::get().getWorld()->getStore().getGameSettings().get(MWWorld::GameSettings::fWereWolfSilverWeaponDamageMult);
 
         if (damage == 0 && attacker == MWBase::Environment::get().getWorld()->getPlayerPtr())
             MWBase::Environment::get().getWindowManager()->messageBox("#{sMagicTargetResistsWeapons}");
@@ -169,7 +169,7 @@ namespace MWMechanics
                        const osg::Vec3f& hitPosition, float attackStrength)
     {
         MWBase::World *world = MWBase::Environment::get().getWorld();
-        const MWWorld::Store<ESM::GameSetting> &gmst = world->getStore().get<ESM::GameSetting>();
+        const MWWorld::GameSettings &gmst = world->getStore().getGameSettings();
 
         if(victim.isEmpty() || !victim.getClass().isActor() || victim.getClass().getCreatureStats(victim).isDead())
             // Can't hit non-actors or dead actors
@@ -211,7 +211,7 @@ namespace MWMechanics
             attacker.getClass().skillUsageSucceeded(attacker, weapskill, 0);
 
         if (victim.getClass().getCreatureStats(victim).getKnockedDown())
-            damage *= gmst.find("fCombatKODamageMult")->getFloat();
+            damage *= gmst.get(MWWorld::GameSettings::fCombatKODamageMult);
 
         // Apply "On hit" effect of the weapon
         bool appliedEnchantment = applyEnchantment(attacker, victim, weapon, hitPosition);
@@ -225,7 +225,7 @@ namespace MWMechanics
         if (victim != MWBase::Environment::get().getWorld()->getPlayerPtr()
                 && !appliedEnchantment)
         {
-            float fProjectileThrownStoreChance = gmst.find("fProjectileThrownStoreChance")->getFloat();
+            float fProjectileThrownStoreChance = gmst.get(MWWorld::GameSettings::fProjectileThrownStoreChance);
             if (Misc::Rng::rollProbability() < fProjectileThrownStoreChance / 100.f)
                 victim.getClass().getContainerStore(victim).add(projectile, 1, victim);
         }
@@ -239,7 +239,7 @@ namespace MWMechanics
         const MWMechanics::MagicEffects &mageffects = stats.getMagicEffects();
 
         MWBase::World *world = MWBase::Environment::get().getWorld();
-        const MWWorld::Store<ESM::GameSetting> &gmst = world->getStore().get<ESM::GameSetting>();
+        const MWWorld::GameSettings &gmst = world->getStore().getGameSettings();
 
         float defenseTerm = 0;
         if (victim.getClass().getCreatureStats(victim).getFatigue().getCurrent() >= 0)
@@ -256,10 +256,10 @@ namespace MWMechanics
                 defenseTerm = victimStats.getEvasion();
             }
             defenseTerm += std::min(100.f,
-                                    gmst.find("fCombatInvisoMult")->getFloat() *
+                                    gmst.get(MWWorld::GameSettings::fCombatInvisoMult) *
                                     victimStats.getMagicEffects().get(ESM::MagicEffect::Chameleon).getMagnitude());
             defenseTerm += std::min(100.f,
-                                    gmst.find("fCombatInvisoMult")->getFloat() *
+                                    gmst.get(MWWorld::GameSettings::fCombatInvisoMult) *
                                     victimStats.getMagicEffects().get(ESM::MagicEffect::Invisibility).getMagnitude());
         }
         float attackTerm = skillValue +
@@ -305,7 +305,7 @@ namespace MWMechanics
 
             x = std::min(100.f, x + elementResistance);
 
-            static const float fElementalShieldMult = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>().find("fElementalShieldMult")->getFloat();
+            const float fElementalShieldMult = MWBase::Environment::get().getWorld()->getStore().getGameSettings().get(MWWorld::GameSettings::fElementalShieldMult);
             x = fElementalShieldMult * magnitude * (1.f - 0.01f * x);
 
             // Note swapped victim and attacker, since the attacker takes the damage here.
@@ -330,7 +330,7 @@ namespace MWMechanics
         {
             int weaphealth = weapon.getClass().getItemHealth(weapon);
 
-            const float fWeaponDamageMult = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>().find("fWeaponDamageMult")->getFloat();
+            const float fWeaponDamageMult = MWBase::Environment::get().getWorld()->getStore().getGameSettings().get(MWWorld::GameSettings::fWeaponDamageMult);
             float x = std::max(1.f, fWeaponDamageMult * damage);
 
             weaphealth -= std::min(int(x), weaphealth);
@@ -355,10 +355,8 @@ namespace MWMechanics
             damage *= (float(weaphealth) / weapmaxhealth);
         }
 
-        static const float fDamageStrengthBase = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>()
-                .find("fDamageStrengthBase")->getFloat();
-        static const float fDamageStrengthMult = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>()
-                .find("fDamageStrengthMult")->getFloat();
+        const float fDamageStrengthBase = MWBase::Environment::get().getWorld()->getStore().getGameSettings().get(MWWorld::GameSettings::fDamageStrengthBase);
+        const float fDamageStrengthMult = MWBase::Environment::get().getWorld()->getStore().getGameSettings().get(MWWorld::GameSettings::fDamageStrengthMult);
         damage *= fDamageStrengthBase +
                 (attacker.getClass().getCreatureStats(attacker).getAttribute(ESM::Attribute::Strength).getModified() * fDamageStrengthMult * 0.1f);
     }
@@ -369,8 +367,8 @@ namespace MWMechanics
         // calculations. Some mods recommend using it, so we may want to include an
         // option for it.
         const MWWorld::ESMStore& store = MWBase::Environment::get().getWorld()->getStore();
-        float minstrike = store.get<ESM::GameSetting>().find("fMinHandToHandMult")->getFloat();
-        float maxstrike = store.get<ESM::GameSetting>().find("fMaxHandToHandMult")->getFloat();
+        float minstrike = store.getGameSettings().get(MWWorld::GameSettings::fMinHandToHandMult);
+        float maxstrike = store.getGameSettings().get(MWWorld::GameSettings::fMaxHandToHandMult);
         damage  = static_cast<float>(attacker.getClass().getSkill(attacker, ESM::Skill::HandToHand));
         damage *= minstrike + ((maxstrike-minstrike)*attackStrength);
 
@@ -385,7 +383,7 @@ namespace MWMechanics
             damage *= MWBase::Environment::get().getWorld()->getGlobalFloat("werewolfclawmult");
         }
         if(healthdmg)
-            damage *= store.get<ESM::GameSetting>().find("fHandtoHandHealthPer")->getFloat();
+            damage *= store.getGameSettings().get(MWWorld::GameSettings::fHandtoHandHealthPer);
 
         MWBase::SoundManager *sndMgr = MWBase::Environment::get().getSoundManager();
         if(isWerewolf)
@@ -401,10 +399,10 @@ namespace MWMechanics
     void applyFatigueLoss(const MWWorld::Ptr &attacker, const MWWorld::Ptr &weapon, float attackStrength)
     {
         // somewhat of a guess, but using the weapon weight makes sense
-        const MWWorld::Store<ESM::GameSetting>& store = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>();
-        const float fFatigueAttackBase = store.find("fFatigueAttackBase")->getFloat();
-        const float fFatigueAttackMult = store.find("fFatigueAttackMult")->getFloat();
-        const float fWeaponFatigueMult = store.find("fWeaponFatigueMult")->getFloat();
+        const MWWorld::GameSettings& gmst = MWBase::Environment::get().getWorld()->getStore().getGameSettings();
+        const float fFatigueAttackBase = gmst.get(MWWorld::GameSettings::fFatigueAttackBase);
+        const float fFatigueAttackMult = gmst.get(MWWorld::GameSettings::fFatigueAttackMult);
+        const float fWeaponFatigueMult = gmst.get(MWWorld::GameSettings::fWeaponFatigueMult);
         CreatureStats& stats = attacker.getClass().getCreatureStats(attacker);
         MWMechanics::DynamicStat<float> fatigue = stats.getFatigue();
         const float normalizedEncumbrance = attacker.getClass().getNormalizedEncumbrance(attacker);
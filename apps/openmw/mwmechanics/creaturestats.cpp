@@ -45,11 +45,11 @@ namespace MWMechanics
 
         float normalised = floor(max) == 0 ? 1 : std::max (0.0f, current / max);
 
-        const MWWorld::Store<ESM::GameSetting> &gmst =
-            MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>();
+        const MWWorld::GameSettings &gmst =
+            MWBase::Environment::get().getWorld()->getStore().getGameSettings();
 
-        return gmst.find ("fFatigueBase")->getFloat()
-            - gmst.find ("fFatigueMult")->getFloat() * (1-normalised);
+        return gmst.get(MWWorld::GameSettings::fFatigueBase)
+            - gmst.get(MWWorld::GameSettings::fFatigueMult) * (1-normalised);
     }
 
     const AttributeValue &CreatureStats::getAttribute(int index) const
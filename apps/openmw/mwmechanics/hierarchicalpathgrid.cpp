@@ -0,0 +1,332 @@
+#include "hierarchicalpathgrid.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+
+#include <components/esm/loadland.hpp>
+
+namespace
+{
+    // Pathgrid points closer than this to a cell border are candidates for linking to the neighbouring cell
+    const float sBorderDistance = 1024.f;
+
+    // Maximum distance between two linked points. Vanilla pathgrids use a spacing of roughly 500 to 1000 units.
+    const float sMaxLinkDistance = 1536.f;
+
+    // Cells further than this from the bounding box of the start and goal cells are not searched
+    const int sSearchMargin = 2;
+
+    // Upper limit for the number of abstract nodes visited by a single search
+    const size_t sMaxNodes = 4096;
+
+    struct NodeKey
+    {
+        int mCellX;
+        int mCellY;
+        int mPoint;
+
+        NodeKey(int x, int y, int point) : mCellX(x), mCellY(y), mPoint(point) {}
+
+        bool operator< (const NodeKey& other) const
+        {
+            if (mCellX != other.mCellX)
+                return mCellX < other.mCellX;
+            if (mCellY != other.mCellY)
+                return mCellY < other.mCellY;
+            return mPoint < other.mPoint;
+        }
+
+        bool operator== (const NodeKey& other) const
+        {
+            return mCellX == other.mCellX && mCellY == other.mCellY && mPoint == other.mPoint;
+        }
+    };
+}
+
+namespace MWMechanics
+{
+    HierarchicalPathgrid::HierarchicalPathgrid()
+    {
+    }
+
+    HierarchicalPathgrid::~HierarchicalPathgrid()
+    {
+        for (CellMap::iterator it = mCells.begin(); it != mCells.end(); ++it)
+            delete it->second;
+    }
+
+    void HierarchicalPathgrid::addCell(int x, int y, const PathgridGraph* graph)
+    {
+        removeCell(x, y);
+
+        if (!graph->getPathgrid() || graph->getPathgrid()->mPoints.empty())
+            return;
+
+        CellGraph* cell = new CellGraph;
+        cell->mX = x;
+        cell->mY = y;
+        cell->mGraph = graph;
+        cell->mLinksBuilt = false;
+        mCells[std::make_pair(x, y)] = cell;
+
+        resetNeighbourLinks(x, y);
+    }
+
+    void HierarchicalPathgrid::removeCell(int x, int y)
+    {
+        CellMap::iterator found = mCells.find(std::make_pair(x, y));
+        if (found == mCells.end())
+            return;
+
+        delete found->second;
+        mCells.erase(found);
+
+        resetNeighbourLinks(x, y);
+    }
+
+    void HierarchicalPathgrid::resetNeighbourLinks(int x, int y)
+    {
+        const int directions[4][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+        for (int d = 0; d < 4; ++d)
+        {
+            CellGraph* neighbour = getCell(x + directions[d][0], y + directions[d][1]);
+            if (!neighbour)
+                continue;
+
+            neighbour->mLinksBuilt = false;
+            neighbour->mLinks.clear();
+            neighbour->mBorderPoints.clear();
+        }
+    }
+
+    HierarchicalPathgrid::CellGraph* HierarchicalPathgrid::getCell(int x, int y)
+    {
+        CellMap::iterator found = mCells.find(std::make_pair(x, y));
+        if (found != mCells.end())
+            return found->second;
+        return NULL;
+    }
+
+    osg::Vec3f HierarchicalPathgrid::toWorld(const CellGraph& cell, int point)
+    {
+        const ESM::Pathgrid::Point& pt = cell.mGraph->getPathgrid()->mPoints[point];
+        return osg::Vec3f(static_cast<float>(pt.mX + cell.mX * ESM::Land::REAL_SIZE),
+                          static_cast<float>(pt.mY + cell.mY * ESM::Land::REAL_SIZE),
+                          static_cast<float>(pt.mZ));
+    }
+
+    void HierarchicalPathgrid::buildLinks(CellGraph& cell)
+    {
+        if (cell.mLinksBuilt)
+            return;
+        cell.mLinksBuilt = true;
+
+        const int directions[4][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+        const ESM::Pathgrid::PointList& points = cell.mGraph->getPathgrid()->mPoints;
+
+        for (int d = 0; d < 4; ++d)
+        {
+            int dx = directions[d][0];
+            int dy = directions[d][1];
+            CellGraph* neighbour = getCell(cell.mX + dx, cell.mY + dy);
+            if (!neighbour)
+                continue;
+
+            for (int i = 0; i < static_cast<int>(points.size()); ++i)
+            {
+                // distance to the border shared with the neighbour, in local co-ordinates
+                float borderDistance;
+                if (dx != 0)
+                    borderDistance = dx > 0 ? ESM::Land::REAL_SIZE - points[i].mX : static_cast<float>(points[i].mX);
+                else
+                    borderDistance = dy > 0 ? ESM::Land::REAL_SIZE - points[i].mY : static_cast<float>(points[i].mY);
+                if (borderDistance > sBorderDistance)
+                    continue;
+
+                osg::Vec3f worldPos = toWorld(cell, i);
+                osg::Vec3f neighbourLocal = worldPos - osg::Vec3f(static_cast<float>(neighbour->mX * ESM::Land::REAL_SIZE),
+                                                                  static_cast<float>(neighbour->mY * ESM::Land::REAL_SIZE), 0.f);
+                int target = neighbour->mGraph->getClosestPoint(neighbourLocal);
+                if (target == -1)
+                    continue;
+
+                float cost = (toWorld(*neighbour, target) - worldPos).length();
+                if (cost > sMaxLinkDistance)
+                    continue;
+
+                Link link;
+                link.mPoint = i;
+                link.mCellX = neighbour->mX;
+                link.mCellY = neighbour->mY;
+                link.mTarget = target;
+                link.mCost = cost;
+                cell.mLinks.push_back(link);
+
+                std::vector<int>& borderPoints = cell.mBorderPoints[cell.mGraph->getComponentId(i)];
+                if (std::find(borderPoints.begin(), borderPoints.end(), i) == borderPoints.end())
+                    borderPoints.push_back(i);
+            }
+        }
+    }
+
+    /*
+     * A* search over the abstract graph of linked border points, followed by
+     * refining each part of the path that lies within one cell.
+     *
+     * Costs on the abstract level are straight line distances, which makes
+     * them an optimistic estimate of the actual path length within a cell.
+     */
+    std::list<ESM::Pathgrid::Point> HierarchicalPathgrid::findPath(const osg::Vec3f& start, const osg::Vec3f& end)
+    {
+        std::list<ESM::Pathgrid::Point> path;
+
+        int startX = static_cast<int>(std::floor(start.x() / ESM::Land::REAL_SIZE));
+        int startY = static_cast<int>(std::floor(start.y() / ESM::Land::REAL_SIZE));
+        int goalX = static_cast<int>(std::floor(end.x() / ESM::Land::REAL_SIZE));
+        int goalY = static_cast<int>(std::floor(end.y() / ESM::Land::REAL_SIZE));
+
+        CellGraph* startCell = getCell(startX, startY);
+        CellGraph* goalCell = getCell(goalX, goalY);
+        if (!startCell || !goalCell)
+            return path;
+
+        osg::Vec3f startOffset(static_cast<float>(startX * ESM::Land::REAL_SIZE), static_cast<float>(startY * ESM::Land::REAL_SIZE), 0.f);
+        osg::Vec3f goalOffset(static_cast<float>(goalX * ESM::Land::REAL_SIZE), static_cast<float>(goalY * ESM::Land::REAL_SIZE), 0.f);
+        int startPoint = startCell->mGraph->getClosestPoint(start - startOffset);
+        int goalPoint = goalCell->mGraph->getClosestPoint(end - goalOffset);
+        if (startPoint == -1 || goalPoint == -1)
+            return path;
+
+        if (startCell == goalCell && startCell->mGraph->isPointConnected(startPoint, goalPoint))
+            return startCell->mGraph->aStarSearch(startPoint, goalPoint);
+
+        const int goalComponent = goalCell->mGraph->getComponentId(goalPoint);
+        const osg::Vec3f goalPos = toWorld(*goalCell, goalPoint);
+        const NodeKey goalKey(goalX, goalY, goalPoint);
+
+        const int minX = std::min(startX, goalX) - sSearchMargin;
+        const int maxX = std::max(startX, goalX) + sSearchMargin;
+        const int minY = std::min(startY, goalY) - sSearchMargin;
+        const int maxY = std::max(startY, goalY) + sSearchMargin;
+
+        std::vector<SearchNode> nodes;
+        std::map<NodeKey, int> nodeIndex;
+
+        typedef std::pair<float, int> OpenEntry;
+        std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry> > openset;
+
+        SearchNode startNode = { startCell, startPoint, 0.f, -1, false };
+        nodes.push_back(startNode);
+        nodeIndex[NodeKey(startX, startY, startPoint)] = 0;
+        openset.push(OpenEntry((toWorld(*startCell, startPoint) - goalPos).length(), 0));
+
+        int found = -1;
+        while (!openset.empty() && nodes.size() < sMaxNodes)
+        {
+            int current = openset.top().second;
+            openset.pop();
+            if (nodes[current].mClosed)
+                continue; // stale entry
+            nodes[current].mClosed = true;
+
+            CellGraph* cell = nodes[current].mCell;
+            int point = nodes[current].mPoint;
+            if (NodeKey(cell->mX, cell->mY, point) == goalKey)
+            {
+                found = current;
+                break;
+            }
+
+            buildLinks(*cell);
+
+            const osg::Vec3f pos = toWorld(*cell, point);
+            const int component = cell->mGraph->getComponentId(point);
+
+            // collect the neighbours of this node: (cell, point, cost)
+            std::vector<std::pair<std::pair<CellGraph*, int>, float> > neighbours;
+
+            if (cell == goalCell && component == goalComponent)
+                neighbours.push_back(std::make_pair(std::make_pair(cell, goalPoint), (goalPos - pos).length()));
+
+            std::map<int, std::vector<int> >::const_iterator borderPoints = cell->mBorderPoints.find(component);
+            if (borderPoints != cell->mBorderPoints.end())
+            {
+                for (std::vector<int>::const_iterator it = borderPoints->second.begin(); it != borderPoints->second.end(); ++it)
+                {
+                    if (*it != point)
+                        neighbours.push_back(std::make_pair(std::make_pair(cell, *it), (toWorld(*cell, *it) - pos).length()));
+                }
+            }
+
+            for (std::vector<Link>::const_iterator it = cell->mLinks.begin(); it != cell->mLinks.end(); ++it)
+            {
+                if (it->mPoint != point)
+                    continue;
+                if (it->mCellX < minX || it->mCellX > maxX || it->mCellY < minY || it->mCellY > maxY)
+                    continue;
+                CellGraph* target = getCell(it->mCellX, it->mCellY);
+                if (target)
+                    neighbours.push_back(std::make_pair(std::make_pair(target, it->mTarget), it->mCost));
+            }
+
+            for (std::vector<std::pair<std::pair<CellGraph*, int>, float> >::const_iterator it = neighbours.begin();
+                 it != neighbours.end(); ++it)
+            {
+                CellGraph* targetCell = it->first.first;
+                int targetPoint = it->first.second;
+                float cost = nodes[current].mCost + it->second;
+
+                NodeKey key(targetCell->mX, targetCell->mY, targetPoint);
+                std::map<NodeKey, int>::iterator existing = nodeIndex.find(key);
+                int index;
+                if (existing == nodeIndex.end())
+                {
+                    SearchNode node = { targetCell, targetPoint, cost, current, false };
+                    index = static_cast<int>(nodes.size());
+                    nodes.push_back(node);
+                    nodeIndex[key] = index;
+                }
+                else
+                {
+                    index = existing->second;
+                    if (nodes[index].mClosed || nodes[index].mCost <= cost)
+                        continue;
+                    nodes[index].mCost = cost;
+                    nodes[index].mParent = current;
+                }
+                openset.push(OpenEntry(cost + (toWorld(*targetCell, targetPoint) - goalPos).length(), index));
+            }
+        }
+
+        if (found == -1)
+            return path;
+
+        std::vector<int> route;
+        for (int node = found; node != -1; node = nodes[node].mParent)
+            route.push_back(node);
+        std::reverse(route.begin(), route.end());
+
+        // refine the abstract path, cell by cell
+        for (size_t i = 0; i < route.size(); ++i)
+        {
+            const SearchNode& node = nodes[route[i]];
+            if (i + 1 < route.size() && nodes[route[i+1]].mCell == node.mCell && nodes[route[i+1]].mPoint != node.mPoint)
+            {
+                std::list<ESM::Pathgrid::Point> segment = node.mCell->mGraph->aStarSearch(node.mPoint, nodes[route[i+1]].mPoint);
+                // the last point of the segment is the first point of the next one
+                if (!segment.empty())
+                    segment.pop_back();
+                path.splice(path.end(), segment);
+            }
+            else
+            {
+                osg::Vec3f pos = toWorld(*node.mCell, node.mPoint);
+                path.push_back(ESM::Pathgrid::Point(static_cast<int>(pos.x()), static_cast<int>(pos.y()), static_cast<int>(pos.z())));
+            }
+        }
+
+        return path;
+    }
+}
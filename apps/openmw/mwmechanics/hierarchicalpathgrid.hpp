@@ -0,0 +1,91 @@
+#ifndef GAME_MWMECHANICS_HIERARCHICALPATHGRID_H
+#define GAME_MWMECHANICS_HIERARCHICALPATHGRID_H
+
+#include <list>
+#include <map>
+#include <vector>
+
+#include <components/esm/loadpgrd.hpp>
+
+#include "pathgrid.hpp"
+
+namespace MWMechanics
+{
+    /// @brief Links the pathgrids of exterior cells at the cell borders, to find paths spanning several cells.
+    ///
+    /// Searching works on two levels. The abstract level consists of the pathgrid points near a cell border
+    /// that are linked to a point of the neighbouring cell. Within a cell, these border points are connected
+    /// to each other if they belong to the same connected component. A path found on the abstract level is
+    /// then refined cell by cell using the regular PathgridGraph search.
+    ///
+    /// Only cells added with addCell() are searched. The Scene adds the active exterior cells and removes
+    /// them again when they are unloaded, reusing the pathgrid graphs of their CellStores. Border links are
+    /// built on demand.
+    class HierarchicalPathgrid
+    {
+        public:
+            HierarchicalPathgrid();
+            ~HierarchicalPathgrid();
+
+            /// Make the exterior cell at \a x, \a y available to the search. Cells without pathgrid points are ignored.
+            /// @param graph The pathgrid graph of the cell, must stay valid until the cell is removed again
+            void addCell(int x, int y, const PathgridGraph* graph);
+
+            /// Remove a cell added by addCell(), e.g. because it is unloaded.
+            void removeCell(int x, int y);
+
+            /// Find a path between two positions in exterior cells, in world co-ordinates.
+            /// @return the path as pathgrid points in world co-ordinates, or an empty list if there is none
+            std::list<ESM::Pathgrid::Point> findPath(const osg::Vec3f& start, const osg::Vec3f& end);
+
+        private:
+            struct Link
+            {
+                int mPoint; // pathgrid point index in the linking cell
+                int mCellX;
+                int mCellY;
+                int mTarget; // pathgrid point index in the neighbouring cell
+                float mCost;
+            };
+
+            struct CellGraph
+            {
+                int mX;
+                int mY;
+                const PathgridGraph* mGraph;
+
+                bool mLinksBuilt;
+                std::vector<Link> mLinks;
+                // componentId -> points that have a link to a neighbouring cell
+                std::map<int, std::vector<int> > mBorderPoints;
+            };
+
+            // a node of the abstract search
+            struct SearchNode
+            {
+                CellGraph* mCell;
+                int mPoint;
+                float mCost;
+                int mParent;
+                bool mClosed;
+            };
+
+            /// @return NULL if the cell was not added, or has no pathgrid
+            CellGraph* getCell(int x, int y);
+
+            void buildLinks(CellGraph& cell);
+
+            /// Make the neighbours of \a x, \a y rebuild their links when they are next searched
+            void resetNeighbourLinks(int x, int y);
+
+            static osg::Vec3f toWorld(const CellGraph& cell, int point);
+
+            typedef std::map<std::pair<int, int>, CellGraph*> CellMap;
+            CellMap mCells;
+
+            HierarchicalPathgrid(const HierarchicalPathgrid&);
+            HierarchicalPathgrid& operator=(const HierarchicalPathgrid&);
+    };
+}
+
+#endif
@@ -1,11 +1,16 @@
 
 #include "magiceffects.hpp"
 
+#include <algorithm>
 #include <cstdlib>
 
 #include <stdexcept>
+#include <vector>
 
+#include <components/esm/attr.hpp>
 #include <components/esm/effectlist.hpp>
+#include <components/esm/loadmgef.hpp>
+#include <components/esm/loadskil.hpp>
 #include <components/esm/magiceffects.hpp>
 
 namespace MWMechanics
@@ -87,40 +92,170 @@ namespace MWMechanics
         return *this;
     }
 
-    void MagicEffects::remove(const EffectKey &key)
+    namespace
+    {
+        /// Number of arguments an effect can take, 1 for effects without argument
+        int getArgumentCount (int effectId)
+        {
+            switch (effectId)
+            {
+                case ESM::MagicEffect::DrainAttribute:
+                case ESM::MagicEffect::DamageAttribute:
+                case ESM::MagicEffect::RestoreAttribute:
+                case ESM::MagicEffect::FortifyAttribute:
+                case ESM::MagicEffect::AbsorbAttribute:
+
+                    return ESM::Attribute::Length;
+
+                case ESM::MagicEffect::DrainSkill:
+                case ESM::MagicEffect::DamageSkill:
+                case ESM::MagicEffect::RestoreSkill:
+                case ESM::MagicEffect::FortifySkill:
+                case ESM::MagicEffect::AbsorbSkill:
+
+                    return ESM::Skill::Length;
+            }
+
+            return 1;
+        }
+
+        struct SlotLayout
+        {
+            int mFirstSlot[ESM::MagicEffect::Length];
+            std::vector<EffectKey> mKeys;
+
+            SlotLayout()
+            {
+                for (int id=0; id<ESM::MagicEffect::Length; ++id)
+                {
+                    mFirstSlot[id] = static_cast<int>(mKeys.size());
+
+                    int count = getArgumentCount (id);
+                    if (count==1)
+                        mKeys.push_back (EffectKey (id));
+                    else
+                        for (int arg=0; arg<count; ++arg)
+                            mKeys.push_back (EffectKey (id, arg));
+                }
+            }
+        };
+
+        const SlotLayout& getLayout()
+        {
+            static const SlotLayout layout;
+            return layout;
+        }
+    }
+
+    int MagicEffects::getSlot (const EffectKey& key)
+    {
+        if (key.mId<0 || key.mId>=ESM::MagicEffect::Length)
+            return -1;
+
+        int count = getArgumentCount (key.mId);
+        if (count==1)
+            return key.mArg==-1 ? getLayout().mFirstSlot[key.mId] : -1;
+
+        if (key.mArg<0 || key.mArg>=count)
+            return -1;
+
+        return getLayout().mFirstSlot[key.mId] + key.mArg;
+    }
+
+    EffectKey MagicEffects::getKey (int slot)
     {
-        mCollection.erase(key);
+        return getLayout().mKeys[slot];
     }
 
-    void MagicEffects::add (const EffectKey& key, const EffectParam& param)
+    MagicEffects::MagicEffects()
     {
-        Collection::iterator iter = mCollection.find (key);
+        // make sure the arrays are sized to match getArgumentCount
+        (void) sizeof (char[sSlots == ESM::MagicEffect::Length
+            + 5 * (ESM::Attribute::Length - 1) + 5 * (ESM::Skill::Length - 1) ? 1 : -1]);
 
-        if (iter==mCollection.end())
+        std::fill (mPresent, mPresent+sSlots, false);
+    }
+
+    MagicEffects::const_iterator MagicEffects::begin() const
+    {
+        return const_iterator (this, 0, mOther.begin());
+    }
+
+    MagicEffects::const_iterator MagicEffects::end() const
+    {
+        return const_iterator (this, sSlots, mOther.end());
+    }
+
+    void MagicEffects::remove(const EffectKey &key)
+    {
+        int slot = getSlot (key);
+
+        if (slot==-1)
         {
-            mCollection.insert (std::make_pair (key, param));
+            mOther.erase(key);
+            return;
         }
-        else
+
+        mParams[slot] = EffectParam();
+        mPresent[slot] = false;
+    }
+
+    void MagicEffects::add (const EffectKey& key, const EffectParam& param)
+    {
+        int slot = getSlot (key);
+
+        if (slot==-1)
         {
-            iter->second += param;
+            Collection::iterator iter = mOther.find (key);
+
+            if (iter==mOther.end())
+            {
+                mOther.insert (std::make_pair (key, param));
+            }
+            else
+            {
+                iter->second += param;
+            }
+            return;
         }
+
+        mParams[slot] += param;
+        mPresent[slot] = true;
     }
 
     void MagicEffects::modifyBase(const EffectKey &key, int diff)
     {
-        mCollection[key].modifyBase(diff);
+        int slot = getSlot (key);
+
+        if (slot==-1)
+        {
+            mOther[key].modifyBase(diff);
+            return;
+        }
+
+        mParams[slot].modifyBase(diff);
+        mPresent[slot] = true;
     }
 
     void MagicEffects::setModifiers(const MagicEffects &effects)
     {
-        for (Collection::iterator it = mCollection.begin(); it != mCollection.end(); ++it)
+        for (int i=0; i<sSlots; ++i)
+        {
+            if (mPresent[i] || effects.mPresent[i])
+            {
+                mParams[i].setModifier(effects.mParams[i].getModifier());
+                mPresent[i] = true;
+            }
+        }
+
+        for (Collection::iterator it = mOther.begin(); it != mOther.end(); ++it)
         {
             it->second.setModifier(effects.get(it->first).getModifier());
         }
 
-        for (Collection::const_iterator it = effects.begin(); it != effects.end(); ++it)
+        for (Collection::const_iterator it = effects.mOther.begin(); it != effects.mOther.end(); ++it)
         {
-            mCollection[it->first].setModifier(it->second.getModifier());
+            mOther[it->first].setModifier(it->second.getModifier());
         }
     }
 
@@ -133,14 +268,23 @@ namespace MWMechanics
             return *this;
         }
 
-        for (Collection::const_iterator iter (effects.begin()); iter!=effects.end(); ++iter)
+        for (int i=0; i<sSlots; ++i)
+        {
+            if (effects.mPresent[i])
+            {
+                mParams[i] += effects.mParams[i];
+                mPresent[i] = true;
+            }
+        }
+
+        for (Collection::const_iterator iter (effects.mOther.begin()); iter!=effects.mOther.end(); ++iter)
         {
-            Collection::iterator result = mCollection.find (iter->first);
+            Collection::iterator result = mOther.find (iter->first);
 
-            if (result!=mCollection.end())
+            if (result!=mOther.end())
                 result->second += iter->second;
             else
-                mCollection.insert (*iter);
+                mOther.insert (*iter);
         }
 
         return *this;
@@ -148,9 +292,14 @@ namespace MWMechanics
 
     EffectParam MagicEffects::get (const EffectKey& key) const
     {
-        Collection::const_iterator iter = mCollection.find (key);
+        int slot = getSlot (key);
 
-        if (iter==mCollection.end())
+        if (slot!=-1)
+            return mParams[slot]; // empty slots are always default constructed
+
+        Collection::const_iterator iter = mOther.find (key);
+
+        if (iter==mOther.end())
         {
             return EffectParam();
         }
@@ -164,12 +313,22 @@ namespace MWMechanics
     {
         MagicEffects result;
 
+        for (int i=0; i<sSlots; ++i)
+        {
+            // adding/changing
+            if (now.mPresent[i])
+                result.add (getKey (i), now.mParams[i] - prev.mParams[i]);
+            // removing
+            else if (prev.mPresent[i])
+                result.add (getKey (i), EffectParam() - prev.mParams[i]);
+        }
+
         // adding/changing
-        for (Collection::const_iterator iter (now.begin()); iter!=now.end(); ++iter)
+        for (Collection::const_iterator iter (now.mOther.begin()); iter!=now.mOther.end(); ++iter)
         {
-            Collection::const_iterator other = prev.mCollection.find (iter->first);
+            Collection::const_iterator other = prev.mOther.find (iter->first);
 
-            if (other==prev.end())
+            if (other==prev.mOther.end())
             {
                 // adding
                 result.add (iter->first, iter->second);
@@ -182,10 +341,10 @@ namespace MWMechanics
         }
 
         // removing
-        for (Collection::const_iterator iter (prev.begin()); iter!=prev.end(); ++iter)
+        for (Collection::const_iterator iter (prev.mOther.begin()); iter!=prev.mOther.end(); ++iter)
         {
-            Collection::const_iterator other = now.mCollection.find (iter->first);
-            if (other==now.end())
+            Collection::const_iterator other = now.mOther.find (iter->first);
+            if (other==now.mOther.end())
             {
                 result.add (iter->first, EffectParam() - iter->second);
             }
@@ -197,7 +356,7 @@ namespace MWMechanics
     void MagicEffects::writeState(ESM::MagicEffects &state) const
     {
         // Don't need to save Modifiers, they are recalculated every frame anyway.
-        for (Collection::const_iterator iter (begin()); iter!=end(); ++iter)
+        for (const_iterator iter (begin()); iter!=end(); ++iter)
         {
             if (iter->second.getBase() != 0)
             {
@@ -211,7 +370,85 @@ namespace MWMechanics
     {
         for (std::map<int, int>::const_iterator it = state.mEffects.begin(); it != state.mEffects.end(); ++it)
         {
-            mCollection[EffectKey(it->first)].setBase(it->second);
+            EffectKey key (it->first);
+            EffectParam param = get (key);
+            param.setBase (it->second);
+            remove (key);
+            add (key, param);
+        }
+    }
+
+    MagicEffects::const_iterator::const_iterator()
+    : mEffects (0), mSlot (0)
+    {}
+
+    MagicEffects::const_iterator::const_iterator (const MagicEffects* effects, int slot,
+        Collection::const_iterator other)
+    : mEffects (effects), mSlot (slot), mOther (other)
+    {
+        skipEmpty();
+    }
+
+    void MagicEffects::const_iterator::skipEmpty()
+    {
+        while (mSlot<sSlots && !mEffects->mPresent[mSlot])
+            ++mSlot;
+    }
+
+    bool MagicEffects::const_iterator::isInSlot() const
+    {
+        // the slots are laid out in key order, so merging them with mOther keeps the whole sequence sorted
+        if (mSlot>=sSlots)
+            return false;
+
+        return mOther==mEffects->mOther.end() || getKey (mSlot) < mOther->first;
+    }
+
+    const std::pair<EffectKey, EffectParam>& MagicEffects::const_iterator::operator*() const
+    {
+        if (isInSlot())
+            mValue = std::make_pair (getKey (mSlot), mEffects->mParams[mSlot]);
+        else
+            mValue = *mOther;
+
+        return mValue;
+    }
+
+    const std::pair<EffectKey, EffectParam>* MagicEffects::const_iterator::operator->() const
+    {
+        return &**this;
+    }
+
+    MagicEffects::const_iterator& MagicEffects::const_iterator::operator++()
+    {
+        if (isInSlot())
+        {
+            ++mSlot;
+            skipEmpty();
         }
+        else
+            ++mOther;
+
+        return *this;
+    }
+
+    MagicEffects::const_iterator MagicEffects::const_iterator::operator++ (int)
+    {
+        const_iterator iter (*this);
+        ++*this;
+        return iter;
+    }
+
+    bool MagicEffects::const_iterator::operator== (const const_iterator& other) const
+    {
+        if (!mEffects || !other.mEffects)
+            return mEffects==other.mEffects;
+
+        return mSlot==other.mSlot && mOther==other.mOther;
+    }
+
+    bool MagicEffects::const_iterator::operator!= (const const_iterator& other) const
+    {
+        return !(*this==other);
     }
 }
@@ -1,8 +1,10 @@
 #ifndef GAME_MWMECHANICS_MAGICEFFECTS_H
 #define GAME_MWMECHANICS_MAGICEFFECTS_H
 
+#include <iterator>
 #include <map>
 #include <string>
+#include <utility>
 
 namespace ESM
 {
@@ -80,21 +82,76 @@ namespace MWMechanics
     };
 
     /// \brief Effects currently affecting a NPC or creature
+    ///
+    /// Effects are stored in a dense array with one slot per effect ID, and one slot per skill or
+    /// attribute for the effects that take one as argument, so that accumulating effects from many
+    /// sources is a linear pass over the array. Keys that don't fit that layout (e.g. an argument on an
+    /// effect that doesn't use one) are kept in a separate map.
     class MagicEffects
     {
         public:
 
-            typedef std::map<EffectKey, EffectParam> Collection;
+            class const_iterator;
 
         private:
 
-            Collection mCollection;
+            // one slot per effect, plus 5 effects with an attribute and 5 with a skill argument
+            static const int sSlots = 308;
+
+            EffectParam mParams[sSlots];
+            bool mPresent[sSlots];
+
+            typedef std::map<EffectKey, EffectParam> Collection;
+            Collection mOther;
+
+            static int getSlot (const EffectKey& key);
+            ///< @return -1 if \a key has no slot in the dense array
+
+            static EffectKey getKey (int slot);
 
         public:
 
-            Collection::const_iterator begin() const { return mCollection.begin(); }
+            /// Iterates over all effects present in key order, yielding std::pair<EffectKey, EffectParam>.
+            /// The dense slots and the separate map are merged on the fly.
+            ///
+            /// \note Removing the effect an iterator points to invalidates only that iterator.
+            class const_iterator
+                : public std::iterator<std::forward_iterator_tag, std::pair<EffectKey, EffectParam> >
+            {
+                    const MagicEffects* mEffects;
+                    int mSlot;
+                    Collection::const_iterator mOther;
+                    mutable std::pair<EffectKey, EffectParam> mValue;
+
+                    void skipEmpty();
+
+                    bool isInSlot() const;
+                    ///< Does the iterator point to a dense slot rather than to an entry of the separate map?
+
+                public:
+
+                    const_iterator();
+
+                    const_iterator (const MagicEffects* effects, int slot, Collection::const_iterator other);
+
+                    const std::pair<EffectKey, EffectParam>& operator*() const;
+
+                    const std::pair<EffectKey, EffectParam>* operator->() const;
+
+                    const_iterator& operator++();
+
+                    const_iterator operator++ (int);
+
+                    bool operator== (const const_iterator& other) const;
+
+                    bool operator!= (const const_iterator& other) const;
+            };
+
+            MagicEffects();
+
+            const_iterator begin() const;
 
-            Collection::const_iterator end() const { return mCollection.end(); }
+            const_iterator end() const;
 
             void readState (const ESM::MagicEffects& state);
             void writeState (ESM::MagicEffects& state) const;
@@ -37,31 +37,28 @@ namespace
 
         float d = (pos1 - pos2).length();
 
-        static const int iFightDistanceBase = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>().find(
-                    "iFightDistanceBase")->getInt();
-        static const float fFightDistanceMultiplier = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>().find(
-                    "fFightDistanceMultiplier")->getFloat();
+        const int iFightDistanceBase = MWBase::Environment::get().getWorld()->getStore().getGameSettings().get(MWWorld::GameSettings::iFightDistanceBase);
+        const float fFightDistanceMultiplier = MWBase::Environment::get().getWorld()->getStore().getGameSettings().get(MWWorld::GameSettings::fFightDistanceMultiplier);
 
         return (iFightDistanceBase - fFightDistanceMultiplier * d);
     }
 
     float getFightDispositionBias(float disposition)
     {
-        static const float fFightDispMult = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>().find(
-                    "fFightDispMult")->getFloat();
+        const float fFightDispMult = MWBase::Environment::get().getWorld()->getStore().getGameSettings().get(MWWorld::GameSettings::fFightDispMult);
         return ((50.f - disposition)  * fFightDispMult);
     }
 
     void getPersuasionRatings(const MWMechanics::NpcStats& stats, float& rating1, float& rating2, float& rating3, bool player)
     {
-        const MWWorld::Store<ESM::GameSetting> &gmst =
-            MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>();
+        const MWWorld::GameSettings &gmst =
+            MWBase::Environment::get().getWorld()->getStore().getGameSettings();
 
-        float persTerm = stats.getAttribute(ESM::Attribute::Personality).getModified() / gmst.find("fPersonalityMod")->getFloat();
-        float luckTerm = stats.getAttribute(ESM::Attribute::Luck).getModified() / gmst.find("fLuckMod")->getFloat();
-        float repTerm = stats.getReputation() * gmst.find("fReputationMod")->getFloat();
+        float persTerm = stats.getAttribute(ESM::Attribute::Personality).getModified() / gmst.get(MWWorld::GameSettings::fPersonalityMod);
+        float luckTerm = stats.getAttribute(ESM::Attribute::Luck).getModified() / gmst.get(MWWorld::GameSettings::fLuckMod);
+        float repTerm = stats.getReputation() * gmst.get(MWWorld::GameSettings::fReputationMod);
         float fatigueTerm = stats.getFatigueTerm();
-        float levelTerm = stats.getLevel() * gmst.find("fLevelMod")->getFloat();
+        float levelTerm = stats.getLevel() * gmst.get(MWWorld::GameSettings::fLevelMod);
 
         rating1 = (repTerm + luckTerm + persTerm + stats.getSkill(ESM::Skill::Speechcraft).getModified()) * fatigueTerm;
 
@@ -213,7 +210,7 @@ namespace MWMechanics
         }
 
         // F_PCStart spells
-        static const float fPCbaseMagickaMult = esmStore.get<ESM::GameSetting>().find("fPCbaseMagickaMult")->getFloat();
+        const float fPCbaseMagickaMult = esmStore.getGameSettings().get(MWWorld::GameSettings::fPCbaseMagickaMult);
 
         float baseMagicka = fPCbaseMagickaMult * creatureStats.getAttribute(ESM::Attribute::Intelligence).getBase();
         bool reachedLimit = false;
@@ -251,7 +248,7 @@ namespace MWMechanics
             if (baseMagicka < spell->mData.mCost)
                 continue;
 
-            static const float fAutoPCSpellChance = esmStore.get<ESM::GameSetting>().find("fAutoPCSpellChance")->getFloat();
+            const float fAutoPCSpellChance = esmStore.getGameSettings().get(MWWorld::GameSettings::fAutoPCSpellChance);
             if (calcAutoCastChance(spell, skills, attributes, -1) < fAutoPCSpellChance)
                 continue;
 
@@ -284,7 +281,7 @@ namespace MWMechanics
                     weakestSpell = spell;
                     minCost = weakestSpell->mData.mCost;
                 }
-                static const unsigned int iAutoPCSpellMax = esmStore.get<ESM::GameSetting>().find("iAutoPCSpellMax")->getInt();
+                const unsigned int iAutoPCSpellMax = esmStore.getGameSettings().get(MWWorld::GameSettings::iAutoPCSpellMax);
                 if (selectedSpells.size() == iAutoPCSpellMax)
                     reachedLimit = true;
             }
@@ -404,8 +401,7 @@ namespace MWMechanics
 
             if(stats.getTimeToStartDrowning() != mWatchedStats.getTimeToStartDrowning())
             {
-                const float fHoldBreathTime = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>()
-                        .find("fHoldBreathTime")->getFloat();
+                const float fHoldBreathTime = MWBase::Environment::get().getWorld()->getStore().getGameSettings().get(MWWorld::GameSettings::fHoldBreathTime);
                 mWatchedStats.setTimeToStartDrowning(stats.getTimeToStartDrowning());
                 if(stats.getTimeToStartDrowning() >= fHoldBreathTime)
                     winMgr->setDrowningBarVisibility(false);
@@ -590,13 +586,13 @@ namespace MWMechanics
         MWWorld::LiveCellRef<ESM::NPC>* player = playerPtr.get<ESM::NPC>();
         const MWMechanics::NpcStats &playerStats = playerPtr.getClass().getNpcStats(playerPtr);
 
-        const MWWorld::Store<ESM::GameSetting>& gmst = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>();
-        static const float fDispRaceMod = gmst.find("fDispRaceMod")->getFloat();
+        const MWWorld::GameSettings& gmst = MWBase::Environment::get().getWorld()->getStore().getGameSettings();
+        const float fDispRaceMod = gmst.get(MWWorld::GameSettings::fDispRaceMod);
         if (Misc::StringUtils::ciEqual(npc->mBase->mRace, player->mBase->mRace))
             x += fDispRaceMod;
 
-        static const float fDispPersonalityMult = gmst.find("fDispPersonalityMult")->getFloat();
-        static const float fDispPersonalityBase = gmst.find("fDispPersonalityBase")->getFloat();
+        const float fDispPersonalityMult = gmst.get(MWWorld::GameSettings::fDispPersonalityMult);
+        const float fDispPersonalityBase = gmst.get(MWWorld::GameSettings::fDispPersonalityBase);
         x += fDispPersonalityMult * (playerStats.getAttribute(ESM::Attribute::Personality).getModified() - fDispPersonalityBase);
 
         float reaction = 0;
@@ -633,20 +629,20 @@ namespace MWMechanics
             rank = 0;
         }
 
-        static const float fDispFactionRankMult = gmst.find("fDispFactionRankMult")->getFloat();
-        static const float fDispFactionRankBase = gmst.find("fDispFactionRankBase")->getFloat();
-        static const float fDispFactionMod = gmst.find("fDispFactionMod")->getFloat();
+        const float fDispFactionRankMult = gmst.get(MWWorld::GameSettings::fDispFactionRankMult);
+        const float fDispFactionRankBase = gmst.get(MWWorld::GameSettings::fDispFactionRankBase);
+        const float fDispFactionMod = gmst.get(MWWorld::GameSettings::fDispFactionMod);
         x += (fDispFactionRankMult * rank
             + fDispFactionRankBase)
             * fDispFactionMod * reaction;
 
-        static const float fDispCrimeMod = gmst.find("fDispCrimeMod")->getFloat();
-        static const float fDispDiseaseMod = gmst.find("fDispDiseaseMod")->getFloat();
+        const float fDispCrimeMod = gmst.get(MWWorld::GameSettings::fDispCrimeMod);
+        const float fDispDiseaseMod = gmst.get(MWWorld::GameSettings::fDispDiseaseMod);
         x -= fDispCrimeMod * playerStats.getBounty();
         if (playerStats.hasCommonDisease() || playerStats.hasBlightDisease())
             x += fDispDiseaseMod;
 
-        static const float fDispWeaponDrawn = gmst.find("fDispWeaponDrawn")->getFloat();
+        const float fDispWeaponDrawn = gmst.get(MWWorld::GameSettings::fDispWeaponDrawn);
         if (playerStats.getDrawState() == MWMechanics::DrawState_Weapon)
             x += fDispWeaponDrawn;
 
@@ -702,8 +698,8 @@ namespace MWMechanics
     void MechanicsManager::getPersuasionDispositionChange (const MWWorld::Ptr& npc, PersuasionType type,
         float currentTemporaryDispositionDelta, bool& success, float& tempChange, float& permChange)
     {
-        const MWWorld::Store<ESM::GameSetting> &gmst =
-            MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>();
+        const MWWorld::GameSettings &gmst =
+            MWBase::Environment::get().getWorld()->getStore().getGameSettings();
 
         MWMechanics::NpcStats& npcStats = npc.getClass().getNpcStats(npc);
 
@@ -723,16 +719,16 @@ namespace MWMechanics
         float target2 = d * (playerRating2 - npcRating2 + 50);
 
         float bribeMod;
-        if (type == PT_Bribe10) bribeMod = gmst.find("fBribe10Mod")->getFloat();
-        else if (type == PT_Bribe100) bribeMod = gmst.find("fBribe100Mod")->getFloat();
-        else bribeMod = gmst.find("fBribe1000Mod")->getFloat();
+        if (type == PT_Bribe10) bribeMod = gmst.get(MWWorld::GameSettings::fBribe10Mod);
+        else if (type == PT_Bribe100) bribeMod = gmst.get(MWWorld::GameSettings::fBribe100Mod);
+        else bribeMod = gmst.get(MWWorld::GameSettings::fBribe1000Mod);
 
         float target3 = d * (playerRating3 - npcRating3 + 50) + bribeMod;
 
-        float iPerMinChance = floor(gmst.find("iPerMinChance")->getFloat());
-        float iPerMinChange = floor(gmst.find("iPerMinChange")->getFloat());
-        float fPerDieRollMult = gmst.find("fPerDieRollMult")->getFloat();
-        float fPerTempMult = gmst.find("fPerTempMult")->getFloat();
+        float iPerMinChance = static_cast<float>(gmst.get(MWWorld::GameSettings::iPerMinChance));
+        float iPerMinChange = static_cast<float>(gmst.get(MWWorld::GameSettings::iPerMinChange));
+        float fPerDieRollMult = gmst.get(MWWorld::GameSettings::fPerDieRollMult);
+        float fPerTempMult = gmst.get(MWWorld::GameSettings::fPerTempMult);
 
         float x = 0;
         float y = 0;
@@ -1075,7 +1071,7 @@ namespace MWMechanics
 
         osg::Vec3f from (player.getRefData().getPosition().asVec3());
         const MWWorld::ESMStore& esmStore = MWBase::Environment::get().getWorld()->getStore();
-        float radius = esmStore.get<ESM::GameSetting>().find("fAlarmRadius")->getFloat();
+        float radius = esmStore.getGameSettings().get(MWWorld::GameSettings::fAlarmRadius);
 
         mActors.getObjectsInRange(from, radius, neighbors);
 
@@ -1130,7 +1126,7 @@ namespace MWMechanics
 
     void MechanicsManager::reportCrime(const MWWorld::Ptr &player, const MWWorld::Ptr &victim, OffenseType type, int arg)
     {
-        const MWWorld::Store<ESM::GameSetting>& store = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>();
+        const MWWorld::GameSettings& gmst = MWBase::Environment::get().getWorld()->getStore().getGameSettings();
 
         if (type == OT_Murder && !victim.isEmpty())
             victim.getClass().getCreatureStats(victim).notifyMurder();
@@ -1139,29 +1135,29 @@ namespace MWMechanics
         float disp = 0.f, dispVictim = 0.f;
         if (type == OT_Trespassing || type == OT_SleepingInOwnedBed)
         {
-            arg = store.find("iCrimeTresspass")->getInt();
-            disp = dispVictim = store.find("iDispTresspass")->getFloat();
+            arg = gmst.get(MWWorld::GameSettings::iCrimeTresspass);
+            disp = dispVictim = gmst.get(MWWorld::GameSettings::iDispTresspass);
         }
         else if (type == OT_Pickpocket)
         {
-            arg = store.find("iCrimePickPocket")->getInt();
-            disp = dispVictim = store.find("fDispPickPocketMod")->getFloat();
+            arg = gmst.get(MWWorld::GameSettings::iCrimePickPocket);
+            disp = dispVictim = gmst.get(MWWorld::GameSettings::fDispPickPocketMod);
         }
         else if (type == OT_Assault)
         {
-            arg = store.find("iCrimeAttack")->getInt();
-            disp = store.find("iDispAttackMod")->getFloat();
-            dispVictim = store.find("fDispAttacking")->getFloat();
+            arg = gmst.get(MWWorld::GameSettings::iCrimeAttack);
+            disp = gmst.get(MWWorld::GameSettings::iDispAttackMod);
+            dispVictim = gmst.get(MWWorld::GameSettings::fDispAttacking);
         }
         else if (type == OT_Murder)
         {
-            arg = store.find("iCrimeKilling")->getInt();
-            disp = dispVictim = store.find("iDispKilling")->getFloat();
+            arg = gmst.get(MWWorld::GameSettings::iCrimeKilling);
+            disp = dispVictim = gmst.get(MWWorld::GameSettings::iDispKilling);
         }
         else if (type == OT_Theft)
         {
-            disp = dispVictim = store.find("fDispStealing")->getFloat() * arg;
-            arg = static_cast<int>(arg * store.find("fCrimeStealing")->getFloat());
+            disp = dispVictim = gmst.get(MWWorld::GameSettings::fDispStealing) * arg;
+            arg = static_cast<int>(arg * gmst.get(MWWorld::GameSettings::fCrimeStealing));
             arg = std::max(1, arg); // Minimum bounty of 1, in case items with zero value are stolen
         }
 
@@ -1171,7 +1167,7 @@ namespace MWMechanics
         const MWWorld::ESMStore& esmStore = MWBase::Environment::get().getWorld()->getStore();
 
         osg::Vec3f from (player.getRefData().getPosition().asVec3());
-        float radius = esmStore.get<ESM::GameSetting>().find("fAlarmRadius")->getFloat();
+        float radius = esmStore.getGameSettings().get(MWWorld::GameSettings::fAlarmRadius);
 
         mActors.getObjectsInRange(from, radius, neighbors);
 
@@ -1185,21 +1181,21 @@ namespace MWMechanics
         // Controls whether witnesses will engage combat with the criminal.
         int fight = 0, fightVictim = 0;
         if (type == OT_Trespassing || type == OT_SleepingInOwnedBed)
-            fight = fightVictim = esmStore.get<ESM::GameSetting>().find("iFightTrespass")->getInt();
+            fight = fightVictim = esmStore.getGameSettings().get(MWWorld::GameSettings::iFightTrespass);
         else if (type == OT_Pickpocket)
         {
-            fight = esmStore.get<ESM::GameSetting>().find("iFightPickpocket")->getInt();
-            fightVictim = esmStore.get<ESM::GameSetting>().find("iFightPickpocket")->getInt() * 4; // *4 according to research wiki
+            fight = esmStore.getGameSettings().get(MWWorld::GameSettings::iFightPickpocket);
+            fightVictim = esmStore.getGameSettings().get(MWWorld::GameSettings::iFightPickpocket) * 4; // *4 according to research wiki
         }
         else if (type == OT_Assault)
         {
-            fight = esmStore.get<ESM::GameSetting>().find("iFightAttacking")->getInt();
-            fightVictim = esmStore.get<ESM::GameSetting>().find("iFightAttack")->getInt();
+            fight = esmStore.getGameSettings().get(MWWorld::GameSettings::iFightAttacking);
+            fightVictim = esmStore.getGameSettings().get(MWWorld::GameSettings::iFightAttack);
         }
         else if (type == OT_Murder)
-            fight = fightVictim = esmStore.get<ESM::GameSetting>().find("iFightKilling")->getInt();
+            fight = fightVictim = esmStore.getGameSettings().get(MWWorld::GameSettings::iFightKilling);
         else if (type == OT_Theft)
-            fight = fightVictim = esmStore.get<ESM::GameSetting>().find("fFightStealing")->getInt();
+            fight = fightVictim = static_cast<int>(esmStore.getGameSettings().get(MWWorld::GameSettings::fFightStealing));
 
         bool reported = false;
 
@@ -1376,7 +1372,7 @@ namespace MWMechanics
         if (observer.getClass().getCreatureStats(observer).isDead() || !observer.getRefData().isEnabled())
             return false;
 
-        const MWWorld::Store<ESM::GameSetting>& store = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>();
+        const MWWorld::GameSettings& gmst = MWBase::Environment::get().getWorld()->getStore().getGameSettings();
 
         CreatureStats& stats = ptr.getClass().getCreatureStats(ptr);
 
@@ -1389,8 +1385,8 @@ namespace MWMechanics
                 && !MWBase::Environment::get().getWorld()->isSwimming(ptr)
                 && MWBase::Environment::get().getWorld()->isOnGround(ptr))
         {
-            static float fSneakSkillMult = store.find("fSneakSkillMult")->getFloat();
-            static float fSneakBootMult = store.find("fSneakBootMult")->getFloat();
+            float fSneakSkillMult = gmst.get(MWWorld::GameSettings::fSneakSkillMult);
+            float fSneakBootMult = gmst.get(MWWorld::GameSettings::fSneakBootMult);
             float sneak = static_cast<float>(ptr.getClass().getSkill(ptr, ESM::Skill::Sneak));
             int agility = stats.getAttribute(ESM::Attribute::Agility).getModified();
             int luck = stats.getAttribute(ESM::Attribute::Luck).getModified();
@@ -1405,8 +1401,8 @@ namespace MWMechanics
             sneakTerm = fSneakSkillMult * sneak + 0.2f * agility + 0.1f * luck + bootWeight * fSneakBootMult;
         }
 
-        static float fSneakDistBase = store.find("fSneakDistanceBase")->getFloat();
-        static float fSneakDistMult = store.find("fSneakDistanceMultiplier")->getFloat();
+        float fSneakDistBase = gmst.get(MWWorld::GameSettings::fSneakDistanceBase);
+        float fSneakDistMult = gmst.get(MWWorld::GameSettings::fSneakDistanceMultiplier);
 
         osg::Vec3f pos1 (ptr.getRefData().getPosition().asVec3());
         osg::Vec3f pos2 (observer.getRefData().getPosition().asVec3());
@@ -1424,8 +1420,8 @@ namespace MWMechanics
         float obsTerm = obsSneak + 0.2f * obsAgility + 0.1f * obsLuck - obsBlind;
 
         // is ptr behind the observer?
-        static float fSneakNoViewMult = store.find("fSneakNoViewMult")->getFloat();
-        static float fSneakViewMult = store.find("fSneakViewMult")->getFloat();
+        float fSneakNoViewMult = gmst.get(MWWorld::GameSettings::fSneakNoViewMult);
+        float fSneakViewMult = gmst.get(MWWorld::GameSettings::fSneakViewMult);
         float y = 0;
         osg::Vec3f vec = pos1 - pos2;
         if (observer.getRefData().getBaseNode())
@@ -153,15 +153,15 @@ float MWMechanics::NpcStats::getSkillProgressRequirement (int skillIndex, const
 {
     float progressRequirement = static_cast<float>(1 + getSkill(skillIndex).getBase());
 
-    const MWWorld::Store<ESM::GameSetting> &gmst =
-        MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>();
+    const MWWorld::GameSettings &gmst =
+        MWBase::Environment::get().getWorld()->getStore().getGameSettings();
 
-    float typeFactor = gmst.find ("fMiscSkillBonus")->getFloat();
+    float typeFactor = gmst.get(MWWorld::GameSettings::fMiscSkillBonus);
 
     for (int i=0; i<5; ++i)
         if (class_.mData.mSkills[i][0]==skillIndex)
         {
-            typeFactor = gmst.find ("fMinorSkillBonus")->getFloat();
+            typeFactor = gmst.get(MWWorld::GameSettings::fMinorSkillBonus);
 
             break;
         }
@@ -169,7 +169,7 @@ float MWMechanics::NpcStats::getSkillProgressRequirement (int skillIndex, const
     for (int i=0; i<5; ++i)
         if (class_.mData.mSkills[i][1]==skillIndex)
         {
-            typeFactor = gmst.find ("fMajorSkillBonus")->getFloat();
+            typeFactor = gmst.get(MWWorld::GameSettings::fMajorSkillBonus);
 
             break;
         }
@@ -185,7 +185,7 @@ float MWMechanics::NpcStats::getSkillProgressRequirement (int skillIndex, const
         MWBase::Environment::get().getWorld()->getStore().get<ESM::Skill>().find (skillIndex);
     if (skill->mData.mSpecialization==class_.mData.mSpecialization)
     {
-        specialisationFactor = gmst.find ("fSpecialSkillBonus")->getFloat();
+        specialisationFactor = gmst.get(MWWorld::GameSettings::fSpecialSkillBonus);
 
         if (specialisationFactor<=0)
             throw std::runtime_error ("invalid skill specialisation factor");
@@ -230,25 +230,25 @@ void MWMechanics::NpcStats::increaseSkill(int skillIndex, const ESM::Class &clas
 
     base += 1;
 
-    const MWWorld::Store<ESM::GameSetting> &gmst =
-        MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>();
+    const MWWorld::GameSettings &gmst =
+        MWBase::Environment::get().getWorld()->getStore().getGameSettings();
 
     // is this a minor or major skill?
-    int increase = gmst.find("iLevelupMiscMultAttriubte")->getInt(); // Note: GMST has a typo
+    int increase = gmst.get(MWWorld::GameSettings::iLevelupMiscMultAttriubte); // Note: GMST has a typo
     for (int k=0; k<5; ++k)
     {
         if (class_.mData.mSkills[k][0] == skillIndex)
         {
-            mLevelProgress += gmst.find("iLevelUpMinorMult")->getInt();
-            increase = gmst.find("iLevelUpMajorMultAttribute")->getInt();
+            mLevelProgress += gmst.get(MWWorld::GameSettings::iLevelUpMinorMult);
+            increase = gmst.get(MWWorld::GameSettings::iLevelUpMajorMultAttribute);
         }
     }
     for (int k=0; k<5; ++k)
     {
         if (class_.mData.mSkills[k][1] == skillIndex)
         {
-            mLevelProgress += gmst.find("iLevelUpMajorMult")->getInt();
-            increase = gmst.find("iLevelUpMinorMultAttribute")->getInt();
+            mLevelProgress += gmst.get(MWWorld::GameSettings::iLevelUpMajorMult);
+            increase = gmst.get(MWWorld::GameSettings::iLevelUpMinorMultAttribute);
         }
     }
 
@@ -266,7 +266,7 @@ void MWMechanics::NpcStats::increaseSkill(int skillIndex, const ESM::Class &clas
                % static_cast<int> (base);
     MWBase::Environment::get().getWindowManager ()->messageBox(message.str(), MWGui::ShowInDialogueMode_Never);
 
-    if (mLevelProgress >= gmst.find("iLevelUpTotal")->getInt())
+    if (mLevelProgress >= gmst.get(MWWorld::GameSettings::iLevelUpTotal))
     {
         // levelup is possible now
         MWBase::Environment::get().getWindowManager ()->messageBox ("#{sLevelUpMsg}", MWGui::ShowInDialogueMode_Never);
@@ -284,10 +284,10 @@ int MWMechanics::NpcStats::getLevelProgress () const
 
 void MWMechanics::NpcStats::levelUp()
 {
-    const MWWorld::Store<ESM::GameSetting> &gmst =
-        MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>();
+    const MWWorld::GameSettings &gmst =
+        MWBase::Environment::get().getWorld()->getStore().getGameSettings();
 
-    mLevelProgress -= gmst.find("iLevelUpTotal")->getInt();
+    mLevelProgress -= gmst.get(MWWorld::GameSettings::iLevelUpTotal);
     mLevelProgress = std::max(0, mLevelProgress); // might be necessary when levelup was invoked via console
 
     for (int i=0; i<ESM::Attribute::Length; ++i)
@@ -298,7 +298,7 @@ void MWMechanics::NpcStats::levelUp()
     // "When you gain a level, in addition to increasing three primary attributes, your Health
     // will automatically increase by 10% of your Endurance attribute. If you increased Endurance this level,
     // the Health increase is calculated from the increased Endurance"
-    setHealth(getHealth().getBase() + endurance * gmst.find("fLevelUpHealthEndMult")->getFloat());
+    setHealth(getHealth().getBase() + endurance * gmst.get(MWWorld::GameSettings::fLevelUpHealthEndMult));
 
     setLevel(getLevel()+1);
 }
@@ -6,73 +6,22 @@
 #include "../mwworld/esmstore.hpp"
 #include "../mwworld/cellstore.hpp"
 
+#include "hierarchicalpathgrid.hpp"
+
 namespace
 {
-    // Slightly cheaper version for comparisons.
-    // Caller needs to be careful for very short distances (i.e. less than 1)
-    // or when accumuating the results i.e. (a + b)^2 != a^2 + b^2
-    //
-    float distanceSquared(ESM::Pathgrid::Point point, const osg::Vec3f& pos)
-    {
-        return (MWMechanics::PathFinder::MakeOsgVec3(point) - pos).length2();
-    }
-
-    // Return the closest pathgrid point index from the specified position co
-    // -ordinates.  NOTE: Does not check if there is a sensible way to get there
-    // (e.g. a cliff in front).
-    //
-    // NOTE: pos is expected to be in local co-ordinates, as is grid->mPoints
-    //
-    int getClosestPoint(const ESM::Pathgrid* grid, const osg::Vec3f& pos)
-    {
-        if(!grid || grid->mPoints.empty())
-            return -1;
-
-        float distanceBetween = distanceSquared(grid->mPoints[0], pos);
-        int closestIndex = 0;
-
-        // TODO: if this full scan causes performance problems mapping pathgrid
-        //       points to a quadtree may help
-        for(unsigned int counter = 1; counter < grid->mPoints.size(); counter++)
-        {
-            float potentialDistBetween = distanceSquared(grid->mPoints[counter], pos);
-            if(potentialDistBetween < distanceBetween)
-            {
-                distanceBetween = potentialDistBetween;
-                closestIndex = counter;
-            }
-        }
-
-        return closestIndex;
-    }
-
     // Chooses a reachable end pathgrid point.  start is assumed reachable.
-    std::pair<int, bool> getClosestReachablePoint(const ESM::Pathgrid* grid,
-                                                  const MWWorld::CellStore *cell,
+    //
+    // NOTE: pos is expected to be in local co-ordinates
+    std::pair<int, bool> getClosestReachablePoint(const MWMechanics::PathgridGraph& graph,
                                                   const osg::Vec3f pos, int start)
     {
-        if(!grid || grid->mPoints.empty())
+        int closestIndex = graph.getClosestPoint(pos);
+        if(closestIndex == -1)
             return std::pair<int, bool> (-1, false);
 
-        float distanceBetween = distanceSquared(grid->mPoints[0], pos);
-        int closestIndex = 0;
-        int closestReachableIndex = 0;
-        // TODO: if this full scan causes performance problems mapping pathgrid
-        //       points to a quadtree may help
-        for(unsigned int counter = 1; counter < grid->mPoints.size(); counter++)
-        {
-            float potentialDistBetween = distanceSquared(grid->mPoints[counter], pos);
-            if(potentialDistBetween < distanceBetween)
-            {
-                // found a closer one
-                distanceBetween = potentialDistBetween;
-                closestIndex = counter;
-                if (cell->isPointConnected(start, counter))
-                {
-                    closestReachableIndex = counter;
-                }
-            }
-        }
+        int closestReachableIndex = graph.getClosestPoint(pos, graph.getComponentId(start));
+
         // AiWander has logic that depends on whether a path was created, deleting
         // allowed nodes if not.  Hence a path needs to be created even if the start
         // and the end points are the same.
@@ -201,6 +150,21 @@ namespace MWMechanics
         {
             xCell = static_cast<float>(mCell->getCell()->mData.mX * ESM::Land::REAL_SIZE);
             yCell = static_cast<float>(mCell->getCell()->mData.mY * ESM::Land::REAL_SIZE);
+
+            // If the destination is in another exterior cell, try to find a path
+            // through the pathgrids of the cells in between
+            int endCellX = static_cast<int>(std::floor(endPoint.mX / static_cast<float>(ESM::Land::REAL_SIZE)));
+            int endCellY = static_cast<int>(std::floor(endPoint.mY / static_cast<float>(ESM::Land::REAL_SIZE)));
+            if (endCellX != mCell->getCell()->mData.mX || endCellY != mCell->getCell()->mData.mY)
+            {
+                mPath = MWBase::Environment::get().getWorld()->getHierarchicalPathgrid().findPath(
+                            MakeOsgVec3(startPoint), MakeOsgVec3(endPoint));
+                if (!mPath.empty())
+                {
+                    mPath.push_back(endPoint);
+                    return;
+                }
+            }
         }
 
         // NOTE: It is possible that getClosestPoint returns a pathgrind point index
@@ -208,12 +172,13 @@ namespace MWMechanics
         //       outside an area enclosed by walls, but there is a pathgrid
         //       point right behind the wall that is closer than any pathgrid
         //       point outside the wall
-        int startNode = getClosestPoint(mPathgrid,
+        const PathgridGraph& graph = mCell->getPathgridGraph();
+        int startNode = graph.getClosestPoint(
                 osg::Vec3f(startPoint.mX - xCell, startPoint.mY - yCell, static_cast<float>(startPoint.mZ)));
         // Some cells don't have any pathgrids at all
         if(startNode != -1)
         {
-            std::pair<int, bool> endNode = getClosestReachablePoint(mPathgrid, cell,
+            std::pair<int, bool> endNode = getClosestReachablePoint(graph,
                 osg::Vec3f(endPoint.mX - xCell, endPoint.mY - yCell, static_cast<float>(endPoint.mZ)),
                     startNode);
 
@@ -1,10 +1,12 @@
 #include "pathgrid.hpp"
 
-#include "../mwbase/world.hpp"
-#include "../mwbase/environment.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
 
-#include "../mwworld/cellstore.hpp"
-#include "../mwworld/esmstore.hpp"
+#include <components/esm/loadcell.hpp>
+#include <components/esm/loadland.hpp>
 
 namespace
 {
@@ -45,6 +47,18 @@ namespace
         //return distance(a, b);
         return manhattan(a, b);
     }
+
+    float distanceSquared(const ESM::Pathgrid::Point& point, const osg::Vec3f& pos)
+    {
+        return (osg::Vec3f(static_cast<float>(point.mX), static_cast<float>(point.mY), static_cast<float>(point.mZ)) - pos).length2();
+    }
+
+    // Size of a bucket of the spatial index, in units. Exterior pathgrids are
+    // thereby split into 8 x 8 buckets.
+    const float sBucketSize = 1024.f;
+    // Upper limit for the number of buckets along each axis, for interiors
+    // with far apart points
+    const int sMaxBuckets = 64;
 }
 
 namespace MWMechanics
@@ -55,6 +69,11 @@ namespace MWMechanics
         , mIsExterior(0)
         , mGraph(0)
         , mIsGraphConstructed(false)
+        , mBucketSize(sBucketSize)
+        , mBucketsMinX(0)
+        , mBucketsMinY(0)
+        , mBucketsX(0)
+        , mBucketsY(0)
         , mSCCId(0)
         , mSCCIndex(0)
     {
@@ -96,17 +115,14 @@ namespace MWMechanics
      *    +---------------->
      *      high cost
      */
-    bool PathgridGraph::load(const MWWorld::CellStore *cell)
+    bool PathgridGraph::load(const ESM::Cell *cell, const ESM::Pathgrid *pathgrid)
     {
-        if(!cell)
-            return false;
-
         if(mIsGraphConstructed)
             return true;
 
-        mCell = cell->getCell();
-        mIsExterior = cell->getCell()->isExterior();
-        mPathgrid = MWBase::Environment::get().getWorld()->getStore().get<ESM::Pathgrid>().search(*cell->getCell());
+        mCell = cell;
+        mIsExterior = cell->isExterior();
+        mPathgrid = pathgrid;
         if(!mPathgrid)
             return false;
 
@@ -126,10 +142,109 @@ namespace MWMechanics
             //mGraph[mPathgrid->mEdges[i].mV1].edges.push_back(neighbour);
         }
         buildConnectedPoints();
+        buildBuckets();
         mIsGraphConstructed = true;
         return true;
     }
 
+    void PathgridGraph::buildBuckets()
+    {
+        const ESM::Pathgrid::PointList& points = mPathgrid->mPoints;
+        if (points.empty())
+            return;
+
+        float minX = static_cast<float>(points[0].mX), maxX = minX;
+        float minY = static_cast<float>(points[0].mY), maxY = minY;
+        for (ESM::Pathgrid::PointList::const_iterator it = points.begin(); it != points.end(); ++it)
+        {
+            minX = std::min(minX, static_cast<float>(it->mX));
+            maxX = std::max(maxX, static_cast<float>(it->mX));
+            minY = std::min(minY, static_cast<float>(it->mY));
+            maxY = std::max(maxY, static_cast<float>(it->mY));
+        }
+
+        mBucketSize = std::max(sBucketSize, std::max(maxX - minX, maxY - minY) / sMaxBuckets);
+        mBucketsMinX = minX;
+        mBucketsMinY = minY;
+        mBucketsX = static_cast<int>((maxX - minX) / mBucketSize) + 1;
+        mBucketsY = static_cast<int>((maxY - minY) / mBucketSize) + 1;
+        mBuckets.resize(mBucketsX * mBucketsY);
+
+        for (int i = 0; i < static_cast<int>(points.size()); ++i)
+        {
+            int x = std::min(mBucketsX-1, static_cast<int>((points[i].mX - mBucketsMinX) / mBucketSize));
+            int y = std::min(mBucketsY-1, static_cast<int>((points[i].mY - mBucketsMinY) / mBucketSize));
+            mBuckets[y * mBucketsX + x].push_back(i);
+        }
+    }
+
+    int PathgridGraph::getClosestPoint(const osg::Vec3f& pos, int componentId) const
+    {
+        if (mBuckets.empty())
+            return -1;
+
+        // the bucket containing pos, or the nearest one if pos is outside the grid
+        int centerX = static_cast<int>(std::floor((pos.x() - mBucketsMinX) / mBucketSize));
+        int centerY = static_cast<int>(std::floor((pos.y() - mBucketsMinY) / mBucketSize));
+        centerX = std::max(0, std::min(mBucketsX-1, centerX));
+        centerY = std::max(0, std::min(mBucketsY-1, centerY));
+
+        int closestIndex = -1;
+        float closestDistance = 0;
+
+        // Search the buckets in rings of increasing size around the center,
+        // until no bucket further out can contain a closer point
+        int maxRing = std::max(std::max(centerX, mBucketsX-1-centerX), std::max(centerY, mBucketsY-1-centerY));
+        for (int ring = 0; ring <= maxRing; ++ring)
+        {
+            for (int y = centerY-ring; y <= centerY+ring; ++y)
+            {
+                if (y < 0 || y >= mBucketsY)
+                    continue;
+                bool edgeRow = (y == centerY-ring || y == centerY+ring);
+                for (int x = centerX-ring; x <= centerX+ring; x += (edgeRow ? 1 : 2*ring))
+                {
+                    if (x >= 0 && x < mBucketsX)
+                    {
+                        const std::vector<int>& bucket = mBuckets[y * mBucketsX + x];
+                        for (std::vector<int>::const_iterator it = bucket.begin(); it != bucket.end(); ++it)
+                        {
+                            if (componentId != -1 && mGraph[*it].componentId != componentId)
+                                continue;
+                            float dist = distanceSquared(mPathgrid->mPoints[*it], pos);
+                            if (closestIndex == -1 || dist < closestDistance)
+                            {
+                                closestIndex = *it;
+                                closestDistance = dist;
+                            }
+                        }
+                    }
+                    if (ring == 0)
+                        break;
+                }
+            }
+
+            if (closestIndex != -1)
+            {
+                // anything outside of the searched square is at least this far away
+                float left = pos.x() - (mBucketsMinX + (centerX-ring) * mBucketSize);
+                float right = (mBucketsMinX + (centerX+ring+1) * mBucketSize) - pos.x();
+                float bottom = pos.y() - (mBucketsMinY + (centerY-ring) * mBucketSize);
+                float top = (mBucketsMinY + (centerY+ring+1) * mBucketSize) - pos.y();
+                float bound = std::min(std::min(left, right), std::min(bottom, top));
+                if (bound > 0 && bound * bound >= closestDistance)
+                    break;
+            }
+        }
+
+        return closestIndex;
+    }
+
+    int PathgridGraph::getComponentId(const int point) const
+    {
+        return mGraph[point].componentId;
+    }
+
     // v is the pathgrid point index (some call them vertices)
     void PathgridGraph::recursiveStrongConnect(int v)
     {
@@ -231,10 +346,11 @@ namespace MWMechanics
      *   start, goal - pathgrid point indexes (for this cell)
      *
      * Variables:
-     *   openset - point indexes to be traversed, lowest cost at the front
-     *   closedset - point indexes already traversed
+     *   openset - binary heap of (estimated total cost, point index) pairs to be
+     *             traversed, lowest cost at the top. A point may be pushed again
+     *             when a cheaper way to it is found; stale entries are skipped.
+     *   closedset - whether a point index has already been traversed
      *   gScore - past accumulated costs vector indexed by point index
-     *   fScore - future estimated costs vector indexed by point index
      *
      * TODO: An intersting exercise might be to cache the paths created for a
      *       start/goal pair.  To cache the results the paths need to be in
@@ -252,60 +368,46 @@ namespace MWMechanics
 
         int graphSize = static_cast<int> (mGraph.size());
         std::vector<float> gScore (graphSize, -1);
-        std::vector<float> fScore (graphSize, -1);
         std::vector<int> graphParent (graphSize, -1);
+        std::vector<bool> closedset (graphSize, false);
 
-        // gScore & fScore keep costs for each pathgrid point in mPoints
-        gScore[start] = 0;
-        fScore[start] = costAStar(mPathgrid->mPoints[start], mPathgrid->mPoints[goal]);
+        typedef std::pair<float, int> OpenEntry;
+        std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry> > openset;
 
-        std::list<int> openset;
-        std::list<int> closedset;
-        openset.push_back(start);
+        // gScore keeps costs for each pathgrid point in mPoints
+        gScore[start] = 0;
+        openset.push(OpenEntry(costAStar(mPathgrid->mPoints[start], mPathgrid->mPoints[goal]), start));
 
         int current = -1;
 
         while(!openset.empty())
         {
-            current = openset.front(); // front has the lowest cost
-            openset.pop_front();
+            current = openset.top().second; // top has the lowest cost
+            openset.pop();
 
             if(current == goal)
                 break;
 
-            closedset.push_back(current); // remember we've been here
+            if(closedset[current])
+                continue; // stale entry, we already found a cheaper way here
+
+            closedset[current] = true; // remember we've been here
 
             // check all edges for the current point index
             for(int j = 0; j < static_cast<int> (mGraph[current].edges.size()); j++)
             {
-                if(std::find(closedset.begin(), closedset.end(), mGraph[current].edges[j].index) ==
-                   closedset.end())
+                int dest = mGraph[current].edges[j].index;
+                if(closedset[dest])
+                    continue; // traversed this edge destination already, try the next edge
+
+                float tentative_g = gScore[current] + mGraph[current].edges[j].cost;
+                if(gScore[dest] < 0 || tentative_g < gScore[dest])
                 {
-                    // not in closedset - i.e. have not traversed this edge destination
-                    int dest = mGraph[current].edges[j].index;
-                    float tentative_g = gScore[current] + mGraph[current].edges[j].cost;
-                    bool isInOpenSet = std::find(openset.begin(), openset.end(), dest) != openset.end();
-                    if(!isInOpenSet
-                        || tentative_g < gScore[dest])
-                    {
-                        graphParent[dest] = current;
-                        gScore[dest] = tentative_g;
-                        fScore[dest] = tentative_g + costAStar(mPathgrid->mPoints[dest],
-                                                               mPathgrid->mPoints[goal]);
-                        if(!isInOpenSet)
-                        {
-                            // add this edge to openset, lowest cost goes to the front
-                            // TODO: if this causes performance problems a hash table may help
-                            std::list<int>::iterator it = openset.begin();
-                            for(it = openset.begin(); it!= openset.end(); ++it)
-                            {
-                                if(fScore[*it] > fScore[dest])
-                                    break;
-                            }
-                            openset.insert(it, dest);
-                        }
-                    }
-                } // if in closedset, i.e. traversed this edge already, try the next edge
+                    graphParent[dest] = current;
+                    gScore[dest] = tentative_g;
+                    openset.push(OpenEntry(tentative_g + costAStar(mPathgrid->mPoints[dest],
+                                                                   mPathgrid->mPoints[goal]), dest));
+                }
             }
         }
 
@@ -3,17 +3,15 @@
 
 #include <components/esm/loadpgrd.hpp>
 #include <list>
+#include <vector>
+
+#include <osg/Vec3f>
 
 namespace ESM
 {
     struct Cell;
 }
 
-namespace MWWorld
-{
-    class CellStore;
-}
-
 namespace MWMechanics
 {
     class PathgridGraph
@@ -21,12 +19,29 @@ namespace MWMechanics
         public:
             PathgridGraph();
 
-            bool load(const MWWorld::CellStore *cell);
+            // pathgrid may be NULL for cells without a pathgrid, in which
+            // case false is returned
+            bool load(const ESM::Cell *cell, const ESM::Pathgrid *pathgrid);
+
+            const ESM::Pathgrid* getPathgrid() const { return mPathgrid; }
 
             // returns true if end point is strongly connected (i.e. reachable
             // from start point) both start and end are pathgrid point indexes
             bool isPointConnected(const int start, const int end) const;
 
+            // returns the connected component a pathgrid point belongs to
+            int getComponentId(const int point) const;
+
+            // returns the index of the pathgrid point closest to pos, or -1 if
+            // there are no points. pos is in local (cell) co-ordinates.
+            //
+            // If componentId is not -1, only points of that component are
+            // considered.
+            //
+            // NOTE: Does not check if there is a sensible way to get there
+            // (e.g. a cliff in front).
+            int getClosestPoint(const osg::Vec3f& pos, int componentId = -1) const;
+
             // the input parameters are pathgrid point indexes
             // the output list is in local (internal cells) or world (external
             // cells) co-ordinates
@@ -64,6 +79,17 @@ namespace MWMechanics
             std::vector<Node> mGraph;
             bool mIsGraphConstructed;
 
+            // Spatial index of the pathgrid points for getClosestPoint. The
+            // points are sorted into square buckets of mBucketSize units,
+            // mBuckets[y * mBucketsX + x] holds the point indexes of a bucket.
+            float mBucketSize;
+            float mBucketsMinX;
+            float mBucketsMinY;
+            int mBucketsX;
+            int mBucketsY;
+            std::vector<std::vector<int> > mBuckets;
+            void buildBuckets();
+
             // variables used to calculate connected components
             int mSCCId;
             int mSCCIndex;
@@ -36,10 +36,8 @@ namespace MWMechanics
         float t = 2*x - y;
 
         float pcSneak = static_cast<float>(mThief.getClass().getSkill(mThief, ESM::Skill::Sneak));
-        int iPickMinChance = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>()
-                .find("iPickMinChance")->getInt();
-        int iPickMaxChance = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>()
-                .find("iPickMaxChance")->getInt();
+        int iPickMinChance = MWBase::Environment::get().getWorld()->getStore().getGameSettings().get(MWWorld::GameSettings::iPickMinChance);
+        int iPickMaxChance = MWBase::Environment::get().getWorld()->getStore().getGameSettings().get(MWWorld::GameSettings::iPickMaxChance);
 
         int roll = Misc::Rng::roll0to99();
         if (t < pcSneak / iPickMinChance)
@@ -56,8 +54,7 @@ namespace MWMechanics
     bool Pickpocket::pick(MWWorld::Ptr item, int count)
     {
         float stackValue = static_cast<float>(item.getClass().getValue(item) * count);
-        float fPickPocketMod = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>()
-                .find("fPickPocketMod")->getFloat();
+        float fPickPocketMod = MWBase::Environment::get().getWorld()->getStore().getGameSettings().get(MWWorld::GameSettings::fPickPocketMod);
         float valueTerm = 10 * fPickPocketMod * stackValue;
 
         return getDetected(valueTerm);
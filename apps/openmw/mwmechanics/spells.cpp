@@ -16,6 +16,11 @@
 
 namespace MWMechanics
 {
+    Spells::Spells()
+        : mSpellsChanged (false)
+    {
+    }
+
     Spells::TIterator Spells::begin() const
     {
         return mSpells.begin();
@@ -53,6 +58,7 @@ namespace MWMechanics
             }
 
             mSpells.insert (std::make_pair (spell->mId, random));
+            mSpellsChanged = true;
         }
     }
 
@@ -75,7 +81,7 @@ namespace MWMechanics
             if (mPermanentSpellEffects.find(lower) != mPermanentSpellEffects.end())
             {
                 MagicEffects & effects = mPermanentSpellEffects[lower];
-                for (MagicEffects::Collection::const_iterator effectIt = effects.begin(); effectIt != effects.end();)
+                for (MagicEffects::const_iterator effectIt = effects.begin(); effectIt != effects.end();)
                 {
                     const ESM::MagicEffect * magicEffect = MWBase::Environment::get().getWorld()->getStore().get<ESM::MagicEffect>().find(effectIt->first.mId);
                     if (magicEffect->mData.mFlags & ESM::MagicEffect::Harmful)
@@ -90,14 +96,25 @@ namespace MWMechanics
         if (iter!=mSpells.end())
             mSpells.erase (iter);
 
+        mSpellsChanged = true;
+
         if (spellId==mSelectedSpell)
             mSelectedSpell.clear();
     }
 
-    MagicEffects Spells::getMagicEffects() const
+    const MagicEffects& Spells::getMagicEffects() const
     {
-        // TODO: These are recalculated every frame, no need to do that
+        if (mSpellsChanged)
+        {
+            rebuildEffects();
+            mSpellsChanged = false;
+        }
+
+        return mEffects;
+    }
 
+    void Spells::rebuildEffects() const
+    {
         MagicEffects effects;
 
         for (TIterator iter = mSpells.begin(); iter!=mSpells.end(); ++iter)
@@ -126,12 +143,13 @@ namespace MWMechanics
             effects += it->second;
         }
 
-        return effects;
+        mEffects = effects;
     }
 
     void Spells::clear()
     {
         mSpells.clear();
+        mSpellsChanged = true;
     }
 
     void Spells::setSelectedSpell (const std::string& spellId)
@@ -198,6 +216,8 @@ namespace MWMechanics
             else
                 ++iter;
         }
+
+        mSpellsChanged = true;
     }
 
     void Spells::purgeBlightDisease()
@@ -212,6 +232,8 @@ namespace MWMechanics
             else
                 ++iter;
         }
+
+        mSpellsChanged = true;
     }
 
     void Spells::purgeCorprusDisease()
@@ -226,6 +248,8 @@ namespace MWMechanics
             else
                 ++iter;
         }
+
+        mSpellsChanged = true;
     }
 
     void Spells::purgeCurses()
@@ -240,6 +264,8 @@ namespace MWMechanics
             else
                 ++iter;
         }
+
+        mSpellsChanged = true;
     }
 
     void Spells::visitEffectSources(EffectSourceVisitor &visitor) const
@@ -273,6 +299,7 @@ namespace MWMechanics
     {
         mCorprusSpells[corpSpellId].mNextWorsening = MWBase::Environment::get().getWorld()->getTimeStamp() + CorprusStats::sWorseningPeriod;
         mCorprusSpells[corpSpellId].mWorsenings++;
+        mSpellsChanged = true;
 
         // update worsened effects
         mPermanentSpellEffects[corpSpellId] = MagicEffects();
@@ -358,6 +385,8 @@ namespace MWMechanics
             }
         }
 
+        mSpellsChanged = true;
+
         mCorprusSpells.clear();
         for (std::map<std::string, ESM::SpellState::CorprusStats>::const_iterator it = state.mCorprusSpells.begin(); it != state.mCorprusSpells.end(); ++it)
         {
@@ -380,7 +409,7 @@ namespace MWMechanics
         for (std::map<std::string, MagicEffects>::const_iterator it = mPermanentSpellEffects.begin(); it != mPermanentSpellEffects.end(); ++it)
         {
             std::vector<ESM::SpellState::PermanentSpellEffectInfo> effectList;
-            for (MagicEffects::Collection::const_iterator effectIt = it->second.begin(); effectIt != it->second.end(); ++effectIt)
+            for (MagicEffects::const_iterator effectIt = it->second.begin(); effectIt != it->second.end(); ++effectIt)
             {
                 ESM::SpellState::PermanentSpellEffectInfo info;
                 info.mId = effectIt->first.mId;
@@ -56,8 +56,16 @@ namespace MWMechanics
 
             std::map<std::string, CorprusStats> mCorprusSpells;
 
+            // Sum of the permanent effects, rebuilt only when the spell list changes
+            mutable MagicEffects mEffects;
+            mutable bool mSpellsChanged;
+
+            void rebuildEffects() const;
+
         public:
 
+            Spells();
+
             void worsenCorprus(const std::string &corpSpellId);
             static bool hasCorprusEffect(const ESM::Spell *spell);
             const std::map<std::string, CorprusStats> & getCorprusSpells() const;
@@ -86,7 +94,7 @@ namespace MWMechanics
             ///< If the spell to be removed is the selected spell, the selected spell will be changed to
             /// no spell (empty string).
 
-            MagicEffects getMagicEffects() const;
+            const MagicEffects& getMagicEffects() const;
             ///< Return sum of magic effects resulting from abilities, blights, deseases and curses.
 
             void clear();
@@ -0,0 +1,482 @@
+#include "movementsolver.hpp"
+
+#include <cmath>
+#include <limits>
+
+#include <osg/Math>
+#include <osg/Quat>
+
+#include <BulletCollision/CollisionDispatch/btCollisionObject.h>
+#include <BulletCollision/CollisionDispatch/btCollisionWorld.h>
+
+#include <components/sceneutil/workqueue.hpp>
+
+#include "actor.hpp"
+#include "collisiontype.hpp"
+#include "convert.hpp"
+#include "trace.h"
+
+namespace MWPhysics
+{
+
+    static const float sMaxSlope = 49.0f;
+    static const float sStepSizeUp = 34.0f;
+    static const float sStepSizeDown = 62.0f;
+
+    // Arbitrary number. To prevent infinite loops. They shouldn't happen but it's good to be prepared.
+    static const int sMaxIterations = 8;
+
+    static float getSlope(osg::Vec3f normal)
+    {
+        normal.normalize();
+        return osg::RadiansToDegrees(std::acos(normal * osg::Vec3f(0.f, 0.f, 1.f)));
+    }
+
+    static bool stepMove(btCollisionObject *colobj, osg::Vec3f &position,
+                         const osg::Vec3f &toMove, float &remainingTime, btCollisionWorld* collisionWorld)
+    {
+        /*
+         * Slide up an incline or set of stairs.  Should be called only after a
+         * collision detection otherwise unnecessary tracing will be performed.
+         *
+         * NOTE: with a small change this method can be used to step over an obstacle
+         * of height sStepSize.
+         *
+         * If successful return 'true' and update 'position' to the new possible
+         * location and adjust 'remainingTime'.
+         *
+         * If not successful return 'false'.  May fail for these reasons:
+         *    - can't move directly up from current position
+         *    - having moved up by between epsilon() and sStepSize, can't move forward
+         *    - having moved forward by between epsilon() and toMove,
+         *        = moved down between 0 and just under sStepSize but slope was too steep, or
+         *        = moved the full sStepSize down (FIXME: this could be a bug)
+         *
+         *
+         *
+         * Starting position.  Obstacle or stairs with height upto sStepSize in front.
+         *
+         *     +--+                          +--+       |XX
+         *     |  | -------> toMove          |  |    +--+XX
+         *     |  |                          |  |    |XXXXX
+         *     |  | +--+                     |  | +--+XXXXX
+         *     |  | |XX|                     |  | |XXXXXXXX
+         *     +--+ +--+                     +--+ +--------
+         *    ==============================================
+         */
+
+        /*
+         * Try moving up sStepSize using stepper.
+         * FIXME: does not work in case there is no front obstacle but there is one above
+         *
+         *     +--+                         +--+
+         *     |  |                         |  |
+         *     |  |                         |  |       |XX
+         *     |  |                         |  |    +--+XX
+         *     |  |                         |  |    |XXXXX
+         *     +--+ +--+                    +--+ +--+XXXXX
+         *          |XX|                         |XXXXXXXX
+         *          +--+                         +--------
+         *    ==============================================
+         */
+        ActorTracer tracer, stepper;
+
+        stepper.doTrace(colobj, position, position+osg::Vec3f(0.0f,0.0f,sStepSizeUp), collisionWorld);
+        if(stepper.mFraction < std::numeric_limits<float>::epsilon())
+            return false; // didn't even move the smallest representable amount
+                          // (TODO: shouldn't this be larger? Why bother with such a small amount?)
+
+        /*
+         * Try moving from the elevated position using tracer.
+         *
+         *                          +--+  +--+
+         *                          |  |  |YY|   FIXME: collision with object YY
+         *                          |  |  +--+
+         *                          |  |
+         *     <------------------->|  |
+         *          +--+            +--+
+         *          |XX|      the moved amount is toMove*tracer.mFraction
+         *          +--+
+         *    ==============================================
+         */
+        tracer.doTrace(colobj, stepper.mEndPos, stepper.mEndPos + toMove, collisionWorld);
+        if(tracer.mFraction < std::numeric_limits<float>::epsilon())
+            return false; // didn't even move the smallest representable amount
+
+        /*
+         * Try moving back down sStepSizeDown using stepper.
+         * NOTE: if there is an obstacle below (e.g. stairs), we'll be "stepping up".
+         * Below diagram is the case where we "stepped over" an obstacle in front.
+         *
+         *                                +--+
+         *                                |YY|
+         *                          +--+  +--+
+         *                          |  |
+         *                          |  |
+         *          +--+            |  |
+         *          |XX|            |  |
+         *          +--+            +--+
+         *    ==============================================
+         */
+        stepper.doTrace(colobj, tracer.mEndPos, tracer.mEndPos-osg::Vec3f(0.0f,0.0f,sStepSizeDown), collisionWorld);
+        if(stepper.mFraction < 1.0f && getSlope(stepper.mPlaneNormal) <= sMaxSlope)
+        {
+            // don't allow stepping up other actors
+            if (stepper.mHitObject->getBroadphaseHandle()->m_collisionFilterGroup == CollisionType_Actor)
+                return false;
+            // only step down onto semi-horizontal surfaces. don't step down onto the side of a house or a wall.
+            // TODO: stepper.mPlaneNormal does not appear to be reliable - needs more testing
+            // NOTE: caller's variables 'position' & 'remainingTime' are modified here
+            position = stepper.mEndPos;
+            remainingTime *= (1.0f-tracer.mFraction); // remaining time is proportional to remaining distance
+            return true;
+        }
+
+        // moved between 0 and just under sStepSize distance but slope was too great,
+        // or moved full sStepSize distance (FIXME: is this a bug?)
+        return false;
+    }
+
+
+    ///Project a vector u on another vector v
+    static inline osg::Vec3f project(const osg::Vec3f& u, const osg::Vec3f &v)
+    {
+        return v * (u * v);
+        //            ^ dot product
+    }
+
+    ///Helper for computing the character sliding
+    static inline osg::Vec3f slide(const osg::Vec3f& direction, const osg::Vec3f &planeNormal)
+    {
+        return direction - project(direction, planeNormal);
+    }
+
+    static inline osg::Vec3f reflect(const osg::Vec3& velocity, const osg::Vec3f& normal)
+    {
+        return velocity - (normal * (normal * velocity)) * 2;
+        //                                  ^ dot product
+    }
+
+    osg::Vec3f MovementSolver::traceDown(const osg::Vec3f& position, btCollisionObject* actor, const osg::Vec3f& halfExtents,
+                                         btCollisionWorld* collisionWorld, float maxHeight, bool& onGround)
+    {
+        ActorTracer tracer;
+        tracer.findGround(actor, halfExtents, position, position-osg::Vec3f(0,0,maxHeight), collisionWorld);
+        if(tracer.mFraction >= 1.0f)
+        {
+            onGround = false;
+            return position;
+        }
+        else
+        {
+            // Check if we actually found a valid spawn point (use an infinitely thin ray this time).
+            // Required for some broken door destinations in Morrowind.esm, where the spawn point
+            // intersects with other geometry if the actor's base is taken into account
+            btVector3 from = toBullet(position);
+            btVector3 to = from - btVector3(0,0,maxHeight);
+
+            btCollisionWorld::ClosestRayResultCallback resultCallback1(from, to);
+            resultCallback1.m_collisionFilterGroup = 0xff;
+            resultCallback1.m_collisionFilterMask = CollisionType_World|CollisionType_HeightMap;
+
+            collisionWorld->rayTest(from, to, resultCallback1);
+            if (resultCallback1.hasHit() &&
+                    ( (toOsg(resultCallback1.m_hitPointWorld) - tracer.mEndPos).length() > 30
+                    || getSlope(tracer.mPlaneNormal) > sMaxSlope))
+            {
+                onGround = getSlope(toOsg(resultCallback1.m_hitNormalWorld)) <= sMaxSlope;
+                return toOsg(resultCallback1.m_hitPointWorld) + osg::Vec3f(0.f, 0.f, 1.f);
+            }
+
+            onGround = getSlope(tracer.mPlaneNormal) <= sMaxSlope;
+
+            return tracer.mEndPos;
+        }
+    }
+
+    osg::Vec3f MovementSolver::move(MovementJob& job, const ESM::Position& refpos, float time, const MovementGlobals& globals,
+                                    btCollisionWorld* collisionWorld)
+    {
+        osg::Vec3f position(refpos.asVec3());
+
+        // Early-out for totally static creatures
+        // (Not sure if gravity should still apply?)
+        if (!job.mIsMobile)
+            return position;
+
+        // Reset per-frame data
+        job.mWalkingOnWater = false;
+        // Anything to collide with?
+        if(!job.mCollisionMode)
+        {
+            return position +  (osg::Quat(refpos.rot[0], osg::Vec3f(-1, 0, 0)) *
+                                osg::Quat(refpos.rot[2], osg::Vec3f(0, 0, -1))
+                                ) * job.mMovement * time;
+        }
+
+        btCollisionObject *colobj = job.mCollisionObject;
+        const osg::Vec3f& halfExtents = job.mHalfExtents;
+        position.z() += halfExtents.z();
+
+        float swimlevel = job.mWaterLevel + halfExtents.z() - (halfExtents.z() * 2 * globals.mSwimHeightScale);
+
+        ActorTracer tracer;
+        osg::Vec3f inertia = job.mInertia;
+        osg::Vec3f velocity;
+
+        if(position.z() < swimlevel || job.mIsFlying)
+        {
+            velocity = (osg::Quat(refpos.rot[0], osg::Vec3f(-1, 0, 0)) *
+                        osg::Quat(refpos.rot[2], osg::Vec3f(0, 0, -1))) * job.mMovement;
+        }
+        else
+        {
+            velocity = (osg::Quat(refpos.rot[2], osg::Vec3f(0, 0, -1))) * job.mMovement;
+
+            if (velocity.z() > 0.f)
+                inertia = velocity;
+            if(!job.mOnGround)
+            {
+                velocity = velocity + job.mInertia;
+            }
+        }
+
+        // Now that we have the effective movement vector, apply wind forces to it
+        if (globals.mInStorm)
+        {
+            const osg::Vec3f& stormDirection = globals.mStormDirection;
+            float angleDegrees = osg::RadiansToDegrees(std::acos(stormDirection * velocity / (stormDirection.length() * velocity.length())));
+            velocity *= 1.f-(globals.mStromWalkMult * (angleDegrees/180.f));
+        }
+
+        osg::Vec3f origVelocity = velocity;
+
+        osg::Vec3f newPosition = position;
+        /*
+         * A loop to find newPosition using tracer, if successful different from the starting position.
+         * nextpos is the local variable used to find potential newPosition, using velocity and remainingTime
+         * The initial velocity was set earlier (see above).
+         */
+        float remainingTime = time;
+        for(int iterations = 0; iterations < sMaxIterations && remainingTime > 0.01f; ++iterations)
+        {
+            osg::Vec3f nextpos = newPosition + velocity * remainingTime;
+
+            // If not able to fly, don't allow to swim up into the air
+            if(newPosition.z() < swimlevel &&
+               !job.mIsFlying &&  // can't fly
+               nextpos.z() > swimlevel &&     // but about to go above water
+               newPosition.z() <= swimlevel)
+            {
+                const osg::Vec3f down(0,0,-1);
+                float movelen = velocity.normalize();
+                osg::Vec3f reflectdir = reflect(velocity, down);
+                reflectdir.normalize();
+                velocity = slide(reflectdir, down)*movelen;
+                // NOTE: remainingTime is unchanged before the loop continues
+                continue; // velocity updated, calculate nextpos again
+            }
+
+            if((newPosition - nextpos).length2() > 0.0001)
+            {
+                // trace to where character would go if there were no obstructions
+                tracer.doTrace(colobj, newPosition, nextpos, collisionWorld);
+
+                // check for obstructions
+                if(tracer.mFraction >= 1.0f)
+                {
+                    newPosition = tracer.mEndPos; // ok to move, so set newPosition
+                    break;
+                }
+                else
+                {
+                    const btCollisionObject* hitObject = tracer.mHitObject;
+                    const PtrHolder* ptrHolder = static_cast<const PtrHolder*>(hitObject->getUserPointer());
+                    if (ptrHolder)
+                        job.mCollidedWith = ptrHolder->getPtr();
+                }
+            }
+            else
+            {
+                // The current position and next position are nearly the same, so just exit.
+                // Note: Bullet can trigger an assert in debug modes if the positions
+                // are the same, since that causes it to attempt to normalize a zero
+                // length vector (which can also happen with nearly identical vectors, since
+                // precision can be lost due to any math Bullet does internally). Since we
+                // aren't performing any collision detection, we want to reject the next
+                // position, so that we don't slowly move inside another object.
+                break;
+            }
+
+
+            osg::Vec3f oldPosition = newPosition;
+            // We hit something. Try to step up onto it. (NOTE: stepMove does not allow stepping over)
+            // NOTE: stepMove modifies newPosition if successful
+            bool result = stepMove(colobj, newPosition, velocity*remainingTime, remainingTime, collisionWorld);
+            if (!result) // to make sure the maximum stepping distance isn't framerate-dependent or movement-speed dependent
+            {
+                osg::Vec3f normalizedVelocity = velocity;
+                normalizedVelocity.normalize();
+                result = stepMove(colobj, newPosition, normalizedVelocity*10.f, remainingTime, collisionWorld);
+            }
+            if(result)
+            {
+                // don't let pure water creatures move out of water after stepMove
+                if (job.mIsPureWaterCreature
+                        && newPosition.z() + halfExtents.z() > job.mWaterLevel)
+                    newPosition = oldPosition;
+            }
+            else
+            {
+                // Can't move this way, try to find another spot along the plane
+                osg::Vec3f direction = velocity;
+                float movelen = direction.normalize();
+                osg::Vec3f reflectdir = reflect(velocity, tracer.mPlaneNormal);
+                reflectdir.normalize();
+
+                osg::Vec3f newVelocity = slide(reflectdir, tracer.mPlaneNormal)*movelen;
+                if ((newVelocity-velocity).length2() < 0.01)
+                    break;
+                if ((velocity * origVelocity) <= 0.f)
+                    break; // ^ dot product
+
+                velocity = newVelocity;
+
+                // Do not allow sliding upward if there is gravity. Stepping will have taken
+                // care of that.
+                if(!(newPosition.z() < swimlevel || job.mIsFlying))
+                    velocity.z() = std::min(velocity.z(), 0.0f);
+            }
+        }
+
+        bool isOnGround = false;
+        if (!(inertia.z() > 0.f) && !(newPosition.z() < swimlevel))
+        {
+            osg::Vec3f from = newPosition;
+            osg::Vec3f to = newPosition - (job.mOnGround ?
+                         osg::Vec3f(0,0,sStepSizeDown+2.f) : osg::Vec3f(0,0,2.f));
+            tracer.doTrace(colobj, from, to, collisionWorld);
+            if(tracer.mFraction < 1.0f && getSlope(tracer.mPlaneNormal) <= sMaxSlope
+                    && tracer.mHitObject->getBroadphaseHandle()->m_collisionFilterGroup != CollisionType_Actor)
+            {
+                const btCollisionObject* hitObject = tracer.mHitObject;
+                const PtrHolder* ptrHolder = static_cast<PtrHolder*>(hitObject->getUserPointer());
+                if (ptrHolder)
+                    job.mStandingOn = ptrHolder->getPtr();
+
+                if (hitObject->getBroadphaseHandle()->m_collisionFilterGroup == CollisionType_Water)
+                    job.mWalkingOnWater = true;
+                if (!job.mIsFlying)
+                    newPosition.z() = tracer.mEndPos.z() + 1.0f;
+
+                isOnGround = true;
+            }
+            else
+            {
+                // standing on actors is not allowed (see above).
+                // in addition to that, apply a sliding effect away from the center of the actor,
+                // so that we do not stay suspended in air indefinitely.
+                if (tracer.mFraction < 1.0f && tracer.mHitObject->getBroadphaseHandle()->m_collisionFilterGroup == CollisionType_Actor)
+                {
+                    if (osg::Vec3f(velocity.x(), velocity.y(), 0).length2() < 100.f*100.f)
+                    {
+                        btVector3 aabbMin, aabbMax;
+                        tracer.mHitObject->getCollisionShape()->getAabb(tracer.mHitObject->getWorldTransform(), aabbMin, aabbMax);
+                        btVector3 center = (aabbMin + aabbMax) / 2.f;
+                        inertia = osg::Vec3f(position.x() - center.x(), position.y() - center.y(), 0);
+                        inertia.normalize();
+                        inertia *= 100;
+                    }
+                }
+
+                isOnGround = false;
+            }
+        }
+
+        if(isOnGround || newPosition.z() < swimlevel || job.mIsFlying)
+            job.mInertia = osg::Vec3f(0.f, 0.f, 0.f);
+        else
+        {
+            inertia.z() += time * -627.2f;
+            if (inertia.z() < 0)
+                inertia.z() *= job.mSlowFall;
+            job.mInertia = inertia;
+        }
+        job.mOnGround = isOnGround;
+
+        newPosition.z() -= halfExtents.z(); // remove what was added at the beginning
+        return newPosition;
+    }
+
+    /// Solves the movement of a range of queued actors. Each job only writes to its own results,
+    /// so several of these may run concurrently against the same collision world.
+    class MovementSolverWorkItem : public SceneUtil::WorkItem
+    {
+    public:
+        MovementSolverWorkItem(std::vector<MovementJob>& jobs, size_t begin, size_t end,
+                               float time, int steps, const MovementGlobals& globals, btCollisionWorld* collisionWorld)
+            : mJobs(jobs), mBegin(begin), mEnd(end), mTime(time), mSteps(steps), mGlobals(globals), mCollisionWorld(collisionWorld)
+        {
+        }
+
+        virtual void doWork()
+        {
+            solve();
+            mTicket->signalDone();
+        }
+
+        void solve()
+        {
+            for (size_t i=mBegin; i<mEnd; ++i)
+            {
+                MovementJob& job = mJobs[i];
+                ESM::Position refpos = job.mRefPosition;
+                job.mPosition = refpos.asVec3();
+                for (int step=0; step<mSteps; ++step)
+                {
+                    // Actors do not see each other's new positions until the results are applied,
+                    // so all steps of one actor can be solved in one go.
+                    job.mPreviousPosition = job.mPosition;
+                    job.mPosition = MovementSolver::move(job, refpos, mTime, mGlobals, mCollisionWorld);
+                    for (int j=0; j<3; ++j)
+                        refpos.pos[j] = job.mPosition[j];
+                }
+            }
+        }
+
+    private:
+        std::vector<MovementJob>& mJobs;
+        size_t mBegin;
+        size_t mEnd;
+        float mTime;
+        int mSteps;
+        MovementGlobals mGlobals;
+        btCollisionWorld* mCollisionWorld;
+    };
+
+    void solveMovement(std::vector<MovementJob>& jobs, float time, int steps, const MovementGlobals& globals,
+                       btCollisionWorld* collisionWorld, SceneUtil::WorkQueue* workQueue, int numThreads)
+    {
+        // Split the jobs into one range per worker thread, plus one for the calling thread
+        size_t numRanges = std::min(jobs.size(), static_cast<size_t>(numThreads+1));
+        if (numRanges <= 1)
+        {
+            MovementSolverWorkItem(jobs, 0, jobs.size(), time, steps, globals, collisionWorld).solve();
+            return;
+        }
+
+        std::vector<osg::ref_ptr<SceneUtil::WorkTicket> > tickets;
+        size_t rangeSize = jobs.size() / numRanges;
+        for (size_t i=1; i<numRanges; ++i)
+        {
+            size_t begin = i * rangeSize;
+            size_t end = (i == numRanges-1) ? jobs.size() : begin + rangeSize;
+            tickets.push_back(workQueue->addWorkItem(
+                                  new MovementSolverWorkItem(jobs, begin, end, time, steps, globals, collisionWorld)));
+        }
+        MovementSolverWorkItem(jobs, 0, rangeSize, time, steps, globals, collisionWorld).solve();
+
+        for (std::vector<osg::ref_ptr<SceneUtil::WorkTicket> >::iterator it = tickets.begin(); it != tickets.end(); ++it)
+            (*it)->waitTillDone();
+    }
+}
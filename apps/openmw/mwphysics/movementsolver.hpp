@@ -0,0 +1,90 @@
+#ifndef OPENMW_MWPHYSICS_MOVEMENTSOLVER_H
+#define OPENMW_MWPHYSICS_MOVEMENTSOLVER_H
+
+#include <vector>
+
+#include <osg/Vec3f>
+
+#include <components/esm/defs.hpp>
+
+#include "../mwworld/ptr.hpp"
+
+class btCollisionObject;
+class btCollisionWorld;
+
+namespace SceneUtil
+{
+    class WorkQueue;
+}
+
+namespace MWPhysics
+{
+    class Actor;
+
+    /// World state needed by the movement solver. Gathered on the main thread before solving,
+    /// so that the solver itself does not need to query the world.
+    struct MovementGlobals
+    {
+        float mSwimHeightScale;
+        float mStromWalkMult;
+        bool mInStorm;
+        osg::Vec3f mStormDirection;
+    };
+
+    /// Input and output of solving the movement of a single queued actor.
+    /// @note The solver only works on the job, it does not touch the Ptr's class or the Actor. The actor
+    /// state is copied into the job before solving, and copied back by the PhysicsSystem afterwards.
+    struct MovementJob
+    {
+        MWWorld::Ptr mPtr;
+        Actor* mActor;
+        osg::Vec3f mMovement;
+        /// Position and rotation to start solving from
+        ESM::Position mRefPosition;
+        float mWaterLevel;
+        float mSlowFall;
+        bool mIsFlying;
+        bool mIsMobile;
+        bool mIsPureWaterCreature;
+
+        btCollisionObject* mCollisionObject;
+        osg::Vec3f mHalfExtents;
+        bool mCollisionMode;
+
+        /// Actor state, carried over from one step to the next
+        osg::Vec3f mInertia;
+        bool mOnGround;
+        bool mWalkingOnWater;
+
+        /// Positions before and after the last solved step
+        osg::Vec3f mPreviousPosition;
+        osg::Vec3f mPosition;
+        MWWorld::Ptr mCollidedWith;
+        MWWorld::Ptr mStandingOn;
+
+        /// The position last handed out by applyQueuedMovement
+        osg::Vec3f mReportedPosition;
+    };
+
+    class MovementSolver
+    {
+    public:
+        /// Find the ground below \a position for an actor, returning the position to place the actor at.
+        /// @param onGround Set to whether the actor would stand on walkable ground there.
+        static osg::Vec3f traceDown(const osg::Vec3f& position, btCollisionObject* actor, const osg::Vec3f& halfExtents,
+                                    btCollisionWorld* collisionWorld, float maxHeight, bool& onGround);
+
+        /// Solve a single step of \a time seconds for \a job, starting from \a refpos.
+        /// @note Only reads from \a collisionWorld and only modifies \a job, so it is safe to call
+        /// concurrently for different jobs.
+        static osg::Vec3f move(MovementJob& job, const ESM::Position& refpos, float time, const MovementGlobals& globals,
+                               btCollisionWorld* collisionWorld);
+    };
+
+    /// Solve \a jobs for \a steps steps of \a time seconds each, spreading them across the calling thread and
+    /// \a numThreads threads of \a workQueue. The result does not depend on the number of threads.
+    void solveMovement(std::vector<MovementJob>& jobs, float time, int steps, const MovementGlobals& globals,
+                       btCollisionWorld* collisionWorld, SceneUtil::WorkQueue* workQueue, int numThreads);
+}
+
+#endif
@@ -1,6 +1,7 @@
 #include "physicssystem.hpp"
 
 #include <stdexcept>
+#include <iostream>
 
 #include <osg/Group>
 #include <osg/PositionAttitudeTransform>
@@ -16,6 +17,10 @@
 #include <BulletCollision/CollisionDispatch/btCollisionWorld.h>
 #include <BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
 #include <LinearMath/btQuickprof.h>
+#include <LinearMath/btScalar.h>
+#ifdef HAVE_BULLET_TASK_SCHEDULER
+#include <LinearMath/btThreads.h>
+#endif
 
 #include <components/nifbullet/bulletshapemanager.hpp>
 #include <components/nifbullet/bulletnifloader.hpp>
@@ -23,6 +28,12 @@
 
 #include <components/esm/loadgmst.hpp>
 
+#include <components/misc/profiler.hpp>
+
+#include <components/sceneutil/workqueue.hpp>
+
+#include <components/settings/settings.hpp>
+
 #include <components/nifosg/particle.hpp> // FindRecIndexVisitor
 
 #include "../mwbase/world.hpp"
@@ -49,411 +60,19 @@
 namespace MWPhysics
 {
 
-    static const float sMaxSlope = 49.0f;
-    static const float sStepSizeUp = 34.0f;
-    static const float sStepSizeDown = 62.0f;
-
-    // Arbitrary number. To prevent infinite loops. They shouldn't happen but it's good to be prepared.
-    static const int sMaxIterations = 8;
-
-    // FIXME: move to a separate file
-    class MovementSolver
+    /// Can broadphase queries be done from several threads at once?
+    static bool isBulletThreadSafe()
     {
-    private:
-        static float getSlope(osg::Vec3f normal)
-        {
-            normal.normalize();
-            return osg::RadiansToDegrees(std::acos(normal * osg::Vec3f(0.f, 0.f, 1.f)));
-        }
-
-        static bool stepMove(btCollisionObject *colobj, osg::Vec3f &position,
-                             const osg::Vec3f &toMove, float &remainingTime, btCollisionWorld* collisionWorld)
-        {
-            /*
-             * Slide up an incline or set of stairs.  Should be called only after a
-             * collision detection otherwise unnecessary tracing will be performed.
-             *
-             * NOTE: with a small change this method can be used to step over an obstacle
-             * of height sStepSize.
-             *
-             * If successful return 'true' and update 'position' to the new possible
-             * location and adjust 'remainingTime'.
-             *
-             * If not successful return 'false'.  May fail for these reasons:
-             *    - can't move directly up from current position
-             *    - having moved up by between epsilon() and sStepSize, can't move forward
-             *    - having moved forward by between epsilon() and toMove,
-             *        = moved down between 0 and just under sStepSize but slope was too steep, or
-             *        = moved the full sStepSize down (FIXME: this could be a bug)
-             *
-             *
-             *
-             * Starting position.  Obstacle or stairs with height upto sStepSize in front.
-             *
-             *     +--+                          +--+       |XX
-             *     |  | -------> toMove          |  |    +--+XX
-             *     |  |                          |  |    |XXXXX
-             *     |  | +--+                     |  | +--+XXXXX
-             *     |  | |XX|                     |  | |XXXXXXXX
-             *     +--+ +--+                     +--+ +--------
-             *    ==============================================
-             */
-
-            /*
-             * Try moving up sStepSize using stepper.
-             * FIXME: does not work in case there is no front obstacle but there is one above
-             *
-             *     +--+                         +--+
-             *     |  |                         |  |
-             *     |  |                         |  |       |XX
-             *     |  |                         |  |    +--+XX
-             *     |  |                         |  |    |XXXXX
-             *     +--+ +--+                    +--+ +--+XXXXX
-             *          |XX|                         |XXXXXXXX
-             *          +--+                         +--------
-             *    ==============================================
-             */
-            ActorTracer tracer, stepper;
-
-            stepper.doTrace(colobj, position, position+osg::Vec3f(0.0f,0.0f,sStepSizeUp), collisionWorld);
-            if(stepper.mFraction < std::numeric_limits<float>::epsilon())
-                return false; // didn't even move the smallest representable amount
-                              // (TODO: shouldn't this be larger? Why bother with such a small amount?)
-
-            /*
-             * Try moving from the elevated position using tracer.
-             *
-             *                          +--+  +--+
-             *                          |  |  |YY|   FIXME: collision with object YY
-             *                          |  |  +--+
-             *                          |  |
-             *     <------------------->|  |
-             *          +--+            +--+
-             *          |XX|      the moved amount is toMove*tracer.mFraction
-             *          +--+
-             *    ==============================================
-             */
-            tracer.doTrace(colobj, stepper.mEndPos, stepper.mEndPos + toMove, collisionWorld);
-            if(tracer.mFraction < std::numeric_limits<float>::epsilon())
-                return false; // didn't even move the smallest representable amount
-
-            /*
-             * Try moving back down sStepSizeDown using stepper.
-             * NOTE: if there is an obstacle below (e.g. stairs), we'll be "stepping up".
-             * Below diagram is the case where we "stepped over" an obstacle in front.
-             *
-             *                                +--+
-             *                                |YY|
-             *                          +--+  +--+
-             *                          |  |
-             *                          |  |
-             *          +--+            |  |
-             *          |XX|            |  |
-             *          +--+            +--+
-             *    ==============================================
-             */
-            stepper.doTrace(colobj, tracer.mEndPos, tracer.mEndPos-osg::Vec3f(0.0f,0.0f,sStepSizeDown), collisionWorld);
-            if(stepper.mFraction < 1.0f && getSlope(stepper.mPlaneNormal) <= sMaxSlope)
-            {
-                // don't allow stepping up other actors
-                if (stepper.mHitObject->getBroadphaseHandle()->m_collisionFilterGroup == CollisionType_Actor)
-                    return false;
-                // only step down onto semi-horizontal surfaces. don't step down onto the side of a house or a wall.
-                // TODO: stepper.mPlaneNormal does not appear to be reliable - needs more testing
-                // NOTE: caller's variables 'position' & 'remainingTime' are modified here
-                position = stepper.mEndPos;
-                remainingTime *= (1.0f-tracer.mFraction); // remaining time is proportional to remaining distance
-                return true;
-            }
-
-            // moved between 0 and just under sStepSize distance but slope was too great,
-            // or moved full sStepSize distance (FIXME: is this a bug?)
-            return false;
-        }
-
-
-        ///Project a vector u on another vector v
-        static inline osg::Vec3f project(const osg::Vec3f& u, const osg::Vec3f &v)
-        {
-            return v * (u * v);
-            //            ^ dot product
-        }
-
-        ///Helper for computing the character sliding
-        static inline osg::Vec3f slide(const osg::Vec3f& direction, const osg::Vec3f &planeNormal)
-        {
-            return direction - project(direction, planeNormal);
-        }
-
-        static inline osg::Vec3f reflect(const osg::Vec3& velocity, const osg::Vec3f& normal)
-        {
-            return velocity - (normal * (normal * velocity)) * 2;
-            //                                  ^ dot product
-        }
-
-
-    public:
-        static osg::Vec3f traceDown(const MWWorld::Ptr &ptr, Actor* actor, btCollisionWorld* collisionWorld, float maxHeight)
-        {
-            osg::Vec3f position(ptr.getRefData().getPosition().asVec3());
-
-            ActorTracer tracer;
-            tracer.findGround(actor, position, position-osg::Vec3f(0,0,maxHeight), collisionWorld);
-            if(tracer.mFraction >= 1.0f)
-            {
-                actor->setOnGround(false);
-                return position;
-            }
-            else
-            {
-                // Check if we actually found a valid spawn point (use an infinitely thin ray this time).
-                // Required for some broken door destinations in Morrowind.esm, where the spawn point
-                // intersects with other geometry if the actor's base is taken into account
-                btVector3 from = toBullet(position);
-                btVector3 to = from - btVector3(0,0,maxHeight);
-
-                btCollisionWorld::ClosestRayResultCallback resultCallback1(from, to);
-                resultCallback1.m_collisionFilterGroup = 0xff;
-                resultCallback1.m_collisionFilterMask = CollisionType_World|CollisionType_HeightMap;
-
-                collisionWorld->rayTest(from, to, resultCallback1);
-                if (resultCallback1.hasHit() &&
-                        ( (toOsg(resultCallback1.m_hitPointWorld) - tracer.mEndPos).length() > 30
-                        || getSlope(tracer.mPlaneNormal) > sMaxSlope))
-                {
-                    actor->setOnGround(getSlope(toOsg(resultCallback1.m_hitNormalWorld)) <= sMaxSlope);
-                    return toOsg(resultCallback1.m_hitPointWorld) + osg::Vec3f(0.f, 0.f, 1.f);
-                }
-
-                actor->setOnGround(getSlope(tracer.mPlaneNormal) <= sMaxSlope);
-
-                return tracer.mEndPos;
-            }
-        }
-
-        static osg::Vec3f move(const MWWorld::Ptr &ptr, Actor* physicActor, const osg::Vec3f &movement, float time,
-                                  bool isFlying, float waterlevel, float slowFall, btCollisionWorld* collisionWorld
-                                  , std::map<MWWorld::Ptr, MWWorld::Ptr>& collisionTracker
-                                  , std::map<MWWorld::Ptr, MWWorld::Ptr>& standingCollisionTracker)
-        {
-            const ESM::Position& refpos = ptr.getRefData().getPosition();
-            osg::Vec3f position(refpos.asVec3());
-
-            // Early-out for totally static creatures
-            // (Not sure if gravity should still apply?)
-            if (!ptr.getClass().isMobile(ptr))
-                return position;
-
-            // Reset per-frame data
-            physicActor->setWalkingOnWater(false);
-            // Anything to collide with?
-            if(!physicActor->getCollisionMode())
-            {
-                return position +  (osg::Quat(refpos.rot[0], osg::Vec3f(-1, 0, 0)) *
-                                    osg::Quat(refpos.rot[2], osg::Vec3f(0, 0, -1))
-                                    ) * movement * time;
-            }
-
-            btCollisionObject *colobj = physicActor->getCollisionObject();
-            osg::Vec3f halfExtents = physicActor->getHalfExtents();
-            position.z() += halfExtents.z();
-
-            static const float fSwimHeightScale = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>()
-                    .find("fSwimHeightScale")->getFloat();
-            float swimlevel = waterlevel + halfExtents.z() - (halfExtents.z() * 2 * fSwimHeightScale);
-
-            ActorTracer tracer;
-            osg::Vec3f inertia = physicActor->getInertialForce();
-            osg::Vec3f velocity;
-
-            if(position.z() < swimlevel || isFlying)
-            {
-                velocity = (osg::Quat(refpos.rot[0], osg::Vec3f(-1, 0, 0)) *
-                            osg::Quat(refpos.rot[2], osg::Vec3f(0, 0, -1))) * movement;
-            }
-            else
-            {
-                velocity = (osg::Quat(refpos.rot[2], osg::Vec3f(0, 0, -1))) * movement;
-
-                if (velocity.z() > 0.f)
-                    inertia = velocity;
-                if(!physicActor->getOnGround())
-                {
-                    velocity = velocity + physicActor->getInertialForce();
-                }
-            }
-            ptr.getClass().getMovementSettings(ptr).mPosition[2] = 0;
-
-            // Now that we have the effective movement vector, apply wind forces to it
-            if (MWBase::Environment::get().getWorld()->isInStorm())
-            {
-                osg::Vec3f stormDirection = MWBase::Environment::get().getWorld()->getStormDirection();
-                float angleDegrees = osg::RadiansToDegrees(std::acos(stormDirection * velocity / (stormDirection.length() * velocity.length())));
-                static const float fStromWalkMult = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>()
-                        .find("fStromWalkMult")->getFloat();
-                velocity *= 1.f-(fStromWalkMult * (angleDegrees/180.f));
-            }
-
-            osg::Vec3f origVelocity = velocity;
-
-            osg::Vec3f newPosition = position;
-            /*
-             * A loop to find newPosition using tracer, if successful different from the starting position.
-             * nextpos is the local variable used to find potential newPosition, using velocity and remainingTime
-             * The initial velocity was set earlier (see above).
-             */
-            float remainingTime = time;
-            for(int iterations = 0; iterations < sMaxIterations && remainingTime > 0.01f; ++iterations)
-            {
-                osg::Vec3f nextpos = newPosition + velocity * remainingTime;
-
-                // If not able to fly, don't allow to swim up into the air
-                if(newPosition.z() < swimlevel &&
-                   !isFlying &&  // can't fly
-                   nextpos.z() > swimlevel &&     // but about to go above water
-                   newPosition.z() <= swimlevel)
-                {
-                    const osg::Vec3f down(0,0,-1);
-                    float movelen = velocity.normalize();
-                    osg::Vec3f reflectdir = reflect(velocity, down);
-                    reflectdir.normalize();
-                    velocity = slide(reflectdir, down)*movelen;
-                    // NOTE: remainingTime is unchanged before the loop continues
-                    continue; // velocity updated, calculate nextpos again
-                }
-
-                if((newPosition - nextpos).length2() > 0.0001)
-                {
-                    // trace to where character would go if there were no obstructions
-                    tracer.doTrace(colobj, newPosition, nextpos, collisionWorld);
-
-                    // check for obstructions
-                    if(tracer.mFraction >= 1.0f)
-                    {
-                        newPosition = tracer.mEndPos; // ok to move, so set newPosition
-                        break;
-                    }
-                    else
-                    {
-                        const btCollisionObject* standingOn = tracer.mHitObject;
-                        const PtrHolder* ptrHolder = static_cast<const PtrHolder*>(standingOn->getUserPointer());
-                        if (ptrHolder)
-                            collisionTracker[ptr] = ptrHolder->getPtr();
-                    }
-                }
-                else
-                {
-                    // The current position and next position are nearly the same, so just exit.
-                    // Note: Bullet can trigger an assert in debug modes if the positions
-                    // are the same, since that causes it to attempt to normalize a zero
-                    // length vector (which can also happen with nearly identical vectors, since
-                    // precision can be lost due to any math Bullet does internally). Since we
-                    // aren't performing any collision detection, we want to reject the next
-                    // position, so that we don't slowly move inside another object.
-                    break;
-                }
-
-
-                osg::Vec3f oldPosition = newPosition;
-                // We hit something. Try to step up onto it. (NOTE: stepMove does not allow stepping over)
-                // NOTE: stepMove modifies newPosition if successful
-                bool result = stepMove(colobj, newPosition, velocity*remainingTime, remainingTime, collisionWorld);
-                if (!result) // to make sure the maximum stepping distance isn't framerate-dependent or movement-speed dependent
-                {
-                    osg::Vec3f normalizedVelocity = velocity;
-                    normalizedVelocity.normalize();
-                    result = stepMove(colobj, newPosition, normalizedVelocity*10.f, remainingTime, collisionWorld);
-                }
-                if(result)
-                {
-                    // don't let pure water creatures move out of water after stepMove
-                    if (ptr.getClass().isPureWaterCreature(ptr)
-                            && newPosition.z() + halfExtents.z() > waterlevel)
-                        newPosition = oldPosition;
-                }
-                else
-                {
-                    // Can't move this way, try to find another spot along the plane
-                    osg::Vec3f direction = velocity;
-                    float movelen = direction.normalize();
-                    osg::Vec3f reflectdir = reflect(velocity, tracer.mPlaneNormal);
-                    reflectdir.normalize();
-
-                    osg::Vec3f newVelocity = slide(reflectdir, tracer.mPlaneNormal)*movelen;
-                    if ((newVelocity-velocity).length2() < 0.01)
-                        break;
-                    if ((velocity * origVelocity) <= 0.f)
-                        break; // ^ dot product
-
-                    velocity = newVelocity;
-
-                    // Do not allow sliding upward if there is gravity. Stepping will have taken
-                    // care of that.
-                    if(!(newPosition.z() < swimlevel || isFlying))
-                        velocity.z() = std::min(velocity.z(), 0.0f);
-                }
-            }
-
-            bool isOnGround = false;
-            if (!(inertia.z() > 0.f) && !(newPosition.z() < swimlevel))
-            {
-                osg::Vec3f from = newPosition;
-                osg::Vec3f to = newPosition - (physicActor->getOnGround() ?
-                             osg::Vec3f(0,0,sStepSizeDown+2.f) : osg::Vec3f(0,0,2.f));
-                tracer.doTrace(colobj, from, to, collisionWorld);
-                if(tracer.mFraction < 1.0f && getSlope(tracer.mPlaneNormal) <= sMaxSlope
-                        && tracer.mHitObject->getBroadphaseHandle()->m_collisionFilterGroup != CollisionType_Actor)
-                {
-                    const btCollisionObject* standingOn = tracer.mHitObject;
-                    const PtrHolder* ptrHolder = static_cast<PtrHolder*>(standingOn->getUserPointer());
-                    if (ptrHolder)
-                        standingCollisionTracker[ptr] = ptrHolder->getPtr();
-
-                    if (standingOn->getBroadphaseHandle()->m_collisionFilterGroup == CollisionType_Water)
-                        physicActor->setWalkingOnWater(true);
-                    if (!isFlying)
-                        newPosition.z() = tracer.mEndPos.z() + 1.0f;
-
-                    isOnGround = true;
-                }
-                else
-                {
-                    // standing on actors is not allowed (see above).
-                    // in addition to that, apply a sliding effect away from the center of the actor,
-                    // so that we do not stay suspended in air indefinitely.
-                    if (tracer.mFraction < 1.0f && tracer.mHitObject->getBroadphaseHandle()->m_collisionFilterGroup == CollisionType_Actor)
-                    {
-                        if (osg::Vec3f(velocity.x(), velocity.y(), 0).length2() < 100.f*100.f)
-                        {
-                            btVector3 aabbMin, aabbMax;
-                            tracer.mHitObject->getCollisionShape()->getAabb(tracer.mHitObject->getWorldTransform(), aabbMin, aabbMax);
-                            btVector3 center = (aabbMin + aabbMax) / 2.f;
-                            inertia = osg::Vec3f(position.x() - center.x(), position.y() - center.y(), 0);
-                            inertia.normalize();
-                            inertia *= 100;
-                        }
-                    }
-
-                    isOnGround = false;
-                }
-            }
-
-            if(isOnGround || newPosition.z() < swimlevel || isFlying)
-                physicActor->setInertialForce(osg::Vec3f(0.f, 0.f, 0.f));
-            else
-            {
-                inertia.z() += time * -627.2f;
-                if (inertia.z() < 0)
-                    inertia.z() *= slowFall;
-                physicActor->setInertialForce(inertia);
-            }
-            physicActor->setOnGround(isOnGround);
-
-            newPosition.z() -= halfExtents.z(); // remove what was added at the beginning
-            return newPosition;
-        }
-    };
-
+#ifdef HAVE_BULLET_TASK_SCHEDULER
+        // Only returns a scheduler if Bullet was built with BT_THREADSAFE
+        btITaskScheduler* scheduler = btCreateDefaultTaskScheduler();
+        bool threadSafe = (scheduler != NULL);
+        delete scheduler;
+        return threadSafe;
+#else
+        return false;
+#endif
+    }
 
     // ---------------------------------------------------------------
 
@@ -596,6 +215,11 @@ namespace MWPhysics
     PhysicsSystem::PhysicsSystem(Resource::ResourceSystem* resourceSystem, osg::ref_ptr<osg::Group> parentNode)
         : mShapeManager(new NifBullet::BulletShapeManager(resourceSystem->getVFS()))
         , mDebugDrawEnabled(false)
+        , mNumThreads(0)
+        , mAsyncSimulation(false)
+        , mStepper(1.0f/60.0f, 5)
+        , mPendingSteps(0)
+        , mMovementGlobals(new MovementGlobals)
         , mTimeAccum(0.0f)
         , mWaterHeight(0)
         , mWaterEnabled(false)
@@ -610,10 +234,29 @@ namespace MWPhysics
         // Don't update AABBs of all objects every frame. Most objects in MW are static, so we don't need this.
         // Should a "static" object ever be moved, we have to update its AABB manually using DynamicsWorld::updateSingleAabb.
         mCollisionWorld->setForceUpdateAllAabbs(false);
+
+        mNumThreads = std::max(0, Settings::Manager::getInt("async num threads", "Physics"));
+        mAsyncSimulation = Settings::Manager::getBool("async simulation", "Physics");
+        // Older or non-threadsafe Bullet builds share a single traversal stack between all broadphase queries
+        if ((mNumThreads > 0 || mAsyncSimulation) && !isBulletThreadSafe())
+        {
+            std::cout << "Bullet was built without multithreading support, actor movement is solved on the main thread" << std::endl;
+            mNumThreads = 0;
+            mAsyncSimulation = false;
+        }
+        if (mNumThreads > 0)
+            mWorkQueue.reset(new SceneUtil::WorkQueue(mNumThreads));
+        if (mAsyncSimulation)
+            mSimulationQueue.reset(new SceneUtil::WorkQueue(1));
     }
 
     PhysicsSystem::~PhysicsSystem()
     {
+        // finish any outstanding work before tearing down the collision world
+        waitForSimulation();
+        mSimulationQueue.reset();
+        mWorkQueue.reset();
+
         if (mWaterCollisionObject.get())
             mCollisionWorld->removeCollisionObject(mWaterCollisionObject.get());
 
@@ -640,6 +283,11 @@ namespace MWPhysics
         delete mBroadphase;
     }
 
+    NifBullet::BulletShapeManager* PhysicsSystem::getShapeManager()
+    {
+        return mShapeManager.get();
+    }
+
     bool PhysicsSystem::toggleDebugRendering()
     {
         mDebugDrawEnabled = !mDebugDrawEnabled;
@@ -718,8 +366,10 @@ namespace MWPhysics
         object.setCollisionShape(&shape);
         object.setWorldTransform(btTransform(toBullet(orient), toBullet(center)));
 
+        waitForSimulation();
+
         const btCollisionObject* me = NULL;
-        Actor* physactor = getActor(actor);
+        const Actor* physactor = findActor(actor);
         if (physactor)
             me = physactor->getCollisionObject();
 
@@ -758,13 +408,15 @@ namespace MWPhysics
 
     PhysicsSystem::RayResult PhysicsSystem::castRay(const osg::Vec3f &from, const osg::Vec3f &to, MWWorld::Ptr ignore, int mask, int group)
     {
+        waitForSimulation();
+
         btVector3 btFrom = toBullet(from);
         btVector3 btTo = toBullet(to);
 
         const btCollisionObject* me = NULL;
         if (!ignore.isEmpty())
         {
-            Actor* actor = getActor(ignore);
+            const Actor* actor = findActor(ignore);
             if (actor)
                 me = actor->getCollisionObject();
         }
@@ -789,6 +441,8 @@ namespace MWPhysics
 
     PhysicsSystem::RayResult PhysicsSystem::castSphere(const osg::Vec3f &from, const osg::Vec3f &to, float radius)
     {
+        waitForSimulation();
+
         btCollisionWorld::ClosestConvexResultCallback callback(toBullet(from), toBullet(to));
         callback.m_collisionFilterGroup = 0xff;
         callback.m_collisionFilterMask = CollisionType_World|CollisionType_HeightMap;
@@ -813,8 +467,10 @@ namespace MWPhysics
 
     bool PhysicsSystem::getLineOfSight(const MWWorld::Ptr &actor1, const MWWorld::Ptr &actor2)
     {
-        Actor* physactor1 = getActor(actor1);
-        Actor* physactor2 = getActor(actor2);
+        waitForSimulation();
+
+        const Actor* physactor1 = findActor(actor1);
+        const Actor* physactor2 = findActor(actor2);
 
         if (!physactor1 || !physactor2)
             return false;
@@ -854,7 +510,7 @@ namespace MWPhysics
 
             ActorTracer tracer;
             // a small distance above collision object is considered "on ground"
-            tracer.findGround(physactor,
+            tracer.findGround(physactor->getCollisionObject(), physactor->getHalfExtents(),
                               pos,
                               pos - osg::Vec3f(0, 0, 1.5f), // trace a small amount down
                               mCollisionWorld);
@@ -870,7 +526,9 @@ namespace MWPhysics
 
     osg::Vec3f PhysicsSystem::getHalfExtents(const MWWorld::Ptr &actor)
     {
-        Actor* physactor = getActor(actor);
+        waitForSimulation();
+
+        const Actor* physactor = findActor(actor);
         if (physactor)
             return physactor->getHalfExtents();
         else
@@ -903,6 +561,8 @@ namespace MWPhysics
 
     std::vector<MWWorld::Ptr> PhysicsSystem::getCollisions(const MWWorld::Ptr &ptr, int collisionGroup, int collisionMask)
     {
+        waitForSimulation();
+
         btCollisionObject* me = NULL;
 
         ObjectMap::iterator found = mObjects.find(ptr);
@@ -920,15 +580,24 @@ namespace MWPhysics
 
     osg::Vec3f PhysicsSystem::traceDown(const MWWorld::Ptr &ptr, float maxHeight)
     {
+        waitForSimulation();
+
         ActorMap::iterator found = mActors.find(ptr);
         if (found ==  mActors.end())
             return ptr.getRefData().getPosition().asVec3();
-        else
-            return MovementSolver::traceDown(ptr, found->second, mCollisionWorld, maxHeight);
+
+        Actor* actor = found->second;
+        bool onGround = false;
+        osg::Vec3f position = MovementSolver::traceDown(ptr.getRefData().getPosition().asVec3(), actor->getCollisionObject(),
+                                                        actor->getHalfExtents(), mCollisionWorld, maxHeight, onGround);
+        actor->setOnGround(onGround);
+        return position;
     }
 
     void PhysicsSystem::addHeightField (float* heights, int x, int y, float triSize, float sqrtVerts)
     {
+        waitForSimulation();
+
         HeightField *heightfield = new HeightField(heights, x, y, triSize, sqrtVerts);
         mHeightFields[std::make_pair(x,y)] = heightfield;
 
@@ -938,6 +607,8 @@ namespace MWPhysics
 
     void PhysicsSystem::removeHeightField (int x, int y)
     {
+        waitForSimulation();
+
         HeightFieldMap::iterator heightfield = mHeightFields.find(std::make_pair(x,y));
         if(heightfield != mHeightFields.end())
         {
@@ -949,6 +620,8 @@ namespace MWPhysics
 
     void PhysicsSystem::addObject (const MWWorld::Ptr& ptr, const std::string& mesh)
     {
+        waitForSimulation();
+
         osg::ref_ptr<NifBullet::BulletShapeInstance> shapeInstance = mShapeManager->createInstance(mesh);
         if (!shapeInstance->getCollisionShape())
             return;
@@ -962,6 +635,8 @@ namespace MWPhysics
 
     void PhysicsSystem::remove(const MWWorld::Ptr &ptr)
     {
+        waitForSimulation();
+
         ObjectMap::iterator found = mObjects.find(ptr);
         if (found != mObjects.end())
         {
@@ -976,26 +651,17 @@ namespace MWPhysics
             delete foundActor->second;
             mActors.erase(foundActor);
         }
-    }
-
-    void PhysicsSystem::updateCollisionMapPtr(CollisionMap& map, const MWWorld::Ptr &old, const MWWorld::Ptr &updated)
-    {
-        CollisionMap::iterator found = map.find(old);
-        if (found != map.end())
-        {
-            map[updated] = found->second;
-            map.erase(found);
-        }
 
-        for (CollisionMap::iterator it = map.begin(); it != map.end(); ++it)
-        {
-            if (it->second == old)
-                it->second = updated;
-        }
+        // The prepared jobs and the last results refer to the deleted Actor
+        mSimulation.remove(ptr);
     }
 
     void PhysicsSystem::updatePtr(const MWWorld::Ptr &old, const MWWorld::Ptr &updated)
     {
+        waitForSimulation();
+
+        mSimulation.updatePtr(old, updated);
+
         ObjectMap::iterator found = mObjects.find(old);
         if (found != mObjects.end())
         {
@@ -1013,21 +679,31 @@ namespace MWPhysics
             mActors.erase(foundActor);
             mActors.insert(std::make_pair(updated, actor));
         }
-
-        updateCollisionMapPtr(mCollisions, old, updated);
-        updateCollisionMapPtr(mStandingCollisions, old, updated);
     }
 
     Actor *PhysicsSystem::getActor(const MWWorld::Ptr &ptr)
     {
+        // the caller may modify the actor
+        waitForSimulation();
+
         ActorMap::iterator found = mActors.find(ptr);
         if (found != mActors.end())
             return found->second;
         return NULL;
     }
 
+    const Actor *PhysicsSystem::findActor(const MWWorld::Ptr &ptr) const
+    {
+        ActorMap::const_iterator found = mActors.find(ptr);
+        if (found != mActors.end())
+            return found->second;
+        return NULL;
+    }
+
     void PhysicsSystem::updateScale(const MWWorld::Ptr &ptr)
     {
+        waitForSimulation();
+
         ObjectMap::iterator found = mObjects.find(ptr);
         float scale = ptr.getCellRef().getScale();
         if (found != mObjects.end())
@@ -1047,6 +723,8 @@ namespace MWPhysics
 
     void PhysicsSystem::updateRotation(const MWWorld::Ptr &ptr)
     {
+        waitForSimulation();
+
         ObjectMap::iterator found = mObjects.find(ptr);
         if (found != mObjects.end())
         {
@@ -1065,6 +743,8 @@ namespace MWPhysics
 
     void PhysicsSystem::updatePosition(const MWWorld::Ptr &ptr)
     {
+        waitForSimulation();
+
         ObjectMap::iterator found = mObjects.find(ptr);
         if (found != mObjects.end())
         {
@@ -1083,6 +763,8 @@ namespace MWPhysics
 
     void PhysicsSystem::addActor (const MWWorld::Ptr& ptr, const std::string& mesh)
     {
+        waitForSimulation();
+
         osg::ref_ptr<NifBullet::BulletShapeInstance> shapeInstance = mShapeManager->createInstance(mesh);
 
         Actor* actor = new Actor(ptr, shapeInstance, mCollisionWorld);
@@ -1091,6 +773,8 @@ namespace MWPhysics
 
     bool PhysicsSystem::toggleCollisionMode()
     {
+        waitForSimulation();
+
         ActorMap::iterator found = mActors.find(MWBase::Environment::get().getWorld()->getPlayerPtr());
         if (found != mActors.end())
         {
@@ -1120,63 +804,171 @@ namespace MWPhysics
 
     void PhysicsSystem::clearQueuedMovement()
     {
+        waitForSimulation();
+
         mMovementQueue.clear();
-        mCollisions.clear();
-        mStandingCollisions.clear();
+        mSimulation.clear();
+        mPendingSteps = 0;
+        mStepper.reset();
     }
 
-    const PtrVelocityList& PhysicsSystem::applyQueuedMovement(float dt)
+    void PhysicsSystem::prepareMovementJobs()
     {
-        mMovementResults.clear();
+        const MWBase::World *world = MWBase::Environment::get().getWorld();
 
-        mTimeAccum += dt;
-        if(mTimeAccum >= 1.0f/60.0f)
+        const MWWorld::Store<ESM::GameSetting>& gmst = world->getStore().get<ESM::GameSetting>();
+        mMovementGlobals->mSwimHeightScale = gmst.find("fSwimHeightScale")->getFloat();
+        mMovementGlobals->mStromWalkMult = gmst.find("fStromWalkMult")->getFloat();
+        mMovementGlobals->mInStorm = world->isInStorm();
+        mMovementGlobals->mStormDirection = world->getStormDirection();
+
+        // Where the simulation runs ahead of the positions handed out, continue from the simulated position
+        std::map<MWWorld::Ptr, const MovementJob*> simulated;
+        if (mAsyncSimulation)
         {
-            // Collision events should be available on every frame
-            mCollisions.clear();
-            mStandingCollisions.clear();
+            const std::vector<MovementJob>& results = mSimulation.getResults();
+            for (std::vector<MovementJob>::const_iterator it = results.begin(); it != results.end(); ++it)
+                simulated[it->mPtr] = &*it;
+        }
 
-            const MWBase::World *world = MWBase::Environment::get().getWorld();
-            PtrVelocityList::iterator iter = mMovementQueue.begin();
-            for(;iter != mMovementQueue.end();++iter)
+        // Gather everything that needs the world or modifies the collision world up front,
+        // so that the actual movement solving only has to read from the collision world.
+        std::vector<MovementJob>& jobs = mSimulation.getJobs();
+        jobs.clear();
+        jobs.reserve(mMovementQueue.size());
+        PtrVelocityList::iterator iter = mMovementQueue.begin();
+        for(;iter != mMovementQueue.end();++iter)
+        {
+            ActorMap::iterator foundActor = mActors.find(iter->first);
+            if (foundActor == mActors.end()) // actor was already removed from the scene
+                continue;
+
+            MovementJob job;
+            job.mPtr = iter->first;
+            job.mActor = foundActor->second;
+            job.mMovement = iter->second;
+            job.mRefPosition = iter->first.getRefData().getPosition();
+
+            job.mReportedPosition = job.mRefPosition.asVec3();
+            std::map<MWWorld::Ptr, const MovementJob*>::const_iterator found = simulated.find(iter->first);
+            if (found != simulated.end())
             {
-                float waterlevel = -std::numeric_limits<float>::max();
-                const MWWorld::CellStore *cell = iter->first.getCell();
-                if(cell->getCell()->hasWater())
-                    waterlevel = cell->getWaterLevel();
+                for (int i=0; i<3; ++i)
+                    job.mRefPosition.pos[i] = found->second->mPosition[i];
+                job.mReportedPosition = found->second->mReportedPosition;
+            }
+            job.mPosition = job.mPreviousPosition = job.mRefPosition.asVec3();
 
-                float oldHeight = iter->first.getRefData().getPosition().pos[2];
+            job.mWaterLevel = -std::numeric_limits<float>::max();
+            const MWWorld::CellStore *cell = iter->first.getCell();
+            if(cell->getCell()->hasWater())
+                job.mWaterLevel = cell->getWaterLevel();
 
-                const MWMechanics::MagicEffects& effects = iter->first.getClass().getCreatureStats(iter->first).getMagicEffects();
+            const MWMechanics::MagicEffects& effects = iter->first.getClass().getCreatureStats(iter->first).getMagicEffects();
 
-                bool waterCollision = false;
-                if (effects.get(ESM::MagicEffect::WaterWalking).getMagnitude()
-                        && cell->getCell()->hasWater()
-                        && !world->isUnderwater(iter->first.getCell(),
-                                               osg::Vec3f(iter->first.getRefData().getPosition().asVec3())))
-                    waterCollision = true;
+            bool waterCollision = false;
+            if (effects.get(ESM::MagicEffect::WaterWalking).getMagnitude()
+                    && cell->getCell()->hasWater()
+                    && !world->isUnderwater(iter->first.getCell(),
+                                           osg::Vec3f(iter->first.getRefData().getPosition().asVec3())))
+                waterCollision = true;
 
-                ActorMap::iterator foundActor = mActors.find(iter->first);
-                if (foundActor == mActors.end()) // actor was already removed from the scene
-                    continue;
-                Actor* physicActor = foundActor->second;
-                physicActor->setCanWaterWalk(waterCollision);
+            job.mActor->setCanWaterWalk(waterCollision);
+
+            // Slow fall reduces fall speed by a factor of (effect magnitude / 200)
+            job.mSlowFall = 1.f - std::max(0.f, std::min(1.f, effects.get(ESM::MagicEffect::SlowFall).getMagnitude() * 0.005f));
+
+            job.mIsFlying = world->isFlying(iter->first);
+            job.mIsMobile = iter->first.getClass().isMobile(iter->first);
+            job.mIsPureWaterCreature = iter->first.getClass().isPureWaterCreature(iter->first);
+
+            job.mCollisionObject = job.mActor->getCollisionObject();
+            job.mHalfExtents = job.mActor->getHalfExtents();
+            job.mCollisionMode = job.mActor->getCollisionMode();
+            job.mInertia = job.mActor->getInertialForce();
+            job.mOnGround = job.mActor->getOnGround();
+            job.mWalkingOnWater = job.mActor->isWalkingOnWater();
+
+            // The vertical movement (i.e. jumping) is consumed by the solver
+            if (job.mIsMobile && job.mCollisionMode)
+                iter->first.getClass().getMovementSettings(iter->first).mPosition[2] = 0;
+
+            jobs.push_back(job);
+        }
+    }
+
+    void PhysicsSystem::mergeMovementJobs()
+    {
+        // Merge the results in queue order, so the outcome does not depend on how the work was split
+        const std::vector<MovementJob>& jobs = mSimulation.getJobs();
+        for (std::vector<MovementJob>::const_iterator it = jobs.begin(); it != jobs.end(); ++it)
+        {
+            // Static creatures are skipped by the solver, and without collision there is nothing to stand on
+            if (it->mIsMobile)
+            {
+                it->mActor->setWalkingOnWater(it->mWalkingOnWater);
+                if (it->mCollisionMode)
+                {
+                    it->mActor->setInertialForce(it->mInertia);
+                    it->mActor->setOnGround(it->mOnGround);
+                }
+            }
 
-                // Slow fall reduces fall speed by a factor of (effect magnitude / 200)
-                float slowFall = 1.f - std::max(0.f, std::min(1.f, effects.get(ESM::MagicEffect::SlowFall).getMagnitude() * 0.005f));
+            float heightDiff = it->mPosition.z() - it->mRefPosition.pos[2];
 
-                osg::Vec3f newpos = MovementSolver::move(iter->first, physicActor, iter->second, mTimeAccum,
-                                                            world->isFlying(iter->first),
-                                                            waterlevel, slowFall, mCollisionWorld, mCollisions, mStandingCollisions);
+            if (heightDiff < 0)
+                it->mPtr.getClass().getCreatureStats(it->mPtr).addToFallHeight(-heightDiff);
+        }
+    }
 
-                float heightDiff = newpos.z() - oldHeight;
+    const PtrVelocityList& PhysicsSystem::applyQueuedMovement(float dt)
+    {
+        Misc::ProfileZone zone("PhysicsSystem::applyQueuedMovement");
+        mMovementResults.clear();
 
-                if (heightDiff < 0)
-                    iter->first.getClass().getCreatureStats(iter->first).addToFallHeight(-heightDiff);
+        if (mAsyncSimulation)
+        {
+            waitForSimulation();
 
-                mMovementResults.push_back(std::make_pair(iter->first, newpos));
+            // Hand out positions interpolated between the last two simulated steps. This lags behind the
+            // simulation by up to one step, but keeps actor motion smooth regardless of the frame rate.
+            float factor = mStepper.getInterpolationFactor();
+            std::vector<MovementJob>& results = mSimulation.getResults();
+            for (std::vector<MovementJob>::iterator it = results.begin(); it != results.end(); )
+            {
+                if (it->mPtr.getRefData().getPosition().asVec3() != it->mReportedPosition)
+                {
+                    // moved by someone else, restart from its current position
+                    it = results.erase(it);
+                    continue;
+                }
+                it->mReportedPosition = it->mPreviousPosition + (it->mPosition - it->mPreviousPosition) * factor;
+                mMovementResults.push_back(std::make_pair(it->mPtr, it->mReportedPosition));
+                ++it;
             }
 
+            mPendingSteps = mStepper.advance(dt);
+            if (mPendingSteps > 0)
+                prepareMovementJobs();
+            mMovementQueue.clear();
+
+            return mMovementResults;
+        }
+
+        mTimeAccum += dt;
+        if(mTimeAccum >= 1.0f/60.0f)
+        {
+            prepareMovementJobs();
+
+            solveMovement(mSimulation.getJobs(), mTimeAccum, 1, *mMovementGlobals, mCollisionWorld, mWorkQueue.get(), mNumThreads);
+
+            mergeMovementJobs();
+            mSimulation.complete();
+
+            const std::vector<MovementJob>& results = mSimulation.getResults();
+            for (std::vector<MovementJob>::const_iterator it = results.begin(); it != results.end(); ++it)
+                mMovementResults.push_back(std::make_pair(it->mPtr, it->mPosition));
+
             mTimeAccum = 0.0f;
         }
         mMovementQueue.clear();
@@ -1184,8 +976,31 @@ namespace MWPhysics
         return mMovementResults;
     }
 
+    void PhysicsSystem::startSimulation()
+    {
+        if (!mAsyncSimulation || mPendingSteps == 0)
+            return;
+
+        mSimulation.start(mSimulationQueue.get(), mStepper.getStepLength(), mPendingSteps, *mMovementGlobals,
+                          mCollisionWorld, mWorkQueue.get(), mNumThreads);
+        mPendingSteps = 0;
+    }
+
+    void PhysicsSystem::waitForSimulation()
+    {
+        if (!mSimulation.isRunning())
+            return;
+
+        mSimulation.wait();
+
+        mergeMovementJobs();
+        mSimulation.complete();
+    }
+
     void PhysicsSystem::stepSimulation(float dt)
     {
+        waitForSimulation();
+
         for (ObjectMap::iterator it = mObjects.begin(); it != mObjects.end(); ++it)
             it->second->animateCollisionShapes(mCollisionWorld);
 
@@ -1201,7 +1016,8 @@ namespace MWPhysics
 
     bool PhysicsSystem::isActorStandingOn(const MWWorld::Ptr &actor, const MWWorld::Ptr &object) const
     {
-        for (CollisionMap::const_iterator it = mStandingCollisions.begin(); it != mStandingCollisions.end(); ++it)
+        const SimulationBuffer::CollisionMap& collisions = mSimulation.getStandingCollisions();
+        for (SimulationBuffer::CollisionMap::const_iterator it = collisions.begin(); it != collisions.end(); ++it)
         {
             if (it->first == actor && it->second == object)
                 return true;
@@ -1211,7 +1027,8 @@ namespace MWPhysics
 
     void PhysicsSystem::getActorsStandingOn(const MWWorld::Ptr &object, std::vector<MWWorld::Ptr> &out) const
     {
-        for (CollisionMap::const_iterator it = mStandingCollisions.begin(); it != mStandingCollisions.end(); ++it)
+        const SimulationBuffer::CollisionMap& collisions = mSimulation.getStandingCollisions();
+        for (SimulationBuffer::CollisionMap::const_iterator it = collisions.begin(); it != collisions.end(); ++it)
         {
             if (it->second == object)
                 out.push_back(it->first);
@@ -1220,7 +1037,8 @@ namespace MWPhysics
 
     bool PhysicsSystem::isActorCollidingWith(const MWWorld::Ptr &actor, const MWWorld::Ptr &object) const
     {
-        for (CollisionMap::const_iterator it = mCollisions.begin(); it != mCollisions.end(); ++it)
+        const SimulationBuffer::CollisionMap& collisions = mSimulation.getCollisions();
+        for (SimulationBuffer::CollisionMap::const_iterator it = collisions.begin(); it != collisions.end(); ++it)
         {
             if (it->first == actor && it->second == object)
                 return true;
@@ -1230,7 +1048,8 @@ namespace MWPhysics
 
     void PhysicsSystem::getActorsCollidingWith(const MWWorld::Ptr &object, std::vector<MWWorld::Ptr> &out) const
     {
-        for (CollisionMap::const_iterator it = mCollisions.begin(); it != mCollisions.end(); ++it)
+        const SimulationBuffer::CollisionMap& collisions = mSimulation.getCollisions();
+        for (SimulationBuffer::CollisionMap::const_iterator it = collisions.begin(); it != collisions.end(); ++it)
         {
             if (it->second == object)
                 out.push_back(it->first);
@@ -1239,6 +1058,8 @@ namespace MWPhysics
 
     void PhysicsSystem::disableWater()
     {
+        waitForSimulation();
+
         if (mWaterEnabled)
         {
             mWaterEnabled = false;
@@ -1248,6 +1069,8 @@ namespace MWPhysics
 
     void PhysicsSystem::enableWater(float height)
     {
+        waitForSimulation();
+
         if (!mWaterEnabled || mWaterHeight != height)
         {
             mWaterEnabled = true;
@@ -1258,6 +1081,8 @@ namespace MWPhysics
 
     void PhysicsSystem::setWaterHeight(float height)
     {
+        waitForSimulation();
+
         if (mWaterHeight != height)
         {
             mWaterHeight = height;
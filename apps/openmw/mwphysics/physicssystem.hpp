@@ -3,13 +3,19 @@
 
 #include <memory>
 #include <map>
+#include <vector>
 
 #include <osg/Quat>
 #include <osg/ref_ptr>
 
+#include <components/esm/defs.hpp>
+
 #include "../mwworld/ptr.hpp"
 
 #include "collisiontype.hpp"
+#include "movementsolver.hpp"
+#include "simulationbuffer.hpp"
+#include "stepper.hpp"
 
 namespace osg
 {
@@ -31,6 +37,11 @@ namespace Resource
     class ResourceSystem;
 }
 
+namespace SceneUtil
+{
+    class WorkQueue;
+}
+
 class btCollisionWorld;
 class btBroadphaseInterface;
 class btDefaultCollisionConfiguration;
@@ -52,6 +63,8 @@ namespace MWPhysics
             PhysicsSystem (Resource::ResourceSystem* resourceSystem, osg::ref_ptr<osg::Group> parentNode);
             ~PhysicsSystem ();
 
+            NifBullet::BulletShapeManager* getShapeManager();
+
             void enableWater(float height);
             void setWaterHeight(float height);
             void disableWater();
@@ -114,24 +127,33 @@ namespace MWPhysics
             void queueObjectMovement(const MWWorld::Ptr &ptr, const osg::Vec3f &velocity);
 
             /// Apply all queued movements, then clear the list.
+            /// @note With asynchronous simulation enabled, returns positions interpolated between the last two
+            /// simulated steps and only prepares the queued movements. The caller is expected to apply the returned
+            /// positions, then call startSimulation().
             const PtrVelocityList& applyQueuedMovement(float dt);
 
+            /// Start simulating the movements prepared by applyQueuedMovement in the background.
+            /// Does nothing unless asynchronous simulation is enabled.
+            void startSimulation();
+
             /// Clear the queued movements list without applying.
             void clearQueuedMovement();
 
-            /// Return true if \a actor has been standing on \a object in this frame
+            /// Return true if \a actor has been standing on \a object during the last movement simulation
             /// This will trigger whenever the object is directly below the actor.
             /// It doesn't matter if the actor is stationary or moving.
+            /// @note Movement is simulated at a fixed rate, so the collisions are kept until the next simulation
+            /// rather than cleared every frame.
             bool isActorStandingOn(const MWWorld::Ptr& actor, const MWWorld::Ptr& object) const;
 
-            /// Get the handle of all actors standing on \a object in this frame.
+            /// Get the handle of all actors standing on \a object during the last movement simulation.
             void getActorsStandingOn(const MWWorld::Ptr& object, std::vector<MWWorld::Ptr>& out) const;
 
-            /// Return true if \a actor has collided with \a object in this frame.
+            /// Return true if \a actor has collided with \a object during the last movement simulation.
             /// This will detect running into objects, but will not detect climbing stairs, stepping up a small object, etc.
             bool isActorCollidingWith(const MWWorld::Ptr& actor, const MWWorld::Ptr& object) const;
 
-            /// Get the handle of all actors colliding with \a object in this frame.
+            /// Get the handle of all actors colliding with \a object during the last movement simulation.
             void getActorsCollidingWith(const MWWorld::Ptr& object, std::vector<MWWorld::Ptr>& out) const;
 
             bool toggleDebugRendering();
@@ -140,6 +162,17 @@ namespace MWPhysics
 
             void updateWater();
 
+            /// Same as getActor, but does not wait for the simulation. Queries of the collision world
+            /// must still call waitForSimulation() first, as it may be in use by the simulation thread.
+            const Actor* findActor(const MWWorld::Ptr& ptr) const;
+
+            void prepareMovementJobs();
+            void mergeMovementJobs();
+
+            /// Wait for the background simulation to complete, if one is running, and collect its results.
+            /// Must be called before modifying the collision world or any actor.
+            void waitForSimulation();
+
             btBroadphaseInterface* mBroadphase;
             btDefaultCollisionConfiguration* mCollisionConfiguration;
             btCollisionDispatcher* mDispatcher;
@@ -158,19 +191,24 @@ namespace MWPhysics
 
             bool mDebugDrawEnabled;
 
-            // Tracks all movement collisions happening during a single frame. <actor handle, collided handle>
-            // This will detect e.g. running against a vertical wall. It will not detect climbing up stairs,
-            // stepping up small objects, etc.
-            typedef std::map<MWWorld::Ptr, MWWorld::Ptr> CollisionMap;
-            CollisionMap mCollisions;
-            CollisionMap mStandingCollisions;
-
-            // replaces all occurences of 'old' in the map by 'updated', no matter if its a key or value
-            void updateCollisionMapPtr(CollisionMap& map, const MWWorld::Ptr &old, const MWWorld::Ptr &updated);
-
             PtrVelocityList mMovementQueue;
             PtrVelocityList mMovementResults;
 
+            /// Movement jobs, their results and the movement collisions found while solving them
+            SimulationBuffer mSimulation;
+
+            /// Number of worker threads helping the main thread with solving actor movement
+            int mNumThreads;
+            std::auto_ptr<SceneUtil::WorkQueue> mWorkQueue;
+
+            /// Simulate at a fixed rate on a separate thread?
+            bool mAsyncSimulation;
+            FixedStepper mStepper;
+            int mPendingSteps;
+            std::auto_ptr<SceneUtil::WorkQueue> mSimulationQueue;
+
+            std::auto_ptr<MovementGlobals> mMovementGlobals;
+
             float mTimeAccum;
 
             float mWaterHeight;
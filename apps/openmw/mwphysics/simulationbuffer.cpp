@@ -0,0 +1,155 @@
+#include "simulationbuffer.hpp"
+
+#include <cassert>
+
+#include <components/sceneutil/workqueue.hpp>
+
+namespace MWPhysics
+{
+
+    namespace
+    {
+        /// Runs a fixed number of simulation steps on the simulation thread.
+        class SimulationWorkItem : public SceneUtil::WorkItem
+        {
+        public:
+            SimulationWorkItem(std::vector<MovementJob>& jobs, float time, int steps, const MovementGlobals& globals,
+                               btCollisionWorld* collisionWorld, SceneUtil::WorkQueue* workQueue, int numThreads)
+                : mJobs(jobs), mTime(time), mSteps(steps), mGlobals(globals), mCollisionWorld(collisionWorld)
+                , mWorkQueue(workQueue), mNumThreads(numThreads)
+            {
+            }
+
+            virtual void doWork()
+            {
+                solveMovement(mJobs, mTime, mSteps, mGlobals, mCollisionWorld, mWorkQueue, mNumThreads);
+                mTicket->signalDone();
+            }
+
+        private:
+            std::vector<MovementJob>& mJobs;
+            float mTime;
+            int mSteps;
+            MovementGlobals mGlobals;
+            btCollisionWorld* mCollisionWorld;
+            SceneUtil::WorkQueue* mWorkQueue;
+            int mNumThreads;
+        };
+
+        void removeJobs(std::vector<MovementJob>& jobs, const MWWorld::Ptr& ptr)
+        {
+            for (std::vector<MovementJob>::iterator it = jobs.begin(); it != jobs.end(); )
+            {
+                if (it->mPtr == ptr)
+                    it = jobs.erase(it);
+                else
+                    ++it;
+            }
+        }
+
+        void updateJobs(std::vector<MovementJob>& jobs, const MWWorld::Ptr& old, const MWWorld::Ptr& updated)
+        {
+            for (std::vector<MovementJob>::iterator it = jobs.begin(); it != jobs.end(); ++it)
+            {
+                if (it->mPtr == old)
+                    it->mPtr = updated;
+            }
+        }
+
+        void updateCollisionMap(SimulationBuffer::CollisionMap& map, const MWWorld::Ptr& old, const MWWorld::Ptr& updated)
+        {
+            SimulationBuffer::CollisionMap::iterator found = map.find(old);
+            if (found != map.end())
+            {
+                map[updated] = found->second;
+                map.erase(found);
+            }
+
+            for (SimulationBuffer::CollisionMap::iterator it = map.begin(); it != map.end(); ++it)
+            {
+                if (it->second == old)
+                    it->second = updated;
+            }
+        }
+    }
+
+    SimulationBuffer::SimulationBuffer()
+    {
+    }
+
+    SimulationBuffer::~SimulationBuffer()
+    {
+        // the simulation thread writes to mJobs
+        wait();
+    }
+
+    void SimulationBuffer::start(SceneUtil::WorkQueue* simulationQueue, float time, int steps, const MovementGlobals& globals,
+                                 btCollisionWorld* collisionWorld, SceneUtil::WorkQueue* workQueue, int numThreads)
+    {
+        assert(!isRunning());
+        mTicket = simulationQueue->addWorkItem(new SimulationWorkItem(mJobs, time, steps, globals, collisionWorld,
+                                                                      workQueue, numThreads));
+    }
+
+    void SimulationBuffer::wait()
+    {
+        if (!mTicket)
+            return;
+
+        mTicket->waitTillDone();
+        mTicket = NULL;
+    }
+
+    void SimulationBuffer::complete()
+    {
+        assert(!isRunning());
+
+        mCollisions.clear();
+        mStandingCollisions.clear();
+
+        for (std::vector<MovementJob>::const_iterator it = mJobs.begin(); it != mJobs.end(); ++it)
+        {
+            if (!it->mCollidedWith.isEmpty())
+                mCollisions[it->mPtr] = it->mCollidedWith;
+            if (!it->mStandingOn.isEmpty())
+                mStandingCollisions[it->mPtr] = it->mStandingOn;
+        }
+
+        mResults.swap(mJobs);
+        mJobs.clear();
+    }
+
+    void SimulationBuffer::remove(const MWWorld::Ptr& ptr)
+    {
+        assert(!isRunning());
+
+        removeJobs(mJobs, ptr);
+        removeJobs(mResults, ptr);
+
+        // The object itself stays valid, so collisions with it are kept
+        mCollisions.erase(ptr);
+        mStandingCollisions.erase(ptr);
+    }
+
+    void SimulationBuffer::updatePtr(const MWWorld::Ptr& old, const MWWorld::Ptr& updated)
+    {
+        assert(!isRunning());
+
+        updateJobs(mJobs, old, updated);
+        updateJobs(mResults, old, updated);
+
+        updateCollisionMap(mCollisions, old, updated);
+        updateCollisionMap(mStandingCollisions, old, updated);
+    }
+
+    void SimulationBuffer::clear()
+    {
+        assert(!isRunning());
+
+        mJobs.clear();
+        mResults.clear();
+        mCollisions.clear();
+        mStandingCollisions.clear();
+    }
+
+}
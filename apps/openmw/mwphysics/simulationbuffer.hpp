@@ -0,0 +1,84 @@
+#ifndef OPENMW_MWPHYSICS_SIMULATIONBUFFER_H
+#define OPENMW_MWPHYSICS_SIMULATIONBUFFER_H
+
+#include <map>
+#include <vector>
+
+#include <osg/ref_ptr>
+
+#include "../mwworld/ptr.hpp"
+
+#include "movementsolver.hpp"
+
+namespace SceneUtil
+{
+    class WorkQueue;
+    class WorkTicket;
+}
+
+namespace MWPhysics
+{
+
+    /// @brief Double buffered movement jobs of the asynchronous simulation.
+    /// Holds the jobs being prepared or simulated, the results of the last completed simulation,
+    /// and the collisions found by it.
+    /// @note Apart from start() and wait(), must not be used while a simulation is running.
+    class SimulationBuffer
+    {
+    public:
+        /// <actor handle, collided handle>
+        typedef std::map<MWWorld::Ptr, MWWorld::Ptr> CollisionMap;
+
+        SimulationBuffer();
+        ~SimulationBuffer();
+
+        /// Start solving the jobs for \a steps steps of \a time seconds each on \a simulationQueue.
+        /// The remaining parameters are passed on to solveMovement.
+        void start(SceneUtil::WorkQueue* simulationQueue, float time, int steps, const MovementGlobals& globals,
+                   btCollisionWorld* collisionWorld, SceneUtil::WorkQueue* workQueue, int numThreads);
+
+        bool isRunning() const { return mTicket.valid(); }
+
+        /// Wait for the simulation started by start() to finish. The results are collected by complete().
+        void wait();
+
+        /// Jobs to be simulated next, or being simulated.
+        std::vector<MovementJob>& getJobs() { return mJobs; }
+
+        /// Jobs of the last completed simulation.
+        std::vector<MovementJob>& getResults() { return mResults; }
+
+        /// Make the simulated jobs the new results, and replace the collisions with those found by the simulation.
+        /// @note The collisions are kept until the next simulation is completed, so they are available on frames
+        /// that did not simulate a step.
+        void complete();
+
+        /// Drop the jobs, results and collisions of \a ptr, e.g. because it was removed from the scene.
+        void remove(const MWWorld::Ptr& ptr);
+
+        /// Replace all occurences of \a old by \a updated.
+        void updatePtr(const MWWorld::Ptr& old, const MWWorld::Ptr& updated);
+
+        void clear();
+
+        /// Movement collisions found by the last completed simulation.
+        /// This will detect e.g. running against a vertical wall. It will not detect climbing up stairs,
+        /// stepping up small objects, etc.
+        const CollisionMap& getCollisions() const { return mCollisions; }
+
+        /// Objects directly below an actor at the end of the last completed simulation.
+        const CollisionMap& getStandingCollisions() const { return mStandingCollisions; }
+
+    private:
+        osg::ref_ptr<SceneUtil::WorkTicket> mTicket;
+
+        std::vector<MovementJob> mJobs;
+        std::vector<MovementJob> mResults;
+
+        CollisionMap mCollisions;
+        CollisionMap mStandingCollisions;
+    };
+
+}
+
+#endif
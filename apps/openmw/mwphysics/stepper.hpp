@@ -0,0 +1,70 @@
+#ifndef OPENMW_MWPHYSICS_STEPPER_H
+#define OPENMW_MWPHYSICS_STEPPER_H
+
+#include <algorithm>
+
+namespace MWPhysics
+{
+
+    /// @brief Splits variable frame durations into a whole number of fixed length simulation steps.
+    /// @note Time is accumulated in double precision, so that the number of steps does not depend on
+    /// how a given amount of time was split into frames.
+    class FixedStepper
+    {
+    public:
+        /// @param stepLength Duration of a single simulation step, in seconds
+        /// @param maxSteps Maximum number of steps to run in a single frame. Any time in excess of that is dropped,
+        /// so that a slow simulation can not fall further and further behind.
+        FixedStepper(float stepLength, int maxSteps)
+            : mStepLength(stepLength)
+            , mMaxSteps(maxSteps)
+            , mAccumulated(0.0)
+        {
+        }
+
+        /// Accumulate \a dt seconds and return the number of whole steps that should now be simulated.
+        int advance(float dt)
+        {
+            mAccumulated += dt;
+
+            // tolerate rounding errors so that e.g. two half steps add up to a full step
+            const double epsilon = 1e-6 * mStepLength;
+            int steps = static_cast<int>((mAccumulated + epsilon) / mStepLength);
+            mAccumulated = std::max(0.0, mAccumulated - steps * static_cast<double>(mStepLength));
+
+            if (steps > mMaxSteps)
+            {
+                steps = mMaxSteps;
+                mAccumulated = 0.0;
+            }
+            return steps;
+        }
+
+        /// Fraction of a step that has been accumulated, but not simulated yet. Used to interpolate
+        /// between the last two simulated states.
+        /// @return a value in the range [0, 1)
+        float getInterpolationFactor() const
+        {
+            return std::min(0.999f, static_cast<float>(mAccumulated / mStepLength));
+        }
+
+        float getStepLength() const
+        {
+            return mStepLength;
+        }
+
+        /// Drop any accumulated time, e.g. when changing cells.
+        void reset()
+        {
+            mAccumulated = 0.0;
+        }
+
+    private:
+        float mStepLength;
+        int mMaxSteps;
+        double mAccumulated;
+    };
+
+}
+
+#endif
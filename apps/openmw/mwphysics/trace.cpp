@@ -1,5 +1,6 @@
 #include "trace.h"
 
+#include <cassert>
 #include <map>
 
 #include <BulletCollision/CollisionDispatch/btCollisionWorld.h>
@@ -7,7 +8,6 @@
 #include <BulletCollision/CollisionShapes/btCylinderShape.h>
 
 #include "collisiontype.hpp"
-#include "actor.hpp"
 #include "convert.hpp"
 
 namespace MWPhysics
@@ -89,25 +89,25 @@ void ActorTracer::doTrace(btCollisionObject *actor, const osg::Vec3f& start, con
     }
 }
 
-void ActorTracer::findGround(const Actor* actor, const osg::Vec3f& start, const osg::Vec3f& end, btCollisionWorld* world)
+void ActorTracer::findGround(btCollisionObject* actor, const osg::Vec3f& halfExtents, const osg::Vec3f& start, const osg::Vec3f& end, btCollisionWorld* world)
 {
     const btVector3 btstart(start.x(), start.y(), start.z()+1.0f);
     const btVector3 btend(end.x(), end.y(), end.z()+1.0f);
 
-    const btTransform &trans = actor->getCollisionObject()->getWorldTransform();
+    const btTransform &trans = actor->getWorldTransform();
     btTransform from(trans.getBasis(), btstart);
     btTransform to(trans.getBasis(), btend);
 
-    ClosestNotMeConvexResultCallback newTraceCallback(actor->getCollisionObject(), btstart-btend, btScalar(0.0));
+    ClosestNotMeConvexResultCallback newTraceCallback(actor, btstart-btend, btScalar(0.0));
     // Inherit the actor's collision group and mask
-    newTraceCallback.m_collisionFilterGroup = actor->getCollisionObject()->getBroadphaseHandle()->m_collisionFilterGroup;
-    newTraceCallback.m_collisionFilterMask = actor->getCollisionObject()->getBroadphaseHandle()->m_collisionFilterMask;
+    newTraceCallback.m_collisionFilterGroup = actor->getBroadphaseHandle()->m_collisionFilterGroup;
+    newTraceCallback.m_collisionFilterMask = actor->getBroadphaseHandle()->m_collisionFilterMask;
     newTraceCallback.m_collisionFilterMask &= ~CollisionType_Actor;
 
-    btVector3 halfExtents = toBullet(actor->getHalfExtents());
+    btVector3 baseExtents = toBullet(halfExtents);
 
-    halfExtents[2] = 1.0f;
-    btCylinderShapeZ base(halfExtents);
+    baseExtents[2] = 1.0f;
+    btCylinderShapeZ base(baseExtents);
 
     world->convexSweepTest(&base, from, to, newTraceCallback);
     if(newTraceCallback.hasHit())
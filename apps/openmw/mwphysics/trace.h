@@ -9,8 +9,6 @@ class btCollisionWorld;
 
 namespace MWPhysics
 {
-    class Actor;
-
     struct ActorTracer
     {
         osg::Vec3f mEndPos;
@@ -20,7 +18,7 @@ namespace MWPhysics
         float mFraction;
 
         void doTrace(btCollisionObject *actor, const osg::Vec3f& start, const osg::Vec3f& end, btCollisionWorld* world);
-        void findGround(const Actor* actor, const osg::Vec3f& start, const osg::Vec3f& end, btCollisionWorld* world);
+        void findGround(btCollisionObject* actor, const osg::Vec3f& halfExtents, const osg::Vec3f& start, const osg::Vec3f& end, btCollisionWorld* world);
     };
 }
 
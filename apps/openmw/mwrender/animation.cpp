@@ -110,25 +110,15 @@ namespace
         NodeMap mMap;
     };
 
-    NifOsg::TextKeyMap::const_iterator findGroupStart(const NifOsg::TextKeyMap &keys, const std::string &groupname)
+    float calcAnimVelocity(const NifOsg::TextKeyEvents& keys, NifOsg::KeyframeController *nonaccumctrl,
+                           const osg::Vec3f& accum, const std::string &groupname)
     {
-        NifOsg::TextKeyMap::const_iterator iter(keys.begin());
-        for(;iter != keys.end();++iter)
-        {
-            if(iter->second.compare(0, groupname.size(), groupname) == 0 &&
-               iter->second.compare(groupname.size(), 2, ": ") == 0)
-                break;
-        }
-        return iter;
-    }
+        int group = keys.findGroup(groupname);
+        if (group == -1)
+            return 0.0f;
 
-    float calcAnimVelocity(const std::multimap<float, std::string>& keys,
-                                      NifOsg::KeyframeController *nonaccumctrl, const osg::Vec3f& accum, const std::string &groupname)
-    {
-        const std::string start = groupname+": start";
-        const std::string loopstart = groupname+": loop start";
-        const std::string loopstop = groupname+": loop stop";
-        const std::string stop = groupname+": stop";
+        const std::vector<NifOsg::TextKeyEvent>& events = keys.getEvents();
+        const std::vector<size_t>& groupEvents = keys.getGroups()[group].mEvents;
         float starttime = std::numeric_limits<float>::max();
         float stoptime = 0.0f;
 
@@ -138,27 +128,26 @@ namespace
         // but the animation velocity calculation uses the second one.
         // As result the animation velocity calculation is not correct, and this incorrect velocity must be replicated,
         // because otherwise the Creature's Speed (dagoth uthol) would not be sufficient to move fast enough.
-        NifOsg::TextKeyMap::const_reverse_iterator keyiter(keys.rbegin());
-        while(keyiter != keys.rend())
+        std::vector<size_t>::const_reverse_iterator keyiter(groupEvents.rbegin());
+        for(;keyiter != groupEvents.rend();++keyiter)
         {
-            if(keyiter->second == start || keyiter->second == loopstart)
+            const NifOsg::TextKeyEvent& key = events[*keyiter];
+            if(key.mType == NifOsg::TextKeyEvent::Type_Start || key.mType == NifOsg::TextKeyEvent::Type_LoopStart)
             {
-                starttime = keyiter->first;
+                starttime = key.mTime;
                 break;
             }
-            ++keyiter;
         }
-        keyiter = keys.rbegin();
-        while(keyiter != keys.rend())
+        for(keyiter = groupEvents.rbegin();keyiter != groupEvents.rend();++keyiter)
         {
-            if (keyiter->second == stop)
-                stoptime = keyiter->first;
-            else if (keyiter->second == loopstop)
+            const NifOsg::TextKeyEvent& key = events[*keyiter];
+            if (key.mType == NifOsg::TextKeyEvent::Type_Stop)
+                stoptime = key.mTime;
+            else if (key.mType == NifOsg::TextKeyEvent::Type_LoopStop)
             {
-                stoptime = keyiter->first;
+                stoptime = key.mTime;
                 break;
             }
-            ++keyiter;
         }
 
         if(stoptime > starttime)
@@ -185,27 +174,27 @@ namespace
         virtual void apply(osg::Geode &node)
         {
             // Not safe to remove in apply(), since the visitor is still iterating the child list
-            osg::Group* parent = node.getParent(0);
+            // The Geode may be shared with other instances, so use the parent we came from rather than getParent(0)
+            const osg::NodePath& path = getNodePath();
+            if (path.size() < 2)
+                return;
+            osg::Group* parent = path[path.size()-2]->asGroup();
             // prune nodes that would be empty after the removal
-            if (parent->getNumChildren() == 1 && parent->getDataVariance() == osg::Object::STATIC)
-                mToRemove.push_back(parent);
+            if (parent->getNumChildren() == 1 && parent->getDataVariance() == osg::Object::STATIC && path.size() >= 3)
+                mToRemove.push_back(std::make_pair(path[path.size()-3]->asGroup(), static_cast<osg::Node*>(parent)));
             else
-                mToRemove.push_back(&node);
+                mToRemove.push_back(std::make_pair(parent, static_cast<osg::Node*>(&node)));
             traverse(node);
         }
 
         void remove()
         {
-            for (std::vector<osg::Node*>::iterator it = mToRemove.begin(); it != mToRemove.end(); ++it)
-            {
-                osg::Node* node = *it;
-                if (node->getNumParents())
-                    node->getParent(0)->removeChild(node);
-            }
+            for (std::vector<std::pair<osg::Group*, osg::Node*> >::iterator it = mToRemove.begin(); it != mToRemove.end(); ++it)
+                it->first->removeChild(it->second);
         }
 
     private:
-        std::vector<osg::Node*> mToRemove;
+        std::vector<std::pair<osg::Group*, osg::Node*> > mToRemove;
     };
 
 }
@@ -221,7 +210,9 @@ namespace MWRender
 
         ControllerMap mControllerMap[Animation::sNumBlendMasks];
 
-        const std::multimap<float, std::string>& getTextKeys();
+        const NifOsg::TextKeyMap& getTextKeys();
+
+        const NifOsg::TextKeyEvents& getTextKeyEvents();
     };
 
     class ResetAccumRootCallback : public osg::NodeCallback
@@ -325,11 +316,16 @@ namespace MWRender
         return 0;
     }
 
-    const std::multimap<float, std::string> &Animation::AnimSource::getTextKeys()
+    const NifOsg::TextKeyMap &Animation::AnimSource::getTextKeys()
     {
         return mKeyframes->mTextKeys;
     }
 
+    const NifOsg::TextKeyEvents &Animation::AnimSource::getTextKeyEvents()
+    {
+        return mKeyframes->mTextKeyEvents;
+    }
+
     void Animation::addAnimSource(const std::string &model)
     {
         std::string kfname = model;
@@ -403,8 +399,7 @@ namespace MWRender
         AnimSourceList::const_iterator iter(mAnimSources.begin());
         for(;iter != mAnimSources.end();++iter)
         {
-            const NifOsg::TextKeyMap &keys = (*iter)->getTextKeys();
-            if(findGroupStart(keys, anim) != keys.end())
+            if((*iter)->getTextKeyEvents().findGroup(anim) != -1)
                 return true;
         }
 
@@ -415,11 +410,11 @@ namespace MWRender
     {
         for(AnimSourceList::const_iterator iter(mAnimSources.begin()); iter != mAnimSources.end(); ++iter)
         {
-            const NifOsg::TextKeyMap &keys = (*iter)->getTextKeys();
+            const NifOsg::TextKeyEvents &keys = (*iter)->getTextKeyEvents();
 
-            NifOsg::TextKeyMap::const_iterator found = findGroupStart(keys, groupname);
-            if(found != keys.end())
-                return found->first;
+            int group = keys.findGroup(groupname);
+            if(group != -1)
+                return keys.getEvents()[keys.getGroups()[group].mEvents.front()].mTime;
         }
         return -1.f;
     }
@@ -440,25 +435,23 @@ namespace MWRender
         return -1.f;
     }
 
-    void Animation::handleTextKey(AnimState &state, const std::string &groupname, const std::multimap<float, std::string>::const_iterator &key,
-                       const std::multimap<float, std::string>& map)
+    void Animation::handleTextKey(AnimState &state, const std::string &groupname, const NifOsg::TextKeyEvents &keys, size_t key)
     {
-        const std::string &evt = key->second;
-
-        size_t off = groupname.size()+2;
-        size_t len = evt.size() - off;
+        const NifOsg::TextKeyEvent &evt = keys.getEvents()[key];
 
-        if(evt.compare(0, groupname.size(), groupname) == 0 &&
-           evt.compare(groupname.size(), 2, ": ") == 0)
+        if(evt.mGroup == state.mGroup)
         {
-            if(evt.compare(off, len, "loop start") == 0)
-                state.mLoopStartTime = key->first;
-            else if(evt.compare(off, len, "loop stop") == 0)
-                state.mLoopStopTime = key->first;
+            if(evt.mType == NifOsg::TextKeyEvent::Type_LoopStart)
+                state.mLoopStartTime = evt.mTime;
+            else if(evt.mType == NifOsg::TextKeyEvent::Type_LoopStop)
+                state.mLoopStopTime = evt.mTime;
         }
+        // Keys of other groups are of no interest to the listener
+        else if(evt.mType != NifOsg::TextKeyEvent::Type_Sound && evt.mType != NifOsg::TextKeyEvent::Type_SoundGen)
+            return;
 
         if (mTextKeyListener)
-            mTextKeyListener->handleTextKey(groupname, key, map);
+            mTextKeyListener->handleTextKey(groupname, keys, key);
     }
 
     void Animation::play(const std::string &groupname, const AnimPriority& priority, int blendMask, bool autodisable, float speedmult,
@@ -495,7 +488,7 @@ namespace MWRender
         AnimSourceList::reverse_iterator iter(mAnimSources.rbegin());
         for(;iter != mAnimSources.rend();++iter)
         {
-            const NifOsg::TextKeyMap &textkeys = (*iter)->getTextKeys();
+            const NifOsg::TextKeyEvents &textkeys = (*iter)->getTextKeyEvents();
             if(reset(state, textkeys, groupname, start, stop, startpoint, loopfallback))
             {
                 state.mSource = *iter;
@@ -507,12 +500,13 @@ namespace MWRender
                 state.mAutoDisable = autodisable;
                 mStates[groupname] = state;
 
-                NifOsg::TextKeyMap::const_iterator textkey(textkeys.lower_bound(state.getTime()));
+                const std::vector<NifOsg::TextKeyEvent> &events = textkeys.getEvents();
+                size_t textkey = textkeys.lowerBound(state.getTime());
                 if (state.mPlaying)
                 {
-                    while(textkey != textkeys.end() && textkey->first <= state.getTime())
+                    while(textkey < events.size() && events[textkey].mTime <= state.getTime())
                     {
-                        handleTextKey(state, groupname, textkey, textkeys);
+                        handleTextKey(state, groupname, textkeys, textkey);
                         ++textkey;
                     }
                 }
@@ -525,10 +519,10 @@ namespace MWRender
                     if(state.getTime() >= state.mLoopStopTime)
                         break;
 
-                    NifOsg::TextKeyMap::const_iterator textkey(textkeys.lower_bound(state.getTime()));
-                    while(textkey != textkeys.end() && textkey->first <= state.getTime())
+                    textkey = textkeys.lowerBound(state.getTime());
+                    while(textkey < events.size() && events[textkey].mTime <= state.getTime())
                     {
-                        handleTextKey(state, groupname, textkey, textkeys);
+                        handleTextKey(state, groupname, textkeys, textkey);
                         ++textkey;
                     }
                 }
@@ -542,76 +536,73 @@ namespace MWRender
         resetActiveGroups();
     }
 
-    bool Animation::reset(AnimState &state, const NifOsg::TextKeyMap &keys, const std::string &groupname, const std::string &start, const std::string &stop, float startpoint, bool loopfallback)
+    bool Animation::reset(AnimState &state, const NifOsg::TextKeyEvents &keys, const std::string &groupname, const std::string &start, const std::string &stop, float startpoint, bool loopfallback)
     {
+        int group = keys.findGroup(groupname);
+        if(group == -1)
+            return false;
+
+        const std::vector<NifOsg::TextKeyEvent> &events = keys.getEvents();
+        const std::vector<size_t> &groupEvents = keys.getGroups()[group].mEvents;
+
         // Look for text keys in reverse. This normally wouldn't matter, but for some reason undeadwolf_2.nif has two
         // separate walkforward keys, and the last one is supposed to be used.
-        NifOsg::TextKeyMap::const_reverse_iterator groupend(keys.rbegin());
-        for(;groupend != keys.rend();++groupend)
-        {
-            if(groupend->second.compare(0, groupname.size(), groupname) == 0 &&
-               groupend->second.compare(groupname.size(), 2, ": ") == 0)
-                break;
-        }
-
-        std::string starttag = groupname+": "+start;
-        NifOsg::TextKeyMap::const_reverse_iterator startkey(groupend);
-        while(startkey != keys.rend() && startkey->second != starttag)
+        std::vector<size_t>::const_reverse_iterator startkey(groupEvents.rbegin());
+        while(startkey != groupEvents.rend() && events[*startkey].mName != start)
             ++startkey;
-        if(startkey == keys.rend() && start == "loop start")
+        if(startkey == groupEvents.rend() && start == "loop start")
         {
-            starttag = groupname+": start";
-            startkey = groupend;
-            while(startkey != keys.rend() && startkey->second != starttag)
+            startkey = groupEvents.rbegin();
+            while(startkey != groupEvents.rend() && events[*startkey].mType != NifOsg::TextKeyEvent::Type_Start)
                 ++startkey;
         }
-        if(startkey == keys.rend())
+        if(startkey == groupEvents.rend())
             return false;
 
-        const std::string stoptag = groupname+": "+stop;
-        NifOsg::TextKeyMap::const_reverse_iterator stopkey(groupend);
-        while(stopkey != keys.rend()
+        std::vector<size_t>::const_reverse_iterator stopkey(groupEvents.rbegin());
+        while(stopkey != groupEvents.rend()
               // We have to ignore extra garbage at the end.
               // The Scrib's idle3 animation has "Idle3: Stop." instead of "Idle3: Stop".
               // Why, just why? :(
-              && (stopkey->second.size() < stoptag.size() || stopkey->second.substr(0,stoptag.size()) != stoptag))
+              && events[*stopkey].mName.compare(0, stop.size(), stop) != 0)
             ++stopkey;
-        if(stopkey == keys.rend())
+        if(stopkey == groupEvents.rend())
             return false;
 
-        if(startkey->first > stopkey->first)
+        const NifOsg::TextKeyEvent &startevt = events[*startkey];
+        const NifOsg::TextKeyEvent &stopevt = events[*stopkey];
+        if(startevt.mTime > stopevt.mTime)
             return false;
 
-        state.mStartTime = startkey->first;
+        state.mGroup = group;
+        state.mStartTime = startevt.mTime;
         if (loopfallback)
         {
-            state.mLoopStartTime = startkey->first;
-            state.mLoopStopTime = stopkey->first;
+            state.mLoopStartTime = startevt.mTime;
+            state.mLoopStopTime = stopevt.mTime;
         }
         else
         {
-            state.mLoopStartTime = startkey->first;
+            state.mLoopStartTime = startevt.mTime;
             state.mLoopStopTime = std::numeric_limits<float>::max();
         }
-        state.mStopTime = stopkey->first;
+        state.mStopTime = stopevt.mTime;
 
         state.setTime(state.mStartTime + ((state.mStopTime - state.mStartTime) * startpoint));
 
         // mLoopStartTime and mLoopStopTime normally get assigned when encountering these keys while playing the animation
         // (see handleTextKey). But if startpoint is already past these keys, or start time is == stop time, we need to assign them now.
-        const std::string loopstarttag = groupname+": loop start";
-        const std::string loopstoptag = groupname+": loop stop";
-
-        NifOsg::TextKeyMap::const_reverse_iterator key(groupend);
-        for (; key != startkey && key != keys.rend(); ++key)
+        std::vector<size_t>::const_reverse_iterator key(groupEvents.rbegin());
+        for (; key != startkey; ++key)
         {
-            if (key->first > state.getTime())
+            const NifOsg::TextKeyEvent &evt = events[*key];
+            if (evt.mTime > state.getTime())
                 continue;
 
-            if (key->second == loopstarttag)
-                state.mLoopStartTime = key->first;
-            else if (key->second == loopstoptag)
-                state.mLoopStopTime = key->first;
+            if (evt.mType == NifOsg::TextKeyEvent::Type_LoopStart)
+                state.mLoopStartTime = evt.mTime;
+            else if (evt.mType == NifOsg::TextKeyEvent::Type_LoopStop)
+                state.mLoopStopTime = evt.mTime;
         }
 
         return true;
@@ -758,15 +749,14 @@ namespace MWRender
         AnimSourceList::const_reverse_iterator animsrc(mAnimSources.rbegin());
         for(;animsrc != mAnimSources.rend();++animsrc)
         {
-            const NifOsg::TextKeyMap &keys = (*animsrc)->getTextKeys();
-            if(findGroupStart(keys, groupname) != keys.end())
+            if((*animsrc)->getTextKeyEvents().findGroup(groupname) != -1)
                 break;
         }
         if(animsrc == mAnimSources.rend())
             return 0.0f;
 
         float velocity = 0.0f;
-        const NifOsg::TextKeyMap &keys = (*animsrc)->getTextKeys();
+        const NifOsg::TextKeyEvents &keys = (*animsrc)->getTextKeyEvents();
 
         const AnimSource::ControllerMap& ctrls = (*animsrc)->mControllerMap[0];
         for (AnimSource::ControllerMap::const_iterator it = ctrls.begin(); it != ctrls.end(); ++it)
@@ -787,7 +777,7 @@ namespace MWRender
 
             while(!(velocity > 1.0f) && ++animiter != mAnimSources.rend())
             {
-                const NifOsg::TextKeyMap &keys = (*animiter)->getTextKeys();
+                const NifOsg::TextKeyEvents &keys = (*animiter)->getTextKeyEvents();
 
                 const AnimSource::ControllerMap& ctrls = (*animiter)->mControllerMap[0];
                 for (AnimSource::ControllerMap::const_iterator it = ctrls.begin(); it != ctrls.end(); ++it)
@@ -818,8 +808,9 @@ namespace MWRender
         while(stateiter != mStates.end())
         {
             AnimState &state = stateiter->second;
-            const NifOsg::TextKeyMap &textkeys = state.mSource->getTextKeys();
-            NifOsg::TextKeyMap::const_iterator textkey(textkeys.upper_bound(state.getTime()));
+            const NifOsg::TextKeyEvents &textkeys = state.mSource->getTextKeyEvents();
+            const std::vector<NifOsg::TextKeyEvent> &events = textkeys.getEvents();
+            size_t textkey = textkeys.upperBound(state.getTime());
 
             float timepassed = duration * state.mSpeedMult;
             while(state.mPlaying)
@@ -830,7 +821,7 @@ namespace MWRender
                     goto handle_loop;
 
                 targetTime = state.getTime() + timepassed;
-                if(textkey == textkeys.end() || textkey->first > targetTime)
+                if(textkey == events.size() || events[textkey].mTime > targetTime)
                 {
                     if(mAccumCtrl && state.mTime == mAnimationTimePtr[0]->getTimePtr())
                         updatePosition(state.getTime(), targetTime, movement);
@@ -839,16 +830,16 @@ namespace MWRender
                 else
                 {
                     if(mAccumCtrl && state.mTime == mAnimationTimePtr[0]->getTimePtr())
-                        updatePosition(state.getTime(), textkey->first, movement);
-                    state.setTime(textkey->first);
+                        updatePosition(state.getTime(), events[textkey].mTime, movement);
+                    state.setTime(events[textkey].mTime);
                 }
 
                 state.mPlaying = (state.getTime() < state.mStopTime);
                 timepassed = targetTime - state.getTime();
 
-                while(textkey != textkeys.end() && textkey->first <= state.getTime())
+                while(textkey < events.size() && events[textkey].mTime <= state.getTime())
                 {
-                    handleTextKey(state, stateiter->first, textkey, textkeys);
+                    handleTextKey(state, stateiter->first, textkeys, textkey);
                     ++textkey;
                 }
 
@@ -859,10 +850,10 @@ namespace MWRender
                     state.setTime(state.mLoopStartTime);
                     state.mPlaying = true;
 
-                    textkey = textkeys.lower_bound(state.getTime());
-                    while(textkey != textkeys.end() && textkey->first <= state.getTime())
+                    textkey = textkeys.lowerBound(state.getTime());
+                    while(textkey < events.size() && events[textkey].mTime <= state.getTime())
                     {
-                        handleTextKey(state, stateiter->first, textkey, textkeys);
+                        handleTextKey(state, stateiter->first, textkeys, textkey);
                         ++textkey;
                     }
 
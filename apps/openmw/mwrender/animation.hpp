@@ -19,6 +19,7 @@ namespace NifOsg
 {
     class KeyframeHolder;
     class KeyframeController;
+    class TextKeyEvents;
 }
 
 namespace SceneUtil
@@ -119,8 +120,8 @@ public:
     class TextKeyListener
     {
     public:
-        virtual void handleTextKey(const std::string &groupname, const std::multimap<float, std::string>::const_iterator &key,
-                           const std::multimap<float, std::string>& map) = 0;
+        /// @param key Index of the key in \a keys. Only sound keys and keys of \a groupname are passed on.
+        virtual void handleTextKey(const std::string &groupname, const NifOsg::TextKeyEvents &keys, size_t key) = 0;
     };
 
     void setTextKeyListener(TextKeyListener* listener);
@@ -154,6 +155,7 @@ protected:
 
     struct AnimState {
         boost::shared_ptr<AnimSource> mSource;
+        int mGroup; // Index of the group in mSource's text key groups
         float mStartTime;
         float mLoopStartTime;
         float mLoopStopTime;
@@ -170,7 +172,7 @@ protected:
         int mBlendMask;
         bool mAutoDisable;
 
-        AnimState() : mStartTime(0.0f), mLoopStartTime(0.0f), mLoopStopTime(0.0f), mStopTime(0.0f),
+        AnimState() : mGroup(-1), mStartTime(0.0f), mLoopStartTime(0.0f), mLoopStopTime(0.0f), mStopTime(0.0f),
                       mTime(new float), mSpeedMult(1.0f), mPlaying(false), mLoopCount(0),
                       mPriority(0), mBlendMask(0), mAutoDisable(true)
         {
@@ -258,12 +260,11 @@ protected:
      * the marker is not found, or if the markers are the same, it returns
      * false.
      */
-    bool reset(AnimState &state, const std::multimap<float, std::string> &keys,
+    bool reset(AnimState &state, const NifOsg::TextKeyEvents &keys,
                const std::string &groupname, const std::string &start, const std::string &stop,
                float startpoint, bool loopfallback);
 
-    void handleTextKey(AnimState &state, const std::string &groupname, const std::multimap<float, std::string>::const_iterator &key,
-                       const std::multimap<float, std::string>& map);
+    void handleTextKey(AnimState &state, const std::string &groupname, const NifOsg::TextKeyEvents &keys, size_t key);
 
     /** Sets the root model of the object.
      *
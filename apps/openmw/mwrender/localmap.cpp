@@ -4,6 +4,7 @@
 #include <stdint.h>
 
 #include <osg/LightModel>
+#include <osg/State>
 #include <osg/Texture2D>
 #include <osg/ComputeBoundsVisitor>
 
@@ -11,8 +12,12 @@
 
 #include <osgViewer/Viewer>
 
+#include <OpenThreads/Mutex>
+#include <OpenThreads/ScopedLock>
+
 #include <components/esm/fogstate.hpp>
 #include <components/esm/loadcell.hpp>
+#include <components/misc/stringops.hpp>
 #include <components/settings/settings.hpp>
 #include <components/sceneutil/visitor.hpp>
 #include <components/files/memorystream.hpp>
@@ -64,13 +69,113 @@ namespace
         return val*val;
     }
 
+    int getNeighbours(const std::set<std::pair<int, int> >& grid, int x, int y)
+    {
+        int neighbours = 0;
+        int bit = 0;
+        for (int dx=-1; dx<2; ++dx)
+        {
+            for (int dy=-1; dy<2; ++dy)
+            {
+                if (dx == 0 && dy == 0)
+                    continue;
+                if (grid.count(std::make_pair(x+dx, y+dy)))
+                    neighbours |= (1<<bit);
+                ++bit;
+            }
+        }
+        return neighbours;
+    }
+
 }
 
 namespace MWRender
 {
 
+/// @brief Uploads only the changed region of a fog of war image, instead of the whole image.
+/// @note The image is changed on the main thread and uploaded by the draw thread. Hold getImageMutex()
+/// while changing it, then call dirty() once the mutex is released.
+class FogOfWarUploader : public osg::Texture2D::SubloadCallback
+{
+public:
+    FogOfWarUploader(osg::Image* image)
+        : mImage(image)
+        , mDirtyX0(0), mDirtyY0(0), mDirtyX1(0), mDirtyY1(0)
+    {
+        dirty(0, 0, image->s(), image->t());
+    }
+
+    OpenThreads::Mutex& getImageMutex()
+    {
+        return mImageMutex;
+    }
+
+    /// Mark the texels from (x0, y0) up to (x1, y1) exclusive as changed.
+    void dirty(int x0, int y0, int x1, int y1)
+    {
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+        if (mDirtyX0 >= mDirtyX1)
+        {
+            mDirtyX0 = x0; mDirtyY0 = y0;
+            mDirtyX1 = x1; mDirtyY1 = y1;
+        }
+        else
+        {
+            mDirtyX0 = std::min(mDirtyX0, x0); mDirtyY0 = std::min(mDirtyY0, y0);
+            mDirtyX1 = std::max(mDirtyX1, x1); mDirtyY1 = std::max(mDirtyY1, y1);
+        }
+    }
+
+    virtual void load(const osg::Texture2D& texture, osg::State& state) const
+    {
+        {
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+            mDirtyX0 = mDirtyX1 = 0;
+        }
+
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mImageMutex);
+        state.unbindPixelBufferObject();
+        glPixelStorei(GL_UNPACK_ALIGNMENT, mImage->getPacking());
+        glTexImage2D(GL_TEXTURE_2D, 0, texture.getInternalFormat(), mImage->s(), mImage->t(), 0,
+                     mImage->getPixelFormat(), mImage->getDataType(), mImage->data());
+    }
+
+    virtual void subload(const osg::Texture2D& texture, osg::State& state) const
+    {
+        int x0, y0, x1, y1;
+        {
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+            if (mDirtyX0 >= mDirtyX1)
+                return;
+            x0 = mDirtyX0; y0 = mDirtyY0;
+            x1 = mDirtyX1; y1 = mDirtyY1;
+            mDirtyX0 = mDirtyX1 = 0;
+        }
+
+        // Texels changed after the dirty region was taken are uploaded again with the next frame
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mImageMutex);
+        state.unbindPixelBufferObject();
+        glPixelStorei(GL_UNPACK_ALIGNMENT, mImage->getPacking());
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, mImage->s());
+        glTexSubImage2D(GL_TEXTURE_2D, 0, x0, y0, x1-x0, y1-y0,
+                        mImage->getPixelFormat(), mImage->getDataType(), mImage->data(x0, y0));
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    }
+
+private:
+    osg::ref_ptr<osg::Image> mImage;
+
+    // Guards the dirty region
+    mutable OpenThreads::Mutex mMutex;
+    // Guards the image data. Separate from mMutex, so that marking a change does not wait for an upload.
+    mutable OpenThreads::Mutex mImageMutex;
+    mutable int mDirtyX0, mDirtyY0, mDirtyX1, mDirtyY1;
+};
+
 LocalMap::LocalMap(osgViewer::Viewer* viewer)
     : mViewer(viewer)
+    , mCacheSize(std::max(0, Settings::Manager::getInt("local map cache size", "Map")))
+    , mCacheCounter(0)
     , mMapResolution(Settings::Manager::getInt("local map resolution", "Map"))
     , mMapWorldSize(8192.f)
     , mAngle(0.f)
@@ -232,11 +337,18 @@ void LocalMap::setupRenderToTexture(osg::ref_ptr<osg::Camera> camera, int x, int
 
 void LocalMap::requestMap(std::set<MWWorld::CellStore*> cells)
 {
+    std::set<std::pair<int, int> > grid;
+    for (std::set<MWWorld::CellStore*>::iterator it = cells.begin(); it != cells.end(); ++it)
+    {
+        if ((*it)->isExterior())
+            grid.insert(std::make_pair((*it)->getCell()->getGridX(), (*it)->getCell()->getGridY()));
+    }
+
     for (std::set<MWWorld::CellStore*>::iterator it = cells.begin(); it != cells.end(); ++it)
     {
         MWWorld::CellStore* cell = *it;
         if (cell->isExterior())
-            requestExteriorMap(cell);
+            requestExteriorMap(cell, getNeighbours(grid, cell->getCell()->getGridX(), cell->getCell()->getGridY()));
         else
             requestInteriorMap(cell);
     }
@@ -247,9 +359,78 @@ void LocalMap::removeCell(MWWorld::CellStore *cell)
     saveFogOfWar(cell);
 
     if (cell->isExterior())
-        mSegments.erase(std::make_pair(cell->getCell()->getGridX(), cell->getCell()->getGridY()));
+    {
+        std::pair<int, int> coords (cell->getCell()->getGridX(), cell->getCell()->getGridY());
+        SegmentMap::iterator found = mSegments.find(coords);
+        if (found == mSegments.end())
+            return;
+
+        if (found->second.mMapTexture)
+        {
+            CachedMap cached;
+            cached.mObjectStateHash = found->second.mObjectStateHash;
+            cached.mNeighbours = found->second.mNeighbours;
+            cached.mTextures[coords] = found->second.mMapTexture;
+            addToCache(CacheKey(std::string(), coords), cached);
+        }
+
+        mSegments.erase(found);
+    }
     else
+    {
+        if (mInterior && !mSegments.empty())
+        {
+            CachedMap cached;
+            cached.mObjectStateHash = mSegments.begin()->second.mObjectStateHash;
+            cached.mBounds = mBounds;
+            cached.mAngle = mAngle;
+            for (SegmentMap::iterator it = mSegments.begin(); it != mSegments.end(); ++it)
+            {
+                if (it->second.mMapTexture)
+                    cached.mTextures[it->first] = it->second.mMapTexture;
+            }
+            addToCache(CacheKey(Misc::StringUtils::lowerCase(cell->getCell()->mName), std::make_pair(0, 0)), cached);
+        }
+
         mSegments.clear();
+    }
+}
+
+void LocalMap::addToCache(const CacheKey &key, CachedMap &map)
+{
+    if (map.mTextures.empty() || map.mTextures.size() > mCacheSize)
+        return;
+
+    map.mLastUsed = ++mCacheCounter;
+    mCache[key] = map;
+
+    size_t textures = 0;
+    for (MapCache::iterator it = mCache.begin(); it != mCache.end(); ++it)
+        textures += it->second.mTextures.size();
+
+    // Evict the least recently used maps
+    while (textures > mCacheSize)
+    {
+        MapCache::iterator oldest = mCache.begin();
+        for (MapCache::iterator it = mCache.begin(); it != mCache.end(); ++it)
+        {
+            if (it->second.mLastUsed < oldest->second.mLastUsed)
+                oldest = it;
+        }
+        textures -= oldest->second.mTextures.size();
+        mCache.erase(oldest);
+    }
+}
+
+bool LocalMap::takeFromCache(const CacheKey &key, CachedMap &map)
+{
+    MapCache::iterator found = mCache.find(key);
+    if (found == mCache.end())
+        return false;
+
+    map = found->second;
+    mCache.erase(found);
+    return true;
 }
 
 osg::ref_ptr<osg::Texture2D> LocalMap::getMapTexture(int x, int y)
@@ -297,22 +478,41 @@ void LocalMap::cleanupCameras()
     mCamerasPendingRemoval.clear();
 }
 
-void LocalMap::requestExteriorMap(MWWorld::CellStore* cell)
+void LocalMap::requestExteriorMap(MWWorld::CellStore* cell, int neighbours)
 {
     mInterior = false;
 
     int x = cell->getCell()->getGridX();
     int y = cell->getCell()->getGridY();
 
-    osg::BoundingSphere bound = mViewer->getSceneData()->getBound();
-    float zmin = bound.center().z() - bound.radius();
-    float zmax = bound.center().z() + bound.radius();
+    MapSegment& segment = mSegments[std::make_pair(x, y)];
+
+    if (!segment.mMapTexture)
+    {
+        CachedMap cached;
+        if (takeFromCache(CacheKey(std::string(), std::make_pair(x, y)), cached))
+        {
+            segment.mMapTexture = cached.mTextures.begin()->second;
+            segment.mObjectStateHash = cached.mObjectStateHash;
+            segment.mNeighbours = cached.mNeighbours;
+        }
+    }
 
-    osg::ref_ptr<osg::Camera> camera = createOrthographicCamera(x*mMapWorldSize + mMapWorldSize/2.f, y*mMapWorldSize + mMapWorldSize/2.f, mMapWorldSize, mMapWorldSize,
-                                                                osg::Vec3d(0,1,0), zmin, zmax);
-    setupRenderToTexture(camera, cell->getCell()->getGridX(), cell->getCell()->getGridY());
+    size_t hash = cell->getObjectStateHash();
+    if (!segment.mMapTexture || segment.mObjectStateHash != hash || (neighbours & ~segment.mNeighbours))
+    {
+        osg::BoundingSphere bound = mViewer->getSceneData()->getBound();
+        float zmin = bound.center().z() - bound.radius();
+        float zmax = bound.center().z() + bound.radius();
+
+        osg::ref_ptr<osg::Camera> camera = createOrthographicCamera(x*mMapWorldSize + mMapWorldSize/2.f, y*mMapWorldSize + mMapWorldSize/2.f, mMapWorldSize, mMapWorldSize,
+                                                                    osg::Vec3d(0,1,0), zmin, zmax);
+        setupRenderToTexture(camera, x, y);
+
+        segment.mObjectStateHash = hash;
+        segment.mNeighbours = neighbours;
+    }
 
-    MapSegment& segment = mSegments[std::make_pair(cell->getCell()->getGridX(), cell->getCell()->getGridY())];
     if (!segment.mFogOfWarImage)
     {
         if (cell->getFog())
@@ -412,6 +612,13 @@ void LocalMap::requestInteriorMap(MWWorld::CellStore* cell)
     const int segsX = static_cast<int>(std::ceil(length.x() / mMapWorldSize));
     const int segsY = static_cast<int>(std::ceil(length.y() / mMapWorldSize));
 
+    // Reuse the textures from the last visit if they still fit
+    size_t hash = cell->getObjectStateHash();
+    CachedMap cached;
+    if (takeFromCache(CacheKey(Misc::StringUtils::lowerCase(cell->getCell()->mName), std::make_pair(0, 0)), cached)
+            && (cached.mObjectStateHash != hash || cached.mBounds != mBounds || cached.mAngle != mAngle))
+        cached.mTextures.clear();
+
     int i = 0;
     for (int x=0; x<segsX; ++x)
     {
@@ -426,13 +633,21 @@ void LocalMap::requestInteriorMap(MWWorld::CellStore* cell)
 
             osg::Vec2f pos = osg::Vec2f(rotatedCenter.x(), rotatedCenter.y()) + center;
 
-            osg::ref_ptr<osg::Camera> camera = createOrthographicCamera(pos.x(), pos.y(),
-                                                                        mMapWorldSize, mMapWorldSize,
-                                                                        osg::Vec3f(north.x(), north.y(), 0.f), zMin, zMax);
+            MapSegment& segment = mSegments[std::make_pair(x,y)];
+            segment.mObjectStateHash = hash;
+
+            std::map<std::pair<int, int>, osg::ref_ptr<osg::Texture2D> >::iterator found = cached.mTextures.find(std::make_pair(x,y));
+            if (found != cached.mTextures.end())
+                segment.mMapTexture = found->second;
+            else
+            {
+                osg::ref_ptr<osg::Camera> camera = createOrthographicCamera(pos.x(), pos.y(),
+                                                                            mMapWorldSize, mMapWorldSize,
+                                                                            osg::Vec3f(north.x(), north.y(), 0.f), zMin, zMax);
 
-            setupRenderToTexture(camera, x, y);
+                setupRenderToTexture(camera, x, y);
+            }
 
-            MapSegment& segment = mSegments[std::make_pair(x,y)];
             if (!segment.mFogOfWarImage)
             {
                 if (!cell->getFog())
@@ -558,32 +773,63 @@ void LocalMap::updatePlayer (const osg::Vec3f& position, const osg::Quat& orient
             if (!segment.mFogOfWarImage || !segment.mMapTexture)
                 continue;
 
-            unsigned char* data = segment.mFogOfWarImage->data();
-            for (int texV = 0; texV<sFogOfWarResolution; ++texV)
+            segment.mHasFogState = true;
+
+            // Only texels within the explore radius can change
+            float centerU = u*(sFogOfWarResolution-1) - mx*(sFogOfWarResolution-1);
+            float centerV = v*(sFogOfWarResolution-1) - my*(sFogOfWarResolution-1);
+            int minU = std::max(0, static_cast<int>(std::floor(centerU - exploreRadius)));
+            int maxU = std::min(sFogOfWarResolution-1, static_cast<int>(std::ceil(centerU + exploreRadius)));
+            int minV = std::max(0, static_cast<int>(std::floor(centerV - exploreRadius)));
+            int maxV = std::min(sFogOfWarResolution-1, static_cast<int>(std::ceil(centerV + exploreRadius)));
+
+            int changedMinU = sFogOfWarResolution, changedMaxU = -1;
+            int changedMinV = sFogOfWarResolution, changedMaxV = -1;
+
             {
-                for (int texU = 0; texU<sFogOfWarResolution; ++texU)
+                OpenThreads::ScopedLock<OpenThreads::Mutex> lock(segment.mFogOfWarUploader->getImageMutex());
+                uint32_t* texels = reinterpret_cast<uint32_t*>(segment.mFogOfWarImage->data());
+                for (int texV = minV; texV<=maxV; ++texV)
                 {
-                    float sqrDist = square((texU + mx*(sFogOfWarResolution-1)) - u*(sFogOfWarResolution-1))
-                            + square((texV + my*(sFogOfWarResolution-1)) - v*(sFogOfWarResolution-1));
+                    for (int texU = minU; texU<=maxU; ++texU)
+                    {
+                        float sqrDist = square(texU - centerU) + square(texV - centerV);
 
-                    uint32_t clr = *(uint32_t*)data;
-                    uint8_t alpha = (clr >> 24);
+                        uint32_t& clr = texels[texV * sFogOfWarResolution + texU];
+                        uint8_t alpha = (clr >> 24);
 
-                    alpha = std::min( alpha, (uint8_t) (std::max(0.f, std::min(1.f, (sqrDist/sqrExploreRadius)))*255) );
-                    *(uint32_t*)data = (uint32_t) (alpha << 24);
+                        uint8_t newAlpha = std::min( alpha, (uint8_t) (std::max(0.f, std::min(1.f, (sqrDist/sqrExploreRadius)))*255) );
+                        if (newAlpha == alpha)
+                            continue;
 
-                    data += 4;
+                        clr = (uint32_t) (newAlpha << 24);
+
+                        changedMinU = std::min(changedMinU, texU);
+                        changedMaxU = std::max(changedMaxU, texU);
+                        changedMinV = std::min(changedMinV, texV);
+                        changedMaxV = std::max(changedMaxV, texV);
+                    }
                 }
             }
 
-            segment.mHasFogState = true;
-            segment.mFogOfWarImage->dirty();
+            if (changedMaxU >= 0)
+                segment.mFogOfWarUploader->dirty(changedMinU, changedMinV, changedMaxU+1, changedMaxV+1);
         }
     }
 }
 
+LocalMap::CachedMap::CachedMap()
+    : mObjectStateHash(0)
+    , mNeighbours(0)
+    , mAngle(0.f)
+    , mLastUsed(0)
+{
+}
+
 LocalMap::MapSegment::MapSegment()
     : mHasFogState(false)
+    , mObjectStateHash(0)
+    , mNeighbours(0)
 {
 }
 
@@ -594,23 +840,25 @@ LocalMap::MapSegment::~MapSegment()
 
 void LocalMap::MapSegment::createFogOfWarTexture()
 {
-    if (mFogOfWarTexture)
-        return;
-    mFogOfWarTexture = new osg::Texture2D;
-    // TODO: synchronize access? for now, the worst that could happen is the draw thread jumping a frame ahead.
-    //mFogOfWarTexture->setDataVariance(osg::Object::DYNAMIC);
-    mFogOfWarTexture->setFilter(osg::Texture::MIN_FILTER, osg::Texture::LINEAR);
-    mFogOfWarTexture->setFilter(osg::Texture::MAG_FILTER, osg::Texture::LINEAR);
-    mFogOfWarTexture->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP_TO_EDGE);
-    mFogOfWarTexture->setWrap(osg::Texture::WRAP_T, osg::Texture::CLAMP_TO_EDGE);
-    mFogOfWarTexture->setUnRefImageDataAfterApply(false);
+    if (!mFogOfWarTexture)
+    {
+        mFogOfWarTexture = new osg::Texture2D;
+        mFogOfWarTexture->setFilter(osg::Texture::MIN_FILTER, osg::Texture::LINEAR);
+        mFogOfWarTexture->setFilter(osg::Texture::MAG_FILTER, osg::Texture::LINEAR);
+        mFogOfWarTexture->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP_TO_EDGE);
+        mFogOfWarTexture->setWrap(osg::Texture::WRAP_T, osg::Texture::CLAMP_TO_EDGE);
+        mFogOfWarTexture->setInternalFormat(GL_RGBA);
+    }
+
+    // The uploader sends changed regions of the image only, see updatePlayer
+    mFogOfWarTexture->setTextureSize(mFogOfWarImage->s(), mFogOfWarImage->t());
+    mFogOfWarUploader = new FogOfWarUploader(mFogOfWarImage);
+    mFogOfWarTexture->setSubloadCallback(mFogOfWarUploader);
 }
 
 void LocalMap::MapSegment::initFogOfWar()
 {
     mFogOfWarImage = new osg::Image;
-    // Assign a PixelBufferObject for asynchronous transfer of data to the GPU
-    mFogOfWarImage->setPixelBufferObject(new osg::PixelBufferObject);
     mFogOfWarImage->allocateImage(sFogOfWarResolution, sFogOfWarResolution, 1, GL_RGBA, GL_UNSIGNED_BYTE);
     assert(mFogOfWarImage->isDataContiguous());
     std::vector<uint32_t> data;
@@ -619,7 +867,6 @@ void LocalMap::MapSegment::initFogOfWar()
     memcpy(mFogOfWarImage->data(), &data[0], data.size()*4);
 
     createFogOfWarTexture();
-    mFogOfWarTexture->setImage(mFogOfWarImage);
 }
 
 void LocalMap::MapSegment::loadFogOfWar(const ESM::FogTexture &esm)
@@ -631,7 +878,30 @@ void LocalMap::MapSegment::loadFogOfWar(const ESM::FogTexture &esm)
         return;
     }
 
-    // TODO: deprecate tga and use raw data instead
+    if (esm.mRunLength)
+    {
+        std::vector<unsigned char> alpha;
+        if (!esm.decodeAlpha(alpha, sFogOfWarResolution*sFogOfWarResolution))
+        {
+            std::cerr << "Failed to read fog: invalid data" << std::endl;
+            return;
+        }
+
+        initFogOfWar();
+
+        {
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mFogOfWarUploader->getImageMutex());
+            uint32_t* texels = reinterpret_cast<uint32_t*>(mFogOfWarImage->data());
+            for (size_t i=0; i<alpha.size(); ++i)
+                texels[i] = static_cast<uint32_t>(alpha[i]) << 24;
+        }
+        mFogOfWarUploader->dirty(0, 0, sFogOfWarResolution, sFogOfWarResolution);
+
+        mHasFogState = true;
+        return;
+    }
+
+    // Saved game format 1 and older
 
     osgDB::ReaderWriter* readerwriter = osgDB::Registry::instance()->getReaderWriterForExtension("tga");
     if (!readerwriter)
@@ -651,10 +921,8 @@ void LocalMap::MapSegment::loadFogOfWar(const ESM::FogTexture &esm)
 
     mFogOfWarImage = result.getImage();
     mFogOfWarImage->flipVertical();
-    mFogOfWarImage->dirty();
 
     createFogOfWarTexture();
-    mFogOfWarTexture->setImage(mFogOfWarImage);
     mHasFogState = true;
 }
 
@@ -663,27 +931,13 @@ void LocalMap::MapSegment::saveFogOfWar(ESM::FogTexture &fog) const
     if (!mFogOfWarImage)
         return;
 
-    std::ostringstream ostream;
-
-    osgDB::ReaderWriter* readerwriter = osgDB::Registry::instance()->getReaderWriterForExtension("tga");
-    if (!readerwriter)
-    {
-        std::cerr << "Unable to write fog, can't find a tga ReaderWriter" << std::endl;
-        return;
-    }
-
-    // extra flips are unfortunate, but required for compatibility with older versions
-    mFogOfWarImage->flipVertical();
-    osgDB::ReaderWriter::WriteResult result = readerwriter->writeImage(*mFogOfWarImage, ostream);
-    if (!result.success())
-    {
-        std::cerr << "Unable to write fog: " << result.message() << std::endl;
-        return;
-    }
-    mFogOfWarImage->flipVertical();
+    // Only the alpha channel is used, which compresses well
+    const uint32_t* texels = reinterpret_cast<const uint32_t*>(mFogOfWarImage->data());
+    std::vector<unsigned char> alpha (sFogOfWarResolution*sFogOfWarResolution);
+    for (size_t i=0; i<alpha.size(); ++i)
+        alpha[i] = static_cast<unsigned char>(texels[i] >> 24);
 
-    std::string data = ostream.str();
-    fog.mImageData = std::vector<char>(data.begin(), data.end());
+    fog.encodeAlpha(alpha);
 }
 
 }
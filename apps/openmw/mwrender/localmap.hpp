@@ -4,6 +4,7 @@
 #include <set>
 #include <vector>
 #include <map>
+#include <string>
 
 #include <osg/BoundingBox>
 #include <osg/Quat>
@@ -35,6 +36,8 @@ namespace osg
 
 namespace MWRender
 {
+    class FogOfWarUploader;
+
     ///
     /// \brief Local map rendering
     ///
@@ -51,11 +54,13 @@ namespace MWRender
 
         /**
          * Request a map render for the given cells. Render textures will be immediately created and can be retrieved with the getMapTexture function.
+         * @note A cell is not rendered again if its objects are unchanged since it was last rendered, unless more
+         * surrounding cells are loaded now. Objects from surrounding cells may cross into a cell's map.
          */
         void requestMap (std::set<MWWorld::CellStore*> cells);
 
         /**
-         * Remove map and fog textures for the given cell.
+         * Remove map and fog textures for the given cell. The map texture is kept in a cache for when the cell is requested again.
          */
         void removeCell (MWWorld::CellStore* cell);
 
@@ -123,18 +128,60 @@ namespace MWRender
             void initFogOfWar();
             void loadFogOfWar(const ESM::FogTexture& fog);
             void saveFogOfWar(ESM::FogTexture& fog) const;
+
+            /// Set up mFogOfWarTexture to show mFogOfWarImage
             void createFogOfWarTexture();
 
             osg::ref_ptr<osg::Texture2D> mMapTexture;
             osg::ref_ptr<osg::Texture2D> mFogOfWarTexture;
             osg::ref_ptr<osg::Image> mFogOfWarImage;
+            osg::ref_ptr<FogOfWarUploader> mFogOfWarUploader;
 
             bool mHasFogState;
+
+            /// CellStore::getObjectStateHash of the cell when mMapTexture was rendered
+            size_t mObjectStateHash;
+
+            /// Exteriors: bit mask of the surrounding cells that were loaded when mMapTexture was rendered
+            int mNeighbours;
         };
 
         typedef std::map<std::pair<int, int>, MapSegment> SegmentMap;
         SegmentMap mSegments;
 
+        /// Map textures of a cell that is no longer loaded
+        struct CachedMap
+        {
+            CachedMap();
+
+            size_t mObjectStateHash;
+
+            // exteriors
+            int mNeighbours;
+
+            // interiors, the segments only fit if the bounds and angle are unchanged
+            osg::BoundingBox mBounds;
+            float mAngle;
+
+            std::map<std::pair<int, int>, osg::ref_ptr<osg::Texture2D> > mTextures;
+
+            unsigned int mLastUsed;
+        };
+
+        /// Interior cell name, or an empty name and the grid position of an exterior cell
+        typedef std::pair<std::string, std::pair<int, int> > CacheKey;
+        typedef std::map<CacheKey, CachedMap> MapCache;
+        MapCache mCache;
+
+        /// Maximum number of map textures in mCache
+        unsigned int mCacheSize;
+        unsigned int mCacheCounter;
+
+        void addToCache(const CacheKey& key, CachedMap& map);
+
+        /// Remove a map from the cache. Returns false if it is not cached.
+        bool takeFromCache(const CacheKey& key, CachedMap& map);
+
         int mMapResolution;
 
         // the dynamic texture is a bottleneck, so don't set this too high
@@ -146,7 +193,8 @@ namespace MWRender
         float mAngle;
         const osg::Vec2f rotatePoint(const osg::Vec2f& point, const osg::Vec2f& center, const float angle);
 
-        void requestExteriorMap(MWWorld::CellStore* cell);
+        /// @param neighbours Bit mask of the surrounding cells that are loaded
+        void requestExteriorMap(MWWorld::CellStore* cell, int neighbours);
         void requestInteriorMap(MWWorld::CellStore* cell);
 
         osg::ref_ptr<osg::Camera> createOrthographicCamera(float left, float top, float width, float height, const osg::Vec3d& upVector, float zmin, float zmax);
@@ -140,7 +140,7 @@ namespace MWScript
     InterpreterContext::InterpreterContext (
         MWScript::Locals *locals, MWWorld::Ptr reference, const std::string& targetId)
     : mLocals (locals), mReference (reference),
-      mActivationHandled (false), mTargetId (targetId)
+      mActivationHandled (false), mTargetId (targetId), mExplicitRefCache (0)
     {
         // If we run on a reference (local script, dialogue script or console with object
         // selected), store the ID of that reference store it so it can be inherited by
@@ -607,4 +607,14 @@ namespace MWScript
         if (!mReference.isEmpty())
             mReference = updated;
     }
+
+    void InterpreterContext::setExplicitRefCache (ExplicitRefCache *cache)
+    {
+        mExplicitRefCache = cache;
+    }
+
+    ExplicitRefCache *InterpreterContext::getExplicitRefCache() const
+    {
+        return mExplicitRefCache;
+    }
 }
@@ -21,6 +21,7 @@ namespace MWInput
 namespace MWScript
 {
     class Locals;
+    class ExplicitRefCache;
 
     class InterpreterContext : public Interpreter::Context
     {
@@ -32,6 +33,8 @@ namespace MWScript
 
             std::string mTargetId;
 
+            ExplicitRefCache *mExplicitRefCache;
+
             /// If \a id is empty, a reference the script is run from is returned or in case
             /// of a non-local script the reference derived from the target ID.
             MWWorld::Ptr getReferenceImp (const std::string& id = "", bool activeOnly = false,
@@ -171,6 +174,12 @@ namespace MWScript
             ///< Update the Ptr stored in mReference, if there is one stored there. Should be called after the reference has been moved to a new cell.
 
             virtual std::string getTargetId() const;
+
+            void setExplicitRefCache (ExplicitRefCache *cache);
+            ///< Cache for the script that is about to run (0-pointer allowed). The ownership of
+            /// \a cache is not transferred.
+
+            ExplicitRefCache *getExplicitRefCache() const;
     };
 }
 
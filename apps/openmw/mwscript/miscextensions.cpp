@@ -2,6 +2,8 @@
 #include "miscextensions.hpp"
 
 #include <cstdlib>
+#include <iomanip>
+#include <sstream>
 
 #include <components/compiler/extensions.hpp>
 #include <components/compiler/opcodes.hpp>
@@ -14,6 +16,10 @@
 #include <components/esm/loadmgef.hpp>
 #include <components/esm/loadcrea.hpp>
 
+#include <components/misc/profiler.hpp>
+
+#include <components/resource/objectcache.hpp>
+
 #include "../mwbase/environment.hpp"
 #include "../mwbase/windowmanager.hpp"
 #include "../mwbase/scriptmanager.hpp"
@@ -910,6 +916,46 @@ namespace MWScript
             }
         };
 
+        class OpToggleProfiler : public Interpreter::Opcode0
+        {
+        public:
+            virtual void execute (Interpreter::Runtime& runtime)
+            {
+                bool wasEnabled = ::Misc::Profiler::isEnabled();
+                bool enabled = ::Misc::Profiler::toggle();
+
+                if (enabled)
+                    runtime.getContext().report("Profiler -> On, writing " + ::Misc::Profiler::getTraceFile());
+                else if (wasEnabled)
+                    runtime.getContext().report("Profiler -> Off, wrote " + ::Misc::Profiler::getTraceFile());
+                else
+                    runtime.getContext().report("Can't write trace file");
+            }
+        };
+
+        class OpResourceStats : public Interpreter::Opcode0
+        {
+        public:
+            virtual void execute (Interpreter::Runtime& runtime)
+            {
+                std::map<std::string, Resource::CacheStats> stats;
+                MWBase::Environment::get().getWorld()->getResourceCacheStats(stats);
+
+                for (std::map<std::string, Resource::CacheStats>::const_iterator it = stats.begin(); it != stats.end(); ++it)
+                {
+                    const Resource::CacheStats& cache = it->second;
+                    std::ostringstream line;
+                    line << std::fixed << std::setprecision(1)
+                         << it->first << ": " << cache.mObjects << " objects, "
+                         << cache.mCost / (1024.0*1024.0) << " MB ("
+                         << cache.mUnusedCost / (1024.0*1024.0) << " MB unused), "
+                         << cache.mHits << " hits, " << cache.mMisses << " misses, "
+                         << cache.mEvictions << " evictions";
+                    runtime.getContext().report(line.str());
+                }
+            }
+        };
+
         class OpToggleGodMode : public Interpreter::Opcode0
         {
             public:
@@ -1218,6 +1264,8 @@ namespace MWScript
             interpreter.installSegment5 (Compiler::Misc::opcodeShowVarsExplicit, new OpShowVars<ExplicitRef>);
             interpreter.installSegment5 (Compiler::Misc::opcodeToggleGodMode, new OpToggleGodMode);
             interpreter.installSegment5 (Compiler::Misc::opcodeToggleScripts, new OpToggleScripts);
+            interpreter.installSegment5 (Compiler::Misc::opcodeToggleProfiler, new OpToggleProfiler);
+            interpreter.installSegment5 (Compiler::Misc::opcodeResourceStats, new OpResourceStats);
             interpreter.installSegment5 (Compiler::Misc::opcodeDisableLevitation, new OpEnableLevitation<false>);
             interpreter.installSegment5 (Compiler::Misc::opcodeEnableLevitation, new OpEnableLevitation<true>);
             interpreter.installSegment5 (Compiler::Misc::opcodeCast, new OpCast<ImplicitRef>);
@@ -0,0 +1,178 @@
+#include "parallelcompiler.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <exception>
+
+#include <OpenThreads/Atomic>
+#include <OpenThreads/Mutex>
+#include <OpenThreads/ScopedLock>
+#include <OpenThreads/Thread>
+
+#include <components/compiler/context.hpp>
+#include <components/compiler/exception.hpp>
+#include <components/compiler/fileparser.hpp>
+#include <components/compiler/scanner.hpp>
+#include <components/compiler/scriptparser.hpp>
+#include <components/compiler/streamerrorhandler.hpp>
+
+#include <components/sceneutil/workqueue.hpp>
+
+namespace
+{
+    /// Forwards to the context shared by all compiler threads
+    class SharedContext : public Compiler::Context
+    {
+            Compiler::Context& mContext;
+            mutable OpenThreads::Mutex mMutex;
+
+        public:
+
+            SharedContext (Compiler::Context& context) : mContext (context)
+            {
+                setExtensions (context.getExtensions());
+            }
+
+            virtual bool canDeclareLocals() const
+            {
+                return mContext.canDeclareLocals();
+            }
+
+            virtual char getGlobalType (const std::string& name) const
+            {
+                return mContext.getGlobalType (name);
+            }
+
+            virtual std::pair<char, bool> getMemberType (const std::string& name,
+                const std::string& id) const
+            {
+                // May search the cells for the reference, and scan its script for locals
+                OpenThreads::ScopedLock<OpenThreads::Mutex> lock (mMutex);
+                return mContext.getMemberType (name, id);
+            }
+
+            virtual bool isId (const std::string& name) const
+            {
+                return mContext.isId (name);
+            }
+
+            virtual bool isJournalId (const std::string& name) const
+            {
+                return mContext.isJournalId (name);
+            }
+    };
+
+    void compile (MWScript::CompileJob& job, Compiler::Context& context, int warningsMode)
+    {
+        std::ostringstream messages;
+        Compiler::StreamErrorHandler errorHandler (messages);
+        errorHandler.setWarningsMode (warningsMode);
+
+        job.mSuccess = false;
+
+        try
+        {
+            std::istringstream input (job.mText);
+
+            Compiler::Scanner scanner (errorHandler, input, context.getExtensions());
+
+            if (job.mLocals)
+            {
+                Compiler::Locals locals = *job.mLocals;
+                Compiler::ScriptParser parser (errorHandler, context, locals, false);
+
+                scanner.scan (parser);
+
+                job.mSuccess = errorHandler.isGood();
+            }
+            else
+            {
+                Compiler::FileParser parser (errorHandler, context);
+
+                scanner.scan (parser);
+
+                if (errorHandler.isGood())
+                {
+                    parser.getCode (job.mCode);
+                    job.mCompiledLocals = parser.getLocals();
+                    job.mSuccess = true;
+                }
+            }
+        }
+        catch (const Compiler::SourceException&)
+        {
+            // error has already been reported via error handler
+        }
+        catch (const std::exception& error)
+        {
+            messages << "An exception has been thrown: " << error.what() << std::endl;
+        }
+
+        job.mMessages = messages.str();
+    }
+
+    /// Takes the next job that no other thread has taken yet, until all are done
+    class CompileWorkItem : public SceneUtil::WorkItem
+    {
+        public:
+
+            CompileWorkItem (std::vector<MWScript::CompileJob>& jobs, OpenThreads::Atomic& nextJob,
+                Compiler::Context& context, int warningsMode)
+            : mJobs (jobs), mNextJob (nextJob), mContext (context), mWarningsMode (warningsMode)
+            {}
+
+            virtual void doWork()
+            {
+                compileJobs();
+                mTicket->signalDone();
+            }
+
+            void compileJobs()
+            {
+                // Scripts differ a lot in length, so jobs are handed out one at a time instead of in ranges
+                for (size_t i = ++mNextJob - 1; i<mJobs.size(); i = ++mNextJob - 1)
+                    compile (mJobs[i], mContext, mWarningsMode);
+            }
+
+        private:
+
+            std::vector<MWScript::CompileJob>& mJobs;
+            OpenThreads::Atomic& mNextJob;
+            Compiler::Context& mContext;
+            int mWarningsMode;
+    };
+}
+
+namespace MWScript
+{
+    CompileJob::CompileJob (const std::string& name, const std::string& text, const Compiler::Locals *locals)
+    : mName (name), mText (text), mLocals (locals), mSuccess (false)
+    {}
+
+    int compileInParallel (std::vector<CompileJob>& jobs, Compiler::Context& context, int warningsMode,
+        int numThreads)
+    {
+        SharedContext sharedContext (context);
+        OpenThreads::Atomic nextJob;
+
+        numThreads = static_cast<int> (std::min (jobs.size(), static_cast<size_t> (std::max (numThreads, 0))));
+
+        std::vector<osg::ref_ptr<SceneUtil::WorkTicket> > tickets;
+        SceneUtil::WorkQueue workQueue (numThreads);
+        for (int i=0; i<numThreads; ++i)
+            tickets.push_back (workQueue.addWorkItem (
+                new CompileWorkItem (jobs, nextJob, sharedContext, warningsMode)));
+
+        CompileWorkItem (jobs, nextJob, sharedContext, warningsMode).compileJobs();
+
+        for (std::vector<osg::ref_ptr<SceneUtil::WorkTicket> >::iterator it = tickets.begin(); it != tickets.end(); ++it)
+            (*it)->waitTillDone();
+
+        return numThreads + 1;
+    }
+
+    int getCompilerThreads()
+    {
+        return std::max (OpenThreads::GetNumberOfProcessors() - 1, 0);
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef GAME_SCRIPT_PARALLELCOMPILER_H
+#define GAME_SCRIPT_PARALLELCOMPILER_H
+
+#include <string>
+#include <vector>
+
+#include <components/compiler/locals.hpp>
+
+#include <components/interpreter/types.hpp>
+
+namespace Compiler
+{
+    class Context;
+}
+
+namespace MWScript
+{
+    /// \brief A script or a dialogue result script to be compiled by compileInParallel()
+    struct CompileJob
+    {
+        std::string mName;
+        std::string mText;
+
+        /// Locals of the script that a dialogue result script runs in, NULL for a full script.
+        /// \note Must stay valid until the job is compiled.
+        const Compiler::Locals *mLocals;
+
+        bool mSuccess;
+
+        /// Output of the error handler, and the messages of exceptions thrown by the compiler
+        std::string mMessages;
+
+        /// Byte code and locals of a successfully compiled full script
+        std::vector<Interpreter::Type_Code> mCode;
+        Compiler::Locals mCompiledLocals;
+
+        CompileJob (const std::string& name, const std::string& text, const Compiler::Locals *locals = 0);
+    };
+
+    /// Compile \a jobs on the calling thread and \a numThreads worker threads. Each thread has its own scanner,
+    /// parser and error handler. The results are stored in the jobs, so that they can be reported in order.
+    ///
+    /// \param context Shared by all threads. Calls to getMemberType() are serialised, as it may have to search
+    /// the world for a reference. The other queries must not modify anything.
+    /// \return Number of threads used, including the calling thread. No more workers are started than there
+    /// are jobs.
+    int compileInParallel (std::vector<CompileJob>& jobs, Compiler::Context& context, int warningsMode,
+        int numThreads);
+
+    /// Number of worker threads to use for compileInParallel(), one less than the number of CPU cores.
+    int getCompilerThreads();
+}
+
+#endif
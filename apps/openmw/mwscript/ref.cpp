@@ -1,22 +1,89 @@
 #include "ref.hpp"
 
+#include <stdexcept>
+
 #include <components/interpreter/runtime.hpp>
 
 #include "../mwbase/environment.hpp"
 #include "../mwbase/world.hpp"
 
+#include "../mwworld/cellref.hpp"
+
 #include "interpretercontext.hpp"
 
+MWWorld::Ptr MWScript::ExplicitRefCache::search (int literal, bool activeOnly,
+    unsigned int generation) const
+{
+    if (literal<0 || literal>=static_cast<int> (mEntries.size()))
+        return MWWorld::Ptr();
+
+    const Entry& entry = mEntries[literal];
+
+    if (entry.mPtr.isEmpty() || entry.mGeneration!=generation || entry.mActiveOnly!=activeOnly)
+        return MWWorld::Ptr();
+
+    // Same conditions as CellRefList::find, in case the reference was removed without being deleted
+    const MWWorld::Ptr& ptr = entry.mPtr;
+    if (ptr.getRefData().isDeletedByContentFile()
+        || (!ptr.getCellRef().hasContentFile() && ptr.getRefData().getCount()<=0))
+        return MWWorld::Ptr();
+
+    return ptr;
+}
+
+void MWScript::ExplicitRefCache::insert (int literal, bool activeOnly, unsigned int generation,
+    const MWWorld::Ptr& ptr)
+{
+    if (literal<0)
+        return;
+
+    if (literal>=static_cast<int> (mEntries.size()))
+        mEntries.resize (literal+1);
+
+    Entry& entry = mEntries[literal];
+    entry.mGeneration = generation;
+    entry.mActiveOnly = activeOnly;
+    entry.mPtr = ptr;
+}
+
+void MWScript::ExplicitRefCache::clear()
+{
+    mEntries.clear();
+}
+
 MWWorld::Ptr MWScript::ExplicitRef::operator() (Interpreter::Runtime& runtime, bool required,
     bool activeOnly) const
 {
-    std::string id = runtime.getStringLiteral(runtime[0].mInteger);
+    int literal = runtime[0].mInteger;
     runtime.pop();
 
-    if (required)
-        return MWBase::Environment::get().getWorld()->getPtr(id, activeOnly);
-    else
-        return MWBase::Environment::get().getWorld()->searchPtr(id, activeOnly);
+    MWScript::InterpreterContext& context
+        = static_cast<MWScript::InterpreterContext&> (runtime.getContext());
+
+    MWBase::World *world = MWBase::Environment::get().getWorld();
+
+    ExplicitRefCache *cache = context.getExplicitRefCache();
+    unsigned int generation = world->getReferenceGeneration();
+
+    if (cache)
+    {
+        MWWorld::Ptr ptr = cache->search (literal, activeOnly, generation);
+        if (!ptr.isEmpty())
+            return ptr;
+    }
+
+    std::string id = runtime.getStringLiteral (literal);
+
+    MWWorld::Ptr ptr = world->searchPtr (id, activeOnly);
+
+    // references in containers can move without changing the generation
+    if (cache && !ptr.isEmpty() && ptr.isInCell())
+        cache->insert (literal, activeOnly, generation, ptr);
+
+    if (ptr.isEmpty() && required)
+        throw std::runtime_error ("unknown ID: " + id);
+
+    return ptr;
 }
 
 MWWorld::Ptr MWScript::ImplicitRef::operator() (Interpreter::Runtime& runtime, bool required,
@@ -2,6 +2,7 @@
 #define GAME_MWSCRIPT_REF_H
 
 #include <string>
+#include <vector>
 
 #include "../mwworld/ptr.hpp"
 
@@ -12,6 +13,33 @@ namespace Interpreter
 
 namespace MWScript
 {
+    /// \brief References found by ExplicitRef for the string literals of one script
+    ///
+    /// An entry is valid as long as MWBase::World::getReferenceGeneration has not changed.
+    /// Only references in cells (and the player) are cached, not references in containers.
+    class ExplicitRefCache
+    {
+            struct Entry
+            {
+                unsigned int mGeneration;
+                bool mActiveOnly;
+                MWWorld::Ptr mPtr;
+
+                Entry() : mGeneration (0), mActiveOnly (false) {}
+            };
+
+            std::vector<Entry> mEntries;
+
+        public:
+
+            MWWorld::Ptr search (int literal, bool activeOnly, unsigned int generation) const;
+            ///< Return an empty Ptr, if nothing valid is cached.
+
+            void insert (int literal, bool activeOnly, unsigned int generation, const MWWorld::Ptr& ptr);
+
+            void clear();
+    };
+
     struct ExplicitRef
     {
         static const bool implicit = false;
@@ -10,6 +10,7 @@
 #include <components/esm/loadscpt.hpp>
 
 #include <components/misc/stringops.hpp>
+#include <components/misc/profiler.hpp>
 
 #include <components/compiler/scanner.hpp>
 #include <components/compiler/context.hpp>
@@ -19,13 +20,23 @@
 #include "../mwworld/esmstore.hpp"
 
 #include "extensions.hpp"
+#include "interpretercontext.hpp"
+#include "parallelcompiler.hpp"
 
 namespace MWScript
 {
+    ScriptManager::CompiledScript::CompiledScript (const std::vector<Interpreter::Type_Code>& byteCode,
+        const Compiler::Locals& locals)
+    : mByteCode (byteCode), mLocals (locals)
+    {
+        if (!mByteCode.empty())
+            Interpreter::Runtime::getStringLiteralOffsets (&mByteCode[0], mStringLiteralOffsets);
+    }
+
     ScriptManager::ScriptManager (const MWWorld::ESMStore& store, bool verbose,
         Compiler::Context& compilerContext, int warningsMode,
         const std::vector<std::string>& scriptBlacklist)
-    : mErrorHandler (std::cerr), mStore (store), mVerbose (verbose),
+    : mErrorHandler (std::cerr), mStore (store), mVerbose (verbose), mWarningsMode (warningsMode),
       mCompilerContext (compilerContext), mParser (mErrorHandler, mCompilerContext),
       mOpcodesInstalled (false), mGlobalScripts (store)
     {
@@ -83,7 +94,7 @@ namespace MWScript
             {
                 std::vector<Interpreter::Type_Code> code;
                 mParser.getCode (code);
-                mScripts.insert (std::make_pair (name, std::make_pair (code, mParser.getLocals())));
+                mScripts.insert (std::make_pair (name, CompiledScript (code, mParser.getLocals())));
 
                 return true;
             }
@@ -94,6 +105,7 @@ namespace MWScript
 
     void ScriptManager::run (const std::string& name, Interpreter::Context& interpreterContext)
     {
+        Misc::ProfileZone zone("ScriptManager::run");
         // compile script
         ScriptCollection::iterator iter = mScripts.find (name);
 
@@ -103,7 +115,7 @@ namespace MWScript
             {
                 // failed -> ignore script from now on.
                 std::vector<Interpreter::Type_Code> empty;
-                mScripts.insert (std::make_pair (name, std::make_pair (empty, Compiler::Locals())));
+                mScripts.insert (std::make_pair (name, CompiledScript (empty, Compiler::Locals())));
                 return;
             }
 
@@ -112,7 +124,14 @@ namespace MWScript
         }
 
         // execute script
-        if (!iter->second.first.empty())
+        CompiledScript& script = iter->second;
+
+        if (!script.mByteCode.empty())
+        {
+            // all contexts passed to the script manager are ours
+            InterpreterContext& context = static_cast<InterpreterContext&> (interpreterContext);
+            context.setExplicitRefCache (&script.mExplicitRefCache);
+
             try
             {
                 if (!mOpcodesInstalled)
@@ -121,21 +140,24 @@ namespace MWScript
                     mOpcodesInstalled = true;
                 }
 
-                mInterpreter.run (&iter->second.first[0], iter->second.first.size(), interpreterContext);
+                mInterpreter.run (&script.mByteCode[0], script.mByteCode.size(), interpreterContext,
+                    &script.mStringLiteralOffsets);
             }
             catch (const std::exception& e)
             {
                 std::cerr << "Execution of script " << name << " failed:" << std::endl;
                 std::cerr << e.what() << std::endl;
 
-                iter->second.first.clear(); // don't execute again.
+                script.mByteCode.clear(); // don't execute again.
             }
+
+            context.setExplicitRefCache (0);
+        }
     }
 
-    std::pair<int, int> ScriptManager::compileAll()
+    std::pair<int, int> ScriptManager::compileAll (int& threads)
     {
-        int count = 0;
-        int success = 0;
+        std::vector<CompileJob> jobs;
 
         const MWWorld::Store<ESM::Script>& scripts = mStore.get<ESM::Script>();
 
@@ -144,13 +166,36 @@ namespace MWScript
             if (!std::binary_search (mScriptBlacklist.begin(), mScriptBlacklist.end(),
                 Misc::StringUtils::lowerCase (iter->mId)))
             {
-                ++count;
+                jobs.push_back (CompileJob (iter->mId, iter->mScriptText));
+            }
+
+        threads = compileInParallel (jobs, mCompilerContext, mWarningsMode, getCompilerThreads());
 
-                if (compile (iter->mId))
-                    ++success;
+        // report in the same order as when compiling one script after another
+        int success = 0;
+
+        for (std::vector<CompileJob>::const_iterator job = jobs.begin(); job!=jobs.end(); ++job)
+        {
+            if (mVerbose)
+                std::cout << "compiling script: " << job->mName << std::endl;
+
+            std::cerr << job->mMessages;
+
+            if (job->mSuccess)
+            {
+                mScripts.insert (std::make_pair (job->mName, CompiledScript (job->mCode, job->mCompiledLocals)));
+                ++success;
             }
+            else
+            {
+                std::cerr
+                    << "compiling failed: " << job->mName << std::endl;
+                if (mVerbose)
+                    std::cerr << job->mText << std::endl << std::endl;
+            }
+        }
 
-        return std::make_pair (count, success);
+        return std::make_pair (static_cast<int> (jobs.size()), success);
     }
 
     const Compiler::Locals& ScriptManager::getLocals (const std::string& name)
@@ -161,7 +206,7 @@ namespace MWScript
             ScriptCollection::iterator iter = mScripts.find (name2);
 
             if (iter!=mScripts.end())
-                return iter->second.second;
+                return iter->second.mLocals;
         }
 
         {
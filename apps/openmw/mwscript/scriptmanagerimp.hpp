@@ -13,6 +13,7 @@
 #include "../mwbase/scriptmanager.hpp"
 
 #include "globalscripts.hpp"
+#include "ref.hpp"
 
 namespace MWWorld
 {
@@ -37,12 +38,23 @@ namespace MWScript
             Compiler::StreamErrorHandler mErrorHandler;
             const MWWorld::ESMStore& mStore;
             bool mVerbose;
+            int mWarningsMode;
             Compiler::Context& mCompilerContext;
             Compiler::FileParser mParser;
             Interpreter::Interpreter mInterpreter;
             bool mOpcodesInstalled;
 
-            typedef std::pair<std::vector<Interpreter::Type_Code>, Compiler::Locals> CompiledScript;
+            struct CompiledScript
+            {
+                std::vector<Interpreter::Type_Code> mByteCode;
+                Compiler::Locals mLocals;
+                std::vector<int> mStringLiteralOffsets;
+                ExplicitRefCache mExplicitRefCache;
+
+                CompiledScript (const std::vector<Interpreter::Type_Code>& byteCode,
+                    const Compiler::Locals& locals);
+            };
+
             typedef std::map<std::string, CompiledScript> ScriptCollection;
 
             ScriptCollection mScripts;
@@ -63,8 +75,9 @@ namespace MWScript
             ///< Compile script with the given namen
             /// \return Success?
 
-            virtual std::pair<int, int> compileAll();
-            ///< Compile all scripts
+            virtual std::pair<int, int> compileAll (int& threads);
+            ///< Compile all scripts, in parallel
+            /// \param threads Set to the number of threads the scripts were compiled on
             /// \return count, success
 
             virtual const Compiler::Locals& getLocals (const std::string& name);
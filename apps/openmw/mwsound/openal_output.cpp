@@ -6,6 +6,7 @@
 #include <stdint.h>
 
 #include <components/vfs/manager.hpp>
+#include <components/misc/profiler.hpp>
 
 #include <boost/thread.hpp>
 
@@ -759,6 +760,7 @@ void OpenAL_Output::deinit()
 
 const CachedSound& OpenAL_Output::getBuffer(const std::string &fname)
 {
+    Misc::ProfileZone zone("OpenAL_Output::getBuffer");
     ALuint buf = 0;
 
     NameMap::iterator iditer = mBufferCache.find(fname);
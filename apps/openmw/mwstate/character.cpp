@@ -2,6 +2,7 @@
 #include "character.hpp"
 
 #include <ctime>
+#include <iostream>
 
 #include <sstream>
 #include <algorithm>
@@ -10,33 +11,163 @@
 #include <boost/filesystem.hpp>
 
 #include <components/esm/esmreader.hpp>
+#include <components/esm/esmwriter.hpp>
 #include <components/esm/defs.hpp>
 
 #include <components/misc/stringops.hpp>
 
+namespace
+{
+    const char* const sIndexFile = "slots.index";
+}
+
 bool MWState::operator< (const Slot& left, const Slot& right)
 {
     return left.mTimeStamp<right.mTimeStamp;
 }
 
 
-void MWState::Character::addSlot (const boost::filesystem::path& path, const std::string& game)
+bool MWState::Character::readIndex (Index& index) const
+{
+    boost::filesystem::path path = mPath / sIndexFile;
+
+    if (!boost::filesystem::exists (path))
+        return false;
+
+    try
+    {
+        ESM::ESMReader reader;
+        reader.open (path.string());
+
+        if (reader.getFormat()!=ESM::SavedGame::sCurrentFormat)
+            return false; // written by a different version; the saved game header may differ
+
+        while (reader.hasMoreRecs())
+        {
+            ESM::NAME name = reader.getRecName();
+            reader.getRecHeader();
+
+            if (!(name == "SLOT"))
+            {
+                reader.skipRecord();
+                continue;
+            }
+
+            std::string file = reader.getHNString ("FILE");
+
+            IndexEntry entry;
+            uint64_t size = 0;
+            reader.getHNT (size, "SIZE");
+            entry.mSize = size;
+            int64_t timeStamp = 0;
+            reader.getHNT (timeStamp, "MTIM");
+            entry.mTimeStamp = static_cast<std::time_t> (timeStamp);
+            entry.mProfile.load (reader);
+
+            index[file] = entry;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Failed to read saved game index " << path.string() << ": " << e.what() << std::endl;
+        index.clear();
+        return false;
+    }
+
+    return true;
+}
+
+void MWState::Character::writeIndex (const Index& index) const
 {
+    boost::filesystem::path path = mPath / sIndexFile;
+
+    try
+    {
+        boost::filesystem::ofstream stream (path, std::ios::binary);
+
+        ESM::ESMWriter writer;
+        writer.setFormat (ESM::SavedGame::sCurrentFormat);
+
+        // all unused
+        writer.setVersion(0);
+        writer.setType(0);
+        writer.setAuthor("");
+        writer.setDescription("");
+
+        writer.setRecordCount (index.size());
+
+        writer.save (stream);
+
+        for (Index::const_iterator it = index.begin(); it != index.end(); ++it)
+        {
+            writer.startRecord ("SLOT");
+            writer.writeHNString ("FILE", it->first);
+            writer.writeHNT ("SIZE", static_cast<uint64_t> (it->second.mSize));
+            writer.writeHNT ("MTIM", static_cast<int64_t> (it->second.mTimeStamp));
+            it->second.mProfile.save (writer);
+            writer.endRecord ("SLOT");
+        }
+
+        writer.close();
+
+        if (stream.fail())
+            throw std::runtime_error ("Write operation failed");
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Failed to write saved game index " << path.string() << ": " << e.what() << std::endl;
+
+        boost::system::error_code ec;
+        boost::filesystem::remove (path, ec);
+    }
+}
+
+void MWState::Character::addSlot (const boost::filesystem::path& path, const std::string& game,
+    const Index& index, Index& newIndex, bool& indexChanged)
+{
+    if (path.filename() == sIndexFile)
+        return;
+
+    if (path.extension() == ".tmp")
+        return; // incomplete saved game, left behind by an interrupted write
+
     Slot slot;
     slot.mPath = path;
     slot.mTimeStamp = boost::filesystem::last_write_time (path);
 
-    ESM::ESMReader reader;
-    reader.open (slot.mPath.string());
+    boost::uintmax_t size = boost::filesystem::file_size (path);
+    std::string file = path.filename().string();
+
+    Index::const_iterator found = index.find (file);
+    if (found!=index.end() && found->second.mSize==size && found->second.mTimeStamp==slot.mTimeStamp)
+    {
+        slot.mProfile = found->second.mProfile;
+        newIndex[file] = found->second;
+    }
+    else
+    {
+        ESM::ESMReader reader;
+        reader.open (slot.mPath.string());
+
+        if (reader.getRecName()!=ESM::REC_SAVE)
+            return; // invalid save file -> ignore
 
-    if (reader.getRecName()!=ESM::REC_SAVE)
-        return; // invalid save file -> ignore
+        reader.getRecHeader();
 
-    reader.getRecHeader();
+        slot.mProfile.load (reader);
 
-    slot.mProfile.load (reader);
+        // The screenshot is loaded on demand
+        std::vector<char>().swap (slot.mProfile.mScreenshot);
 
-    if (Misc::StringUtils::lowerCase (slot.mProfile.mContentFiles.at (0))!=
+        IndexEntry& entry = newIndex[file];
+        entry.mSize = size;
+        entry.mTimeStamp = slot.mTimeStamp;
+        entry.mProfile = slot.mProfile;
+        indexChanged = true;
+    }
+
+    if (slot.mProfile.mContentFiles.empty() ||
+        Misc::StringUtils::lowerCase (slot.mProfile.mContentFiles[0])!=
         Misc::StringUtils::lowerCase (game))
         return; // this file is for a different game -> ignore
 
@@ -86,6 +217,11 @@ MWState::Character::Character (const boost::filesystem::path& saves, const std::
     }
     else
     {
+        Index index;
+        bool indexChanged = !readIndex (index);
+
+        Index newIndex;
+
         for (boost::filesystem::directory_iterator iter (mPath);
             iter!=boost::filesystem::directory_iterator(); ++iter)
         {
@@ -93,11 +229,15 @@ MWState::Character::Character (const boost::filesystem::path& saves, const std::
 
             try
             {
-                addSlot (slotPath, game);
+                addSlot (slotPath, game, index, newIndex, indexChanged);
             }
             catch (...) {} // ignoring bad saved game files for now
         }
 
+        // Saved games were added or removed since the last run
+        if (indexChanged || newIndex.size()!=index.size())
+            writeIndex (newIndex);
+
         std::sort (mSlots.begin(), mSlots.end());
     }
 }
@@ -109,6 +249,9 @@ void MWState::Character::cleanup()
         // All slots are gone, no need to keep the empty directory
         if (boost::filesystem::is_directory (mPath))
         {
+            boost::system::error_code ec;
+            boost::filesystem::remove (mPath / sIndexFile, ec);
+
             // Extra safety check to make sure the directory is empty (e.g. slots failed to parse header)
             boost::filesystem::directory_iterator it(mPath);
             if (it == boost::filesystem::directory_iterator())
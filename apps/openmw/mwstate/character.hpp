@@ -1,6 +1,9 @@
 #ifndef GAME_STATE_CHARACTER_H
 #define GAME_STATE_CHARACTER_H
 
+#include <map>
+
+#include <boost/cstdint.hpp>
 #include <boost/filesystem/path.hpp>
 
 #include <components/esm/savedgame.hpp>
@@ -10,7 +13,10 @@ namespace MWState
     struct Slot
     {
         boost::filesystem::path mPath;
+
+        /// \note The screenshot is usually not loaded. Read it from the saved game file if needed.
         ESM::SavedGame mProfile;
+
         std::time_t mTimeStamp;
     };
 
@@ -24,10 +30,28 @@ namespace MWState
 
         private:
 
+            /// Saved game headers of the last run, so unchanged saved games don't have to be opened again.
+            struct IndexEntry
+            {
+                boost::uintmax_t mSize;
+                std::time_t mTimeStamp;
+                ESM::SavedGame mProfile;
+            };
+
+            /// Index entries by file name
+            typedef std::map<std::string, IndexEntry> Index;
+
             boost::filesystem::path mPath;
             std::vector<Slot> mSlots;
 
-            void addSlot (const boost::filesystem::path& path, const std::string& game);
+            bool readIndex (Index& index) const;
+
+            void writeIndex (const Index& index) const;
+
+            void addSlot (const boost::filesystem::path& path, const std::string& game,
+                const Index& index, Index& newIndex, bool& indexChanged);
+            ///< Add the saved game at \a path. Its header is taken from \a index if the file is unchanged,
+            /// otherwise it is read from the file. Either way, it is added to \a newIndex.
 
             void addSlot (const ESM::SavedGame& profile);
 
@@ -100,6 +100,15 @@ std::list<MWState::Character>::iterator MWState::CharacterManager::findCharacter
     return it;
 }
 
+MWState::Character *MWState::CharacterManager::findCharacter (const boost::filesystem::path& path)
+{
+    for (std::list<Character>::iterator it = mCharacters.begin(); it != mCharacters.end(); ++it)
+        if (it->getPath() == path)
+            return &*it;
+
+    return 0;
+}
+
 void MWState::CharacterManager::setCurrentCharacter (const Character *character)
 {
     std::list<Character>::iterator it = findCharacter(character);
@@ -37,6 +37,10 @@ namespace MWState
 
             void deleteSlot(const MWState::Character *character, const MWState::Slot *slot);
 
+            Character *findCharacter (const boost::filesystem::path& path);
+            ///< \return The character whose saved games are stored in \a path, or 0 if there is none
+            /// (e.g. because it was deleted).
+
             void createCharacter(const std::string& name);
             ///< Create new character within saved game management
             /// \param name Name for the character (does not need to be unique)
@@ -0,0 +1,133 @@
+#include "savegamewriter.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include <osg/Image>
+
+#include <osgDB/Registry>
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <components/esm/esmwriter.hpp>
+#include <components/esm/compressedrecords.hpp>
+#include <components/esm/defs.hpp>
+
+namespace
+{
+    void encodeScreenshot(const osg::Image& screenshot, std::vector<char>& imageData)
+    {
+        osgDB::ReaderWriter* readerwriter = osgDB::Registry::instance()->getReaderWriterForExtension("jpg");
+        if (!readerwriter)
+        {
+            std::cerr << "Unable to write screenshot, can't find a jpg ReaderWriter" << std::endl;
+            return;
+        }
+
+        std::ostringstream ostream;
+        osgDB::ReaderWriter::WriteResult result = readerwriter->writeImage(screenshot, ostream);
+        if (!result.success())
+        {
+            std::cerr << "Unable to write screenshot: " << result.message() << std::endl;
+            return;
+        }
+
+        std::string data = ostream.str();
+        imageData = std::vector<char>(data.begin(), data.end());
+    }
+}
+
+namespace MWState
+{
+
+SaveGameData::SaveGameData()
+    : mRecordCount(0)
+    , mCompress(false)
+{
+    setThreadSafeRefUnref(true);
+}
+
+SaveGameWriter::SaveGameWriter(SaveGameData *data)
+    : mData(data)
+{
+}
+
+void SaveGameWriter::doWork()
+{
+    try
+    {
+        write();
+    }
+    catch (const std::exception& e)
+    {
+        mData->mError = e.what();
+    }
+
+    // The snapshot is no longer needed, only the outcome
+    std::string().swap(mData->mRecords);
+    mData->mScreenshot = NULL;
+
+    mTicket->signalDone();
+}
+
+void SaveGameWriter::write()
+{
+    if (mData->mScreenshot)
+        encodeScreenshot(*mData->mScreenshot, mData->mProfile.mScreenshot);
+
+    boost::filesystem::path tempPath = mData->mPath;
+    tempPath += ".tmp";
+
+    {
+        boost::filesystem::ofstream stream (tempPath, std::ios::binary);
+
+        ESM::ESMWriter writer;
+
+        for (std::vector<std::string>::const_iterator iter (mData->mProfile.mContentFiles.begin());
+             iter!=mData->mProfile.mContentFiles.end(); ++iter)
+            writer.addMaster (*iter, 0); // not using the size information anyway -> use value of 0
+
+        writer.setFormat (ESM::SavedGame::sCurrentFormat);
+
+        // all unused
+        writer.setVersion(0);
+        writer.setType(0);
+        writer.setAuthor("");
+        writer.setDescription("");
+
+        writer.setRecordCount (mData->mRecordCount);
+
+        writer.save (stream);
+
+        writer.startRecord (ESM::REC_SAVE);
+        mData->mProfile.save (writer);
+        writer.endRecord (ESM::REC_SAVE);
+
+        if (mData->mCompress)
+        {
+            writer.startRecord (ESM::REC_CMPR);
+            ESM::writeCompressedRecords (writer, mData->mRecords.data(), mData->mRecords.size());
+            writer.endRecord (ESM::REC_CMPR);
+        }
+
+        writer.close();
+
+        if (!mData->mCompress)
+            stream.write (mData->mRecords.data(), mData->mRecords.size());
+
+        stream.close();
+
+        if (stream.fail())
+        {
+            boost::system::error_code ec;
+            boost::filesystem::remove(tempPath, ec);
+            throw std::runtime_error("Write operation failed");
+        }
+    }
+
+    boost::filesystem::rename(tempPath, mData->mPath);
+}
+
+}
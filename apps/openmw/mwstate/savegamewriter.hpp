@@ -0,0 +1,64 @@
+#ifndef GAME_STATE_SAVEGAMEWRITER_H
+#define GAME_STATE_SAVEGAMEWRITER_H
+
+#include <string>
+
+#include <boost/filesystem/path.hpp>
+
+#include <osg/Referenced>
+#include <osg/ref_ptr>
+
+#include <components/esm/savedgame.hpp>
+
+#include <components/sceneutil/workqueue.hpp>
+
+namespace osg
+{
+    class Image;
+}
+
+namespace MWState
+{
+    /// @brief Snapshot of a saved game, taken on the main thread, and the outcome of writing it to disk.
+    struct SaveGameData : public osg::Referenced
+    {
+        SaveGameData();
+
+        boost::filesystem::path mPath;
+
+        /// The saved game header. The screenshot is encoded by the writer.
+        ESM::SavedGame mProfile;
+
+        osg::ref_ptr<osg::Image> mScreenshot;
+
+        /// Number of records following the TES3 header, including the saved game header.
+        int mRecordCount;
+
+        /// Serialized game state records, following the saved game header in the file.
+        std::string mRecords;
+
+        /// Store mRecords compressed (see components/esm/compressedrecords.hpp)?
+        bool mCompress;
+
+        /// Set by the writer if the saved game could not be written.
+        std::string mError;
+    };
+
+    /// @brief Writes a saved game snapshot in the background.
+    /// @note The file is written under a temporary name first and then renamed, so that an existing
+    /// saved game with the same name is only replaced by a complete one.
+    class SaveGameWriter : public SceneUtil::WorkItem
+    {
+    public:
+        SaveGameWriter(SaveGameData* data);
+
+        virtual void doWork();
+
+    private:
+        void write();
+
+        osg::ref_ptr<SaveGameData> mData;
+    };
+}
+
+#endif
@@ -1,6 +1,9 @@
 
 #include "statemanagerimp.hpp"
 
+#include <iostream>
+#include <sstream>
+
 #include <components/esm/esmwriter.hpp>
 #include <components/esm/esmreader.hpp>
 #include <components/esm/cellid.hpp>
@@ -12,11 +15,10 @@
 
 #include <components/settings/settings.hpp>
 
-#include <osg/Image>
+#include <components/sceneutil/workqueue.hpp>
 
-#include <osgDB/Registry>
+#include <osg/Image>
 
-#include <boost/filesystem/fstream.hpp>
 #include <boost/filesystem/operations.hpp>
 
 #include "../mwbase/environment.hpp"
@@ -40,8 +42,23 @@
 
 #include "../mwscript/globalscripts.hpp"
 
+#include "savegamewriter.hpp"
+
+namespace
+{
+    const MWState::Slot* findSlot (const MWState::Character& character, const boost::filesystem::path& path)
+    {
+        for (MWState::Character::SlotIterator it = character.begin(); it != character.end(); ++it)
+            if (it->mPath == path)
+                return &*it;
+        return NULL;
+    }
+}
+
 void MWState::StateManager::cleanup (bool force)
 {
+    finishSave(true);
+
     if (mState!=State_NoGame || force)
     {
         MWBase::Environment::get().getSoundManager()->clear();
@@ -92,6 +109,13 @@ MWState::StateManager::StateManager (const boost::filesystem::path& saves, const
 
 }
 
+MWState::StateManager::~StateManager()
+{
+    // Don't lose a saved game that is still being written
+    if (mPendingSaveTicket)
+        mPendingSaveTicket->waitTillDone();
+}
+
 void MWState::StateManager::requestQuit()
 {
     mQuitRequest = true;
@@ -172,6 +196,20 @@ void MWState::StateManager::endGame()
 
 void MWState::StateManager::saveGame (const std::string& description, const Slot *slot)
 {
+    // Only one saved game is written at a time. Finishing the previous one may change the slot list,
+    // so look up the requested slot again afterwards.
+    if (mPendingSaveTicket)
+    {
+        boost::filesystem::path slotPath;
+        if (slot)
+            slotPath = slot->mPath;
+
+        finishSave(true);
+
+        if (slot)
+            slot = findSlot(*getCurrentCharacter(), slotPath);
+    }
+
     try
     {
         ESM::SavedGame profile;
@@ -200,31 +238,24 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
         profile.mTimePlayed = mTimePlayed;
         profile.mDescription = description;
 
-        writeScreenshot(profile.mScreenshot);
+        osg::ref_ptr<osg::Image> screenshot = takeScreenshot();
 
         if (!slot)
             slot = getCurrentCharacter()->createSlot (profile);
         else
             slot = getCurrentCharacter()->updateSlot (slot, profile);
 
-        boost::filesystem::ofstream stream (slot->mPath, std::ios::binary);
+        osg::ref_ptr<SaveGameData> data (new SaveGameData);
+        data->mPath = slot->mPath;
+        data->mProfile = profile;
+        data->mScreenshot = screenshot;
+        data->mCompress = Settings::Manager::getBool ("compress", "Saves");
 
-        ESM::ESMWriter writer;
+        // Only the game state is serialized here. The TES3 and saved game headers are written by
+        // the SaveGameWriter, together with the encoded screenshot.
+        std::ostringstream stream (std::ios::binary);
 
-        const std::vector<std::string>& current =
-            MWBase::Environment::get().getWorld()->getContentFiles();
-
-        for (std::vector<std::string>::const_iterator iter (current.begin()); iter!=current.end();
-            ++iter)
-            writer.addMaster (*iter, 0); // not using the size information anyway -> use value of 0
-
-        writer.setFormat (ESM::SavedGame::sCurrentFormat);
-
-        // all unused
-        writer.setVersion(0);
-        writer.setType(0);
-        writer.setAuthor("");
-        writer.setDescription("");
+        ESM::ESMWriter writer;
 
         int recordCount =         1 // saved game header
                 +MWBase::Environment::get().getJournal()->countSavedGameRecords()
@@ -233,9 +264,9 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
                 +MWBase::Environment::get().getDialogueManager()->countSavedGameRecords()
                 +MWBase::Environment::get().getWindowManager()->countSavedGameRecords()
                 +MWBase::Environment::get().getMechanicsManager()->countSavedGameRecords();
-        writer.setRecordCount (recordCount);
+        data->mRecordCount = recordCount;
 
-        writer.save (stream);
+        writer.saveRecords (stream);
 
         Loading::Listener& listener = *MWBase::Environment::get().getWindowManager()->getLoadingScreen();
         // Using only Cells for progress information, since they typically have the largest records by far
@@ -244,10 +275,6 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
 
         Loading::ScopedLoad load(&listener);
 
-        writer.startRecord (ESM::REC_SAVE);
-        slot->mProfile.save (writer);
-        writer.endRecord (ESM::REC_SAVE);
-
         MWBase::Environment::get().getJournal()->write (writer, listener);
         MWBase::Environment::get().getDialogueManager()->write (writer, listener);
         MWBase::Environment::get().getWorld()->write (writer, listener);
@@ -256,16 +283,21 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
         MWBase::Environment::get().getMechanicsManager()->write(writer, listener);
 
         // Ensure we have written the number of records that was estimated
-        if (writer.getRecordCount() != recordCount+1) // 1 extra for TES3 record
-            std::cerr << "Warning: number of written savegame records does not match. Estimated: " << recordCount+1 << ", written: " << writer.getRecordCount() << std::endl;
+        if (writer.getRecordCount() != recordCount-1) // saved game header is written later
+            std::cerr << "Warning: number of written savegame records does not match. Estimated: " << recordCount-1 << ", written: " << writer.getRecordCount() << std::endl;
 
         writer.close();
 
         if (stream.fail())
             throw std::runtime_error("Write operation failed");
 
-        Settings::Manager::setString ("character", "Saves",
-            slot->mPath.parent_path().filename().string());
+        data->mRecords = stream.str();
+
+        if (!mSaveQueue.get())
+            mSaveQueue.reset(new SceneUtil::WorkQueue(1));
+
+        mPendingSave = data;
+        mPendingSaveTicket = mSaveQueue->addWorkItem(new SaveGameWriter(data.get()));
     }
     catch (const std::exception& e)
     {
@@ -284,6 +316,48 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
     }
 }
 
+void MWState::StateManager::finishSave (bool wait)
+{
+    if (!mPendingSaveTicket)
+        return;
+
+    if (wait)
+        mPendingSaveTicket->waitTillDone();
+    else if (!mPendingSaveTicket->isDone())
+        return;
+
+    osg::ref_ptr<SaveGameData> data = mPendingSave;
+    mPendingSave = NULL;
+    mPendingSaveTicket = NULL;
+
+    // Look the character up by its directory rather than keeping a pointer, as it may have been
+    // deleted while the saved game was written
+    Character* character = mCharacterManager.findCharacter(data->mPath.parent_path());
+    const Slot* slot = character ? findSlot(*character, data->mPath) : NULL;
+
+    if (data->mError.empty())
+    {
+        // The slot's screenshot is left empty, the save dialog loads it from the file when needed
+        Settings::Manager::setString ("character", "Saves",
+            data->mPath.parent_path().filename().string());
+    }
+    else
+    {
+        std::stringstream error;
+        error << "Failed to save game: " << data->mError;
+
+        std::cerr << error.str() << std::endl;
+
+        std::vector<std::string> buttons;
+        buttons.push_back("#{sOk}");
+        MWBase::Environment::get().getWindowManager()->interactiveMessageBox(error.str(), buttons);
+
+        // If no file was written, clean up the slot
+        if (slot && !boost::filesystem::exists(slot->mPath))
+            character->deleteSlot(slot);
+    }
+}
+
 void MWState::StateManager::quickSave (std::string name)
 {
     if (!(mState==State_Running &&
@@ -295,6 +369,8 @@ void MWState::StateManager::quickSave (std::string name)
         return;
     }
 
+    finishSave(true);
+
     const Slot* slot = NULL;
     Character* mCurrentCharacter = getCurrentCharacter(true); //Get current character
 
@@ -310,6 +386,8 @@ void MWState::StateManager::quickSave (std::string name)
 
 void MWState::StateManager::loadGame(const std::string& filepath)
 {
+    finishSave(true);
+
     for (CharacterIterator it = mCharacterManager.begin(); it != mCharacterManager.end(); ++it)
     {
         const MWState::Character& character = *it;
@@ -362,7 +440,6 @@ void MWState::StateManager::loadGame (const Character *character, const std::str
 
         bool firstPersonCam = false;
 
-        size_t total = reader.getFileSize();
         int currentPercent = 0;
         while (reader.hasMoreRecs())
         {
@@ -371,6 +448,12 @@ void MWState::StateManager::loadGame (const Character *character, const std::str
 
             switch (n.val)
             {
+                case ESM::REC_CMPR:
+
+                    // the rest of the file is compressed
+                    reader.decompressRecord();
+                    break;
+
                 case ESM::REC_SAVE:
                     {
                         ESM::SavedGame profile;
@@ -449,7 +532,7 @@ void MWState::StateManager::loadGame (const Character *character, const std::str
                     std::cerr << "Ignoring unknown record: " << n.toString() << std::endl;
                     reader.skipRecord();
             }
-            int progressPercent = static_cast<int>(float(reader.getFileOffset())/total*100);
+            int progressPercent = static_cast<int>(float(reader.getFileOffset())/reader.getFileSize()*100);
             if (progressPercent > currentPercent)
             {
                 listener.increaseProgress(progressPercent-currentPercent);
@@ -515,6 +598,18 @@ void MWState::StateManager::quickLoad()
 
 void MWState::StateManager::deleteGame(const MWState::Character *character, const MWState::Slot *slot)
 {
+    // Let the saved game being written settle first, so the slot doesn't reappear
+    if (mPendingSaveTicket)
+    {
+        boost::filesystem::path slotPath = slot->mPath;
+
+        finishSave(true);
+
+        slot = findSlot(*character, slotPath);
+        if (!slot)
+            return;
+    }
+
     mCharacterManager.deleteSlot(character, slot);
 }
 
@@ -540,6 +635,8 @@ void MWState::StateManager::update (float duration)
 {
     mTimePlayed += duration;
 
+    finishSave(false);
+
     // Note: It would be nicer to trigger this from InputManager, i.e. the very beginning of the frame update.
     if (mAskLoadRecent)
     {
@@ -588,7 +685,7 @@ bool MWState::StateManager::verifyProfile(const ESM::SavedGame& profile) const
     return true;
 }
 
-void MWState::StateManager::writeScreenshot(std::vector<char> &imageData) const
+osg::ref_ptr<osg::Image> MWState::StateManager::takeScreenshot() const
 {
     int screenshotW = 259*2, screenshotH = 133*2; // *2 to get some nice antialiasing
 
@@ -596,22 +693,5 @@ void MWState::StateManager::writeScreenshot(std::vector<char> &imageData) const
 
     MWBase::Environment::get().getWorld()->screenshot(screenshot.get(), screenshotW, screenshotH);
 
-    osgDB::ReaderWriter* readerwriter = osgDB::Registry::instance()->getReaderWriterForExtension("jpg");
-    if (!readerwriter)
-    {
-        std::cerr << "Unable to write screenshot, can't find a jpg ReaderWriter" << std::endl;
-        return;
-    }
-
-    std::ostringstream ostream;
-    osgDB::ReaderWriter::WriteResult result = readerwriter->writeImage(*screenshot, ostream);
-    if (!result.success())
-    {
-        std::cerr << "Unable to write screenshot: " << result.message() << std::endl;
-        return;
-    }
-
-    std::string data = ostream.str();
-    imageData = std::vector<char>(data.begin(), data.end());
-
+    return screenshot;
 }
@@ -2,15 +2,31 @@
 #define GAME_STATE_STATEMANAGER_H
 
 #include <map>
+#include <memory>
 
 #include "../mwbase/statemanager.hpp"
 
 #include <boost/filesystem/path.hpp>
 
+#include <osg/ref_ptr>
+
 #include "charactermanager.hpp"
 
+namespace osg
+{
+    class Image;
+}
+
+namespace SceneUtil
+{
+    class WorkQueue;
+    class WorkTicket;
+}
+
 namespace MWState
 {
+    struct SaveGameData;
+
     class StateManager : public MWBase::StateManager
     {
             bool mQuitRequest;
@@ -19,13 +35,23 @@ namespace MWState
             CharacterManager mCharacterManager;
             double mTimePlayed;
 
+            std::auto_ptr<SceneUtil::WorkQueue> mSaveQueue;
+            osg::ref_ptr<SaveGameData> mPendingSave;
+            osg::ref_ptr<SceneUtil::WorkTicket> mPendingSaveTicket;
+
         private:
 
             void cleanup (bool force = false);
 
             bool verifyProfile (const ESM::SavedGame& profile) const;
 
-            void writeScreenshot (std::vector<char>& imageData) const;
+            osg::ref_ptr<osg::Image> takeScreenshot() const;
+
+            void finishSave (bool wait);
+            ///< Handle the outcome of the saved game being written in the background, if any.
+            ///
+            /// \param wait Block until the saved game is written. Otherwise, only handle it if it
+            /// is already done.
 
             std::map<int, int> buildContentFileIndexMap (const ESM::ESMReader& reader) const;
 
@@ -33,6 +59,8 @@ namespace MWState
 
             StateManager (const boost::filesystem::path& saves, const std::string& game);
 
+            virtual ~StateManager();
+
             virtual void requestQuit();
 
             virtual bool hasQuitRequest() const;
@@ -55,6 +83,7 @@ namespace MWState
             ///< Write a saved game to \a slot or create a new slot if \a slot == 0.
             ///
             /// \note Slot must belong to the current character.
+            /// \note The game state is serialized right away, but written to disk in the background.
 
             ///Saves a file, using supplied filename, overwritting if needed
             /** This is mostly used for quicksaving and autosaving, for they use the same name over and over again
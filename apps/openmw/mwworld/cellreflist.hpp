@@ -1,18 +1,20 @@
 #ifndef GAME_MWWORLD_CELLREFLIST_H
 #define GAME_MWWORLD_CELLREFLIST_H
 
-#include <list>
-
 #include "livecellref.hpp"
+#include "chunkedlist.hpp"
 
 namespace MWWorld
 {
     /// \brief Collection of references of one type
+    ///
+    /// References are never moved or erased once inserted, so pointers to them (e.g. in a Ptr) stay valid for as long
+    /// as the cell is loaded.
     template <typename X>
     struct CellRefList
     {
         typedef LiveCellRef<X> LiveRef;
-        typedef std::list<LiveRef> List;
+        typedef ChunkedList<LiveRef> List;
         List mList;
 
         /// Search for the given reference in the given reclist from
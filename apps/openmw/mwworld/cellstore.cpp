@@ -24,6 +24,7 @@
 #include "esmstore.hpp"
 #include "class.hpp"
 #include "containerstore.hpp"
+#include "refhash.hpp"
 
 namespace
 {
@@ -153,7 +154,7 @@ namespace MWWorld
 
         if (const X *ptr = store.search (ref.mRefID))
         {
-            typename std::list<LiveRef>::iterator iter =
+            typename List::iterator iter =
                 std::find(mList.begin(), mList.end(), ref.mRefNum);
 
             LiveRef liveCellRef (ref, ptr);
@@ -305,6 +306,28 @@ namespace MWWorld
         mHasState = true;
     }
 
+    size_t CellStore::getObjectStateHash() const
+    {
+        size_t seed = 0;
+        hashRefs(seed, mActivators);
+        hashRefs(seed, mPotions);
+        hashRefs(seed, mAppas);
+        hashRefs(seed, mArmors);
+        hashRefs(seed, mBooks);
+        hashRefs(seed, mClothes);
+        hashRefs(seed, mContainers);
+        hashRefs(seed, mDoors);
+        hashRefs(seed, mIngreds);
+        hashRefs(seed, mLights);
+        hashRefs(seed, mLockpicks);
+        hashRefs(seed, mMiscItems);
+        hashRefs(seed, mProbes);
+        hashRefs(seed, mRepairs);
+        hashRefs(seed, mStatics);
+        hashRefs(seed, mWeapons);
+        return seed;
+    }
+
     int CellStore::count() const
     {
         return
@@ -343,7 +366,7 @@ namespace MWWorld
 
             // TODO: the pathgrid graph only needs to be loaded for active cells, so move this somewhere else.
             // In a simple test, loading the graph for all cells in MW + expansions took 200 ms
-            mPathgridGraph.load(this);
+            mPathgridGraph.load(mCell, store.get<ESM::Pathgrid>().search(*mCell));
         }
     }
 
@@ -715,6 +738,11 @@ namespace MWWorld
         return mPathgridGraph.aStarSearch(start, end);
     }
 
+    const MWMechanics::PathgridGraph& CellStore::getPathgridGraph() const
+    {
+        return mPathgridGraph;
+    }
+
     void CellStore::setFog(ESM::FogState *fog)
     {
         mFogState.reset(fog);
@@ -128,6 +128,10 @@ namespace MWWorld
             int count() const;
             ///< Return total number of references, including deleted ones.
 
+            size_t getObjectStateHash() const;
+            ///< Return a hash of the references that are not actors, including their positions, counts
+            /// and whether they are enabled or deleted. Only meaningful within a session.
+
             void load (const MWWorld::ESMStore &store, std::vector<ESM::ESMReader> &esm);
             ///< Load references from content file.
 
@@ -212,6 +216,8 @@ namespace MWWorld
 
             std::list<ESM::Pathgrid::Point> aStarSearch(const int start, const int end) const;
 
+            const MWMechanics::PathgridGraph& getPathgridGraph() const;
+
         private:
 
             template<class Functor, class List>
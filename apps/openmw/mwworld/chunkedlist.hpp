@@ -0,0 +1,344 @@
+#ifndef GAME_MWWORLD_CHUNKEDLIST_H
+#define GAME_MWWORLD_CHUNKEDLIST_H
+
+#include <cstddef>
+#include <iterator>
+#include <new>
+
+namespace MWWorld
+{
+    /// \brief Append-only sequence that stores its elements in chunks of contiguous memory
+    ///
+    /// Elements are never moved once inserted, so pointers, references and iterators to them (including end())
+    /// stay valid until the list is cleared or destroyed, like with std::list. Unlike std::list, inserting does not
+    /// allocate once per element, and neighbouring elements are next to each other in memory.
+    ///
+    /// Elements can not be erased individually. References are removed from a cell by setting their count to 0.
+    template <typename T>
+    class ChunkedList
+    {
+            struct Chunk
+            {
+                Chunk *mPrev;
+                Chunk *mNext;
+                size_t mSize;
+                size_t mCapacity;
+                T *mElements;
+            };
+
+            enum
+            {
+                MinChunkCapacity = 4,
+                MaxChunkCapacity = 128
+            };
+
+            // Circular list of chunks. The sentinel is empty and marks end(), so that end() is stable as well.
+            Chunk mSentinel;
+            size_t mSize;
+            size_t mCapacity;
+
+            /// Capacity of the next chunk allocated, if greater than the one chosen by the growth policy
+            size_t mReserved;
+
+        public:
+
+            template <typename Value>
+            class Iterator
+            {
+                    Chunk *mChunk;
+                    size_t mIndex;
+
+                    template <typename Other> friend class Iterator;
+                    friend class ChunkedList;
+
+                    Iterator (Chunk *chunk, size_t index) : mChunk (chunk), mIndex (index) {}
+
+                public:
+
+                    typedef std::bidirectional_iterator_tag iterator_category;
+                    typedef T value_type;
+                    typedef std::ptrdiff_t difference_type;
+                    typedef Value *pointer;
+                    typedef Value& reference;
+
+                    Iterator() : mChunk (0), mIndex (0) {}
+
+                    /// Also converts an iterator into a const_iterator.
+                    Iterator (const Iterator<T>& iter) : mChunk (iter.mChunk), mIndex (iter.mIndex) {}
+
+                    Value& operator* () const
+                    {
+                        return mChunk->mElements[mIndex];
+                    }
+
+                    Value *operator-> () const
+                    {
+                        return mChunk->mElements + mIndex;
+                    }
+
+                    Iterator& operator++ ()
+                    {
+                        if (++mIndex==mChunk->mSize)
+                        {
+                            mChunk = mChunk->mNext;
+                            mIndex = 0;
+                        }
+                        return *this;
+                    }
+
+                    Iterator operator++ (int)
+                    {
+                        Iterator iter (*this);
+                        ++*this;
+                        return iter;
+                    }
+
+                    Iterator& operator-- ()
+                    {
+                        if (mIndex==0)
+                        {
+                            mChunk = mChunk->mPrev;
+                            mIndex = mChunk->mSize;
+                        }
+                        --mIndex;
+                        return *this;
+                    }
+
+                    Iterator operator-- (int)
+                    {
+                        Iterator iter (*this);
+                        --*this;
+                        return iter;
+                    }
+
+                    template <typename Other>
+                    bool operator== (const Iterator<Other>& iter) const
+                    {
+                        return mChunk==iter.mChunk && mIndex==iter.mIndex;
+                    }
+
+                    template <typename Other>
+                    bool operator!= (const Iterator<Other>& iter) const
+                    {
+                        return !(*this==iter);
+                    }
+            };
+
+            typedef T value_type;
+            typedef T& reference;
+            typedef const T& const_reference;
+            typedef size_t size_type;
+            typedef Iterator<T> iterator;
+            typedef Iterator<const T> const_iterator;
+
+            ChunkedList() : mSize (0), mCapacity (0), mReserved (0)
+            {
+                init();
+            }
+
+            ChunkedList (const ChunkedList& list) : mSize (0), mCapacity (0), mReserved (0)
+            {
+                init();
+
+                // The destructor is not run if the constructor throws
+                try
+                {
+                    append (list);
+                }
+                catch (...)
+                {
+                    clear();
+                    throw;
+                }
+            }
+
+            ~ChunkedList()
+            {
+                clear();
+            }
+
+            ChunkedList& operator= (const ChunkedList& list)
+            {
+                if (this!=&list)
+                {
+                    clear();
+                    append (list);
+                }
+                return *this;
+            }
+
+            iterator begin()
+            {
+                return iterator (mSentinel.mNext, 0);
+            }
+
+            const_iterator begin() const
+            {
+                return const_iterator (mSentinel.mNext, 0);
+            }
+
+            iterator end()
+            {
+                return iterator (&mSentinel, 0);
+            }
+
+            const_iterator end() const
+            {
+                return const_iterator (const_cast<Chunk *> (&mSentinel), 0);
+            }
+
+            size_t size() const
+            {
+                return mSize;
+            }
+
+            bool empty() const
+            {
+                return mSize==0;
+            }
+
+            /// Number of elements that can be stored without allocating.
+            size_t capacity() const
+            {
+                return mCapacity;
+            }
+
+            /// Make sure that the list can hold \a count elements in total. Memory is only allocated by the next
+            /// insertion that does not fit, as one chunk.
+            void reserve (size_t count)
+            {
+                if (count>mCapacity && count-mCapacity>mReserved)
+                    mReserved = count - mCapacity;
+            }
+
+            T& front()
+            {
+                return mSentinel.mNext->mElements[0];
+            }
+
+            const T& front() const
+            {
+                return mSentinel.mNext->mElements[0];
+            }
+
+            T& back()
+            {
+                return mSentinel.mPrev->mElements[mSentinel.mPrev->mSize-1];
+            }
+
+            const T& back() const
+            {
+                return mSentinel.mPrev->mElements[mSentinel.mPrev->mSize-1];
+            }
+
+            void push_back (const T& value)
+            {
+                Chunk *chunk = mSentinel.mPrev;
+
+                if (chunk->mSize<chunk->mCapacity)
+                {
+                    new (chunk->mElements + chunk->mSize) T (value);
+                    ++chunk->mSize;
+                }
+                else
+                {
+                    // Link the new chunk only once it holds an element, so that no chunk is ever empty
+                    chunk = allocateChunk();
+
+                    try
+                    {
+                        new (chunk->mElements) T (value);
+                    }
+                    catch (...)
+                    {
+                        deallocateChunk (chunk);
+                        throw;
+                    }
+
+                    chunk->mSize = 1;
+                    chunk->mPrev = mSentinel.mPrev;
+                    chunk->mNext = &mSentinel;
+                    mSentinel.mPrev->mNext = chunk;
+                    mSentinel.mPrev = chunk;
+                    mCapacity += chunk->mCapacity;
+                }
+
+                ++mSize;
+            }
+
+            void clear()
+            {
+                Chunk *chunk = mSentinel.mNext;
+                while (chunk!=&mSentinel)
+                {
+                    Chunk *next = chunk->mNext;
+
+                    for (size_t i=0; i<chunk->mSize; ++i)
+                        chunk->mElements[i].~T();
+                    deallocateChunk (chunk);
+
+                    chunk = next;
+                }
+
+                init();
+                mSize = 0;
+                mCapacity = 0;
+                mReserved = 0;
+            }
+
+        private:
+
+            void init()
+            {
+                mSentinel.mPrev = &mSentinel;
+                mSentinel.mNext = &mSentinel;
+                mSentinel.mSize = 0;
+                mSentinel.mCapacity = 0;
+                mSentinel.mElements = 0;
+            }
+
+            void append (const ChunkedList& list)
+            {
+                reserve (mSize + list.size());
+                for (const_iterator iter (list.begin()); iter!=list.end(); ++iter)
+                    push_back (*iter);
+            }
+
+            Chunk *allocateChunk()
+            {
+                // Grow geometrically, so that a list of n elements only takes O(log n) allocations, up to a limit to
+                // not waste memory on the last chunk of large lists
+                size_t capacity = mSize;
+                if (capacity<MinChunkCapacity)
+                    capacity = MinChunkCapacity;
+                else if (capacity>MaxChunkCapacity)
+                    capacity = MaxChunkCapacity;
+
+                if (mReserved>capacity)
+                    capacity = mReserved;
+                mReserved = 0;
+
+                Chunk *chunk = new Chunk;
+                try
+                {
+                    chunk->mElements = static_cast<T *> (::operator new (capacity * sizeof (T)));
+                }
+                catch (...)
+                {
+                    delete chunk;
+                    throw;
+                }
+                chunk->mSize = 0;
+                chunk->mCapacity = capacity;
+                return chunk;
+            }
+
+            static void deallocateChunk (Chunk *chunk)
+            {
+                ::operator delete (chunk->mElements);
+                delete chunk;
+            }
+    };
+}
+
+#endif
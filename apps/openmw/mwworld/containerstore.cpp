@@ -1,6 +1,7 @@
 
 #include "containerstore.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <typeinfo>
 #include <stdexcept>
@@ -22,20 +23,16 @@
 namespace
 {
     template<typename T>
-    float getTotalWeight (const MWWorld::CellRefList<T>& cellRefList)
+    void addTotals (const MWWorld::CellRefList<T>& cellRefList, int typeIndex, MWWorld::ContainerTotals& totals)
     {
-        float sum = 0;
-
         for (typename MWWorld::CellRefList<T>::List::const_iterator iter (
             cellRefList.mList.begin());
             iter!=cellRefList.mList.end();
             ++iter)
         {
             if (iter->mData.getCount()>0)
-                sum += iter->mData.getCount()*iter->mBase->mData.mWeight;
+                totals.countChanged (typeIndex, iter->mBase->mData.mWeight, 0, iter->mData.getCount());
         }
-
-        return sum;
     }
 
     template<typename T>
@@ -113,7 +110,7 @@ void MWWorld::ContainerStore::storeStates (CellRefList<T>& collection,
 
 const std::string MWWorld::ContainerStore::sGoldId = "gold_001";
 
-MWWorld::ContainerStore::ContainerStore() : mCachedWeight (0), mWeightUpToDate (false) {}
+MWWorld::ContainerStore::ContainerStore() {}
 
 MWWorld::ContainerStore::~ContainerStore() {}
 
@@ -163,8 +160,12 @@ MWWorld::ContainerStoreIterator MWWorld::ContainerStore::restack(const MWWorld::
     {
         if (stacks(*iter, item))
         {
-            iter->getRefData().setCount(iter->getRefData().getCount() + item.getRefData().getCount());
+            int oldCount = iter->getRefData().getCount();
+            int itemCount = item.getRefData().getCount();
+            iter->getRefData().setCount(oldCount + itemCount);
+            itemCountChanged(*iter, oldCount, oldCount + itemCount);
             item.getRefData().setCount(0);
+            itemCountChanged(item, itemCount, 0);
             retval = iter;
             break;
         }
@@ -306,8 +307,10 @@ MWWorld::ContainerStoreIterator MWWorld::ContainerStore::addImp (const Ptr& ptr,
         {
             if (Misc::StringUtils::ciEqual((*iter).getCellRef().getRefId(), MWWorld::ContainerStore::sGoldId))
             {
-                iter->getRefData().setCount(iter->getRefData().getCount() + realCount);
-                flagAsModified();
+                int oldCount = iter->getRefData().getCount();
+                iter->getRefData().setCount(oldCount + realCount);
+                itemCountChanged(*iter, oldCount, oldCount + realCount);
+                contentsChanged();
                 return iter;
             }
         }
@@ -322,9 +325,11 @@ MWWorld::ContainerStoreIterator MWWorld::ContainerStore::addImp (const Ptr& ptr,
         if (stacks(*iter, ptr))
         {
             // stack
-            iter->getRefData().setCount( iter->getRefData().getCount() + count );
+            int oldCount = iter->getRefData().getCount();
+            iter->getRefData().setCount( oldCount + count );
+            itemCountChanged(*iter, oldCount, oldCount + count);
 
-            flagAsModified();
+            contentsChanged();
             return iter;
         }
     }
@@ -353,8 +358,9 @@ MWWorld::ContainerStoreIterator MWWorld::ContainerStore::addNewStack (const Ptr&
     }
 
     it->getRefData().setCount(count);
+    itemCountChanged(*it, 0, count);
 
-    flagAsModified();
+    contentsChanged();
     return it;
 }
 
@@ -366,7 +372,7 @@ int MWWorld::ContainerStore::remove(const std::string& itemId, int count, const
         if (Misc::StringUtils::ciEqual(iter->getCellRef().getRefId(), itemId))
             toRemove -= remove(*iter, toRemove, actor);
 
-    flagAsModified();
+    contentsChanged();
 
     // number of removed items
     return count - toRemove;
@@ -378,6 +384,7 @@ int MWWorld::ContainerStore::remove(const Ptr& item, int count, const Ptr& actor
 
     int toRemove = count;
     RefData& itemRef = item.getRefData();
+    int oldCount = itemRef.getCount();
 
     if (itemRef.getCount() <= toRemove)
     {
@@ -390,7 +397,9 @@ int MWWorld::ContainerStore::remove(const Ptr& item, int count, const Ptr& actor
         toRemove = 0;
     }
 
-    flagAsModified();
+    itemCountChanged(item, oldCount, itemRef.getCount());
+
+    contentsChanged();
 
     // number of removed items
     return count - toRemove;
@@ -405,7 +414,7 @@ void MWWorld::ContainerStore::fill (const ESM::InventoryList& items, const std::
         addInitialItem(id, owner, iter->mCount);
     }
 
-    flagAsModified();
+    contentsChanged();
 }
 
 void MWWorld::ContainerStore::addInitialItem (const std::string& id, const std::string& owner,
@@ -476,7 +485,7 @@ void MWWorld::ContainerStore::restock (const ESM::InventoryList& items, const MW
                 addInitialItem(item, owner, std::abs(it->mCount) - currentCount, true);
         }
     }
-    flagAsModified();
+    contentsChanged();
 }
 
 void MWWorld::ContainerStore::clear()
@@ -484,37 +493,79 @@ void MWWorld::ContainerStore::clear()
     for (ContainerStoreIterator iter (begin()); iter!=end(); ++iter)
         iter->getRefData().setCount (0);
 
-    flagAsModified();
+    mTotals.reset();
+
+    contentsChanged();
 }
 
+void MWWorld::ContainerStore::contentsChanged() {}
+
 void MWWorld::ContainerStore::flagAsModified()
 {
-    mWeightUpToDate = false;
+    mTotals.invalidate();
+    contentsChanged();
+}
+
+void MWWorld::ContainerStore::itemCountChanged (const Ptr& item, int oldCount, int newCount)
+{
+    if (!mTotals.isUpToDate())
+        return;
+
+    mTotals.countChanged(getTypeIndex(getType(item)), item.getClass().getWeight(item), oldCount, newCount);
+}
+
+void MWWorld::ContainerStore::setItemCount (const Ptr& item, int count)
+{
+    int oldCount = item.getRefData().getCount();
+    item.getRefData().setCount(count);
+    itemCountChanged(item, oldCount, count);
+
+    contentsChanged();
+}
+
+void MWWorld::ContainerStore::updateTotals() const
+{
+    mTotals.reset();
+
+    addTotals (potions, getTypeIndex(Type_Potion), mTotals);
+    addTotals (appas, getTypeIndex(Type_Apparatus), mTotals);
+    addTotals (armors, getTypeIndex(Type_Armor), mTotals);
+    addTotals (books, getTypeIndex(Type_Book), mTotals);
+    addTotals (clothes, getTypeIndex(Type_Clothing), mTotals);
+    addTotals (ingreds, getTypeIndex(Type_Ingredient), mTotals);
+    addTotals (lights, getTypeIndex(Type_Light), mTotals);
+    addTotals (lockpicks, getTypeIndex(Type_Lockpick), mTotals);
+    addTotals (miscItems, getTypeIndex(Type_Miscellaneous), mTotals);
+    addTotals (probes, getTypeIndex(Type_Probe), mTotals);
+    addTotals (repairs, getTypeIndex(Type_Repair), mTotals);
+    addTotals (weapons, getTypeIndex(Type_Weapon), mTotals);
 }
 
 float MWWorld::ContainerStore::getWeight() const
 {
-    if (!mWeightUpToDate)
+    if (!mTotals.isUpToDate())
+        updateTotals();
+
+    return mTotals.getWeight();
+}
+
+int MWWorld::ContainerStore::getTypesInUse() const
+{
+    if (!mTotals.isUpToDate())
+        updateTotals();
+
+    return mTotals.getTypesInUse();
+}
+
+int MWWorld::ContainerStore::getTypeIndex (int type)
+{
+    int index = 0;
+    while (type > 1)
     {
-        mCachedWeight = 0;
-
-        mCachedWeight += getTotalWeight (potions);
-        mCachedWeight += getTotalWeight (appas);
-        mCachedWeight += getTotalWeight (armors);
-        mCachedWeight += getTotalWeight (books);
-        mCachedWeight += getTotalWeight (clothes);
-        mCachedWeight += getTotalWeight (ingreds);
-        mCachedWeight += getTotalWeight (lights);
-        mCachedWeight += getTotalWeight (lockpicks);
-        mCachedWeight += getTotalWeight (miscItems);
-        mCachedWeight += getTotalWeight (probes);
-        mCachedWeight += getTotalWeight (repairs);
-        mCachedWeight += getTotalWeight (weapons);
-
-        mWeightUpToDate = true;
+        type >>= 1;
+        ++index;
     }
-
-    return mCachedWeight;
+    return index;
 }
 
 int MWWorld::ContainerStore::getType (const Ptr& ptr)
@@ -699,6 +750,9 @@ void MWWorld::ContainerStore::readState (const ESM::InventoryState& inventory)
 
 
     mLevelledItemMap = inventory.mLevelledItemMap;
+
+    // items were inserted directly into the lists above
+    flagAsModified();
 }
 
 
@@ -762,11 +816,20 @@ void MWWorld::ContainerStoreIterator::incType()
 
 void MWWorld::ContainerStoreIterator::nextType()
 {
+    // skip types without any items without looking at their lists
+    int types = mMask & mContainer->getTypesInUse();
+
     while (mType!=-1)
     {
+        if ((mType==0 ? types : types & ~((mType << 1) - 1)) == 0)
+        {
+            mType = -1;
+            break;
+        }
+
         incType();
 
-        if ((mType & mMask) && mType>0)
+        if ((mType & types) && mType>0)
             if (resetIterator())
                 break;
     }
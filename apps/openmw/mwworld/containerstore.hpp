@@ -19,6 +19,7 @@
 
 #include "ptr.hpp"
 #include "cellreflist.hpp"
+#include "containertotals.hpp"
 
 namespace ESM
 {
@@ -72,8 +73,14 @@ namespace MWWorld
             ///< Stores result of levelled item spawns. <refId, count>
             /// This is used to remove the spawned item(s) if the levelled item is restocked.
 
-            mutable float mCachedWeight;
-            mutable bool mWeightUpToDate;
+            // Totals of the contained items. These are updated incrementally whenever an item count is
+            // changed through this class, and only recalculated from scratch after flagAsModified.
+            mutable ContainerTotals mTotals;
+
+            void updateTotals() const;
+
+            static int getTypeIndex (int type);
+
             ContainerStoreIterator addImp (const Ptr& ptr, int count);
             void addInitialItem (const std::string& id, const std::string& owner, int count, bool topLevel=true, const std::string& levItem = "");
 
@@ -144,7 +151,15 @@ namespace MWWorld
             ContainerStoreIterator addNewStack (const Ptr& ptr, int count);
             ///< Add the item to this container (do not try to stack it onto existing items)
 
+            virtual void contentsChanged();
+            ///< Called after the contents of *this were changed through this class.
+
+            void itemCountChanged (const Ptr& item, int oldCount, int newCount);
+            ///< Update the weight and stack counters after the count of a contained item was changed.
+
             virtual void flagAsModified();
+            ///< Recalculate all cached state from scratch on the next query, e.g. after items were
+            /// inserted without going through addImp.
 
         public:
 
@@ -162,6 +177,13 @@ namespace MWWorld
             float getWeight() const;
             ///< Return total weight of the items contained in *this.
 
+            int getTypesInUse() const;
+            ///< Return a mask of the item types that have at least one non-empty stack in *this.
+
+            void setItemCount (const Ptr& item, int count);
+            ///< Set the count of \a item, which must be contained in *this. Use this instead of
+            /// RefData::setCount, which would leave the cached weight and stack counters out of date.
+
             static int getType (const Ptr& ptr);
             ///< This function throws an exception, if ptr does not point to an object, that can be
             /// put into a container.
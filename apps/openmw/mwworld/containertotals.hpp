@@ -0,0 +1,86 @@
+#ifndef GAME_MWWORLD_CONTAINERTOTALS_H
+#define GAME_MWWORLD_CONTAINERTOTALS_H
+
+#include <algorithm>
+
+namespace MWWorld
+{
+    /// @brief Total weight and number of non-empty stacks per item type of the items in a ContainerStore.
+    ///
+    /// The totals are updated incrementally whenever an item count changes. After invalidate() they are
+    /// stale until counted from scratch with reset() followed by countChanged() for every stack.
+    class ContainerTotals
+    {
+        public:
+
+            static const int sTypeCount = 12;
+
+            ContainerTotals()
+                : mWeight(0)
+                , mUpToDate(false)
+            {
+                std::fill(mStackCounts, mStackCounts + sTypeCount, 0);
+            }
+
+            bool isUpToDate() const
+            {
+                return mUpToDate;
+            }
+
+            void invalidate()
+            {
+                mUpToDate = false;
+            }
+
+            /// Start counting from an empty container.
+            void reset()
+            {
+                mWeight = 0;
+                std::fill(mStackCounts, mStackCounts + sTypeCount, 0);
+                mUpToDate = true;
+            }
+
+            /// Update the totals after the count of a stack changed. Does nothing while the totals are stale.
+            /// @param typeIndex Bit number of the item type
+            /// @param weight Weight of a single item of the stack
+            void countChanged(int typeIndex, float weight, int oldCount, int newCount)
+            {
+                if (!mUpToDate)
+                    return;
+
+                mWeight += (newCount - oldCount) * weight;
+
+                if (oldCount == 0 && newCount != 0)
+                    ++mStackCounts[typeIndex];
+                else if (oldCount != 0 && newCount == 0)
+                    --mStackCounts[typeIndex];
+
+                // avoid accumulating rounding errors once the container is empty again
+                if (newCount == 0 && mWeight < 0.001f && getTypesInUse() == 0)
+                    mWeight = 0;
+            }
+
+            float getWeight() const
+            {
+                return mWeight;
+            }
+
+            /// @return a mask with bit n set if there is a non-empty stack of the item type with bit number n
+            int getTypesInUse() const
+            {
+                int mask = 0;
+                for (int i=0; i<sTypeCount; ++i)
+                    if (mStackCounts[i] > 0)
+                        mask |= (1 << i);
+                return mask;
+            }
+
+        private:
+
+            float mWeight;
+            int mStackCounts[sTypeCount];
+            bool mUpToDate;
+    };
+}
+
+#endif
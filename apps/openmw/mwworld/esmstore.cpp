@@ -139,6 +139,8 @@ void ESMStore::setUp()
     mMagicEffects.setUp();
     mAttributes.setUp();
     mDialogs.setUp();
+
+    mGameSettingValues.setUp(mGameSettings);
 }
 
     int ESMStore::countSavedGameRecords() const
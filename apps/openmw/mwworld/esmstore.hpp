@@ -6,6 +6,7 @@
 
 #include <components/esm/records.hpp>
 #include "store.hpp"
+#include "gamesettings.hpp"
 
 namespace Loading
 {
@@ -51,6 +52,7 @@ namespace MWWorld
         Store<ESM::Weapon>          mWeapons;
 
         Store<ESM::GameSetting>     mGameSettings;
+        GameSettings                mGameSettingValues;
         Store<ESM::Script>          mScripts;
 
         // Lists that need special rules
@@ -86,6 +88,12 @@ namespace MWWorld
             return mStores.end();
         }
 
+        /// Values of the game settings listed in GameSettings, for use in per-frame code.
+        const GameSettings& getGameSettings() const
+        {
+            return mGameSettingValues;
+        }
+
         /// Look up the given ID in 'all'. Returns 0 if not found.
         /// \note id must be in lower case.
         int find(const std::string &id) const
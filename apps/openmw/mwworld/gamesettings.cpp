@@ -0,0 +1,90 @@
+#include "gamesettings.hpp"
+
+#include <stdexcept>
+#include <string>
+
+#include <components/esm/loadgmst.hpp>
+
+#include "store.hpp"
+
+namespace
+{
+#define OPENMW_GMST_NAME(name) #name,
+
+    const char *sFloatNames[] = { OPENMW_GMST_FLOATS(OPENMW_GMST_NAME) };
+    const char *sIntNames[] = { OPENMW_GMST_INTS(OPENMW_GMST_NAME) };
+
+#undef OPENMW_GMST_NAME
+}
+
+namespace MWWorld
+{
+    GameSettings::GameSettings()
+    {
+        for (int i=0; i<Float_Count; ++i)
+        {
+            mFloats[i] = 0;
+            mFloatsFound[i] = false;
+        }
+
+        for (int i=0; i<Int_Count; ++i)
+        {
+            mInts[i] = 0;
+            mIntsFound[i] = false;
+        }
+    }
+
+    void GameSettings::setUp (const Store<ESM::GameSetting>& store)
+    {
+        for (int i=0; i<Float_Count; ++i)
+        {
+            mFloatsFound[i] = false;
+
+            if (const ESM::GameSetting *setting = store.search (sFloatNames[i]))
+            {
+                try
+                {
+                    mFloats[i] = setting->getFloat();
+                    mFloatsFound[i] = true;
+                }
+                catch (const std::exception&)
+                {
+                    // reported when the setting is used, like a missing one
+                }
+            }
+        }
+
+        for (int i=0; i<Int_Count; ++i)
+        {
+            mIntsFound[i] = false;
+
+            if (const ESM::GameSetting *setting = store.search (sIntNames[i]))
+            {
+                try
+                {
+                    mInts[i] = setting->getInt();
+                    mIntsFound[i] = true;
+                }
+                catch (const std::exception&)
+                {
+                    // reported when the setting is used, like a missing one
+                }
+            }
+        }
+    }
+
+    const char *GameSettings::getName (Float setting)
+    {
+        return sFloatNames[setting];
+    }
+
+    const char *GameSettings::getName (Int setting)
+    {
+        return sIntNames[setting];
+    }
+
+    void GameSettings::throwMissing (const char *name)
+    {
+        throw std::runtime_error (std::string ("Game setting ") + name + " not found or not a number");
+    }
+}
@@ -0,0 +1,210 @@
+#ifndef GAME_MWWORLD_GAMESETTINGS_H
+#define GAME_MWWORLD_GAMESETTINGS_H
+
+namespace ESM
+{
+    struct GameSetting;
+}
+
+namespace MWWorld
+{
+    template <class T>
+    class Store;
+
+// Game settings read in per-frame code. To add one, insert it into the list of its type.
+#define OPENMW_GMST_FLOATS(GMST) \
+    GMST(fAlarmRadius) \
+    GMST(fAutoPCSpellChance) \
+    GMST(fBlockStillBonus) \
+    GMST(fBribe1000Mod) \
+    GMST(fBribe100Mod) \
+    GMST(fBribe10Mod) \
+    GMST(fCombatBlockLeftAngle) \
+    GMST(fCombatBlockRightAngle) \
+    GMST(fCombatDelayCreature) \
+    GMST(fCombatDelayNPC) \
+    GMST(fCombatInvisoMult) \
+    GMST(fCombatKODamageMult) \
+    GMST(fCrimeStealing) \
+    GMST(fDamageStrengthBase) \
+    GMST(fDamageStrengthMult) \
+    GMST(fDifficultyMult) \
+    GMST(fDispAttacking) \
+    GMST(fDispCrimeMod) \
+    GMST(fDispDiseaseMod) \
+    GMST(fDispFactionMod) \
+    GMST(fDispFactionRankBase) \
+    GMST(fDispFactionRankMult) \
+    GMST(fDispPersonalityBase) \
+    GMST(fDispPersonalityMult) \
+    GMST(fDispPickPocketMod) \
+    GMST(fDispRaceMod) \
+    GMST(fDispStealing) \
+    GMST(fDispWeaponDrawn) \
+    GMST(fElementalShieldMult) \
+    GMST(fEndFatigueMult) \
+    GMST(fFallAcroBase) \
+    GMST(fFallAcroMult) \
+    GMST(fFallDamageDistanceMin) \
+    GMST(fFallDistanceBase) \
+    GMST(fFallDistanceMult) \
+    GMST(fFatigueAttackBase) \
+    GMST(fFatigueAttackMult) \
+    GMST(fFatigueBase) \
+    GMST(fFatigueBlockBase) \
+    GMST(fFatigueBlockMult) \
+    GMST(fFatigueJumpBase) \
+    GMST(fFatigueJumpMult) \
+    GMST(fFatigueMult) \
+    GMST(fFatigueReturnBase) \
+    GMST(fFatigueReturnMult) \
+    GMST(fFatigueRunBase) \
+    GMST(fFatigueRunMult) \
+    GMST(fFatigueSneakBase) \
+    GMST(fFatigueSneakMult) \
+    GMST(fFatigueSwimRunBase) \
+    GMST(fFatigueSwimRunMult) \
+    GMST(fFatigueSwimWalkBase) \
+    GMST(fFatigueSwimWalkMult) \
+    GMST(fFightDispMult) \
+    GMST(fFightDistanceMultiplier) \
+    GMST(fFightStealing) \
+    GMST(fHandToHandReach) \
+    GMST(fHandtoHandHealthPer) \
+    GMST(fHoldBreathTime) \
+    GMST(fInteriorHeadTrackMult) \
+    GMST(fJumpMoveBase) \
+    GMST(fJumpMoveMult) \
+    GMST(fLevelMod) \
+    GMST(fLevelUpHealthEndMult) \
+    GMST(fLuckMod) \
+    GMST(fMajorSkillBonus) \
+    GMST(fMaxHandToHandMult) \
+    GMST(fMaxHeadTrackDistance) \
+    GMST(fMinHandToHandMult) \
+    GMST(fMinorSkillBonus) \
+    GMST(fMiscSkillBonus) \
+    GMST(fNPCbaseMagickaMult) \
+    GMST(fPCbaseMagickaMult) \
+    GMST(fPerDieRollMult) \
+    GMST(fPerTempMult) \
+    GMST(fPersonalityMod) \
+    GMST(fPickLockMult) \
+    GMST(fPickPocketMod) \
+    GMST(fProjectileMaxSpeed) \
+    GMST(fProjectileMinSpeed) \
+    GMST(fProjectileThrownStoreChance) \
+    GMST(fReputationMod) \
+    GMST(fRestMagicMult) \
+    GMST(fSneakBootMult) \
+    GMST(fSneakDistanceBase) \
+    GMST(fSneakDistanceMultiplier) \
+    GMST(fSneakNoViewMult) \
+    GMST(fSneakSkillMult) \
+    GMST(fSneakUseDelay) \
+    GMST(fSneakUseDist) \
+    GMST(fSneakViewMult) \
+    GMST(fSoulgemMult) \
+    GMST(fSpecialSkillBonus) \
+    GMST(fSuffocationDamage) \
+    GMST(fSwingBlockBase) \
+    GMST(fSwingBlockMult) \
+    GMST(fThrownWeaponMaxSpeed) \
+    GMST(fThrownWeaponMinSpeed) \
+    GMST(fTrapCostMult) \
+    GMST(fWeaponDamageMult) \
+    GMST(fWeaponFatigueBlockMult) \
+    GMST(fWeaponFatigueMult) \
+    GMST(fWereWolfSilverWeaponDamageMult)
+
+#define OPENMW_GMST_INTS(GMST) \
+    GMST(iAutoPCSpellMax) \
+    GMST(iBlockMaxChance) \
+    GMST(iBlockMinChance) \
+    GMST(iCrimeAttack) \
+    GMST(iCrimeKilling) \
+    GMST(iCrimePickPocket) \
+    GMST(iCrimeThreshold) \
+    GMST(iCrimeThresholdMultiplier) \
+    GMST(iCrimeTresspass) \
+    GMST(iDispAttackMod) \
+    GMST(iDispKilling) \
+    GMST(iDispTresspass) \
+    GMST(iFightAttack) \
+    GMST(iFightAttacking) \
+    GMST(iFightDistanceBase) \
+    GMST(iFightKilling) \
+    GMST(iFightPickpocket) \
+    GMST(iFightTrespass) \
+    GMST(iLevelUpMajorMult) \
+    GMST(iLevelUpMajorMultAttribute) \
+    GMST(iLevelUpMinorMult) \
+    GMST(iLevelUpMinorMultAttribute) \
+    GMST(iLevelUpTotal) \
+    GMST(iLevelupMiscMultAttriubte) \
+    GMST(iPerMinChance) \
+    GMST(iPerMinChange) \
+    GMST(iPickMaxChance) \
+    GMST(iPickMinChance) \
+    GMST(iVoiceAttackOdds)
+
+#define OPENMW_GMST_ENUM(name) name,
+
+    /// \brief Values of frequently used game settings, indexed by enum instead of looked up by name
+    ///
+    /// Filled from the store of GMST records by ESMStore::setUp, i.e. again whenever content
+    /// is loaded.
+    class GameSettings
+    {
+        public:
+
+            enum Float
+            {
+                OPENMW_GMST_FLOATS(OPENMW_GMST_ENUM)
+                Float_Count
+            };
+
+            enum Int
+            {
+                OPENMW_GMST_INTS(OPENMW_GMST_ENUM)
+                Int_Count
+            };
+
+            GameSettings();
+
+            void setUp (const Store<ESM::GameSetting>& store);
+
+            float get (Float setting) const
+            {
+                if (!mFloatsFound[setting])
+                    throwMissing (getName (setting));
+                return mFloats[setting];
+            }
+            ///< Throws an exception if the setting is missing.
+
+            int get (Int setting) const
+            {
+                if (!mIntsFound[setting])
+                    throwMissing (getName (setting));
+                return mInts[setting];
+            }
+            ///< Throws an exception if the setting is missing.
+
+            static const char *getName (Float setting);
+
+            static const char *getName (Int setting);
+
+        private:
+
+            static void throwMissing (const char *name);
+
+            float mFloats[Float_Count];
+            int mInts[Int_Count];
+            bool mFloatsFound[Float_Count];
+            bool mIntsFound[Int_Count];
+    };
+
+#undef OPENMW_GMST_ENUM
+}
+
+#endif
@@ -88,7 +88,9 @@ void MWWorld::InventoryStore::readEquipmentState(const MWWorld::ContainerStoreIt
         if (!allowedSlots.second && iter->getRefData().getCount() > 1)
         {
             MWWorld::ContainerStoreIterator newIter = addNewStack(*iter, 1);
-            iter->getRefData().setCount(iter->getRefData().getCount()-1);
+            int oldCount = iter->getRefData().getCount();
+            iter->getRefData().setCount(oldCount-1);
+            itemCountChanged(*iter, oldCount, oldCount-1);
             mSlots[slot] = newIter;
         }
         else
@@ -126,6 +128,7 @@ MWWorld::InventoryStore& MWWorld::InventoryStore::operator= (const InventoryStor
     mFirstAutoEquip = store.mFirstAutoEquip;
     mPermanentMagicEffectMagnitudes = store.mPermanentMagicEffectMagnitudes;
     mRechargingItemsUpToDate = false;
+    mEquipmentInfo.clear();
     ContainerStore::operator= (store);
     mSlots.clear();
     copySlots (store);
@@ -177,7 +180,7 @@ void MWWorld::InventoryStore::equip (int slot, const ContainerStoreIterator& ite
 
     mSlots[slot] = iterator;
 
-    flagAsModified();
+    contentsChanged();
 
     fireEquipmentChangedEvent(actor);
 
@@ -214,6 +217,21 @@ MWWorld::ContainerStoreIterator MWWorld::InventoryStore::getSlot (int slot)
     return mSlots[slot];
 }
 
+const MWWorld::InventoryStore::EquipmentInfo& MWWorld::InventoryStore::getEquipmentInfo (const Ptr& item)
+{
+    TEquipmentInfo::iterator found = mEquipmentInfo.find(item.getBase());
+    if (found != mEquipmentInfo.end())
+        return found->second;
+
+    EquipmentInfo& info = mEquipmentInfo[item.getBase()];
+    std::pair<std::vector<int>, bool> slots_ = item.getClass().getEquipmentSlots (item);
+    info.mSlots.swap(slots_.first);
+    info.mStacks = slots_.second;
+    info.mSkill = item.getClass().getEquipmentSkill (item);
+    info.mValue = item.getClass().getValue (item);
+    return info;
+}
+
 void MWWorld::InventoryStore::autoEquip (const MWWorld::Ptr& actor)
 {
     TSlots slots_;
@@ -222,16 +240,12 @@ void MWWorld::InventoryStore::autoEquip (const MWWorld::Ptr& actor)
     // Disable model update during auto-equip
     mUpdatesEnabled = false;
 
-    for (ContainerStoreIterator iter (begin()); iter!=end(); ++iter)
+    // Don't autoEquip lights. Handled in Actors::updateEquippedLight based on environment light.
+    // Other item types either have no equipment slots or only fit the right hand, which is skipped below.
+    for (ContainerStoreIterator iter (begin(Type_Armor | Type_Clothing | Type_Weapon)); iter!=end(); ++iter)
     {
         Ptr test = *iter;
 
-        // Don't autoEquip lights. Handled in Actors::updateEquippedLight based on environment light.
-        if (test.getTypeName() == typeid(ESM::Light).name())
-        {
-            continue;
-        }
-
         // Only autoEquip if we are the original owner of the item.
         // This stops merchants from auto equipping anything you sell to them.
         // ...unless this is a companion, he should always equip items given to him.
@@ -243,13 +257,11 @@ void MWWorld::InventoryStore::autoEquip (const MWWorld::Ptr& actor)
         {
             continue;
         }
-        int testSkill = test.getClass().getEquipmentSkill (test);
+        const EquipmentInfo& testInfo = getEquipmentInfo (test);
+        int testSkill = testInfo.mSkill;
 
-        std::pair<std::vector<int>, bool> itemsSlots =
-            iter->getClass().getEquipmentSlots (*iter);
-
-        for (std::vector<int>::const_iterator iter2 (itemsSlots.first.begin());
-            iter2!=itemsSlots.first.end(); ++iter2)
+        for (std::vector<int>::const_iterator iter2 (testInfo.mSlots.begin());
+            iter2!=testInfo.mSlots.end(); ++iter2)
         {
             if (*iter2 == Slot_CarriedRight) // Items in right hand are situational use, so don't equip them.
                 // Equipping weapons is handled by AiCombat. Anything else (lockpicks, probes) can't be used by NPCs anyway (yet)
@@ -258,9 +270,10 @@ void MWWorld::InventoryStore::autoEquip (const MWWorld::Ptr& actor)
             if (slots_.at (*iter2)!=end())
             {
                 Ptr old = *slots_.at (*iter2);
+                const EquipmentInfo& oldInfo = getEquipmentInfo (old);
 
                 // check skill
-                int oldSkill = old.getClass().getEquipmentSkill (old);
+                int oldSkill = oldInfo.mSkill;
 
                 bool use = false;
                 if (testSkill!=-1 && oldSkill==-1)
@@ -277,8 +290,7 @@ void MWWorld::InventoryStore::autoEquip (const MWWorld::Ptr& actor)
                 if (!use)
                 {
                     // check value
-                    if (old.getClass().getValue (old)>=
-                        test.getClass().getValue (test))
+                    if (oldInfo.mValue >= testInfo.mValue)
                     {
                         continue;
                     }
@@ -293,7 +305,7 @@ void MWWorld::InventoryStore::autoEquip (const MWWorld::Ptr& actor)
                     break;
             }
 
-            if (!itemsSlots.second) // if itemsSlots.second is true, item can stay stacked when equipped
+            if (!testInfo.mStacks) // if mStacks is true, item can stay stacked when equipped
             {
                 // unstack item pointed to by iterator if required
                 if (iter->getRefData().getCount() > 1)
@@ -324,7 +336,7 @@ void MWWorld::InventoryStore::autoEquip (const MWWorld::Ptr& actor)
         mSlots.swap (slots_);
         fireEquipmentChangedEvent(actor);
         updateMagicEffects(actor);
-        flagAsModified();
+        contentsChanged();
     }
 }
 
@@ -449,10 +461,16 @@ void MWWorld::InventoryStore::updateMagicEffects(const Ptr& actor)
     mFirstAutoEquip = false;
 }
 
+void MWWorld::InventoryStore::contentsChanged()
+{
+    ContainerStore::contentsChanged();
+    mRechargingItemsUpToDate = false;
+}
+
 void MWWorld::InventoryStore::flagAsModified()
 {
+    mEquipmentInfo.clear();
     ContainerStore::flagAsModified();
-    mRechargingItemsUpToDate = false;
 }
 
 bool MWWorld::InventoryStore::stacks(const Ptr& ptr1, const Ptr& ptr2)
@@ -493,6 +511,8 @@ int MWWorld::InventoryStore::remove(const Ptr& item, int count, const Ptr& actor
     bool wasEquipped = false;
     if (!item.getRefData().getCount())
     {
+        mEquipmentInfo.erase(item.getBase());
+
         for (int slot=0; slot < MWWorld::InventoryStore::Slots; ++slot)
         {
             if (mSlots[slot] == end())
@@ -737,6 +757,7 @@ void MWWorld::InventoryStore::clear()
 {
     mSlots.clear();
     initSlots (mSlots);
+    mEquipmentInfo.clear();
     ContainerStore::clear();
 }
 
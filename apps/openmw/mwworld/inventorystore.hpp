@@ -103,6 +103,25 @@ namespace MWWorld
 
             bool mRechargingItemsUpToDate;
 
+            // Properties of an item used to score it in autoEquip. These only depend on the item's
+            // base record, so they are cached per item until the item is removed.
+            struct EquipmentInfo
+            {
+                std::vector<int> mSlots;
+                bool mStacks; // can the item stay stacked when equipped?
+                int mSkill;
+                int mValue;
+            };
+
+            typedef std::map<const LiveCellRefBase*, EquipmentInfo> TEquipmentInfo;
+            TEquipmentInfo mEquipmentInfo;
+
+            const EquipmentInfo& getEquipmentInfo (const Ptr& item);
+
+            virtual void contentsChanged();
+
+            virtual void flagAsModified();
+
             void copySlots (const InventoryStore& store);
 
             void initSlots (TSlots& slots_);
@@ -163,10 +182,6 @@ namespace MWWorld
             const MWMechanics::MagicEffects& getMagicEffects() const;
             ///< Return magic effects from worn items.
 
-            virtual void flagAsModified();
-            ///< \attention This function is internal to the world model and should not be called from
-            /// outside.
-
             virtual bool stacks (const Ptr& ptr1, const Ptr& ptr2);
             ///< @return true if the two specified objects can stack with each other
 
@@ -207,6 +207,11 @@ namespace MWWorld
         return mPosition;
     }
 
+    const ESM::Position& RefData::getPosition() const
+    {
+        return mPosition;
+    }
+
     void RefData::setLocalRotation(const LocalRotation& rot)
     {
         mChanged = true;
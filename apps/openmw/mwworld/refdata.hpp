@@ -111,6 +111,7 @@ namespace MWWorld
 
             void setPosition (const ESM::Position& pos);
             const ESM::Position& getPosition();
+            const ESM::Position& getPosition() const;
 
             void setLocalRotation (const LocalRotation& rotation);
             const LocalRotation& getLocalRotation();
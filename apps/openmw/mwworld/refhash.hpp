@@ -0,0 +1,38 @@
+#ifndef GAME_MWWORLD_REFHASH_H
+#define GAME_MWWORLD_REFHASH_H
+
+#include <cstddef>
+
+#include <boost/functional/hash.hpp>
+
+#include <components/esm/defs.hpp>
+
+namespace MWWorld
+{
+    /// Combine the identity and the state of the references in \a list into \a seed: their base record,
+    /// RefNum, enabled and deleted flags, count and position.
+    /// @param List A CellRefList, or anything with an mList of objects shaped like LiveCellRef
+    template<typename List>
+    void hashRefs (std::size_t& seed, const List& list)
+    {
+        for (typename List::List::const_iterator iter (list.mList.begin());
+             iter!=list.mList.end(); ++iter)
+        {
+            boost::hash_combine(seed, static_cast<const void*>(iter->mBase));
+            boost::hash_combine(seed, iter->mRef.getRefNum().mIndex);
+            boost::hash_combine(seed, iter->mRef.getRefNum().mContentFile);
+            boost::hash_combine(seed, iter->mData.isEnabled());
+            boost::hash_combine(seed, iter->mData.isDeleted());
+            boost::hash_combine(seed, iter->mData.getCount());
+
+            const ESM::Position& pos = iter->mData.getPosition();
+            for (int i=0; i<3; ++i)
+            {
+                boost::hash_combine(seed, pos.pos[i]);
+                boost::hash_combine(seed, pos.rot[i]);
+            }
+        }
+    }
+}
+
+#endif
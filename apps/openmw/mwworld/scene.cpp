@@ -3,8 +3,11 @@
 #include <limits>
 #include <iostream>
 
+#include <osg/Timer>
+
 #include <components/loadinglistener/loadinglistener.hpp>
 #include <components/misc/resourcehelpers.hpp>
+#include <components/misc/profiler.hpp>
 #include <components/settings/settings.hpp>
 #include <components/resource/resourcesystem.hpp>
 
@@ -16,6 +19,8 @@
 
 #include "../mwrender/renderingmanager.hpp"
 
+#include "../mwmechanics/hierarchicalpathgrid.hpp"
+
 #include "../mwphysics/physicssystem.hpp"
 
 #include "player.hpp"
@@ -171,8 +176,8 @@ namespace MWWorld
     {
         if (mNeedMapUpdate)
         {
-            // Note: exterior cell maps must be updated, even if they were visited before, because the set of surrounding cells might be different
-            // (and objects in a different cell can "bleed" into another cells map if they cross the border)
+            // Note: exterior cell maps must be requested, even if they were visited before, because the set of surrounding cells might be different
+            // (and objects in a different cell can "bleed" into another cells map if they cross the border). The LocalMap decides if they need rendering.
             std::set<MWWorld::CellStore*> cellsToUpdate;
             for (CellStoreCollection::iterator active = mActiveCells.begin(); active!=mActiveCells.end(); ++active)
             {
@@ -214,6 +219,9 @@ namespace MWWorld
                 );
             if (land && land->mDataTypes&ESM::Land::DATA_VHGT)
                 mPhysics->removeHeightField ((*iter)->getCell()->getGridX(), (*iter)->getCell()->getGridY());
+
+            MWBase::Environment::get().getWorld()->getHierarchicalPathgrid().removeCell(
+                        (*iter)->getCell()->getGridX(), (*iter)->getCell()->getGridY());
         }
 
         MWBase::Environment::get().getMechanicsManager()->drop (*iter);
@@ -225,6 +233,7 @@ namespace MWWorld
 
         MWBase::Environment::get().getSoundManager()->stopSound (*iter);
         mActiveCells.erase(*iter);
+        ++mGeneration;
     }
 
     void Scene::loadCell (CellStore *cell, Loading::Listener* loadingListener)
@@ -234,6 +243,7 @@ namespace MWWorld
         if(result.second)
         {
             std::cout << "Loading cell " << cell->getCell()->getDescription() << std::endl;
+            ++mGeneration;
 
             float verts = ESM::Land::LAND_SIZE;
             float worldsize = ESM::Land::REAL_SIZE;
@@ -255,6 +265,9 @@ namespace MWWorld
                     mPhysics->addHeightField (land->mLandData->mHeights, cell->getCell()->getGridX(), cell->getCell()->getGridY(),
                         worldsize / (verts-1), verts);
                 }
+
+                MWBase::Environment::get().getWorld()->getHierarchicalPathgrid().addCell(
+                            cell->getCell()->getGridX(), cell->getCell()->getGridY(), &cell->getPathgridGraph());
             }
 
             cell->respawn();
@@ -316,6 +329,8 @@ namespace MWWorld
 
     void Scene::changeCellGrid (int X, int Y)
     {
+        Misc::ProfileZone zone("Scene::changeCellGrid");
+        osg::Timer_t start = osg::Timer::instance()->tick();
         Loading::Listener* loadingListener = MWBase::Environment::get().getWindowManager()->getLoadingScreen();
         Loading::ScopedLoad load(loadingListener);
 
@@ -399,6 +414,8 @@ namespace MWWorld
         MWBase::Environment::get().getWindowManager()->changeCell(current);
 
         mCellChanged = true;
+        ++mCellLoads;
+        mCellLoadTime += osg::Timer::instance()->delta_s(start, osg::Timer::instance()->tick());
 
         // Delay the map update until scripts have been given a chance to run.
         // If we don't do this, objects that should be disabled will still appear on the map.
@@ -437,7 +454,7 @@ namespace MWWorld
     }
 
     Scene::Scene (MWRender::RenderingManager& rendering, MWPhysics::PhysicsSystem *physics)
-    : mCurrentCell (0), mCellChanged (false), mPhysics(physics), mRendering(rendering), mNeedMapUpdate(false)
+    : mCurrentCell (0), mCellChanged (false), mGeneration (0), mCellLoads (0), mCellLoadTime (0), mPhysics(physics), mRendering(rendering), mNeedMapUpdate(false)
     {
     }
 
@@ -450,6 +467,17 @@ namespace MWWorld
         return mCellChanged;
     }
 
+    unsigned int Scene::getGeneration() const
+    {
+        return mGeneration;
+    }
+
+    void Scene::getCellLoadStats (unsigned int& count, double& time) const
+    {
+        count = mCellLoads;
+        time = mCellLoadTime;
+    }
+
     const Scene::CellStoreCollection& Scene::getActiveCells() const
     {
         return mActiveCells;
@@ -457,6 +485,7 @@ namespace MWWorld
 
     void Scene::changeToInteriorCell (const std::string& cellName, const ESM::Position& position)
     {
+        osg::Timer_t start = osg::Timer::instance()->tick();
         CellStore *cell = MWBase::Environment::get().getWorld()->getInterior(cellName);
         bool loadcell = (mCurrentCell == NULL);
         if(!loadcell)
@@ -512,6 +541,8 @@ namespace MWWorld
         MWBase::Environment::get().getWorld()->adjustSky();
 
         mCellChanged = true; MWBase::Environment::get().getWindowManager()->fadeScreenIn(0.5);
+        ++mCellLoads;
+        mCellLoadTime += osg::Timer::instance()->delta_s(start, osg::Timer::instance()->tick());
 
         MWBase::Environment::get().getWindowManager()->changeCell(mCurrentCell);
 
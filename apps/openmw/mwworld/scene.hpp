@@ -55,6 +55,9 @@ namespace MWWorld
             CellStore* mCurrentCell; // the cell the player is in
             CellStoreCollection mActiveCells;
             bool mCellChanged;
+            unsigned int mGeneration;
+            unsigned int mCellLoads;
+            double mCellLoadTime;
             MWPhysics::PhysicsSystem *mPhysics;
             MWRender::RenderingManager& mRendering;
 
@@ -88,6 +91,13 @@ namespace MWWorld
             bool hasCellChanged() const;
             ///< Has the set of active cells changed, since the last frame?
 
+            unsigned int getGeneration() const;
+            ///< Changes whenever a cell is loaded or unloaded.
+
+            void getCellLoadStats (unsigned int& count, double& time) const;
+            ///< Get the number of times the set of active cells was changed and the total time spent changing
+            /// it, in seconds.
+
             void changeToInteriorCell (const std::string& cellName, const ESM::Position& position);
             ///< Move to interior cell.
 
@@ -123,17 +123,14 @@ namespace MWWorld
     template<typename T>
     const T *Store<T>::search(const std::string &id) const
     {
-        T item;
-        item.mId = Misc::StringUtils::lowerCase(id);
-
-        typename Dynamic::const_iterator dit = mDynamic.find(item.mId);
+        typename Dynamic::const_iterator dit = mDynamic.find(id);
         if (dit != mDynamic.end()) {
             return &dit->second;
         }
 
-        typename std::map<std::string, T>::const_iterator it = mStatic.find(item.mId);
+        typename Static::const_iterator it = mStatic.find(id);
 
-        if (it != mStatic.end() && Misc::StringUtils::ciEqual(it->second.mId, id)) {
+        if (it != mStatic.end()) {
             return &(it->second);
         }
 
@@ -256,18 +253,17 @@ namespace MWWorld
     template<typename T>
     bool Store<T>::eraseStatic(const std::string &id)
     {
-        T item;
-        item.mId = Misc::StringUtils::lowerCase(id);
+        std::string idLower = Misc::StringUtils::lowerCase(id);
 
-        typename std::map<std::string, T>::iterator it = mStatic.find(item.mId);
+        typename Static::iterator it = mStatic.find(idLower);
 
-        if (it != mStatic.end() && Misc::StringUtils::ciEqual(it->second.mId, id)) {
+        if (it != mStatic.end()) {
             // delete from the static part of mShared
             typename std::vector<T *>::iterator sharedIter = mShared.begin();
             typename std::vector<T *>::iterator end = sharedIter + mStatic.size();
 
             while (sharedIter != mShared.end() && sharedIter != end) {
-                if((*sharedIter)->mId == item.mId) {
+                if((*sharedIter)->mId == idLower) {
                     mShared.erase(sharedIter);
                     break;
                 }
@@ -282,8 +278,7 @@ namespace MWWorld
     template<typename T>
     bool Store<T>::erase(const std::string &id)
     {
-        std::string key = Misc::StringUtils::lowerCase(id);
-        typename Dynamic::iterator it = mDynamic.find(key);
+        typename Dynamic::iterator it = mDynamic.find(id);
         if (it == mDynamic.end()) {
             return false;
         }
@@ -1006,7 +1001,7 @@ namespace MWWorld
 
         mShared.clear();
         mShared.reserve(mStatic.size());
-        std::map<std::string, ESM::Dialogue>::iterator it = mStatic.begin();
+        Static::iterator it = mStatic.begin();
         for (; it != mStatic.end(); ++it) {
             mShared.push_back(&(it->second));
         }
@@ -1016,7 +1011,7 @@ namespace MWWorld
     inline void Store<ESM::Dialogue>::load(ESM::ESMReader &esm, const std::string &id) {
         std::string idLower = Misc::StringUtils::lowerCase(id);
 
-        std::map<std::string, ESM::Dialogue>::iterator it = mStatic.find(idLower);
+        Static::iterator it = mStatic.find(idLower);
         if (it == mStatic.end()) {
             it = mStatic.insert( std::make_pair( idLower, ESM::Dialogue() ) ).first;
             it->second.mId = id; // don't smash case here, as this line is printed
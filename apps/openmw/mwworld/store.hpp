@@ -5,6 +5,8 @@
 #include <vector>
 #include <map>
 
+#include <components/misc/stringops.hpp>
+
 #include "recordcmp.hpp"
 
 namespace ESM
@@ -127,14 +129,15 @@ namespace MWWorld
     template <class T>
     class Store : public StoreBase
     {
-        std::map<std::string, T>      mStatic;
+        // Keys are lower case, but can be searched with IDs of any case
+        typedef std::map<std::string, T, Misc::StringUtils::CiLess> Dynamic;
+        typedef std::map<std::string, T, Misc::StringUtils::CiLess> Static;
+
+        Static              mStatic;
         std::vector<T *>    mShared; // Preserves the record order as it came from the content files (this
                                      // is relevant for the spell autocalc code and selection order
                                      // for heads/hairs in the character creation)
-        std::map<std::string, T> mDynamic;
-
-        typedef std::map<std::string, T> Dynamic;
-        typedef std::map<std::string, T> Static;
+        Dynamic             mDynamic;
 
         friend class ESMStore;
 
@@ -11,6 +11,7 @@
 #include <osg/Group>
 #include <osg/ComputeBoundsVisitor>
 #include <osg/PositionAttitudeTransform>
+#include <osg/Timer>
 
 #include <components/esm/esmreader.hpp>
 #include <components/esm/esmwriter.hpp>
@@ -21,6 +22,11 @@
 #include <components/files/collections.hpp>
 #include <components/misc/resourcehelpers.hpp>
 #include <components/resource/resourcesystem.hpp>
+#include <components/resource/objectcache.hpp>
+
+#include <components/nifbullet/bulletshapemanager.hpp>
+
+#include <components/settings/settings.hpp>
 
 #include "../mwbase/environment.hpp"
 #include "../mwbase/soundmanager.hpp"
@@ -35,6 +41,7 @@
 #include "../mwmechanics/levelledlist.hpp"
 #include "../mwmechanics/combat.hpp"
 #include "../mwmechanics/aiavoiddoor.hpp" //Used to tell actors to avoid doors
+#include "../mwmechanics/hierarchicalpathgrid.hpp"
 
 #include "../mwrender/animation.hpp"
 #include "../mwrender/renderingmanager.hpp"
@@ -159,12 +166,17 @@ namespace MWWorld
       mGodMode(false), mScriptsEnabled(true), mContentFiles (contentFiles),
       mActivationDistanceOverride (activationDistanceOverride), mStartupScript(startupScript),
       mStartCell (startCell), mTeleportEnabled(true),
-      mLevitationEnabled(true), mGoToJail(false), mDaysInPrison(0)
+      mLevitationEnabled(true), mGoToJail(false), mDaysInPrison(0), mReferenceGeneration(0)
     {
         mPhysics = new MWPhysics::PhysicsSystem(resourceSystem, rootNode);
         mProjectileManager.reset(new ProjectileManager(rootNode, resourceSystem, mPhysics));
         mRendering = new MWRender::RenderingManager(viewer, rootNode, resourceSystem, &mFallback);
 
+        float cacheExpiryDelay = std::max(0.f, Settings::Manager::getFloat("cache expiry delay", "Cells"));
+        size_t cacheBudget = static_cast<size_t>(std::max(0, Settings::Manager::getInt("cache budget", "Cells"))) * 1024 * 1024;
+        mResourceSystem->setCacheLimits(cacheExpiryDelay, cacheBudget);
+        mPhysics->getShapeManager()->setCacheLimits(cacheExpiryDelay, cacheBudget);
+
         mEsm.resize(contentFiles.size());
         Loading::Listener* listener = MWBase::Environment::get().getWindowManager()->getLoadingScreen();
         listener->loadingOn();
@@ -193,6 +205,8 @@ namespace MWWorld
 
         mGlobalVariables.fill (mStore);
 
+        mHierarchicalPathgrid = new MWMechanics::HierarchicalPathgrid;
+
         mWeatherManager = new MWWorld::WeatherManager(mRendering,&mFallback,&mStore);
 
         mWorldScene = new Scene(*mRendering, mPhysics);
@@ -275,6 +289,7 @@ namespace MWWorld
 
     void World::clear()
     {
+        ++mReferenceGeneration;
         mWeatherManager->clear();
         mRendering->clear();
         mProjectileManager->clear();
@@ -472,6 +487,7 @@ namespace MWWorld
         delete mWorldScene;
         delete mRendering;
         delete mPhysics;
+        delete mHierarchicalPathgrid;
 
         delete mPlayer;
     }
@@ -542,6 +558,11 @@ namespace MWWorld
         return mStore;
     }
 
+    MWMechanics::HierarchicalPathgrid& World::getHierarchicalPathgrid()
+    {
+        return *mHierarchicalPathgrid;
+    }
+
     std::vector<ESM::ESMReader>& World::getEsmReader()
     {
         return mEsm;
@@ -557,6 +578,11 @@ namespace MWWorld
         return mWorldScene->hasCellChanged();
     }
 
+    void World::getCellLoadStats (unsigned int& count, double& time) const
+    {
+        mWorldScene->getCellLoadStats(count, time);
+    }
+
     void World::setGlobalInt (const std::string& name, int value)
     {
         if (name=="gamehour")
@@ -659,6 +685,11 @@ namespace MWWorld
         return ptr;
     }
 
+    unsigned int World::getReferenceGeneration() const
+    {
+        return mReferenceGeneration + mWorldScene->getGeneration();
+    }
+
     Ptr World::getPtr (const std::string& name, bool activeOnly)
     {
         Ptr ret = searchPtr(name, activeOnly);
@@ -1052,7 +1083,11 @@ namespace MWWorld
     {
         if (!ptr.getRefData().isDeleted())
         {
-            ptr.getRefData().setCount(0);
+            if (ptr.getContainerStore())
+                ptr.getContainerStore()->setItemCount(ptr, 0);
+            else
+                ptr.getRefData().setCount(0);
+            ++mReferenceGeneration;
 
             if (ptr.isInCell()
                 && mWorldScene->getActiveCells().find(ptr.getCell()) != mWorldScene->getActiveCells().end()
@@ -1071,7 +1106,12 @@ namespace MWWorld
             return;
         if (ptr.getRefData().isDeleted())
         {
-            ptr.getRefData().setCount(1);
+            if (ptr.getContainerStore())
+                ptr.getContainerStore()->setItemCount(ptr, 1);
+            else
+                ptr.getRefData().setCount(1);
+            ++mReferenceGeneration;
+
             if (mWorldScene->getActiveCells().find(ptr.getCell()) != mWorldScene->getActiveCells().end()
                     && ptr.getRefData().isEnabled())
             {
@@ -1103,6 +1143,7 @@ namespace MWWorld
 
         if (currCell != newCell)
         {
+            ++mReferenceGeneration;
             removeContainerScripts(ptr);
 
             if (isPlayer)
@@ -1168,6 +1209,7 @@ namespace MWWorld
                         addContainerScripts (newPtr, newCell);
                     }
                 }
+                // ptr is a cell reference, so there are no container totals to update
                 ptr.getRefData().setCount(0);
             }
         }
@@ -1382,6 +1424,8 @@ namespace MWWorld
             moveObjectImp(player->first, player->second.x(), player->second.y(), player->second.z());
 
         mPhysics->debugDraw();
+
+        mPhysics->startSimulation();
     }
 
     bool World::castRay (float x1, float y1, float z1, float x2, float y2, float z2)
@@ -1565,6 +1609,16 @@ namespace MWWorld
         updateSoundListener();
 
         updatePlayer(paused);
+
+        double time = osg::Timer::instance()->time_s();
+        mResourceSystem->updateCache(time);
+        mPhysics->getShapeManager()->updateCache(time);
+    }
+
+    void World::getResourceCacheStats(std::map<std::string, Resource::CacheStats>& stats) const
+    {
+        mResourceSystem->getCacheStats(stats);
+        stats["Collision shapes"] = mPhysics->getShapeManager()->getCacheStats();
     }
 
     void World::updatePlayer(bool paused)
@@ -1799,7 +1853,8 @@ namespace MWWorld
         pos.rot[0] = 0;
         pos.rot[1] = 0;
 
-        // copy the object and set its count
+        // copy the object and set its count. The original count is restored before anything can query
+        // the container the object may be in, so its cached totals stay valid.
         int origCount = object.getRefData().getCount();
         object.getRefData().setCount(amount);
         Ptr dropped = copyObjectToCell(object, cell, pos, true);
@@ -1840,6 +1895,7 @@ namespace MWWorld
 
         MWWorld::Ptr dropped =
             object.getClass().copyToCell(object, *cell, pos);
+        ++mReferenceGeneration;
 
         // Reset some position values that could be uninitialized if this item came from a container
         LocalRotation localRotation;
@@ -1907,7 +1963,8 @@ namespace MWWorld
         if (result.mHit)
             pos.pos[2] = result.mHitPointWorld.z();
 
-        // copy the object and set its count
+        // copy the object and set its count. The original count is restored before anything can query
+        // the container the object may be in, so its cached totals stay valid.
         int origCount = object.getRefData().getCount();
         object.getRefData().setCount(amount);
         Ptr dropped = copyObjectToCell(object, cell, pos);
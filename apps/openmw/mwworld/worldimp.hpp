@@ -83,6 +83,7 @@ namespace MWWorld
             LocalScripts mLocalScripts;
             MWWorld::Globals mGlobalVariables;
             MWPhysics::PhysicsSystem *mPhysics;
+            MWMechanics::HierarchicalPathgrid *mHierarchicalPathgrid;
             bool mSky;
 
             Cells mCells;
@@ -153,6 +154,9 @@ namespace MWWorld
             bool mGoToJail;
             int mDaysInPrison;
 
+            // Changed when references are added, removed or moved between cells, see getReferenceGeneration
+            unsigned int mReferenceGeneration;
+
             float feetToGameUnits(float feet);
 
             MWWorld::Ptr getClosestMarker( const MWWorld::Ptr &ptr, const std::string &id );
@@ -207,6 +211,9 @@ namespace MWWorld
 
             virtual const MWWorld::ESMStore& getStore() const;
 
+            virtual MWMechanics::HierarchicalPathgrid& getHierarchicalPathgrid();
+            ///< Pathgrids of all exterior cells, linked at the cell borders
+
             virtual std::vector<ESM::ESMReader>& getEsmReader();
 
             virtual LocalScripts& getLocalScripts();
@@ -214,6 +221,10 @@ namespace MWWorld
             virtual bool hasCellChanged() const;
             ///< Has the set of active cells changed, since the last frame?
 
+            virtual void getCellLoadStats (unsigned int& count, double& time) const;
+            ///< Get the number of times the set of active cells was changed and the total time spent changing
+            /// it, in seconds.
+
             virtual bool isCellExterior() const;
 
             virtual bool isCellQuasiExterior() const;
@@ -256,6 +267,9 @@ namespace MWWorld
             ///< Return a pointer to a liveCellRef with the given name.
             /// \param activeOnly do non search inactive cells.
 
+            virtual unsigned int getReferenceGeneration() const;
+            ///< Changes whenever the result of searchPtr for a reference in a cell may change.
+
             virtual Ptr searchPtrViaActorId (int actorId);
             ///< Search is limited to the active cells.
 
@@ -432,6 +446,9 @@ namespace MWWorld
 
             virtual void update (float duration, bool paused);
 
+            virtual void getResourceCacheStats (std::map<std::string, Resource::CacheStats>& stats) const;
+            ///< Get the statistics of the mesh, texture, animation and collision shape caches, by cache name.
+
             virtual MWWorld::Ptr placeObject (const MWWorld::Ptr& object, float cursorX, float cursorY, int amount);
             ///< copy and place an object into the gameworld at the specified cursor position
             /// @param object
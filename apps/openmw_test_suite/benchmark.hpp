@@ -0,0 +1,45 @@
+#ifndef OPENMW_TEST_SUITE_BENCHMARK_H
+#define OPENMW_TEST_SUITE_BENCHMARK_H
+
+#include <iostream>
+
+#include <osg/Timer>
+
+namespace TestSuite
+{
+    /// @brief Measures a section of a DISABLED_benchmark_* test.
+    ///
+    /// Measures wall clock time, as std::clock() would add up the time of all threads in multi-threaded
+    /// benchmarks. Starts measuring when constructed.
+    class BenchmarkTimer
+    {
+        public:
+
+            void restart()
+            {
+                mTimer.setStartTick();
+            }
+
+            double getSeconds() const
+            {
+                return mTimer.time_s();
+            }
+
+            double getMilliseconds() const
+            {
+                return mTimer.time_m();
+            }
+
+        private:
+
+            osg::Timer mTimer;
+    };
+
+    /// Start a benchmark result line in the style of the gtest output. Finish it with std::endl.
+    inline std::ostream& reportBenchmark()
+    {
+        return std::cout << "[ BENCHMARK] ";
+    }
+}
+
+#endif
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include "components/bsa/bsa_file.hpp"
+#include "components/bsa/bsa_writer.hpp"
+
+namespace bfs = boost::filesystem;
+
+struct BSAWriterTest : public ::testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        mDirectory = bfs::temp_directory_path() / bfs::unique_path("openmw_test_%%%%-%%%%");
+        bfs::create_directories(mDirectory);
+    }
+
+    virtual void TearDown()
+    {
+        bfs::remove_all(mDirectory);
+    }
+
+    std::string createFile(const std::string& name, const std::string& content)
+    {
+        bfs::path path = mDirectory / name;
+        bfs::ofstream stream (path, std::ios_base::binary);
+        stream << content;
+        return path.string();
+    }
+
+    std::string readFile(Bsa::BSAFile& bsa, const char* name)
+    {
+        Files::IStreamPtr stream = bsa.getFile(name);
+        return std::string(std::istreambuf_iterator<char>(*stream), std::istreambuf_iterator<char>());
+    }
+
+    bfs::path mDirectory;
+};
+
+TEST_F(BSAWriterTest, read_back)
+{
+    Bsa::BSAWriter writer;
+    writer.addFile("Textures/b.dds", createFile("b", "second file"));
+    writer.addFile("meshes\\a.nif", createFile("a", "first"));
+    writer.addFile("empty.txt", createFile("empty", ""));
+    std::string archive = (mDirectory / "test.bsa").string();
+    writer.write(archive);
+
+    Bsa::BSAFile bsa;
+    bsa.open(archive);
+    ASSERT_EQ(3u, bsa.getList().size());
+    EXPECT_TRUE(bsa.exists("TEXTURES\\B.DDS"));
+    EXPECT_EQ("second file", readFile(bsa, "textures\\b.dds"));
+    EXPECT_EQ("first", readFile(bsa, "meshes\\a.nif"));
+    EXPECT_EQ("", readFile(bsa, "empty.txt"));
+}
+
+TEST_F(BSAWriterTest, directory_sorted_by_hash_data_in_added_order)
+{
+    const char* names[] = { "z.nif", "a.nif", "m\\x.dds", "b.kf", "textures\\long_name.tga" };
+    const size_t count = sizeof(names)/sizeof(names[0]);
+
+    Bsa::BSAWriter writer;
+    for (size_t i=0; i<count; ++i)
+        writer.addFile(names[i], createFile(std::string(1, char('a'+i)), "data"));
+    std::string archive = (mDirectory / "test.bsa").string();
+    writer.write(archive);
+
+    Bsa::BSAFile bsa;
+    bsa.open(archive);
+    const Bsa::BSAFile::FileList& files = bsa.getList();
+    ASSERT_EQ(count, files.size());
+
+    for (size_t i=1; i<files.size(); ++i)
+        EXPECT_LT(Bsa::BSAWriter::getHash(files[i-1].name), Bsa::BSAWriter::getHash(files[i].name));
+
+    // Offsets follow the order the files were added in
+    uint32_t previous = 0;
+    for (size_t i=0; i<count; ++i)
+    {
+        uint32_t offset = 0;
+        for (size_t j=0; j<files.size(); ++j)
+            if (std::string(files[j].name) == names[i])
+                offset = files[j].offset;
+        if (i > 0)
+            EXPECT_EQ(previous + 4, offset);
+        previous = offset;
+    }
+}
+
+TEST_F(BSAWriterTest, hash_of_vanilla_names)
+{
+    // Expected values computed with the hash algorithm documented for the TES3 archive format
+    EXPECT_EQ(Bsa::BSAWriter::Hash(0x0a2f6569, 0xe36de0ae), Bsa::BSAWriter::getHash("meshes\\base_anim.nif"));
+    EXPECT_EQ(Bsa::BSAWriter::Hash(0x102f776a, 0x85e71c9d), Bsa::BSAWriter::getHash("meshes\\xbase_anim.kf"));
+    EXPECT_EQ(Bsa::BSAWriter::Hash(0x5865635d, 0x759a30e4), Bsa::BSAWriter::getHash("textures\\tx_sky_clear.dds"));
+    EXPECT_EQ(Bsa::BSAWriter::Hash(0x76462437, 0x99660c00), Bsa::BSAWriter::getHash("meshes\\m\\misc_dwrv_coin00.nif"));
+
+    // characters above 127 are sign extended
+    EXPECT_EQ(Bsa::BSAWriter::Hash(0x6e6f631a, 0x49bd6dca), Bsa::BSAWriter::getHash("icons\\\xe9.dds"));
+}
+
+TEST_F(BSAWriterTest, normalize_names)
+{
+    EXPECT_EQ("meshes\\a\\b.nif", Bsa::BSAWriter::normalizeName("/Meshes/A/b.NIF"));
+    EXPECT_EQ("", Bsa::BSAWriter::normalizeName("\\"));
+}
+
+TEST_F(BSAWriterTest, reject_duplicates)
+{
+    Bsa::BSAWriter writer;
+    std::string file = createFile("a", "data");
+    writer.addFile("meshes/a.nif", file);
+    EXPECT_THROW(writer.addFile("Meshes\\A.nif", file), std::runtime_error);
+    EXPECT_THROW(writer.addFile("", file), std::runtime_error);
+}
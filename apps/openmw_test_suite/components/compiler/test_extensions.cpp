@@ -0,0 +1,240 @@
+#include <gtest/gtest.h>
+#include "components/compiler/extensions.hpp"
+#include "apps/openmw_test_suite/benchmark.hpp"
+
+#include <set>
+#include <sstream>
+
+#include <components/compiler/context.hpp>
+#include <components/compiler/extensions0.hpp>
+#include <components/compiler/fileparser.hpp>
+#include <components/compiler/scanner.hpp>
+#include <components/compiler/streamerrorhandler.hpp>
+
+#include <components/misc/stringops.hpp>
+
+using Compiler::Extensions;
+
+namespace
+{
+    class TestContext : public Compiler::Context
+    {
+        public:
+
+            virtual bool canDeclareLocals() const
+            {
+                return true;
+            }
+
+            virtual char getGlobalType (const std::string& name) const
+            {
+                return name=="gamehour" ? 'f' : ' ';
+            }
+
+            virtual std::pair<char, bool> getMemberType (const std::string& name, const std::string& id) const
+            {
+                return std::make_pair (' ', false);
+            }
+
+            virtual bool isId (const std::string& name) const
+            {
+                std::string id = Misc::StringUtils::lowerCase (name);
+                return id=="fargoth" || id=="gold_001" || id=="player";
+            }
+
+            virtual bool isJournalId (const std::string& name) const
+            {
+                return name=="a1_1_findspymaster";
+            }
+    };
+
+    /// A local script in the style of the vanilla ones
+    std::string makeScript (int index)
+    {
+        std::ostringstream stream;
+        stream
+            << "Begin Test_Script_" << index << "\n"
+            << "\n"
+            << "short doOnce\n"
+            << "short state\n"
+            << "float timer\n"
+            << "\n"
+            << "if ( MenuMode == 1 )\n"
+            << "    return\n"
+            << "endif\n"
+            << "\n"
+            << "if ( OnActivate == 1 )\n"
+            << "    if ( GetJournalIndex A1_1_FindSpymaster < 10 )\n"
+            << "        MessageBox \"The door is locked.\"\n"
+            << "    else\n"
+            << "        Activate\n"
+            << "    endif\n"
+            << "endif\n"
+            << "\n"
+            << "if ( doOnce == 0 )\n"
+            << "    if ( GetDistance Player < " << 256 + index << " )\n"
+            << "        \"fargoth\"->AddItem Gold_001 " << index << "\n"
+            << "        Player->ModDisposition 10\n"
+            << "        set doOnce to 1\n"
+            << "    endif\n"
+            << "endif\n"
+            << "\n"
+            << "set timer to timer + GetSecondsPassed\n"
+            << "if ( timer > 5 )\n"
+            << "    set timer to 0\n"
+            << "    if ( GetCurrentAIPackage != 0 )\n"
+            << "        AIWander 512 5 0 40 30 20 10 0 0 0 0\n"
+            << "    endif\n"
+            << "    if ( GameHour > 20 )\n"
+            << "        Disable\n"
+            << "    elseif ( GetDisabled == 1 )\n"
+            << "        Enable\n"
+            << "    endif\n"
+            << "    PlaySound3D \"Door Creaky Open\"\n"
+            << "    set state to ( state + 1 ) * 2\n"
+            << "endif\n"
+            << "\n"
+            << "End\n";
+        return stream.str();
+    }
+
+    struct ExtensionsTest : public ::testing::Test
+    {
+        Extensions mExtensions;
+
+        virtual void SetUp()
+        {
+            Compiler::registerExtensions (mExtensions);
+        }
+    };
+}
+
+TEST_F(ExtensionsTest, search_keyword)
+{
+    std::vector<std::string> keywords;
+    mExtensions.listKeywords (keywords);
+    ASSERT_GT(keywords.size(), 400u);
+
+    std::set<int> codes;
+    for (std::vector<std::string>::const_iterator iter (keywords.begin()); iter!=keywords.end(); ++iter)
+    {
+        int keyword = mExtensions.searchKeyword (*iter);
+        EXPECT_LT(keyword, 0) << *iter;
+        EXPECT_TRUE(codes.insert (keyword).second) << *iter;
+
+        Compiler::ScriptReturn returnType;
+        Compiler::ScriptArgs arguments;
+        bool explicitReference = false;
+        bool function = mExtensions.isFunction (keyword, returnType, arguments, explicitReference);
+        bool instruction = mExtensions.isInstruction (keyword, arguments, explicitReference);
+        EXPECT_TRUE(function!=instruction) << *iter;
+    }
+
+    EXPECT_EQ(0, mExtensions.searchKeyword (""));
+    EXPECT_EQ(0, mExtensions.searchKeyword ("fargoth"));
+    EXPECT_EQ(0, mExtensions.searchKeyword ("additem2"));
+    EXPECT_EQ(0, mExtensions.searchKeyword ("additemx"));
+
+    for (size_t i=1; i<keywords.size(); ++i)
+        EXPECT_LT(keywords[i-1], keywords[i]);
+}
+
+TEST_F(ExtensionsTest, register)
+{
+    Extensions extensions;
+    EXPECT_EQ(0, extensions.searchKeyword ("getfoo"));
+
+    extensions.registerFunction ("getfoo", 'l', "c", 0x2000000, 0x2000001);
+    extensions.registerInstruction ("setfoo", "l/l", 0x20000);
+
+    int getFoo = extensions.searchKeyword ("getfoo");
+    int setFoo = extensions.searchKeyword ("setfoo");
+    EXPECT_EQ(-1, getFoo);
+    EXPECT_EQ(-2, setFoo);
+
+    Compiler::ScriptReturn returnType = ' ';
+    Compiler::ScriptArgs arguments;
+    bool explicitReference = true;
+    EXPECT_TRUE(extensions.isFunction (getFoo, returnType, arguments, explicitReference));
+    EXPECT_EQ('l', returnType);
+    EXPECT_EQ("c", arguments);
+    EXPECT_TRUE(explicitReference);
+    EXPECT_FALSE(extensions.isInstruction (getFoo, arguments, explicitReference));
+
+    EXPECT_TRUE(extensions.isInstruction (setFoo, arguments, explicitReference));
+    EXPECT_EQ("l/l", arguments);
+    EXPECT_FALSE(explicitReference);
+    EXPECT_FALSE(extensions.isFunction (setFoo, returnType, arguments, explicitReference));
+
+    EXPECT_FALSE(extensions.isFunction (0, returnType, arguments, explicitReference));
+    EXPECT_FALSE(extensions.isInstruction (-3, arguments, explicitReference));
+    EXPECT_FALSE(extensions.isInstruction (1, arguments, explicitReference));
+}
+
+TEST_F(ExtensionsTest, DISABLED_benchmark_search_keyword)
+{
+    std::vector<std::string> keywords;
+    mExtensions.listKeywords (keywords);
+
+    // names that are not keywords are looked up as well, e.g. for every variable and ID in a script
+    std::vector<std::string> names (keywords);
+    for (size_t i=0; i<keywords.size(); ++i)
+        names.push_back (keywords[i] + "_var");
+
+    const int lookups = 2000000;
+    int sum = 0;
+
+    TestSuite::BenchmarkTimer timer;
+    for (int i=0; i<lookups; ++i)
+        sum += mExtensions.searchKeyword (names[i % names.size()]);
+
+    TestSuite::reportBenchmark() << lookups << " keyword lookups in " << keywords.size() << " keywords: "
+                                 << timer.getMilliseconds() << " ms" << std::endl;
+
+    EXPECT_NE(0, sum);
+}
+
+TEST_F(ExtensionsTest, DISABLED_benchmark_compile_throughput)
+{
+    TestContext context;
+    context.setExtensions (&mExtensions);
+
+    // about as many scripts as in the vanilla game
+    std::vector<std::string> scripts;
+    size_t bytes = 0;
+    for (int i=0; i<1000; ++i)
+    {
+        scripts.push_back (makeScript (i));
+        bytes += scripts.back().size();
+    }
+
+    const int rounds = 5;
+    int compiled = 0;
+
+    TestSuite::BenchmarkTimer timer;
+    for (int round=0; round<rounds; ++round)
+    {
+        for (std::vector<std::string>::const_iterator iter (scripts.begin()); iter!=scripts.end(); ++iter)
+        {
+            std::ostringstream messages;
+            Compiler::StreamErrorHandler errorHandler (messages);
+            Compiler::FileParser parser (errorHandler, context);
+            std::istringstream input (*iter);
+            Compiler::Scanner scanner (errorHandler, input, &mExtensions);
+
+            scanner.scan (parser);
+
+            if (errorHandler.isGood())
+                ++compiled;
+            else
+                ADD_FAILURE() << messages.str();
+        }
+    }
+    double seconds = timer.getSeconds();
+
+    TestSuite::reportBenchmark() << "compiled " << scripts.size() << " scripts (" << bytes / 1024 << " KiB) "
+                                 << rounds << " times: " << seconds * 1000.0 << " ms, "
+                                 << (seconds>0 ? rounds * scripts.size() / seconds : 0) << " scripts/s" << std::endl;
+
+    EXPECT_EQ(rounds * static_cast<int> (scripts.size()), compiled);
+}
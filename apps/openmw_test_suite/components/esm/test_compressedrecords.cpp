@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include <boost/shared_ptr.hpp>
+
+#include "components/esm/esmreader.hpp"
+#include "components/esm/esmwriter.hpp"
+#include "components/esm/compressedrecords.hpp"
+#include "components/esm/fogstate.hpp"
+#include "components/esm/defs.hpp"
+
+struct CompressedRecordsTest : public ::testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    // Write records with the given indices, each holding some easily compressible padding
+    void writeRecords(ESM::ESMWriter& writer, int first, int count)
+    {
+        for (int i=first; i<first+count; ++i)
+        {
+            writer.startRecord(ESM::REC_GLOB);
+            writer.writeHNT("INDX", i);
+            writer.writeHNString("DATA", std::string(1000 + i % 100, 'a' + i % 26));
+            writer.endRecord(ESM::REC_GLOB);
+        }
+    }
+
+    void readRecords(ESM::ESMReader& reader, int first, int count)
+    {
+        for (int i=first; i<first+count; ++i)
+        {
+            ASSERT_TRUE(reader.hasMoreRecs());
+            ASSERT_EQ(ESM::REC_GLOB, reader.getRecName().val);
+            reader.getRecHeader();
+
+            int index = -1;
+            reader.getHNT(index, "INDX");
+            EXPECT_EQ(i, index);
+            EXPECT_EQ(std::string(1000 + i % 100, 'a' + i % 26), reader.getHNString("DATA"));
+        }
+    }
+
+    // A file with a plain part of 10 records, followed by a compressed record holding \a count records
+    std::string writeFile(int count)
+    {
+        std::ostringstream records;
+        ESM::ESMWriter recordWriter;
+        recordWriter.saveRecords(records);
+        writeRecords(recordWriter, 10, count);
+        recordWriter.close();
+        std::string data = records.str();
+
+        std::ostringstream file;
+        ESM::ESMWriter writer;
+        writer.setFormat(2);
+        writer.setVersion(0);
+        writer.setType(0);
+        writer.setAuthor("");
+        writer.setDescription("");
+        writer.save(file);
+        writeRecords(writer, 0, 10);
+        writer.startRecord(ESM::REC_CMPR);
+        ESM::writeCompressedRecords(writer, data.data(), data.size());
+        writer.endRecord(ESM::REC_CMPR);
+        writer.close();
+
+        mUncompressedSize = data.size();
+        return file.str();
+    }
+
+    size_t mUncompressedSize;
+};
+
+TEST_F(CompressedRecordsTest, read_back)
+{
+    std::string file = writeFile(1000);
+    EXPECT_LT(file.size(), mUncompressedSize / 10);
+
+    ESM::ESMReader reader;
+    reader.open(Files::IStreamPtr(new std::istringstream(file)), "test");
+    EXPECT_EQ(2, reader.getFormat());
+
+    readRecords(reader, 0, 10);
+
+    ASSERT_EQ(ESM::REC_CMPR, reader.getRecName().val);
+    reader.getRecHeader();
+    reader.decompressRecord();
+    EXPECT_EQ(mUncompressedSize, reader.getFileSize());
+
+    readRecords(reader, 10, 1000);
+    EXPECT_FALSE(reader.hasMoreRecs());
+}
+
+TEST_F(CompressedRecordsTest, skip_and_seek)
+{
+    std::string file = writeFile(1000);
+
+    ESM::ESMReader reader;
+    reader.open(Files::IStreamPtr(new std::istringstream(file)), "test");
+    for (int i=0; i<10; ++i)
+    {
+        reader.getRecName();
+        reader.getRecHeader();
+        reader.skipRecord();
+    }
+    reader.getRecName();
+    reader.getRecHeader();
+    reader.decompressRecord();
+
+    // skipping over block boundaries
+    for (int i=0; i<500; ++i)
+    {
+        reader.getRecName();
+        reader.getRecHeader();
+        reader.skipRecord();
+    }
+
+    ESM::ESM_Context context = reader.getContext();
+    readRecords(reader, 510, 500);
+    EXPECT_FALSE(reader.hasMoreRecs());
+
+    // seeking back
+    reader.restoreContext(context);
+    readRecords(reader, 510, 500);
+}
+
+TEST_F(CompressedRecordsTest, empty)
+{
+    std::string file = writeFile(0);
+
+    ESM::ESMReader reader;
+    reader.open(Files::IStreamPtr(new std::istringstream(file)), "test");
+    readRecords(reader, 0, 10);
+    reader.getRecName();
+    reader.getRecHeader();
+    reader.decompressRecord();
+    EXPECT_FALSE(reader.hasMoreRecs());
+}
+
+TEST_F(CompressedRecordsTest, corrupted_data)
+{
+    std::string file = writeFile(100);
+    file[file.size()-100] ^= 0x55;
+
+    ESM::ESMReader reader;
+    reader.open(Files::IStreamPtr(new std::istringstream(file)), "test");
+    readRecords(reader, 0, 10);
+    reader.getRecName();
+    reader.getRecHeader();
+    reader.decompressRecord();
+
+    EXPECT_THROW(readRecords(reader, 10, 100), std::runtime_error);
+}
+
+TEST_F(CompressedRecordsTest, invalid_index)
+{
+    // block size, block count, uncompressed size, compressed block sizes
+    const uint32_t invalid[][4] = {
+        { 0, 0, 0, 0 },              // no block size
+        { 1024*1024, 1, 10, 10 },    // larger blocks than ever written
+        { 64*1024, 0, 0xffffffff, 0 }, // block count wraps around in 32 bits
+        { 64*1024, 1, 10, 0 },       // empty compressed block
+        { 64*1024, 1, 10, 1000 }     // block extends past the record
+    };
+
+    for (size_t i=0; i<sizeof(invalid)/sizeof(invalid[0]); ++i)
+    {
+        std::string data (reinterpret_cast<const char*>(invalid[i]), sizeof(invalid[i]));
+        data += std::string(100, 'x');
+        Files::IStreamPtr stream (new std::istringstream(data));
+        EXPECT_THROW(ESM::openCompressedRecords(stream, data.size()), std::runtime_error) << "index " << i;
+    }
+}
+
+TEST_F(CompressedRecordsTest, fog_run_length)
+{
+    std::vector<unsigned char> alpha (32*32, 255);
+    for (int i=0; i<300; ++i)
+        alpha[100+i] = static_cast<unsigned char>(i % 7 == 0 ? 0 : 128);
+
+    ESM::FogTexture fog;
+    fog.encodeAlpha(alpha);
+    EXPECT_TRUE(fog.mRunLength);
+    EXPECT_LT(fog.mImageData.size(), alpha.size() / 2);
+
+    std::vector<unsigned char> decoded;
+    EXPECT_TRUE(fog.decodeAlpha(decoded, alpha.size()));
+    EXPECT_EQ(alpha, decoded);
+
+    EXPECT_FALSE(fog.decodeAlpha(decoded, alpha.size()-1));
+    fog.mImageData.pop_back();
+    EXPECT_FALSE(fog.decodeAlpha(decoded, alpha.size()));
+}
@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "components/misc/profiler.hpp"
+
+namespace
+{
+    void workerZones()
+    {
+        Misc::Profiler::setThreadName("Worker");
+        for (int i=0; i<10; ++i)
+            Misc::ProfileZone zone("WorkerZone");
+    }
+
+    void otherWorkerZone()
+    {
+        Misc::ProfileZone zone("OtherWorkerZone");
+    }
+
+    /// @return the thread ID of the first event called \a name, or -1 if there is none
+    int getThreadId(const std::string& trace, const std::string& name)
+    {
+        size_t pos = trace.find("\"name\":\"" + name + "\"");
+        if (pos == std::string::npos)
+            return -1;
+        pos = trace.find("\"tid\":", pos);
+        if (pos == std::string::npos)
+            return -1;
+        return std::atoi(trace.c_str() + pos + 6);
+    }
+
+    int countOccurrences(const std::string& text, const std::string& pattern)
+    {
+        int count = 0;
+        for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos+1))
+            ++count;
+        return count;
+    }
+}
+
+struct ProfilerTest : public ::testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        mDirectory = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+        boost::filesystem::create_directories(mDirectory);
+        Misc::Profiler::setTraceDirectory(mDirectory.string());
+    }
+
+    virtual void TearDown()
+    {
+        if (Misc::Profiler::isEnabled())
+            Misc::Profiler::toggle();
+        boost::filesystem::remove_all(mDirectory);
+    }
+
+    std::string readTrace()
+    {
+        std::ifstream stream(Misc::Profiler::getTraceFile().c_str());
+        std::stringstream content;
+        content << stream.rdbuf();
+        return content.str();
+    }
+
+    boost::filesystem::path mDirectory;
+};
+
+TEST_F(ProfilerTest, disabled_records_nothing)
+{
+    {
+        Misc::ProfileZone zone("Ignored");
+    }
+    ASSERT_TRUE(Misc::Profiler::toggle());
+    ASSERT_FALSE(Misc::Profiler::toggle());
+
+    std::string trace = readTrace();
+    EXPECT_EQ(0, countOccurrences(trace, "Ignored"));
+    EXPECT_EQ('[', trace[0]);
+    EXPECT_NE(std::string::npos, trace.rfind(']'));
+}
+
+TEST_F(ProfilerTest, zones_from_threads)
+{
+    ASSERT_TRUE(Misc::Profiler::toggle());
+
+    Misc::Profiler::setThreadName("Main \"thread\"");
+    {
+        Misc::ProfileZone outer("Outer");
+        Misc::ProfileZone inner("Inner");
+    }
+    boost::thread worker(workerZones);
+    worker.join();
+
+    Misc::Profiler::flush();
+    ASSERT_FALSE(Misc::Profiler::toggle());
+
+    std::string trace = readTrace();
+    EXPECT_EQ(1, countOccurrences(trace, "\"name\":\"Outer\""));
+    EXPECT_EQ(1, countOccurrences(trace, "\"name\":\"Inner\""));
+    EXPECT_EQ(10, countOccurrences(trace, "\"name\":\"WorkerZone\""));
+    EXPECT_EQ(12, countOccurrences(trace, "\"ph\":\"X\""));
+    EXPECT_EQ(1, countOccurrences(trace, "\"name\":\"Worker\""));
+    EXPECT_EQ(1, countOccurrences(trace, "\"name\":\"Main \\\"thread\\\"\""));
+}
+
+TEST_F(ProfilerTest, thread_ids_are_kept_per_thread)
+{
+    ASSERT_TRUE(Misc::Profiler::toggle());
+
+    {
+        Misc::ProfileZone zone("MainZone");
+    }
+    boost::thread worker(workerZones);
+    worker.join();
+    boost::thread otherWorker(otherWorkerZone);
+    otherWorker.join();
+    {
+        Misc::ProfileZone zone("LaterMainZone");
+    }
+
+    Misc::Profiler::flush();
+    ASSERT_FALSE(Misc::Profiler::toggle());
+
+    std::string trace = readTrace();
+    int main = getThreadId(trace, "MainZone");
+    int worker1 = getThreadId(trace, "WorkerZone");
+    int worker2 = getThreadId(trace, "OtherWorkerZone");
+    ASSERT_NE(-1, main);
+    ASSERT_NE(-1, worker1);
+    ASSERT_NE(-1, worker2);
+    EXPECT_EQ(main, getThreadId(trace, "LaterMainZone"));
+    EXPECT_NE(main, worker1);
+    EXPECT_NE(main, worker2);
+    EXPECT_NE(worker1, worker2);
+}
+
+TEST_F(ProfilerTest, new_file_per_trace)
+{
+    ASSERT_TRUE(Misc::Profiler::toggle());
+    std::string first = Misc::Profiler::getTraceFile();
+    ASSERT_FALSE(Misc::Profiler::toggle());
+
+    ASSERT_TRUE(Misc::Profiler::toggle());
+    EXPECT_NE(first, Misc::Profiler::getTraceFile());
+    ASSERT_FALSE(Misc::Profiler::toggle());
+}
@@ -1,5 +1,12 @@
 #include <gtest/gtest.h>
 #include "components/misc/stringops.hpp"
+#include "apps/openmw_test_suite/benchmark.hpp"
+
+#include <map>
+#include <sstream>
+#include <vector>
+
+using Misc::StringUtils;
 
 struct StringOpsTest : public ::testing::Test
 {
@@ -12,3 +19,141 @@ struct StringOpsTest : public ::testing::Test
     {
     }
 };
+
+namespace
+{
+    std::vector<std::string> makeIds(int count)
+    {
+        std::vector<std::string> ids;
+        for (int i=0; i<count; ++i)
+        {
+            std::ostringstream stream;
+            stream << "Misc_Com_Bottle_" << i;
+            ids.push_back(stream.str());
+        }
+        return ids;
+    }
+}
+
+TEST_F(StringOpsTest, to_lower)
+{
+    EXPECT_EQ('a', StringUtils::toLower('A'));
+    EXPECT_EQ('z', StringUtils::toLower('Z'));
+    EXPECT_EQ('a', StringUtils::toLower('a'));
+    EXPECT_EQ('@', StringUtils::toLower('@'));
+    EXPECT_EQ('[', StringUtils::toLower('['));
+    // non-ASCII characters are left alone, like in the classic locale
+    EXPECT_EQ('\xc4', StringUtils::toLower('\xc4'));
+
+    EXPECT_EQ("fargoth's ring 01", StringUtils::lowerCase("Fargoth's RING 01"));
+}
+
+TEST_F(StringOpsTest, ci_compare)
+{
+    EXPECT_TRUE(StringUtils::ciEqual("Fargoth", "fARGOTH"));
+    EXPECT_FALSE(StringUtils::ciEqual("Fargoth", "Fargot"));
+    EXPECT_FALSE(StringUtils::ciEqual("Fargoth", "Fargotx"));
+    EXPECT_TRUE(StringUtils::ciEqual("", ""));
+
+    EXPECT_TRUE(StringUtils::ciLess("apple", "Banana"));
+    EXPECT_FALSE(StringUtils::ciLess("Banana", "apple"));
+    EXPECT_FALSE(StringUtils::ciLess("APPLE", "apple"));
+    EXPECT_TRUE(StringUtils::ciLess("app", "APPLE"));
+    EXPECT_TRUE(StringUtils::ciLess(std::string("z"), std::string("\xe4")));
+    EXPECT_TRUE(StringUtils::ciLess("Apple", "banana"));
+
+    EXPECT_EQ(0, StringUtils::ciCompareLen("Balmora", "BALMORA, Caius", 7));
+    EXPECT_EQ(-1, StringUtils::ciCompareLen("Balmora", "Balmorb", 7));
+    EXPECT_EQ(1, StringUtils::ciCompareLen("Balmora, Caius", "Balmora", 8));
+}
+
+TEST_F(StringOpsTest, ci_less_orders_lower_case_like_std_less)
+{
+    std::vector<std::string> ids = makeIds(100);
+    ids.push_back("\xe4pfel");
+    ids.push_back("zebra");
+    for (size_t i=0; i<ids.size(); ++i)
+        StringUtils::toLower(ids[i]);
+
+    for (size_t i=0; i<ids.size(); ++i)
+        for (size_t j=0; j<ids.size(); ++j)
+            EXPECT_EQ(ids[i] < ids[j], StringUtils::ciLess(ids[i], ids[j]));
+}
+
+TEST_F(StringOpsTest, ci_hash)
+{
+    EXPECT_EQ(StringUtils::ciHash("Misc_Com_Bottle_01"), StringUtils::ciHash("misc_com_bottle_01"));
+    EXPECT_NE(StringUtils::ciHash("misc_com_bottle_01"), StringUtils::ciHash("misc_com_bottle_02"));
+    EXPECT_EQ(StringUtils::CiHash()("GOLD_001"), StringUtils::ciHash(std::string("gold_001")));
+    EXPECT_TRUE(StringUtils::CiEqual()("GOLD_001", "gold_001"));
+}
+
+TEST_F(StringOpsTest, ci_less_map_lookup)
+{
+    std::map<std::string, int, StringUtils::CiLess> map;
+    map["fargoth"] = 1;
+    map["Caius Cosades"] = 2;
+
+    EXPECT_EQ(1, map.find("FARGOTH")->second);
+    EXPECT_EQ(2, map.find("caius cosades")->second);
+    EXPECT_TRUE(map.find("fargot") == map.end());
+
+    map["Fargoth"] = 3;
+    EXPECT_EQ(2u, map.size());
+    EXPECT_EQ(3, map["fargoth"]);
+}
+
+TEST_F(StringOpsTest, DISABLED_benchmark_id_lookup)
+{
+    const int count = 10000;
+    const int lookups = 1000000;
+
+    std::vector<std::string> ids = makeIds(count);
+
+    std::map<std::string, int> lowerCaseMap;
+    std::map<std::string, int, StringUtils::CiLess> ciMap;
+    for (int i=0; i<count; ++i)
+    {
+        lowerCaseMap[StringUtils::lowerCase(ids[i])] = i;
+        ciMap[StringUtils::lowerCase(ids[i])] = i;
+    }
+
+    long found = 0;
+    TestSuite::BenchmarkTimer timer;
+    for (int i=0; i<lookups; ++i)
+        found += lowerCaseMap.find(StringUtils::lowerCase(ids[(i*7) % count]))->second;
+    double lowerCaseMilliseconds = timer.getMilliseconds();
+
+    timer.restart();
+    for (int i=0; i<lookups; ++i)
+        found -= ciMap.find(ids[(i*7) % count])->second;
+    double ciMilliseconds = timer.getMilliseconds();
+
+    TestSuite::reportBenchmark() << lookups << " lookups in " << count << " IDs: "
+                                 << lowerCaseMilliseconds << " ms with lowerCase, "
+                                 << ciMilliseconds << " ms with CiLess" << std::endl;
+
+    EXPECT_EQ(0, found);
+}
+
+TEST_F(StringOpsTest, DISABLED_benchmark_ci_equal)
+{
+    const int count = 1000;
+    const int rounds = 1000;
+
+    std::vector<std::string> ids = makeIds(count);
+    std::vector<std::string> lowerIds;
+    for (int i=0; i<count; ++i)
+        lowerIds.push_back(StringUtils::lowerCase(ids[i]));
+
+    int equal = 0;
+    TestSuite::BenchmarkTimer timer;
+    for (int round=0; round<rounds; ++round)
+        for (int i=0; i<count; ++i)
+            equal += StringUtils::ciEqual(ids[i], lowerIds[(i + round) % count]);
+
+    TestSuite::reportBenchmark() << count * rounds << " ciEqual calls: " << timer.getMilliseconds() << " ms" << std::endl;
+
+    // the IDs only line up in the first round
+    EXPECT_EQ(count, equal);
+}
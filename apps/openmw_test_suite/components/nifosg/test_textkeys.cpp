@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include "components/nifosg/textkeys.hpp"
+
+namespace
+{
+    NifOsg::TextKeyMap makeKeys()
+    {
+        NifOsg::TextKeyMap keys;
+        keys.insert(std::make_pair(0.f, "idle: start"));
+        keys.insert(std::make_pair(0.5f, "soundgen: left"));
+        keys.insert(std::make_pair(0.5f, "idle: loop start"));
+        keys.insert(std::make_pair(1.f, "soundgen: roar 0.5 1.5"));
+        keys.insert(std::make_pair(1.f, "sound: fabric up"));
+        keys.insert(std::make_pair(1.5f, "idle: stop."));
+        keys.insert(std::make_pair(2.f, "attack1: start"));
+        keys.insert(std::make_pair(2.5f, "attack1: hit"));
+        keys.insert(std::make_pair(2.5f, "spellcast: target release"));
+        keys.insert(std::make_pair(3.f, "attack1: stop"));
+        keys.insert(std::make_pair(3.f, "garbage"));
+        return keys;
+    }
+}
+
+TEST(TextKeyEventsTest, groups)
+{
+    NifOsg::TextKeyEvents events;
+    events.build(makeKeys());
+
+    ASSERT_EQ(11u, events.getEvents().size());
+    ASSERT_EQ(3u, events.getGroups().size());
+
+    EXPECT_EQ(0, events.findGroup("attack1"));
+    EXPECT_EQ(1, events.findGroup("idle"));
+    EXPECT_EQ(2, events.findGroup("spellcast"));
+    EXPECT_EQ(-1, events.findGroup("idle2"));
+    EXPECT_EQ(-1, events.findGroup("sound"));
+
+    const NifOsg::TextKeyEvents::Group& idle = events.getGroups()[1];
+    ASSERT_EQ(3u, idle.mEvents.size());
+    EXPECT_EQ(NifOsg::TextKeyEvent::Type_Start, events.getEvents()[idle.mEvents[0]].mType);
+    EXPECT_EQ(NifOsg::TextKeyEvent::Type_LoopStart, events.getEvents()[idle.mEvents[1]].mType);
+
+    const NifOsg::TextKeyEvent& stop = events.getEvents()[idle.mEvents[2]];
+    EXPECT_EQ(NifOsg::TextKeyEvent::Type_Other, stop.mType);
+    EXPECT_EQ("stop.", stop.mName);
+    EXPECT_EQ(1, stop.mGroup);
+    EXPECT_EQ(1.5f, stop.mTime);
+}
+
+TEST(TextKeyEventsTest, key_types)
+{
+    NifOsg::TextKeyEvents events;
+    events.build(makeKeys());
+    const std::vector<NifOsg::TextKeyEvent>& keys = events.getEvents();
+
+    // multimap order is kept for keys with the same time
+    EXPECT_EQ(NifOsg::TextKeyEvent::Type_SoundGen, keys[1].mType);
+    EXPECT_EQ("left", keys[1].mName);
+    EXPECT_TRUE(keys[1].mFootstep);
+    EXPECT_EQ(-1, keys[1].mGroup);
+
+    EXPECT_EQ(NifOsg::TextKeyEvent::Type_SoundGen, keys[3].mType);
+    EXPECT_EQ("roar", keys[3].mName);
+    EXPECT_FALSE(keys[3].mFootstep);
+    EXPECT_EQ(0.5f, keys[3].mVolume);
+    EXPECT_EQ(1.5f, keys[3].mPitch);
+
+    EXPECT_EQ(NifOsg::TextKeyEvent::Type_Sound, keys[4].mType);
+    EXPECT_EQ("fabric up", keys[4].mName);
+    EXPECT_EQ(1.f, keys[4].mVolume);
+
+    EXPECT_EQ(NifOsg::TextKeyEvent::Type_Hit, keys[7].mType);
+    EXPECT_EQ(NifOsg::TextKeyEvent::Type_Release, keys[8].mType);
+    EXPECT_EQ("target release", keys[8].mName);
+    EXPECT_EQ(NifOsg::TextKeyEvent::Type_Stop, keys[9].mType);
+
+    EXPECT_EQ(NifOsg::TextKeyEvent::Type_Unknown, keys[10].mType);
+    EXPECT_EQ(-1, keys[10].mGroup);
+}
+
+TEST(TextKeyEventsTest, time_bounds)
+{
+    NifOsg::TextKeyEvents events;
+    events.build(makeKeys());
+
+    EXPECT_EQ(0u, events.lowerBound(0.f));
+    EXPECT_EQ(1u, events.upperBound(0.f));
+    EXPECT_EQ(3u, events.lowerBound(1.f));
+    EXPECT_EQ(5u, events.upperBound(1.f));
+    EXPECT_EQ(11u, events.upperBound(3.f));
+
+    events.build(NifOsg::TextKeyMap());
+    EXPECT_TRUE(events.empty());
+    EXPECT_TRUE(events.getGroups().empty());
+    EXPECT_EQ(0u, events.lowerBound(1.f));
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <osg/Referenced>
+#include <osg/ref_ptr>
+
+#include "components/resource/objectcache.hpp"
+
+namespace
+{
+    struct TestResource : public osg::Referenced
+    {
+    };
+
+    typedef Resource::ObjectCache<int, TestResource> TestCache;
+
+    const size_t sMegabyte = 1024*1024;
+
+    osg::ref_ptr<TestResource> getResource(TestCache& cache, int id)
+    {
+        osg::ref_ptr<TestResource> resource = cache.get(id);
+        if (!resource)
+        {
+            resource = new TestResource;
+            cache.add(id, resource.get(), sMegabyte);
+        }
+        return resource;
+    }
+}
+
+TEST(ObjectCacheTest, keeps_used_objects)
+{
+    TestCache cache;
+    cache.setExpiryDelay(10.0);
+
+    osg::ref_ptr<TestResource> used = getResource(cache, 1);
+    getResource(cache, 2);
+    EXPECT_EQ(2u, cache.getStats().mMisses);
+
+    cache.update(5.0);
+    EXPECT_EQ(used.get(), cache.get(1));
+    EXPECT_EQ(1u, cache.getStats().mHits);
+    EXPECT_EQ(sMegabyte, cache.getStats().mUnusedCost);
+
+    cache.update(20.0);
+    EXPECT_EQ(1u, cache.getStats().mObjects);
+    EXPECT_EQ(1u, cache.getStats().mEvictions);
+    EXPECT_EQ(sMegabyte, cache.getStats().mCost);
+    EXPECT_EQ(NULL, cache.get(2));
+
+    // Unused from the last update on
+    used = NULL;
+    cache.update(25.0);
+    EXPECT_EQ(1u, cache.getStats().mObjects);
+    cache.update(40.0);
+    EXPECT_EQ(0u, cache.getStats().mObjects);
+    EXPECT_EQ(0u, cache.getStats().mCost);
+}
+
+TEST(ObjectCacheTest, budget_evicts_least_recently_used)
+{
+    TestCache cache;
+    cache.setExpiryDelay(1000.0);
+    cache.setBudget(2*sMegabyte);
+
+    for (int i=0; i<4; ++i)
+    {
+        getResource(cache, i);
+        cache.update(i);
+    }
+    EXPECT_EQ(2u, cache.getStats().mObjects);
+    EXPECT_TRUE(cache.get(2) != NULL);
+    EXPECT_TRUE(cache.get(3) != NULL);
+    EXPECT_EQ(2*sMegabyte, cache.getStats().mUnusedCost);
+}
+
+// Simulates the access pattern of walking through cells with resources of a fixed, made up cost.
+// The cost estimates of the real resource managers are not covered here.
+TEST(ObjectCacheTest, cost_bounded_while_touring_cells)
+{
+    const int numResources = 400;
+    const int resourcesPerCell = 30;
+    const size_t budget = 50*sMegabyte;
+
+    TestCache cache;
+    cache.setExpiryDelay(60.0);
+    cache.setBudget(budget);
+
+    double time = 0.0;
+    for (int cell=0; cell<200; ++cell)
+    {
+        // Neighbouring cells share most of their resources
+        std::vector<osg::ref_ptr<TestResource> > loaded;
+        for (int i=0; i<resourcesPerCell; ++i)
+            loaded.push_back(getResource(cache, (cell*5 + i) % numResources));
+
+        time += 1.0;
+        cache.update(time);
+        EXPECT_LE(cache.getStats().mUnusedCost, budget);
+        EXPECT_LE(cache.getStats().mCost, budget + resourcesPerCell*sMegabyte);
+
+        loaded.clear();
+        time += 10.0;
+        cache.update(time);
+        EXPECT_LE(cache.getStats().mCost, budget);
+    }
+
+    const Resource::CacheStats& stats = cache.getStats();
+    EXPECT_GT(stats.mHits, stats.mMisses);
+    EXPECT_GT(stats.mEvictions, 0u);
+    EXPECT_EQ(stats.mMisses - stats.mEvictions, stats.mObjects);
+}
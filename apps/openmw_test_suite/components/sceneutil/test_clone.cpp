@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+
+#include <set>
+#include <vector>
+
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/MatrixTransform>
+#include <osg/NodeCallback>
+#include <osg/NodeVisitor>
+
+#include "components/sceneutil/clone.hpp"
+
+#include "apps/openmw_test_suite/benchmark.hpp"
+
+namespace
+{
+    osg::ref_ptr<osg::Geode> createMesh(unsigned int vertices)
+    {
+        osg::ref_ptr<osg::Geometry> geometry (new osg::Geometry);
+        geometry->setVertexArray(new osg::Vec3Array(vertices));
+        geometry->setNormalArray(new osg::Vec3Array(vertices), osg::Array::BIND_PER_VERTEX);
+        geometry->addPrimitiveSet(new osg::DrawArrays(GL_TRIANGLES, 0, vertices));
+
+        osg::ref_ptr<osg::Geode> geode (new osg::Geode);
+        geode->addDrawable(geometry.get());
+        return geode;
+    }
+
+    /// Roughly the layout the NIF loader produces for a static building: transforms with one mesh each.
+    osg::ref_ptr<osg::Group> createBuilding(unsigned int parts)
+    {
+        osg::ref_ptr<osg::Group> root (new osg::Group);
+        for (unsigned int i=0; i<parts; ++i)
+        {
+            osg::ref_ptr<osg::MatrixTransform> trans (new osg::MatrixTransform(osg::Matrix::translate(i, 0, 0)));
+            trans->addChild(createMesh(300).get());
+            root->addChild(trans.get());
+        }
+        return root;
+    }
+
+    osg::Node* clone(const osg::Node* node)
+    {
+        return osg::clone(node, SceneUtil::CopyOp());
+    }
+
+    class CollectVisitor : public osg::NodeVisitor
+    {
+    public:
+        CollectVisitor()
+            : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
+        {
+        }
+
+        virtual void apply(osg::Node& node)
+        {
+            mObjects.insert(&node);
+            traverse(node);
+        }
+
+        virtual void apply(osg::Geode& geode)
+        {
+            mObjects.insert(&geode);
+            for (unsigned int i=0; i<geode.getNumDrawables(); ++i)
+                mObjects.insert(geode.getDrawable(i));
+        }
+
+        std::set<const osg::Object*> mObjects;
+    };
+
+    /// @return Number of nodes and drawables of \a instance that are not shared with \a original.
+    size_t countCopies(osg::Node* original, osg::Node* instance)
+    {
+        CollectVisitor originalObjects;
+        original->accept(originalObjects);
+        CollectVisitor instanceObjects;
+        instance->accept(instanceObjects);
+
+        size_t copies = 0;
+        for (std::set<const osg::Object*>::const_iterator it = instanceObjects.mObjects.begin(); it != instanceObjects.mObjects.end(); ++it)
+            if (!originalObjects.mObjects.count(*it))
+                ++copies;
+        return copies;
+    }
+}
+
+TEST(SceneUtilCloneTest, static_geodes_are_shared)
+{
+    osg::ref_ptr<osg::Group> original = createBuilding(2);
+    osg::ref_ptr<osg::Group> instance = clone(original.get())->asGroup();
+
+    ASSERT_EQ(2u, instance->getNumChildren());
+    for (unsigned int i=0; i<2; ++i)
+    {
+        osg::Group* originalTrans = original->getChild(i)->asGroup();
+        osg::Group* instanceTrans = instance->getChild(i)->asGroup();
+        EXPECT_NE(originalTrans, instanceTrans);
+        EXPECT_EQ(originalTrans->getChild(0), instanceTrans->getChild(0));
+        EXPECT_EQ(2u, originalTrans->getChild(0)->getNumParents());
+    }
+}
+
+TEST(SceneUtilCloneTest, mutable_geodes_are_copied)
+{
+    osg::ref_ptr<osg::Group> original (new osg::Group);
+
+    osg::ref_ptr<osg::Geode> animated = createMesh(3);
+    animated->addUpdateCallback(new osg::NodeCallback);
+    original->addChild(animated.get());
+
+    osg::ref_ptr<osg::Geode> dynamicState = createMesh(3);
+    dynamicState->getOrCreateStateSet()->setDataVariance(osg::Object::DYNAMIC);
+    original->addChild(dynamicState.get());
+
+    osg::ref_ptr<osg::Geode> animatedDrawable = createMesh(3);
+    animatedDrawable->getDrawable(0)->setUpdateCallback(new osg::Drawable::UpdateCallback);
+    original->addChild(animatedDrawable.get());
+
+    osg::ref_ptr<osg::Group> instance = clone(original.get())->asGroup();
+    ASSERT_EQ(3u, instance->getNumChildren());
+    for (unsigned int i=0; i<3; ++i)
+        EXPECT_NE(original->getChild(i), instance->getChild(i));
+    EXPECT_NE(dynamicState->getStateSet(), instance->getChild(1)->getStateSet());
+}
+
+TEST(SceneUtilCloneTest, DISABLED_benchmark_city_cell)
+{
+    // A city cell places a few hundred objects, many of them sharing the same handful of models
+    const unsigned int instances = 1000;
+    const unsigned int models = 20;
+    const unsigned int parts = 10;
+
+    std::vector<osg::ref_ptr<osg::Group> > templates;
+    for (unsigned int i=0; i<models; ++i)
+        templates.push_back(createBuilding(parts));
+
+    std::vector<osg::ref_ptr<osg::Node> > cloned;
+    cloned.reserve(instances);
+
+    TestSuite::BenchmarkTimer timer;
+    for (unsigned int i=0; i<instances; ++i)
+        cloned.push_back(clone(templates[i % models].get()));
+    double milliseconds = timer.getMilliseconds();
+
+    size_t copies = countCopies(templates[0].get(), cloned[0].get());
+    TestSuite::reportBenchmark() << instances << " instances of " << parts << " meshes: "
+                                 << milliseconds * 1000.0 / instances << " us and " << copies
+                                 << " copied objects per instance" << std::endl;
+
+    // the root and one transform per mesh
+    EXPECT_EQ(parts + 1, copies);
+}
@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include "apps/openmw/mwmechanics/hierarchicalpathgrid.hpp"
+
+#include <cstdlib>
+#include <map>
+
+#include <components/esm/loadcell.hpp>
+#include <components/esm/loadland.hpp>
+
+using MWMechanics::HierarchicalPathgrid;
+using MWMechanics::PathgridGraph;
+
+namespace
+{
+    const int sGridSize = 8;
+    const int sSpacing = ESM::Land::REAL_SIZE / sGridSize;
+
+    /// An exterior cell with a regular grid of pathgrid points, each connected to its four neighbours
+    struct TestCell
+    {
+        ESM::Cell mCell;
+        ESM::Pathgrid mPathgrid;
+        PathgridGraph mGraph;
+
+        TestCell(int x, int y, bool hasPathgrid)
+        {
+            mCell.mData.mFlags = 0;
+            mCell.mData.mX = x;
+            mCell.mData.mY = y;
+            mPathgrid.mData.mX = x;
+            mPathgrid.mData.mY = y;
+
+            if (hasPathgrid)
+            {
+                for (int j=0; j<sGridSize; ++j)
+                {
+                    for (int i=0; i<sGridSize; ++i)
+                    {
+                        mPathgrid.mPoints.push_back(ESM::Pathgrid::Point(sSpacing/2 + i * sSpacing, sSpacing/2 + j * sSpacing, 0));
+                        if (i > 0)
+                            connect(j * sGridSize + i, j * sGridSize + i - 1);
+                        if (j > 0)
+                            connect(j * sGridSize + i, (j-1) * sGridSize + i);
+                    }
+                }
+            }
+
+            mGraph.load(&mCell, &mPathgrid);
+        }
+
+        void connect(int a, int b)
+        {
+            ESM::Pathgrid::Edge edge;
+            edge.mV0 = a;
+            edge.mV1 = b;
+            mPathgrid.mEdges.push_back(edge);
+            edge.mV0 = b;
+            edge.mV1 = a;
+            mPathgrid.mEdges.push_back(edge);
+        }
+    };
+
+    osg::Vec3f cellCenter(int x, int y)
+    {
+        return osg::Vec3f((x + 0.5f) * ESM::Land::REAL_SIZE, (y + 0.5f) * ESM::Land::REAL_SIZE, 0.f);
+    }
+
+    bool isInCell(const ESM::Pathgrid::Point& point, int x, int y)
+    {
+        return point.mX >= x * ESM::Land::REAL_SIZE && point.mX < (x+1) * ESM::Land::REAL_SIZE
+                && point.mY >= y * ESM::Land::REAL_SIZE && point.mY < (y+1) * ESM::Land::REAL_SIZE;
+    }
+}
+
+struct HierarchicalPathgridTest : public ::testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+    }
+
+    virtual void TearDown()
+    {
+        for (std::map<std::pair<int, int>, TestCell*>::iterator it = mCells.begin(); it != mCells.end(); ++it)
+            delete it->second;
+    }
+
+    void addCell(int x, int y, bool hasPathgrid = true)
+    {
+        TestCell* cell = new TestCell(x, y, hasPathgrid);
+        mCells[std::make_pair(x, y)] = cell;
+        mPathgrid.addCell(x, y, &cell->mGraph);
+    }
+
+    void expectConnected(const std::list<ESM::Pathgrid::Point>& path)
+    {
+        ASSERT_FALSE(path.empty());
+        std::list<ESM::Pathgrid::Point>::const_iterator prev = path.begin();
+        for (std::list<ESM::Pathgrid::Point>::const_iterator it = ++path.begin(); it != path.end(); ++it, ++prev)
+        {
+            // neighbouring points of the same cell, or of adjacent cells
+            EXPECT_EQ(sSpacing, std::abs(it->mX - prev->mX) + std::abs(it->mY - prev->mY));
+        }
+    }
+
+    HierarchicalPathgrid mPathgrid;
+    std::map<std::pair<int, int>, TestCell*> mCells;
+};
+
+TEST_F(HierarchicalPathgridTest, path_within_one_cell)
+{
+    addCell(0, 0);
+
+    std::list<ESM::Pathgrid::Point> path = mPathgrid.findPath(osg::Vec3f(600, 600, 0), osg::Vec3f(7600, 600, 0));
+    expectConnected(path);
+    EXPECT_EQ(sSpacing/2, path.front().mX);
+    EXPECT_EQ(sSpacing/2 + 7 * sSpacing, path.back().mX);
+}
+
+TEST_F(HierarchicalPathgridTest, path_across_cells)
+{
+    addCell(0, 0);
+    addCell(1, 0);
+    addCell(2, 0);
+
+    std::list<ESM::Pathgrid::Point> path = mPathgrid.findPath(cellCenter(0, 0), cellCenter(2, 0));
+    expectConnected(path);
+    EXPECT_TRUE(isInCell(path.front(), 0, 0));
+    EXPECT_TRUE(isInCell(path.back(), 2, 0));
+}
+
+TEST_F(HierarchicalPathgridTest, path_around_cell_without_pathgrid)
+{
+    addCell(0, 0);
+    addCell(1, 0, false);
+    addCell(2, 0);
+    addCell(0, 1);
+    addCell(1, 1);
+    addCell(2, 1);
+
+    std::list<ESM::Pathgrid::Point> path = mPathgrid.findPath(cellCenter(0, 0), cellCenter(2, 0));
+    expectConnected(path);
+    EXPECT_TRUE(isInCell(path.front(), 0, 0));
+    EXPECT_TRUE(isInCell(path.back(), 2, 0));
+    for (std::list<ESM::Pathgrid::Point>::const_iterator it = path.begin(); it != path.end(); ++it)
+        EXPECT_FALSE(isInCell(*it, 1, 0)) << it->mX << " " << it->mY;
+}
+
+TEST_F(HierarchicalPathgridTest, no_path_through_cell_without_pathgrid)
+{
+    addCell(0, 0);
+    addCell(1, 0, false);
+    addCell(2, 0);
+
+    EXPECT_TRUE(mPathgrid.findPath(cellCenter(0, 0), cellCenter(2, 0)).empty());
+    EXPECT_TRUE(mPathgrid.findPath(cellCenter(0, 0), cellCenter(1, 0)).empty());
+}
+
+TEST_F(HierarchicalPathgridTest, removed_cells_are_not_searched)
+{
+    addCell(0, 0);
+    addCell(1, 0);
+    addCell(2, 0);
+    ASSERT_FALSE(mPathgrid.findPath(cellCenter(0, 0), cellCenter(2, 0)).empty());
+
+    mPathgrid.removeCell(1, 0);
+    EXPECT_TRUE(mPathgrid.findPath(cellCenter(0, 0), cellCenter(2, 0)).empty());
+    EXPECT_TRUE(mPathgrid.findPath(cellCenter(0, 0), cellCenter(1, 0)).empty());
+
+    // the neighbours link up with the cell again once it is reloaded
+    mPathgrid.addCell(1, 0, &mCells[std::make_pair(1, 0)]->mGraph);
+    expectConnected(mPathgrid.findPath(cellCenter(0, 0), cellCenter(2, 0)));
+}
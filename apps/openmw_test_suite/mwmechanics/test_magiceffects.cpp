@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+#include "apps/openmw/mwmechanics/magiceffects.hpp"
+#include "apps/openmw_test_suite/benchmark.hpp"
+
+#include <vector>
+
+#include <components/esm/loadmgef.hpp>
+#include <components/esm/loadskil.hpp>
+
+using MWMechanics::EffectKey;
+using MWMechanics::EffectParam;
+using MWMechanics::MagicEffects;
+
+struct MagicEffectsTest : public ::testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+    }
+
+    virtual void TearDown()
+    {
+    }
+};
+
+TEST_F(MagicEffectsTest, add_and_get)
+{
+    MagicEffects effects;
+    effects.add(EffectKey(ESM::MagicEffect::FortifySkill, ESM::Skill::Block), EffectParam(10));
+    effects.add(EffectKey(ESM::MagicEffect::FortifySkill, ESM::Skill::Block), EffectParam(5));
+    effects.add(EffectKey(ESM::MagicEffect::Shield), EffectParam(20));
+
+    EXPECT_EQ(15, effects.get(EffectKey(ESM::MagicEffect::FortifySkill, ESM::Skill::Block)).getMagnitude());
+    EXPECT_EQ(20, effects.get(EffectKey(ESM::MagicEffect::Shield)).getMagnitude());
+    EXPECT_EQ(0, effects.get(EffectKey(ESM::MagicEffect::FortifySkill, ESM::Skill::Armorer)).getMagnitude());
+    EXPECT_EQ(0, effects.get(EffectKey(ESM::MagicEffect::Light)).getMagnitude());
+}
+
+TEST_F(MagicEffectsTest, keys_outside_of_layout)
+{
+    // an argument on an effect that doesn't take one, and an effect ID beyond the vanilla ones
+    MagicEffects effects;
+    effects.add(EffectKey(ESM::MagicEffect::Shield, 3), EffectParam(7));
+    effects.add(EffectKey(ESM::MagicEffect::Length + 10), EffectParam(8));
+    effects.add(EffectKey(ESM::MagicEffect::Shield), EffectParam(1));
+
+    EXPECT_EQ(7, effects.get(EffectKey(ESM::MagicEffect::Shield, 3)).getMagnitude());
+    EXPECT_EQ(8, effects.get(EffectKey(ESM::MagicEffect::Length + 10)).getMagnitude());
+    EXPECT_EQ(1, effects.get(EffectKey(ESM::MagicEffect::Shield)).getMagnitude());
+
+    int count = 0;
+    for (MagicEffects::const_iterator it = effects.begin(); it != effects.end(); ++it)
+        ++count;
+    EXPECT_EQ(3, count);
+}
+
+TEST_F(MagicEffectsTest, iteration_in_key_order)
+{
+    MagicEffects effects;
+    effects.add(EffectKey(ESM::MagicEffect::Shield), EffectParam(1));
+    effects.add(EffectKey(ESM::MagicEffect::FortifyAttribute, 2), EffectParam(2));
+    effects.add(EffectKey(ESM::MagicEffect::FortifyAttribute, 0), EffectParam(3));
+    effects.add(EffectKey(ESM::MagicEffect::WaterWalking), EffectParam(4));
+
+    std::vector<EffectKey> keys;
+    for (MagicEffects::const_iterator it = effects.begin(); it != effects.end(); ++it)
+        keys.push_back(it->first);
+
+    ASSERT_EQ(4u, keys.size());
+    for (size_t i=1; i<keys.size(); ++i)
+        EXPECT_TRUE(keys[i-1] < keys[i]);
+}
+
+TEST_F(MagicEffectsTest, iteration_in_key_order_with_keys_outside_of_layout)
+{
+    MagicEffects effects;
+    effects.add(EffectKey(ESM::MagicEffect::Length + 10), EffectParam(1));
+    effects.add(EffectKey(ESM::MagicEffect::Shield), EffectParam(2));
+    effects.add(EffectKey(ESM::MagicEffect::Shield, 3), EffectParam(3));
+    effects.add(EffectKey(ESM::MagicEffect::FortifyAttribute, 2), EffectParam(4));
+    effects.add(EffectKey(ESM::MagicEffect::WaterWalking, 0), EffectParam(5));
+    effects.add(EffectKey(ESM::MagicEffect::WaterWalking), EffectParam(6));
+    effects.add(EffectKey(ESM::MagicEffect::FireDamage), EffectParam(7));
+
+    std::vector<EffectKey> keys;
+    for (MagicEffects::const_iterator it = effects.begin(); it != effects.end(); ++it)
+        keys.push_back(it->first);
+
+    ASSERT_EQ(7u, keys.size());
+    for (size_t i=1; i<keys.size(); ++i)
+        EXPECT_TRUE(keys[i-1] < keys[i]) << i;
+}
+
+TEST_F(MagicEffectsTest, remove_while_iterating)
+{
+    MagicEffects effects;
+    effects.add(EffectKey(ESM::MagicEffect::Shield), EffectParam(1));
+    effects.add(EffectKey(ESM::MagicEffect::FireDamage), EffectParam(2));
+    effects.add(EffectKey(ESM::MagicEffect::Shield, 5), EffectParam(3));
+
+    for (MagicEffects::const_iterator it = effects.begin(); it != effects.end();)
+    {
+        if (it->first.mId == ESM::MagicEffect::FireDamage || it->first.mArg == 5)
+            effects.remove((it++)->first);
+        else
+            ++it;
+    }
+
+    EXPECT_EQ(1, effects.get(EffectKey(ESM::MagicEffect::Shield)).getMagnitude());
+    EXPECT_EQ(0, effects.get(EffectKey(ESM::MagicEffect::FireDamage)).getMagnitude());
+    EXPECT_EQ(0, effects.get(EffectKey(ESM::MagicEffect::Shield, 5)).getMagnitude());
+    EXPECT_TRUE(++effects.begin() == effects.end());
+}
+
+TEST_F(MagicEffectsTest, diff)
+{
+    MagicEffects prev;
+    prev.add(EffectKey(ESM::MagicEffect::Shield), EffectParam(10));
+    prev.add(EffectKey(ESM::MagicEffect::Light), EffectParam(5));
+
+    MagicEffects now;
+    now.add(EffectKey(ESM::MagicEffect::Shield), EffectParam(4));
+    now.add(EffectKey(ESM::MagicEffect::Sanctuary), EffectParam(3));
+
+    MagicEffects result = MagicEffects::diff(prev, now);
+    EXPECT_EQ(-6, result.get(EffectKey(ESM::MagicEffect::Shield)).getMagnitude());
+    EXPECT_EQ(-5, result.get(EffectKey(ESM::MagicEffect::Light)).getMagnitude());
+    EXPECT_EQ(3, result.get(EffectKey(ESM::MagicEffect::Sanctuary)).getMagnitude());
+}
+
+TEST_F(MagicEffectsTest, set_modifiers_keeps_base)
+{
+    MagicEffects stats;
+    stats.modifyBase(EffectKey(ESM::MagicEffect::ResistFire), 20);
+    stats.add(EffectKey(ESM::MagicEffect::Light), EffectParam(5));
+
+    MagicEffects sources;
+    sources.add(EffectKey(ESM::MagicEffect::ResistFire), EffectParam(30));
+
+    stats.setModifiers(sources);
+    EXPECT_EQ(50, stats.get(EffectKey(ESM::MagicEffect::ResistFire)).getMagnitude());
+    EXPECT_EQ(20, stats.get(EffectKey(ESM::MagicEffect::ResistFire)).getBase());
+    EXPECT_EQ(0, stats.get(EffectKey(ESM::MagicEffect::Light)).getMagnitude());
+}
+
+namespace
+{
+    /// The effect sources of an actor, as combined by Actors::adjustMagicEffects every frame
+    struct BuffedActor
+    {
+        MagicEffects mSpells;
+        MagicEffects mEquipment;
+        MagicEffects mActiveSpells;
+        MagicEffects mStats;
+    };
+}
+
+TEST_F(MagicEffectsTest, DISABLED_benchmark_buffed_actors)
+{
+    const int actorCount = 100;
+    const int frames = 1000;
+
+    std::vector<BuffedActor> actors (actorCount);
+    for (int i=0; i<actorCount; ++i)
+    {
+        BuffedActor& actor = actors[i];
+
+        // racial abilities and a disease
+        for (int attribute=0; attribute<4; ++attribute)
+            actor.mSpells.add(EffectKey(ESM::MagicEffect::FortifyAttribute, attribute), EffectParam(5));
+        actor.mSpells.add(EffectKey(ESM::MagicEffect::ResistFire), EffectParam(50));
+        actor.mSpells.add(EffectKey(ESM::MagicEffect::DrainAttribute, (i % 8)), EffectParam(3));
+
+        // a heavily enchanted loadout with constant effects
+        for (int item=0; item<12; ++item)
+        {
+            actor.mEquipment.add(EffectKey(ESM::MagicEffect::FortifySkill, (item + i) % ESM::Skill::Length), EffectParam(10));
+            actor.mEquipment.add(EffectKey(ESM::MagicEffect::Shield), EffectParam(5));
+            actor.mEquipment.add(EffectKey(ESM::MagicEffect::ResistShock + item % 3), EffectParam(15));
+        }
+
+        // potions and buffs
+        for (int effect=0; effect<20; ++effect)
+            actor.mActiveSpells.add(EffectKey(ESM::MagicEffect::FortifyHealth + effect % 10), EffectParam(2));
+    }
+
+    TestSuite::BenchmarkTimer timer;
+
+    double total = 0;
+    for (int frame=0; frame<frames; ++frame)
+    {
+        for (std::vector<BuffedActor>::iterator actor = actors.begin(); actor != actors.end(); ++actor)
+        {
+            MagicEffects now = actor->mSpells;
+            now += actor->mEquipment;
+            now += actor->mActiveSpells;
+            actor->mStats.setModifiers(now);
+
+            for (MagicEffects::const_iterator it = actor->mStats.begin(); it != actor->mStats.end(); ++it)
+                total += it->second.getMagnitude();
+        }
+    }
+
+    TestSuite::reportBenchmark() << actorCount << " actors, " << frames << " frames: "
+                                 << timer.getMilliseconds() / frames << " ms per frame" << std::endl;
+
+    // 4*5 + 50 + 3 + 12*(10+5+15) + 20*2 per actor and frame
+    EXPECT_DOUBLE_EQ(473.0 * actorCount * frames, total);
+}
@@ -0,0 +1,574 @@
+#include <gtest/gtest.h>
+#include "apps/openmw/mwphysics/movementsolver.hpp"
+
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcher.h>
+#include <BulletCollision/CollisionDispatch/btCollisionObject.h>
+#include <BulletCollision/CollisionDispatch/btCollisionWorld.h>
+#include <BulletCollision/CollisionDispatch/btDefaultCollisionConfiguration.h>
+#include <BulletCollision/CollisionShapes/btBoxShape.h>
+#include <BulletCollision/CollisionShapes/btCylinderShape.h>
+
+#include <components/sceneutil/workqueue.hpp>
+
+#include "apps/openmw/mwphysics/actor.hpp"
+#include "apps/openmw/mwphysics/collisiontype.hpp"
+#include "apps/openmw/mwphysics/convert.hpp"
+#include "apps/openmw/mwphysics/simulationbuffer.hpp"
+#include "apps/openmw/mwphysics/stepper.hpp"
+
+using MWPhysics::MovementJob;
+
+namespace
+{
+    const int sNumActors = 8;
+    const osg::Vec3f sHalfExtents(20.f, 20.f, 64.f);
+
+    /// The code under test only compares Ptrs, so they do not need to point to actual references
+    MWWorld::Ptr makePtr(int id)
+    {
+        static char refs[16];
+        return MWWorld::Ptr(reinterpret_cast<MWWorld::LiveCellRefBase*>(&refs[id]));
+    }
+
+    class TestPtrHolder : public MWPhysics::PtrHolder
+    {
+    public:
+        TestPtrHolder(const MWWorld::Ptr& ptr)
+        {
+            mPtr = ptr;
+        }
+    };
+
+    /// One frame of a recorded movement queue: the frame duration and the movement of every actor
+    struct RecordedFrame
+    {
+        float mDuration;
+        std::vector<osg::Vec3f> mMovement;
+    };
+
+    /// State of an actor kept by the PhysicsSystem between frames
+    struct ActorState
+    {
+        osg::Vec3f mPosition;
+        osg::Vec3f mInertia;
+        bool mOnGround;
+    };
+
+    /// A floor, a platform to step up onto and a wall to run into, with one lane per actor.
+    /// The lanes are far enough apart that the actors do not collide with each other.
+    class TestWorld
+    {
+    public:
+        TestWorld()
+            : mDispatcher(&mConfiguration)
+            , mWorld(&mDispatcher, &mBroadphase, &mConfiguration)
+            , mFloorShape(btVector3(2000, 2000, 10))
+            , mPlatformShape(btVector3(275, 2000, 10))
+            , mWallShape(btVector3(10, 2000, 200))
+            , mActorShape(MWPhysics::toBullet(sHalfExtents))
+            , mFloorHolder(getFloorPtr())
+            , mPlatformHolder(getPlatformPtr())
+            , mWallHolder(getWallPtr())
+        {
+            addStatic(mFloor, mFloorShape, btVector3(0, 0, -10), mFloorHolder);
+            addStatic(mPlatform, mPlatformShape, btVector3(525, 0, 10), mPlatformHolder);
+            addStatic(mWall, mWallShape, btVector3(810, 0, 200), mWallHolder);
+
+            for (int i=0; i<sNumActors; ++i)
+            {
+                mActors[i].setCollisionShape(&mActorShape);
+                mActors[i].setCollisionFlags(btCollisionObject::CF_KINEMATIC_OBJECT);
+                mActors[i].setWorldTransform(btTransform(btQuaternion::getIdentity(),
+                                                         MWPhysics::toBullet(getStart(i) + osg::Vec3f(0, 0, sHalfExtents.z()))));
+                mRemoved[i] = false;
+                mWorld.addCollisionObject(&mActors[i], MWPhysics::CollisionType_Actor,
+                                          MWPhysics::CollisionType_World | MWPhysics::CollisionType_HeightMap
+                                          | MWPhysics::CollisionType_Actor | MWPhysics::CollisionType_Projectile);
+            }
+        }
+
+        ~TestWorld()
+        {
+            for (int i=0; i<sNumActors; ++i)
+            {
+                if (!mRemoved[i])
+                    mWorld.removeCollisionObject(&mActors[i]);
+            }
+            mWorld.removeCollisionObject(&mFloor);
+            mWorld.removeCollisionObject(&mPlatform);
+            mWorld.removeCollisionObject(&mWall);
+        }
+
+        static osg::Vec3f getStart(int actor)
+        {
+            return osg::Vec3f(0.f, actor * 400.f - 1400.f, 0.f);
+        }
+
+        static MWWorld::Ptr getActorPtr(int actor)
+        {
+            return makePtr(actor);
+        }
+
+        static MWWorld::Ptr getFloorPtr()
+        {
+            return makePtr(sNumActors);
+        }
+
+        static MWWorld::Ptr getPlatformPtr()
+        {
+            return makePtr(sNumActors + 1);
+        }
+
+        static MWWorld::Ptr getWallPtr()
+        {
+            return makePtr(sNumActors + 2);
+        }
+
+        void moveActor(int actor, const osg::Vec3f& position)
+        {
+            mActors[actor].getWorldTransform().setOrigin(
+                        MWPhysics::toBullet(position + osg::Vec3f(0, 0, sHalfExtents.z())));
+            mWorld.updateSingleAabb(&mActors[actor]);
+        }
+
+        btCollisionObject* getActor(int actor)
+        {
+            return &mActors[actor];
+        }
+
+        btCollisionWorld* getWorld()
+        {
+            return &mWorld;
+        }
+
+        void removeActor(int actor)
+        {
+            mWorld.removeCollisionObject(&mActors[actor]);
+            mRemoved[actor] = true;
+        }
+
+    private:
+        void addStatic(btCollisionObject& object, btCollisionShape& shape, const btVector3& position, TestPtrHolder& holder)
+        {
+            object.setCollisionShape(&shape);
+            object.setUserPointer(&holder);
+            object.setWorldTransform(btTransform(btQuaternion::getIdentity(), position));
+            mWorld.addCollisionObject(&object, MWPhysics::CollisionType_World,
+                                      MWPhysics::CollisionType_Actor | MWPhysics::CollisionType_HeightMap
+                                      | MWPhysics::CollisionType_Projectile);
+        }
+
+        btDefaultCollisionConfiguration mConfiguration;
+        btCollisionDispatcher mDispatcher;
+        btDbvtBroadphase mBroadphase;
+        btCollisionWorld mWorld;
+
+        btBoxShape mFloorShape;
+        btBoxShape mPlatformShape;
+        btBoxShape mWallShape;
+        btCylinderShapeZ mActorShape;
+
+        TestPtrHolder mFloorHolder;
+        TestPtrHolder mPlatformHolder;
+        TestPtrHolder mWallHolder;
+
+        btCollisionObject mFloor;
+        btCollisionObject mPlatform;
+        btCollisionObject mWall;
+        btCollisionObject mActors[sNumActors];
+        bool mRemoved[sNumActors];
+    };
+
+    /// Set up a job the way PhysicsSystem::prepareMovementJobs does, for actor \a actor in \a state.
+    MovementJob makeJob(TestWorld& world, int actor, const osg::Vec3f& movement, const ActorState& state)
+    {
+        MovementJob job;
+        job.mPtr = TestWorld::getActorPtr(actor);
+        job.mActor = NULL;
+        job.mMovement = movement;
+        for (int j=0; j<3; ++j)
+        {
+            job.mRefPosition.pos[j] = state.mPosition[j];
+            job.mRefPosition.rot[j] = 0.f;
+        }
+        job.mWaterLevel = -std::numeric_limits<float>::max();
+        job.mSlowFall = 1.f;
+        job.mIsFlying = false;
+        job.mIsMobile = true;
+        job.mIsPureWaterCreature = false;
+        job.mCollisionObject = world.getActor(actor);
+        job.mHalfExtents = sHalfExtents;
+        job.mCollisionMode = true;
+        job.mInertia = state.mInertia;
+        job.mOnGround = state.mOnGround;
+        job.mWalkingOnWater = false;
+        job.mPosition = job.mPreviousPosition = job.mReportedPosition = state.mPosition;
+        return job;
+    }
+
+    /// Replay \a recording through the movement solver, the way PhysicsSystem does with asynchronous
+    /// simulation: the frames are split into fixed steps, the queued movement of all actors is solved
+    /// for these steps and the results are written back before the next frame.
+    std::vector<ActorState> replay(const std::vector<RecordedFrame>& recording, int numThreads, int& totalSteps)
+    {
+        TestWorld world;
+        SceneUtil::WorkQueue workQueue(numThreads);
+        MWPhysics::FixedStepper stepper(1.f/60.f, 5);
+
+        MWPhysics::MovementGlobals globals;
+        globals.mSwimHeightScale = 0.9f;
+        globals.mStromWalkMult = 0.f;
+        globals.mInStorm = false;
+
+        std::vector<ActorState> actors(sNumActors);
+        for (int i=0; i<sNumActors; ++i)
+        {
+            actors[i].mPosition = TestWorld::getStart(i);
+            actors[i].mOnGround = true;
+        }
+
+        totalSteps = 0;
+        for (std::vector<RecordedFrame>::const_iterator frame = recording.begin(); frame != recording.end(); ++frame)
+        {
+            int steps = stepper.advance(frame->mDuration);
+            if (steps == 0)
+                continue;
+            totalSteps += steps;
+
+            std::vector<MovementJob> jobs;
+            for (int i=0; i<sNumActors; ++i)
+                jobs.push_back(makeJob(world, i, frame->mMovement[i], actors[i]));
+
+            MWPhysics::solveMovement(jobs, stepper.getStepLength(), steps, globals, world.getWorld(),
+                                     &workQueue, numThreads);
+
+            for (int i=0; i<sNumActors; ++i)
+            {
+                actors[i].mPosition = jobs[i].mPosition;
+                actors[i].mInertia = jobs[i].mInertia;
+                actors[i].mOnGround = jobs[i].mOnGround;
+                world.moveActor(i, actors[i].mPosition);
+            }
+        }
+        return actors;
+    }
+
+    /// Drives a SimulationBuffer frame by frame, the way PhysicsSystem does with asynchronous simulation.
+    class AsyncSimulation
+    {
+    public:
+        AsyncSimulation()
+            : mSimulationQueue(1)
+            , mStepper(1.f/60.f, 5)
+            , mPendingSteps(0)
+        {
+            mGlobals.mSwimHeightScale = 0.9f;
+            mGlobals.mStromWalkMult = 0.f;
+            mGlobals.mInStorm = false;
+
+            for (int i=0; i<sNumActors; ++i)
+            {
+                mActors[i].mPosition = TestWorld::getStart(i);
+                mActors[i].mOnGround = true;
+                mRemoved[i] = false;
+            }
+        }
+
+        /// Collect the results of the running simulation, like PhysicsSystem::waitForSimulation
+        void waitForSimulation()
+        {
+            if (!mBuffer.isRunning())
+                return;
+
+            mBuffer.wait();
+            mBuffer.complete();
+
+            const std::vector<MovementJob>& results = mBuffer.getResults();
+            for (std::vector<MovementJob>::const_iterator it = results.begin(); it != results.end(); ++it)
+            {
+                int actor = getActor(it->mPtr);
+                mActors[actor].mPosition = it->mPosition;
+                mActors[actor].mInertia = it->mInertia;
+                mActors[actor].mOnGround = it->mOnGround;
+                mWorld.moveActor(actor, it->mPosition);
+            }
+        }
+
+        /// Prepare the jobs for the steps due after \a duration seconds, like PhysicsSystem::applyQueuedMovement
+        void applyQueuedMovement(float duration, const osg::Vec3f& movement)
+        {
+            waitForSimulation();
+
+            mPendingSteps = mStepper.advance(duration);
+            if (mPendingSteps == 0)
+                return;
+
+            std::vector<MovementJob>& jobs = mBuffer.getJobs();
+            jobs.clear();
+            for (int i=0; i<sNumActors; ++i)
+            {
+                if (!mRemoved[i])
+                    jobs.push_back(makeJob(mWorld, i, movement, mActors[i]));
+            }
+        }
+
+        void startSimulation()
+        {
+            if (mPendingSteps == 0)
+                return;
+
+            mBuffer.start(&mSimulationQueue, mStepper.getStepLength(), mPendingSteps, mGlobals, mWorld.getWorld(), NULL, 0);
+            mPendingSteps = 0;
+        }
+
+        void frame(float duration, const osg::Vec3f& movement)
+        {
+            applyQueuedMovement(duration, movement);
+            startSimulation();
+        }
+
+        /// Remove \a actor from the scene, like PhysicsSystem::remove
+        void removeActor(int actor)
+        {
+            waitForSimulation();
+            mBuffer.remove(TestWorld::getActorPtr(actor));
+            mWorld.removeActor(actor);
+            mRemoved[actor] = true;
+        }
+
+        const ActorState& getActorState(int actor) const
+        {
+            return mActors[actor];
+        }
+
+        const MWPhysics::SimulationBuffer& getBuffer() const
+        {
+            return mBuffer;
+        }
+
+        std::vector<MovementJob> getResults()
+        {
+            return mBuffer.getResults();
+        }
+
+    private:
+        static int getActor(const MWWorld::Ptr& ptr)
+        {
+            for (int i=0; i<sNumActors; ++i)
+            {
+                if (TestWorld::getActorPtr(i) == ptr)
+                    return i;
+            }
+            throw std::runtime_error("unknown actor");
+        }
+
+        TestWorld mWorld;
+        SceneUtil::WorkQueue mSimulationQueue;
+        MWPhysics::FixedStepper mStepper;
+        MWPhysics::MovementGlobals mGlobals;
+        int mPendingSteps;
+        ActorState mActors[sNumActors];
+        bool mRemoved[sNumActors];
+
+        // declared last, so the simulation is finished before the world is destroyed
+        MWPhysics::SimulationBuffer mBuffer;
+    };
+
+    bool hasResult(const std::vector<MovementJob>& results, int actor)
+    {
+        for (std::vector<MovementJob>::const_iterator it = results.begin(); it != results.end(); ++it)
+        {
+            if (it->mPtr == TestWorld::getActorPtr(actor))
+                return true;
+        }
+        return false;
+    }
+
+    /// Split each frame of \a recording into \a parts frames of equal length.
+    std::vector<RecordedFrame> resample(const std::vector<RecordedFrame>& recording, int parts)
+    {
+        std::vector<RecordedFrame> result;
+        for (std::vector<RecordedFrame>::const_iterator it = recording.begin(); it != recording.end(); ++it)
+        {
+            for (int i=0; i<parts; ++i)
+            {
+                RecordedFrame frame = *it;
+                frame.mDuration /= parts;
+                result.push_back(frame);
+            }
+        }
+        return result;
+    }
+
+    void expectEqual(const std::vector<ActorState>& expected, const std::vector<ActorState>& actual)
+    {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t i=0; i<expected.size(); ++i)
+        {
+            for (int j=0; j<3; ++j)
+            {
+                EXPECT_EQ(expected[i].mPosition[j], actual[i].mPosition[j]) << "actor " << i;
+                EXPECT_EQ(expected[i].mInertia[j], actual[i].mInertia[j]) << "actor " << i;
+            }
+            EXPECT_EQ(expected[i].mOnGround, actual[i].mOnGround) << "actor " << i;
+        }
+    }
+}
+
+struct MovementSolverTest : public ::testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        // three seconds of movement at 30 fps: running towards the wall at different speeds,
+        // across the platform, with a jump after one second
+        for (int i=0; i<90; ++i)
+        {
+            RecordedFrame frame;
+            frame.mDuration = 1.f/30.f;
+            for (int actor=0; actor<sNumActors; ++actor)
+            {
+                osg::Vec3f movement(100.f + actor * 40.f, 0.f, 0.f);
+                if (i == 30 && actor % 2 == 0)
+                    movement.z() = 300.f;
+                frame.mMovement.push_back(movement);
+            }
+            mRecording.push_back(frame);
+        }
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    std::vector<RecordedFrame> mRecording;
+};
+
+TEST_F(MovementSolverTest, replay_is_deterministic)
+{
+    int steps1, steps2;
+    std::vector<ActorState> first = replay(mRecording, 0, steps1);
+    std::vector<ActorState> second = replay(mRecording, 0, steps2);
+
+    ASSERT_EQ(180, steps1);
+    ASSERT_EQ(steps1, steps2);
+    expectEqual(first, second);
+}
+
+TEST_F(MovementSolverTest, result_independent_of_thread_count)
+{
+    int steps0, steps1, steps3;
+    std::vector<ActorState> mainThread = replay(mRecording, 0, steps0);
+    std::vector<ActorState> oneThread = replay(mRecording, 1, steps1);
+    std::vector<ActorState> threeThreads = replay(mRecording, 3, steps3);
+
+    expectEqual(mainThread, oneThread);
+    expectEqual(mainThread, threeThreads);
+}
+
+TEST_F(MovementSolverTest, result_independent_of_frame_rate)
+{
+    int steps30, steps60, steps120;
+    std::vector<ActorState> at30 = replay(mRecording, 0, steps30);
+    std::vector<ActorState> at60 = replay(resample(mRecording, 2), 0, steps60);
+    std::vector<ActorState> at120 = replay(resample(mRecording, 4), 0, steps120);
+
+    ASSERT_EQ(steps30, steps60);
+    ASSERT_EQ(steps30, steps120);
+    expectEqual(at30, at60);
+    expectEqual(at30, at120);
+}
+
+TEST_F(MovementSolverTest, actors_collide_with_the_world)
+{
+    int steps;
+    std::vector<ActorState> actors = replay(mRecording, 0, steps);
+
+    for (int i=0; i<sNumActors; ++i)
+    {
+        // stepped up onto the platform, in front of the wall, and landed after jumping
+        EXPECT_NEAR(21.f, actors[i].mPosition.z(), 2.f) << "actor " << i;
+        EXPECT_GT(actors[i].mPosition.x(), 250.f) << "actor " << i;
+        EXPECT_LT(actors[i].mPosition.x(), 800.f - sHalfExtents.x()) << "actor " << i;
+        EXPECT_NEAR(TestWorld::getStart(i).y(), actors[i].mPosition.y(), 1.f) << "actor " << i;
+        EXPECT_TRUE(actors[i].mOnGround) << "actor " << i;
+    }
+}
+
+TEST(AsyncMovementSimulationTest, removed_actors_are_dropped_from_the_simulation)
+{
+    AsyncSimulation simulation;
+    const osg::Vec3f movement(300.f, 0.f, 0.f);
+
+    for (int i=0; i<10; ++i)
+        simulation.frame(1.f/30.f, movement);
+
+    // removed while its movement is being simulated
+    simulation.removeActor(2);
+    EXPECT_FALSE(hasResult(simulation.getResults(), 2));
+
+    // removed after its movement was prepared, but before the simulation started
+    simulation.applyQueuedMovement(1.f/30.f, movement);
+    simulation.removeActor(5);
+    simulation.startSimulation();
+
+    osg::Vec3f removedPosition = simulation.getActorState(5).mPosition;
+    for (int i=0; i<10; ++i)
+        simulation.frame(1.f/30.f, movement);
+    simulation.waitForSimulation();
+
+    std::vector<MovementJob> results = simulation.getResults();
+    EXPECT_EQ(static_cast<size_t>(sNumActors - 2), results.size());
+    EXPECT_FALSE(hasResult(results, 2));
+    EXPECT_FALSE(hasResult(results, 5));
+    EXPECT_EQ(removedPosition, simulation.getActorState(5).mPosition);
+
+    const MWPhysics::SimulationBuffer::CollisionMap& standing = simulation.getBuffer().getStandingCollisions();
+    EXPECT_EQ(0u, standing.count(TestWorld::getActorPtr(2)));
+    EXPECT_EQ(0u, standing.count(TestWorld::getActorPtr(5)));
+    EXPECT_EQ(1u, standing.count(TestWorld::getActorPtr(0)));
+    EXPECT_GT(simulation.getActorState(0).mPosition.x(), 100.f);
+}
+
+TEST(AsyncMovementSimulationTest, collisions_are_kept_until_the_next_simulation)
+{
+    AsyncSimulation simulation;
+
+    // run into the wall
+    for (int i=0; i<90; ++i)
+        simulation.frame(1.f/30.f, osg::Vec3f(600.f, 0.f, 0.f));
+    simulation.waitForSimulation();
+
+    const MWPhysics::SimulationBuffer::CollisionMap& collisions = simulation.getBuffer().getCollisions();
+    const MWPhysics::SimulationBuffer::CollisionMap& standing = simulation.getBuffer().getStandingCollisions();
+    for (int i=0; i<sNumActors; ++i)
+    {
+        MWPhysics::SimulationBuffer::CollisionMap::const_iterator found = collisions.find(TestWorld::getActorPtr(i));
+        ASSERT_TRUE(found != collisions.end()) << "actor " << i;
+        EXPECT_EQ(TestWorld::getWallPtr(), found->second) << "actor " << i;
+
+        found = standing.find(TestWorld::getActorPtr(i));
+        ASSERT_TRUE(found != standing.end()) << "actor " << i;
+        EXPECT_EQ(TestWorld::getPlatformPtr(), found->second) << "actor " << i;
+    }
+
+    // frames too short to simulate a step keep the collisions of the last simulation
+    for (int i=0; i<3; ++i)
+    {
+        simulation.frame(1.f/240.f, osg::Vec3f(-300.f, 0.f, 0.f));
+        simulation.waitForSimulation();
+        EXPECT_EQ(static_cast<size_t>(sNumActors), collisions.size());
+        EXPECT_EQ(static_cast<size_t>(sNumActors), standing.size());
+    }
+
+    // the next simulation replaces them
+    simulation.frame(1.f/240.f, osg::Vec3f(-300.f, 0.f, 0.f));
+    simulation.waitForSimulation();
+    EXPECT_TRUE(collisions.empty());
+    EXPECT_EQ(static_cast<size_t>(sNumActors), standing.size());
+}
@@ -0,0 +1,31 @@
+#include <gtest/gtest.h>
+#include "apps/openmw/mwphysics/stepper.hpp"
+
+TEST(FixedStepperTest, steps_independent_of_frame_rate)
+{
+    const int rates[] = { 24, 30, 60, 75, 120, 144 };
+    for (size_t i=0; i<sizeof(rates)/sizeof(rates[0]); ++i)
+    {
+        MWPhysics::FixedStepper stepper(1.f/60.f, 5);
+        int steps = 0;
+        for (int frame=0; frame<rates[i]; ++frame)
+            steps += stepper.advance(1.f/rates[i]);
+        EXPECT_EQ(60, steps) << rates[i] << " fps";
+    }
+}
+
+TEST(FixedStepperTest, interpolation_factor)
+{
+    MWPhysics::FixedStepper stepper(1.f/60.f, 5);
+    ASSERT_EQ(0, stepper.advance(1.f/240.f));
+    ASSERT_NEAR(0.25f, stepper.getInterpolationFactor(), 1e-4f);
+    ASSERT_EQ(1, stepper.advance(1.f/60.f));
+    ASSERT_NEAR(0.25f, stepper.getInterpolationFactor(), 1e-4f);
+}
+
+TEST(FixedStepperTest, max_steps)
+{
+    MWPhysics::FixedStepper stepper(1.f/60.f, 5);
+    ASSERT_EQ(5, stepper.advance(1.f));
+    ASSERT_EQ(0.f, stepper.getInterpolationFactor());
+}
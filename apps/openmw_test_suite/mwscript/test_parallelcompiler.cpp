@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include "apps/openmw/mwscript/parallelcompiler.hpp"
+#include "apps/openmw_test_suite/benchmark.hpp"
+
+#include <sstream>
+
+#include <components/compiler/context.hpp>
+#include <components/compiler/extensions.hpp>
+#include <components/compiler/extensions0.hpp>
+
+using MWScript::CompileJob;
+
+namespace
+{
+    class TestContext : public Compiler::Context
+    {
+        public:
+
+            virtual bool canDeclareLocals() const
+            {
+                return true;
+            }
+
+            virtual char getGlobalType (const std::string& name) const
+            {
+                return name=="gamehour" ? 'f' : ' ';
+            }
+
+            virtual std::pair<char, bool> getMemberType (const std::string& name, const std::string& id) const
+            {
+                return std::make_pair (id=="fargoth" && name=="state" ? 's' : ' ', true);
+            }
+
+            virtual bool isId (const std::string& name) const
+            {
+                return name=="fargoth" || name=="gold_001";
+            }
+
+            virtual bool isJournalId (const std::string& name) const
+            {
+                return name=="a1_1_findspymaster";
+            }
+    };
+
+    std::string makeScript (int index, int blocks)
+    {
+        std::ostringstream stream;
+        stream << "begin test_script_" << index << "\nshort state\nfloat timer\n";
+        for (int i=0; i<blocks; ++i)
+        {
+            stream
+                << "if ( state == " << i << " )\n"
+                << "    set timer to timer + GetSecondsPassed\n"
+                << "    if ( timer > " << i << " )\n"
+                << "        \"fargoth\"->AddItem gold_001 " << i << "\n"
+                << "        MessageBox \"Timer: %.2f\" timer\n"
+                << "        set state to fargoth.state + 1\n"
+                << "    endif\n"
+                << "    if ( GetJournalIndex a1_1_findspymaster >= 10 )\n"
+                << "        Journal a1_1_findspymaster 20\n"
+                << "    endif\n"
+                << "endif\n";
+        }
+
+        if (index%7==0)
+            stream << "set unknown to 1\n";
+        if (index%11==0)
+            stream << "if ( state ==\n";
+
+        stream << "end\n";
+        return stream.str();
+    }
+
+    struct ParallelCompilerTest : public ::testing::Test
+    {
+        Compiler::Extensions mExtensions;
+        TestContext mContext;
+        Compiler::Locals mLocals;
+
+        virtual void SetUp()
+        {
+            Compiler::registerExtensions (mExtensions);
+            mContext.setExtensions (&mExtensions);
+            mLocals.declare ('s', "state");
+        }
+
+        std::vector<CompileJob> makeJobs (int scripts, int blocks)
+        {
+            std::vector<CompileJob> jobs;
+            for (int i=0; i<scripts; ++i)
+            {
+                jobs.push_back (CompileJob ("test_script", makeScript (i, blocks)));
+
+                // dialogue result scripts, with the locals of the actor's script
+                jobs.push_back (CompileJob ("result", i%5==0 ? "set state to 1\nunknown\n" : "set state to state + 1\n",
+                    &mLocals));
+            }
+            return jobs;
+        }
+    };
+}
+
+TEST_F(ParallelCompilerTest, results_do_not_depend_on_threads)
+{
+    std::vector<CompileJob> sequential = makeJobs (100, 5);
+    std::vector<CompileJob> parallel = sequential;
+
+    EXPECT_EQ(1, MWScript::compileInParallel (sequential, mContext, 1, 0));
+    EXPECT_EQ(5, MWScript::compileInParallel (parallel, mContext, 1, 4));
+
+    int success = 0;
+    for (size_t i=0; i<sequential.size(); ++i)
+    {
+        EXPECT_EQ(sequential[i].mSuccess, parallel[i].mSuccess);
+        EXPECT_EQ(sequential[i].mMessages, parallel[i].mMessages);
+        EXPECT_TRUE(sequential[i].mCode == parallel[i].mCode);
+        EXPECT_EQ(sequential[i].mCompiledLocals.getType ("timer"), parallel[i].mCompiledLocals.getType ("timer"));
+        success += sequential[i].mSuccess;
+    }
+
+    // scripts 0, 11, 22, ... and results 0, 5, 10, ... fail, unknown variables are only a warning
+    EXPECT_EQ(200 - 10 - 20, success);
+
+    EXPECT_TRUE(sequential[0].mCode.empty());
+    EXPECT_NE(std::string::npos, sequential[0].mMessages.find ("unknown variable"));
+    EXPECT_FALSE(sequential[2].mCode.empty());
+    EXPECT_EQ('f', sequential[2].mCompiledLocals.getType ("timer"));
+    EXPECT_TRUE(sequential[3].mMessages.empty());
+}
+
+TEST_F(ParallelCompilerTest, no_jobs)
+{
+    std::vector<CompileJob> jobs;
+    EXPECT_EQ(1, MWScript::compileInParallel (jobs, mContext, 1, 4));
+    EXPECT_TRUE(jobs.empty());
+}
+
+TEST_F(ParallelCompilerTest, no_more_workers_than_jobs)
+{
+    std::vector<CompileJob> jobs = makeJobs (1, 1);
+    ASSERT_EQ(2u, jobs.size());
+    EXPECT_EQ(3, MWScript::compileInParallel (jobs, mContext, 1, 4));
+}
+
+TEST_F(ParallelCompilerTest, DISABLED_benchmark_compile_all)
+{
+    std::vector<CompileJob> sequential = makeJobs (500, 20);
+    std::vector<CompileJob> parallel = sequential;
+
+    TestSuite::BenchmarkTimer timer;
+    MWScript::compileInParallel (sequential, mContext, 1, 0);
+    double sequentialMilliseconds = timer.getMilliseconds();
+
+    timer.restart();
+    int threads = MWScript::compileInParallel (parallel, mContext, 1, MWScript::getCompilerThreads());
+    double parallelMilliseconds = timer.getMilliseconds();
+
+    TestSuite::reportBenchmark() << "compiling " << sequential.size() << " jobs: " << sequentialMilliseconds
+                                 << " ms on 1 thread, " << parallelMilliseconds << " ms on " << threads
+                                 << (threads > 1 ? " threads" : " thread") << std::endl;
+
+    for (size_t i=0; i<sequential.size(); ++i)
+        EXPECT_EQ(sequential[i].mMessages, parallel[i].mMessages);
+}
@@ -0,0 +1,253 @@
+#include <gtest/gtest.h>
+#include "apps/openmw/mwworld/chunkedlist.hpp"
+#include "apps/openmw_test_suite/benchmark.hpp"
+
+#include <list>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using MWWorld::ChunkedList;
+
+namespace
+{
+    /// Stand-in for a LiveCellRef: an ID, a position and some state
+    struct Ref
+    {
+        std::string mId;
+        float mPos[6];
+        int mCount;
+        char mState[160];
+
+        explicit Ref (const std::string& id = std::string(), int count = 1) : mId (id), mCount (count)
+        {
+            for (int i=0; i<6; ++i)
+                mPos[i] = static_cast<float> (i);
+        }
+    };
+
+    /// Throws when copied after a number of copies, to test exception safety
+    struct Fragile
+    {
+        static int sCopiesLeft;
+        static int sLive;
+
+        int mValue;
+
+        explicit Fragile (int value) : mValue (value) { ++sLive; }
+
+        Fragile (const Fragile& other) : mValue (other.mValue)
+        {
+            if (sCopiesLeft--==0)
+                throw std::runtime_error ("copy failed");
+            ++sLive;
+        }
+
+        ~Fragile() { --sLive; }
+    };
+
+    int Fragile::sCopiesLeft = 0;
+    int Fragile::sLive = 0;
+
+    std::string makeId (int type, int index)
+    {
+        std::ostringstream stream;
+        stream << "ex_vivec_reference_" << type << "_" << index;
+        return stream.str();
+    }
+
+    const int sRefTypes = 20;
+
+    /// References of all types in a cell, like the CellRefLists of a CellStore
+    template <class List>
+    struct Cell
+    {
+        List mLists[sRefTypes];
+
+        void load (int refs)
+        {
+            // References of different types are interleaved in content files
+            for (int i=0; i<refs; ++i)
+                mLists[(i * 7) % sRefTypes].push_back (Ref (makeId (i % sRefTypes, i)));
+        }
+
+        int forEach() const
+        {
+            int count = 0;
+            for (int type=0; type<sRefTypes; ++type)
+                for (typename List::const_iterator iter (mLists[type].begin()); iter!=mLists[type].end(); ++iter)
+                    if (iter->mCount>0)
+                        count += iter->mCount + static_cast<int> (iter->mPos[0]);
+            return count;
+        }
+    };
+
+    template <class List>
+    void benchmarkCells (const char *name, int cells, int refs, int iterations)
+    {
+        TestSuite::BenchmarkTimer timer;
+
+        std::vector<Cell<List>*> loaded;
+        for (int i=0; i<cells; ++i)
+        {
+            loaded.push_back (new Cell<List>);
+            loaded.back()->load (refs);
+        }
+
+        double loadMilliseconds = timer.getMilliseconds();
+
+        timer.restart();
+        int count = 0;
+        for (int i=0; i<iterations; ++i)
+            for (int cell=0; cell<cells; ++cell)
+                count += loaded[cell]->forEach();
+        double iterateMilliseconds = timer.getMilliseconds();
+
+        for (int i=0; i<cells; ++i)
+            delete loaded[i];
+
+        TestSuite::reportBenchmark() << name << ": loading " << cells << " cells of " << refs << " references: "
+                                     << loadMilliseconds << " ms, " << iterations << " forEach over all cells: "
+                                     << iterateMilliseconds << " ms" << std::endl;
+
+        EXPECT_EQ(iterations * cells * refs, count);
+    }
+}
+
+TEST(ChunkedListTest, push_back_and_iterate)
+{
+    ChunkedList<int> list;
+    EXPECT_TRUE(list.empty());
+    EXPECT_TRUE(list.begin() == list.end());
+
+    for (int i=0; i<1000; ++i)
+        list.push_back (i);
+
+    EXPECT_EQ(1000u, list.size());
+    EXPECT_EQ(0, list.front());
+    EXPECT_EQ(999, list.back());
+
+    int expected = 0;
+    for (ChunkedList<int>::const_iterator iter (list.begin()); iter!=list.end(); ++iter)
+        EXPECT_EQ(expected++, *iter);
+    EXPECT_EQ(1000, expected);
+
+    ChunkedList<int>::iterator iter = list.end();
+    for (int i=999; i>=0; --i)
+        EXPECT_EQ(i, *--iter);
+    EXPECT_TRUE(iter == list.begin());
+}
+
+TEST(ChunkedListTest, elements_and_end_are_stable)
+{
+    ChunkedList<Ref> list;
+    std::vector<Ref*> refs;
+    ChunkedList<Ref>::iterator end = list.end();
+
+    for (int i=0; i<500; ++i)
+    {
+        list.push_back (Ref (makeId (0, i)));
+        refs.push_back (&list.back());
+    }
+
+    EXPECT_TRUE(end == list.end());
+
+    int index = 0;
+    for (ChunkedList<Ref>::iterator iter (list.begin()); iter!=end; ++iter, ++index)
+    {
+        EXPECT_EQ(refs[index], &*iter);
+        EXPECT_EQ(makeId (0, index), iter->mId);
+    }
+    EXPECT_EQ(500, index);
+
+    // Iterators to the last element move on to elements inserted later, like with std::list
+    ChunkedList<Ref>::iterator last = --list.end();
+    list.push_back (Ref ("added"));
+    EXPECT_EQ("added", (++last)->mId);
+    EXPECT_TRUE(++last == list.end());
+}
+
+TEST(ChunkedListTest, grows_geometrically)
+{
+    ChunkedList<int> list;
+    list.push_back (0);
+    EXPECT_EQ(4u, list.capacity());
+
+    for (int i=1; i<10000; ++i)
+        list.push_back (i);
+    EXPECT_LT(list.capacity(), 10000u + 128u);
+
+    ChunkedList<int> reserved;
+    reserved.reserve (300);
+    EXPECT_EQ(0u, reserved.capacity());
+    reserved.push_back (0);
+    EXPECT_EQ(300u, reserved.capacity());
+}
+
+TEST(ChunkedListTest, copy)
+{
+    ChunkedList<Ref> list;
+    for (int i=0; i<100; ++i)
+        list.push_back (Ref (makeId (1, i), i));
+
+    ChunkedList<Ref> copy (list);
+    EXPECT_EQ(100u, copy.size());
+    EXPECT_EQ(100u, copy.capacity());
+    EXPECT_NE(&list.front(), &copy.front());
+
+    ChunkedList<Ref>::const_iterator iter = copy.begin();
+    for (ChunkedList<Ref>::const_iterator original = list.begin(); original!=list.end(); ++original, ++iter)
+    {
+        EXPECT_EQ(original->mId, iter->mId);
+        EXPECT_EQ(original->mCount, iter->mCount);
+    }
+    EXPECT_TRUE(iter == copy.end());
+
+    ChunkedList<Ref> assigned;
+    assigned.push_back (Ref ("replaced"));
+    assigned = list;
+    EXPECT_EQ(100u, assigned.size());
+    EXPECT_EQ(makeId (1, 0), assigned.front().mId);
+
+    assigned = assigned;
+    EXPECT_EQ(100u, assigned.size());
+
+    assigned.clear();
+    EXPECT_TRUE(assigned.empty());
+    EXPECT_TRUE(assigned.begin() == assigned.end());
+}
+
+TEST(ChunkedListTest, copy_failure)
+{
+    {
+        ChunkedList<Fragile> list;
+        Fragile value (1);
+
+        // the fifth copy needs a new chunk
+        Fragile::sCopiesLeft = 4;
+        for (int i=0; i<4; ++i)
+            list.push_back (value);
+        EXPECT_THROW(list.push_back (value), std::runtime_error);
+        EXPECT_EQ(4u, list.size());
+        EXPECT_EQ(4u, list.capacity());
+
+        Fragile::sCopiesLeft = 1;
+        list.push_back (value);
+        EXPECT_EQ(5u, list.size());
+        EXPECT_EQ(6, Fragile::sLive);
+
+        // the copies made before the failure are destroyed again
+        Fragile::sCopiesLeft = 3;
+        EXPECT_THROW(ChunkedList<Fragile> copy (list), std::runtime_error);
+        EXPECT_EQ(6, Fragile::sLive);
+    }
+    EXPECT_EQ(0, Fragile::sLive);
+}
+
+TEST(ChunkedListTest, DISABLED_benchmark_cell_iteration)
+{
+    // A cell the size of Vivec's cantons, with all 20 reference types
+    benchmarkCells<std::list<Ref> > ("std::list", 50, 2000, 20);
+    benchmarkCells<ChunkedList<Ref> > ("ChunkedList", 50, 2000, 20);
+}
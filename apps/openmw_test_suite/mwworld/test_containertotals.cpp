@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "apps/openmw/mwworld/containertotals.hpp"
+
+using MWWorld::ContainerTotals;
+
+namespace
+{
+    const int sPotion = 0;
+    const int sWeapon = 11;
+}
+
+struct ContainerTotalsTest : public ::testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        mTotals.reset();
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    ContainerTotals mTotals;
+};
+
+TEST_F(ContainerTotalsTest, stale_until_counted)
+{
+    ContainerTotals totals;
+    EXPECT_FALSE(totals.isUpToDate());
+    totals.reset();
+    EXPECT_TRUE(totals.isUpToDate());
+    EXPECT_EQ(0.f, totals.getWeight());
+    EXPECT_EQ(0, totals.getTypesInUse());
+}
+
+TEST_F(ContainerTotalsTest, count_changes_are_applied_incrementally)
+{
+    mTotals.countChanged(sPotion, 0.5f, 0, 4);
+    mTotals.countChanged(sWeapon, 10.f, 0, 1);
+    EXPECT_FLOAT_EQ(12.f, mTotals.getWeight());
+    EXPECT_EQ((1 << sPotion) | (1 << sWeapon), mTotals.getTypesInUse());
+
+    mTotals.countChanged(sPotion, 0.5f, 4, 2);
+    EXPECT_FLOAT_EQ(11.f, mTotals.getWeight());
+    EXPECT_EQ((1 << sPotion) | (1 << sWeapon), mTotals.getTypesInUse());
+
+    mTotals.countChanged(sWeapon, 10.f, 1, 0);
+    EXPECT_FLOAT_EQ(1.f, mTotals.getWeight());
+    EXPECT_EQ(1 << sPotion, mTotals.getTypesInUse());
+}
+
+TEST_F(ContainerTotalsTest, type_stays_in_use_while_any_stack_is_left)
+{
+    mTotals.countChanged(sPotion, 0.5f, 0, 1);
+    mTotals.countChanged(sPotion, 1.f, 0, 1);
+    mTotals.countChanged(sPotion, 0.5f, 1, 0);
+    EXPECT_EQ(1 << sPotion, mTotals.getTypesInUse());
+
+    mTotals.countChanged(sPotion, 1.f, 1, 0);
+    EXPECT_EQ(0, mTotals.getTypesInUse());
+}
+
+TEST_F(ContainerTotalsTest, invalidated_totals_ignore_count_changes)
+{
+    mTotals.countChanged(sPotion, 0.5f, 0, 4);
+    mTotals.invalidate();
+    EXPECT_FALSE(mTotals.isUpToDate());
+
+    // e.g. items inserted directly while loading a saved state
+    mTotals.countChanged(sWeapon, 10.f, 0, 1);
+
+    // recount from scratch, as ContainerStore does on the next query
+    mTotals.reset();
+    mTotals.countChanged(sPotion, 0.5f, 0, 4);
+    mTotals.countChanged(sWeapon, 10.f, 0, 1);
+    EXPECT_TRUE(mTotals.isUpToDate());
+    EXPECT_FLOAT_EQ(12.f, mTotals.getWeight());
+    EXPECT_EQ((1 << sPotion) | (1 << sWeapon), mTotals.getTypesInUse());
+}
+
+TEST_F(ContainerTotalsTest, empty_container_has_no_weight)
+{
+    for (int i=0; i<1000; ++i)
+    {
+        mTotals.countChanged(sPotion, 0.1f, 0, 3);
+        mTotals.countChanged(sWeapon, 0.7f, 0, 1);
+        mTotals.countChanged(sPotion, 0.1f, 3, 0);
+        mTotals.countChanged(sWeapon, 0.7f, 1, 0);
+    }
+
+    EXPECT_EQ(0.f, mTotals.getWeight());
+    EXPECT_EQ(0, mTotals.getTypesInUse());
+}
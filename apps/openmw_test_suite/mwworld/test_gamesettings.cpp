@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include "apps/openmw/mwworld/gamesettings.hpp"
+#include "apps/openmw/mwworld/store.hpp"
+#include "apps/openmw_test_suite/benchmark.hpp"
+
+#include <stdexcept>
+
+#include <components/esm/loadgmst.hpp>
+#include <components/misc/stringops.hpp>
+
+using MWWorld::GameSettings;
+
+namespace
+{
+    void insertFloat(MWWorld::Store<ESM::GameSetting>& store, const std::string& id, float value)
+    {
+        ESM::GameSetting setting;
+        setting.mId = id;
+        setting.mValue.setType(ESM::VT_Float);
+        setting.mValue.setFloat(value);
+        store.insertStatic(setting);
+    }
+
+    void insertInt(MWWorld::Store<ESM::GameSetting>& store, const std::string& id, int value)
+    {
+        ESM::GameSetting setting;
+        setting.mId = id;
+        setting.mValue.setType(ESM::VT_Int);
+        setting.mValue.setInteger(value);
+        store.insertStatic(setting);
+    }
+
+    // The settings read by MWMechanics::blockMeleeAttack and applyFatigueLoss
+    const GameSettings::Float sCombatFloats[] = {
+        GameSettings::fCombatBlockLeftAngle, GameSettings::fCombatBlockRightAngle,
+        GameSettings::fSwingBlockMult, GameSettings::fSwingBlockBase, GameSettings::fBlockStillBonus,
+        GameSettings::fFatigueBlockBase, GameSettings::fFatigueBlockMult, GameSettings::fWeaponFatigueBlockMult,
+        GameSettings::fFatigueAttackBase, GameSettings::fFatigueAttackMult, GameSettings::fWeaponFatigueMult
+    };
+    const int sCombatFloatCount = sizeof(sCombatFloats) / sizeof(sCombatFloats[0]);
+}
+
+struct GameSettingsTest : public ::testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        // Ids in content files are not necessarily in the same case
+        for (int i=0; i<GameSettings::Float_Count; ++i)
+            insertFloat(mStore, Misc::StringUtils::lowerCase(GameSettings::getName(GameSettings::Float(i))), i + 0.5f);
+        for (int i=0; i<GameSettings::Int_Count; ++i)
+            insertInt(mStore, GameSettings::getName(GameSettings::Int(i)), i);
+        mStore.setUp();
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    MWWorld::Store<ESM::GameSetting> mStore;
+};
+
+TEST_F(GameSettingsTest, values_by_enum)
+{
+    GameSettings settings;
+    settings.setUp(mStore);
+
+    for (int i=0; i<GameSettings::Float_Count; ++i)
+        EXPECT_EQ(i + 0.5f, settings.get(GameSettings::Float(i)));
+    for (int i=0; i<GameSettings::Int_Count; ++i)
+        EXPECT_EQ(i, settings.get(GameSettings::Int(i)));
+
+    EXPECT_EQ(mStore.find("fCombatKODamageMult")->getFloat(), settings.get(GameSettings::fCombatKODamageMult));
+    EXPECT_EQ(mStore.find("iLevelUpTotal")->getInt(), settings.get(GameSettings::iLevelUpTotal));
+}
+
+TEST_F(GameSettingsTest, missing_setting_throws_on_use)
+{
+    MWWorld::Store<ESM::GameSetting> empty;
+    GameSettings settings;
+    settings.setUp(empty);
+
+    EXPECT_THROW(settings.get(GameSettings::fAlarmRadius), std::runtime_error);
+    EXPECT_THROW(settings.get(GameSettings::iLevelUpTotal), std::runtime_error);
+}
+
+TEST_F(GameSettingsTest, refreshed_by_set_up)
+{
+    GameSettings settings;
+    settings.setUp(mStore);
+
+    insertFloat(mStore, "fAlarmRadius", 2000.f);
+    EXPECT_EQ(GameSettings::fAlarmRadius + 0.5f, settings.get(GameSettings::fAlarmRadius));
+
+    settings.setUp(mStore);
+    EXPECT_EQ(2000.f, settings.get(GameSettings::fAlarmRadius));
+}
+
+TEST_F(GameSettingsTest, DISABLED_benchmark_combat_frames)
+{
+    // actors exchanging blows every frame
+    const int actorCount = 50;
+    const int frames = 1000;
+
+    GameSettings settings;
+    settings.setUp(mStore);
+
+    TestSuite::BenchmarkTimer timer;
+    double byName = 0;
+    for (int frame=0; frame<frames; ++frame)
+        for (int actor=0; actor<actorCount; ++actor)
+            for (int i=0; i<sCombatFloatCount; ++i)
+                byName += mStore.find(GameSettings::getName(sCombatFloats[i]))->getFloat();
+    double nameMilliseconds = timer.getMilliseconds();
+
+    timer.restart();
+    double byEnum = 0;
+    for (int frame=0; frame<frames; ++frame)
+        for (int actor=0; actor<actorCount; ++actor)
+            for (int i=0; i<sCombatFloatCount; ++i)
+                byEnum += settings.get(sCombatFloats[i]);
+    double enumMilliseconds = timer.getMilliseconds();
+
+    TestSuite::reportBenchmark() << actorCount << " actors, " << frames << " frames: "
+                                 << nameMilliseconds / frames << " ms per frame by name, "
+                                 << enumMilliseconds / frames << " ms per frame by enum" << std::endl;
+
+    EXPECT_DOUBLE_EQ(byName, byEnum);
+}
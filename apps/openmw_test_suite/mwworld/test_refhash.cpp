@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include "apps/openmw/mwworld/refhash.hpp"
+
+#include <list>
+
+#include <components/esm/cellref.hpp>
+
+namespace
+{
+    struct Base
+    {
+    };
+
+    /// Stand-in for the RefData of a LiveCellRef
+    struct Data
+    {
+        bool mEnabled;
+        int mCount;
+        ESM::Position mPosition;
+
+        Data() : mEnabled(true), mCount(1)
+        {
+            for (int i=0; i<3; ++i)
+            {
+                mPosition.pos[i] = 0;
+                mPosition.rot[i] = 0;
+            }
+        }
+
+        bool isEnabled() const { return mEnabled; }
+        bool isDeleted() const { return mCount == 0; }
+        int getCount() const { return mCount; }
+        const ESM::Position& getPosition() const { return mPosition; }
+    };
+
+    /// Stand-in for the CellRef of a LiveCellRef
+    struct Ref
+    {
+        ESM::RefNum mRefNum;
+
+        const ESM::RefNum& getRefNum() const { return mRefNum; }
+    };
+
+    struct LiveRef
+    {
+        const Base* mBase;
+        Ref mRef;
+        Data mData;
+    };
+
+    struct RefList
+    {
+        typedef std::list<LiveRef> List;
+        List mList;
+    };
+
+    size_t hash(const RefList& list)
+    {
+        size_t seed = 0;
+        MWWorld::hashRefs(seed, list);
+        return seed;
+    }
+}
+
+struct RefHashTest : public ::testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        for (int i=0; i<3; ++i)
+        {
+            LiveRef ref;
+            ref.mBase = &mBase;
+            ref.mRef.mRefNum.mIndex = i;
+            ref.mRef.mRefNum.mContentFile = 0;
+            mList.mList.push_back(ref);
+        }
+        mInitial = hash(mList);
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    LiveRef& getRef()
+    {
+        return *++mList.mList.begin();
+    }
+
+    Base mBase;
+    RefList mList;
+    size_t mInitial;
+};
+
+TEST_F(RefHashTest, unchanged_state_keeps_hash)
+{
+    EXPECT_EQ(mInitial, hash(mList));
+}
+
+TEST_F(RefHashTest, enable_and_disable_change_hash)
+{
+    getRef().mData.mEnabled = false;
+    size_t disabled = hash(mList);
+    EXPECT_NE(mInitial, disabled);
+
+    getRef().mData.mEnabled = true;
+    EXPECT_EQ(mInitial, hash(mList));
+}
+
+TEST_F(RefHashTest, position_changes_hash)
+{
+    getRef().mData.mPosition.pos[2] = 10;
+    EXPECT_NE(mInitial, hash(mList));
+
+    getRef().mData.mPosition.pos[2] = 0;
+    getRef().mData.mPosition.rot[1] = 0.5f;
+    EXPECT_NE(mInitial, hash(mList));
+}
+
+TEST_F(RefHashTest, count_changes_hash)
+{
+    getRef().mData.mCount = 5;
+    EXPECT_NE(mInitial, hash(mList));
+
+    getRef().mData.mCount = 0;
+    EXPECT_NE(mInitial, hash(mList));
+}
@@ -0,0 +1,186 @@
+#include "bsa_writer.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <components/misc/stringops.hpp>
+
+namespace
+{
+    struct DirectoryEntry
+    {
+        Bsa::BSAWriter::Hash mHash;
+        uint32_t mSize;
+        uint32_t mOffset; // into the data buffer
+        uint32_t mNameOffset; // into the name buffer
+    };
+
+    bool operator< (const DirectoryEntry &left, const DirectoryEntry &right)
+    {
+        return left.mHash < right.mHash;
+    }
+
+    void writeInt(std::ostream &stream, uint32_t value)
+    {
+        stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+}
+
+namespace Bsa
+{
+
+void BSAWriter::addFile(const std::string &name, const std::string &source)
+{
+    std::string normalized = normalizeName(name);
+    if (normalized.empty())
+        throw std::runtime_error("BSA Error: Invalid file name: " + name);
+
+    if (!mNames.insert(normalized).second)
+        throw std::runtime_error("BSA Error: Duplicate file name: " + name);
+
+    Entry entry;
+    entry.mName = normalized;
+    entry.mSource = source;
+    mEntries.push_back(entry);
+}
+
+void BSAWriter::write(const std::string &file) const
+{
+    // See BSAFile::readHeader for the layout
+    namespace bfs = boost::filesystem;
+
+    std::vector<DirectoryEntry> directory (mEntries.size());
+
+    uint64_t dataSize = 0;
+    uint32_t nameSize = 0;
+    for (size_t i=0; i<mEntries.size(); ++i)
+    {
+        uintmax_t size = bfs::file_size(bfs::path(mEntries[i].mSource));
+        if (dataSize + size > 0xffffffffu)
+            throw std::runtime_error("BSA Error: Too much data for one archive: " + file);
+
+        DirectoryEntry &entry = directory[i];
+        entry.mHash = getHash(mEntries[i].mName);
+        entry.mSize = static_cast<uint32_t>(size);
+        entry.mOffset = static_cast<uint32_t>(dataSize);
+        entry.mNameOffset = nameSize;
+
+        dataSize += size;
+        nameSize += static_cast<uint32_t>(mEntries[i].mName.size()) + 1;
+    }
+
+    // The index into mEntries is still needed for the names
+    std::vector<std::pair<DirectoryEntry, size_t> > sorted;
+    sorted.reserve(directory.size());
+    for (size_t i=0; i<directory.size(); ++i)
+        sorted.push_back(std::make_pair(directory[i], i));
+    std::sort(sorted.begin(), sorted.end());
+
+    uint32_t fileCount = static_cast<uint32_t>(mEntries.size());
+
+    bfs::ofstream stream (bfs::path(file), std::ios_base::binary);
+    if (!stream.is_open())
+        throw std::runtime_error("BSA Error: Unable to create archive: " + file);
+
+    writeInt(stream, 0x100);
+    writeInt(stream, 12*fileCount + nameSize);
+    writeInt(stream, fileCount);
+
+    for (size_t i=0; i<sorted.size(); ++i)
+    {
+        writeInt(stream, sorted[i].first.mSize);
+        writeInt(stream, sorted[i].first.mOffset);
+    }
+
+    // Names are stored in directory order as well
+    uint32_t nameOffset = 0;
+    for (size_t i=0; i<sorted.size(); ++i)
+    {
+        writeInt(stream, nameOffset);
+        nameOffset += static_cast<uint32_t>(mEntries[sorted[i].second].mName.size()) + 1;
+    }
+
+    for (size_t i=0; i<sorted.size(); ++i)
+    {
+        const std::string &name = mEntries[sorted[i].second].mName;
+        stream.write(name.c_str(), name.size()+1);
+    }
+
+    for (size_t i=0; i<sorted.size(); ++i)
+    {
+        writeInt(stream, sorted[i].first.mHash.first);
+        writeInt(stream, sorted[i].first.mHash.second);
+    }
+
+    std::vector<char> buffer (64*1024);
+    for (size_t i=0; i<mEntries.size(); ++i)
+    {
+        bfs::ifstream source (bfs::path(mEntries[i].mSource), std::ios_base::binary);
+        if (!source.is_open())
+            throw std::runtime_error("BSA Error: Unable to open " + mEntries[i].mSource);
+
+        uint32_t remaining = directory[i].mSize;
+        while (remaining > 0)
+        {
+            std::streamsize chunk = std::min(remaining, static_cast<uint32_t>(buffer.size()));
+            source.read(&buffer[0], chunk);
+            if (source.gcount() != chunk)
+                throw std::runtime_error("BSA Error: Unable to read " + mEntries[i].mSource);
+            stream.write(&buffer[0], chunk);
+            remaining -= static_cast<uint32_t>(chunk);
+        }
+    }
+
+    stream.close();
+    if (stream.fail())
+        throw std::runtime_error("BSA Error: Unable to write archive: " + file);
+}
+
+std::string BSAWriter::normalizeName(const std::string &name)
+{
+    std::string normalized = Misc::StringUtils::lowerCase(name);
+    std::replace(normalized.begin(), normalized.end(), '/', '\\');
+
+    size_t start = normalized.find_first_not_of('\\');
+    if (start == std::string::npos)
+        return std::string();
+    return normalized.substr(start);
+}
+
+BSAWriter::Hash BSAWriter::getHash(const std::string &name)
+{
+    // The characters are sign extended, like in the original engine
+    size_t half = name.size() / 2;
+    size_t i = 0;
+
+    uint32_t low = 0;
+    unsigned int shift = 0;
+    for (; i<half; ++i)
+    {
+        low ^= static_cast<uint32_t>(static_cast<signed char>(name[i])) << (shift & 0x1f);
+        shift += 8;
+    }
+
+    uint32_t high = 0;
+    shift = 0;
+    for (; i<name.size(); ++i)
+    {
+        uint32_t temp = static_cast<uint32_t>(static_cast<signed char>(name[i])) << (shift & 0x1f);
+        high ^= temp;
+
+        // rotate right
+        unsigned int rotate = temp & 0x1f;
+        if (rotate)
+            high = (high >> rotate) | (high << (32 - rotate));
+
+        shift += 8;
+    }
+
+    return Hash(low, high);
+}
+
+}
@@ -0,0 +1,59 @@
+#ifndef BSA_BSA_WRITER_H
+#define BSA_BSA_WRITER_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <set>
+#include <utility>
+
+namespace Bsa
+{
+
+/**
+   This class is used to write "Bethesda Archive Files" in the format read by BSAFile.
+
+   The directory is sorted by name hash, as the original engine expects, but the file data is
+   stored in the order the files were added. That way, files that are used together can be
+   placed next to each other on disk.
+ */
+class BSAWriter
+{
+public:
+    /// Name hash, stored as two ints in the hash table block
+    typedef std::pair<uint32_t, uint32_t> Hash;
+
+    /// Add a file to the archive. The data is only read from \a source when the archive is written.
+    /// \param name Path of the file inside the archive. It is stored lower-cased, with backslashes as separators.
+    void addFile(const std::string &name, const std::string &source);
+
+    /// Number of files added so far
+    size_t getFileCount() const
+    { return mEntries.size(); }
+
+    /// Write the archive. Throws an exception on failure.
+    void write(const std::string &file) const;
+
+    /// Convert \a name to the form it is stored in an archive
+    static std::string normalizeName(const std::string &name);
+
+    /// Get the hash the original engine uses to look up files, of a name in archive form
+    static Hash getHash(const std::string &name);
+
+private:
+    struct Entry
+    {
+        std::string mName;
+        std::string mSource;
+    };
+
+    /// Files in data order
+    std::vector<Entry> mEntries;
+
+    /// Used to reject duplicates
+    std::set<std::string> mNames;
+};
+
+}
+
+#endif
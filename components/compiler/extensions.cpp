@@ -1,61 +1,115 @@
 
 #include "extensions.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <stdexcept>
 
+#include <components/misc/stringops.hpp>
+
 #include "generator.hpp"
 #include "literals.hpp"
 
 namespace Compiler
 {
-    Extensions::Extensions() : mNextKeywordIndex (-1) {}
+    Extensions::Extensions() : mSlots (64, 0) {}
+
+    const Extensions::Extension *Extensions::getExtension (int keyword) const
+    {
+        if (keyword>=0 || -keyword>static_cast<int> (mExtensions.size()))
+            return 0;
+
+        return &mExtensions[-keyword-1];
+    }
+
+    int Extensions::findSlot (const std::string& keyword, std::size_t hash) const
+    {
+        std::size_t mask = mSlots.size()-1;
+
+        for (std::size_t slot = hash & mask; ; slot = (slot+1) & mask)
+        {
+            int index = mSlots[slot];
+
+            if (index==0)
+                return static_cast<int> (slot);
+
+            const Extension& extension = mExtensions[index-1];
+
+            if (extension.mHash==hash && extension.mKeyword==keyword)
+                return static_cast<int> (slot);
+        }
+    }
+
+    void Extensions::registerExtension (const Extension& extension)
+    {
+        mExtensions.push_back (extension);
+
+        if (mExtensions.size()*2>mSlots.size())
+        {
+            // Rehash all keywords into a table of twice the size
+            mSlots.assign (mSlots.size()*2, 0);
+
+            for (std::size_t i=0; i<mExtensions.size()-1; ++i)
+            {
+                int slot = findSlot (mExtensions[i].mKeyword, mExtensions[i].mHash);
+
+                // If a keyword was registered twice, the first registration wins
+                if (mSlots[slot]==0)
+                    mSlots[slot] = static_cast<int> (i)+1;
+            }
+        }
+
+        int slot = findSlot (extension.mKeyword, extension.mHash);
+
+        if (mSlots[slot]==0)
+            mSlots[slot] = static_cast<int> (mExtensions.size());
+    }
 
     int Extensions::searchKeyword (const std::string& keyword) const
     {
-        std::map<std::string, int>::const_iterator iter = mKeywords.find (keyword);
+        int index = mSlots[findSlot (keyword, Misc::StringUtils::ciHash (keyword))];
 
-        if (iter==mKeywords.end())
+        if (index==0)
             return 0;
 
-        return iter->second;
+        return -index;
     }
 
     bool Extensions::isFunction (int keyword, ScriptReturn& returnType, ScriptArgs& argumentType,
         bool& explicitReference) const
     {
-        std::map<int, Function>::const_iterator iter = mFunctions.find (keyword);
+        const Extension *extension = getExtension (keyword);
 
-        if (iter==mFunctions.end())
+        if (!extension || !extension->mFunction)
             return false;
 
-        if (explicitReference && iter->second.mCodeExplicit==-1)
+        if (explicitReference && extension->mCodeExplicit==-1)
             explicitReference = false;
 
-        returnType = iter->second.mReturn;
-        argumentType = iter->second.mArguments;
+        returnType = extension->mReturn;
+        argumentType = extension->mArguments;
         return true;
     }
 
     bool Extensions::isInstruction (int keyword, ScriptArgs& argumentType,
         bool& explicitReference) const
     {
-        std::map<int, Instruction>::const_iterator iter = mInstructions.find (keyword);
+        const Extension *extension = getExtension (keyword);
 
-        if (iter==mInstructions.end())
+        if (!extension || extension->mFunction)
             return false;
 
-        if (explicitReference && iter->second.mCodeExplicit==-1)
+        if (explicitReference && extension->mCodeExplicit==-1)
             explicitReference = false;
 
-        argumentType = iter->second.mArguments;
+        argumentType = extension->mArguments;
         return true;
     }
 
     void Extensions::registerFunction (const std::string& keyword, ScriptReturn returnType,
         const ScriptArgs& argumentType, int code, int codeExplicit)
     {
-        Function function;
+        Extension function;
 
         if (argumentType.find ('/')==std::string::npos)
         {
@@ -70,22 +124,21 @@ namespace Compiler
             assert (codeExplicit==-1 || (codeExplicit>=0x20000 && codeExplicit<=0x2ffff));
         }
 
-        int keywordIndex = mNextKeywordIndex--;
-
-        mKeywords.insert (std::make_pair (keyword, keywordIndex));
-
+        function.mKeyword = keyword;
+        function.mHash = Misc::StringUtils::ciHash (keyword);
+        function.mFunction = true;
         function.mReturn = returnType;
         function.mArguments = argumentType;
         function.mCode = code;
         function.mCodeExplicit = codeExplicit;
 
-        mFunctions.insert (std::make_pair (keywordIndex, function));
+        registerExtension (function);
     }
 
     void Extensions::registerInstruction (const std::string& keyword,
         const ScriptArgs& argumentType, int code, int codeExplicit)
     {
-        Instruction instruction;
+        Extension instruction;
 
         if (argumentType.find ('/')==std::string::npos)
         {
@@ -100,15 +153,15 @@ namespace Compiler
             assert (codeExplicit==-1 || (codeExplicit>=0x20000 && codeExplicit<=0x2ffff));
         }
 
-        int keywordIndex = mNextKeywordIndex--;
-
-        mKeywords.insert (std::make_pair (keyword, keywordIndex));
-
+        instruction.mKeyword = keyword;
+        instruction.mHash = Misc::StringUtils::ciHash (keyword);
+        instruction.mFunction = false;
+        instruction.mReturn = ' ';
         instruction.mArguments = argumentType;
         instruction.mCode = code;
         instruction.mCodeExplicit = codeExplicit;
 
-        mInstructions.insert (std::make_pair (keywordIndex, instruction));
+        registerExtension (instruction);
     }
 
     void Extensions::generateFunctionCode (int keyword, std::vector<Interpreter::Type_Code>& code,
@@ -116,24 +169,24 @@ namespace Compiler
     {
         assert (optionalArguments>=0);
 
-        std::map<int, Function>::const_iterator iter = mFunctions.find (keyword);
+        const Extension *extension = getExtension (keyword);
 
-        if (iter==mFunctions.end())
+        if (!extension || !extension->mFunction)
             throw std::logic_error ("unknown custom function keyword");
 
-        if (optionalArguments && iter->second.mSegment!=3)
+        if (optionalArguments && extension->mSegment!=3)
             throw std::logic_error ("functions with optional arguments must be placed into segment 3");
 
         if (!id.empty())
         {
-            if (iter->second.mCodeExplicit==-1)
+            if (extension->mCodeExplicit==-1)
                 throw std::logic_error ("explicit references not supported");
 
             int index = literals.addString (id);
             Generator::pushInt (code, literals, index);
         }
 
-        switch (iter->second.mSegment)
+        switch (extension->mSegment)
         {
             case 3:
 
@@ -141,7 +194,7 @@ namespace Compiler
                     throw std::logic_error ("number of optional arguments is too large for segment 3");
 
                 code.push_back (Generator::segment3 (
-                    id.empty() ? iter->second.mCode : iter->second.mCodeExplicit,
+                    id.empty() ? extension->mCode : extension->mCodeExplicit,
                     optionalArguments));
 
                 break;
@@ -149,7 +202,7 @@ namespace Compiler
             case 5:
 
                 code.push_back (Generator::segment5 (
-                    id.empty() ? iter->second.mCode : iter->second.mCodeExplicit));
+                    id.empty() ? extension->mCode : extension->mCodeExplicit));
 
                 break;
 
@@ -165,24 +218,24 @@ namespace Compiler
     {
         assert (optionalArguments>=0);
 
-        std::map<int, Instruction>::const_iterator iter = mInstructions.find (keyword);
+        const Extension *extension = getExtension (keyword);
 
-        if (iter==mInstructions.end())
+        if (!extension || extension->mFunction)
             throw std::logic_error ("unknown custom instruction keyword");
 
-        if (optionalArguments && iter->second.mSegment!=3)
+        if (optionalArguments && extension->mSegment!=3)
             throw std::logic_error ("instructions with optional arguments must be placed into segment 3");
 
         if (!id.empty())
         {
-            if (iter->second.mCodeExplicit==-1)
+            if (extension->mCodeExplicit==-1)
                 throw std::logic_error ("explicit references not supported");
 
             int index = literals.addString (id);
             Generator::pushInt (code, literals, index);
         }
 
-        switch (iter->second.mSegment)
+        switch (extension->mSegment)
         {
             case 3:
 
@@ -190,7 +243,7 @@ namespace Compiler
                     throw std::logic_error ("number of optional arguments is too large for segment 3");
 
                 code.push_back (Generator::segment3 (
-                    id.empty() ? iter->second.mCode : iter->second.mCodeExplicit,
+                    id.empty() ? extension->mCode : extension->mCodeExplicit,
                     optionalArguments));
 
                 break;
@@ -198,7 +251,7 @@ namespace Compiler
             case 5:
 
                 code.push_back (Generator::segment5 (
-                    id.empty() ? iter->second.mCode : iter->second.mCodeExplicit));
+                    id.empty() ? extension->mCode : extension->mCodeExplicit));
 
                 break;
 
@@ -210,8 +263,12 @@ namespace Compiler
 
     void Extensions::listKeywords (std::vector<std::string>& keywords) const
     {
-        for (std::map<std::string, int>::const_iterator iter (mKeywords.begin());
-            iter!=mKeywords.end(); ++iter)
-            keywords.push_back (iter->first);
+        std::vector<std::string>::size_type first = keywords.size();
+
+        for (std::vector<int>::const_iterator iter (mSlots.begin()); iter!=mSlots.end(); ++iter)
+            if (*iter)
+                keywords.push_back (mExtensions[*iter-1].mKeyword);
+
+        std::sort (keywords.begin()+first, keywords.end());
     }
 }
@@ -1,8 +1,8 @@
 #ifndef COMPILER_EXTENSIONS_H_INCLUDED
 #define COMPILER_EXTENSIONS_H_INCLUDED
 
+#include <cstddef>
 #include <string>
-#include <map>
 #include <vector>
 
 #include <components/interpreter/types.hpp>
@@ -39,8 +39,11 @@ namespace Compiler
     class Extensions
     {
 
-            struct Function
+            struct Extension
             {
+                std::string mKeyword;
+                std::size_t mHash;
+                bool mFunction;
                 char mReturn;
                 ScriptArgs mArguments;
                 int mCode;
@@ -48,18 +51,22 @@ namespace Compiler
                 int mSegment;
             };
 
-            struct Instruction
-            {
-                ScriptArgs mArguments;
-                int mCode;
-                int mCodeExplicit;
-                int mSegment;
-            };
+            /// Extensions are stored in the order of registration, so that keyword -1 is at index 0,
+            /// keyword -2 at index 1, and so on.
+            std::vector<Extension> mExtensions;
+
+            /// Open addressing hash table over the keywords, with linear probing. Each slot holds the index of an
+            /// extension plus one, 0 marks an empty slot. The size is a power of two and the table is at most
+            /// half full, so that a lookup rarely has to compare more than one keyword.
+            std::vector<int> mSlots;
+
+            const Extension *getExtension (int keyword) const;
+
+            int findSlot (const std::string& keyword, std::size_t hash) const;
+            ///< Return the slot that holds \a keyword, or the empty slot it would be inserted into.
 
-            int mNextKeywordIndex;
-            std::map<std::string, int> mKeywords;
-            std::map<int, Function> mFunctions;
-            std::map<int, Instruction> mInstructions;
+            void registerExtension (const Extension& extension);
+            ///< Assign the next keyword code to \a extension.
 
         public:
 
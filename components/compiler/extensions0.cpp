@@ -304,6 +304,9 @@ namespace Compiler
             extensions.registerInstruction("tgm", "", opcodeToggleGodMode);
             extensions.registerInstruction("togglegodmode", "", opcodeToggleGodMode);
             extensions.registerInstruction("togglescripts", "", opcodeToggleScripts);
+            extensions.registerInstruction("toggleprofiler", "", opcodeToggleProfiler);
+            extensions.registerInstruction("tprof", "", opcodeToggleProfiler);
+            extensions.registerInstruction("resourcestats", "", opcodeResourceStats);
             extensions.registerInstruction ("disablelevitation", "", opcodeDisableLevitation);
             extensions.registerInstruction ("enablelevitation", "", opcodeEnableLevitation);
             extensions.registerFunction ("getpcinjail", 'l', "", opcodeGetPcInJail);
@@ -279,6 +279,8 @@ namespace Compiler
         const int opcodeShowVarsExplicit = 0x200021e;
         const int opcodeToggleGodMode = 0x200021f;
         const int opcodeToggleScripts = 0x2000301;
+        const int opcodeToggleProfiler = 0x2000302;
+        const int opcodeResourceStats = 0x2000303;
         const int opcodeDisableLevitation = 0x2000220;
         const int opcodeEnableLevitation = 0x2000221;
         const int opcodeCast = 0x2000227;
@@ -0,0 +1,221 @@
+#include "compressedrecords.hpp"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <istream>
+#include <stdexcept>
+#include <streambuf>
+#include <vector>
+
+#include <zlib.h>
+
+#include "esmwriter.hpp"
+
+namespace
+{
+    // Large enough to compress well, small enough to seek cheaply
+    const uint32_t sBlockSize = 64*1024;
+
+    class CompressedRecordsBuf : public std::streambuf
+    {
+        Files::IStreamPtr mSource;
+        std::streampos mDataStart;
+
+        uint32_t mBlockSize;
+        uint32_t mSize;
+        std::vector<uint32_t> mBlockOffsets; // relative to mDataStart, one extra entry for the end
+
+        int mCurrentBlock;
+        size_t mBufferStart; // uncompressed position of mBuffer[0]
+
+        std::vector<char> mCompressed;
+        std::vector<char> mBuffer;
+
+        void readIndex (size_t size)
+        {
+            uint32_t header[3];
+            mSource->read(reinterpret_cast<char*>(header), sizeof(header));
+
+            mBlockSize = header[0];
+            uint32_t blockCount = header[1];
+            mSize = header[2];
+
+            // Done in 64 bits, so that a corrupted header can not make any of the checks wrap around
+            uint64_t indexSize = sizeof(header) + uint64_t(blockCount)*sizeof(uint32_t);
+            if (!mSource->good() || indexSize > size || mBlockSize == 0 || mBlockSize > sBlockSize
+                    || blockCount != (uint64_t(mSize) + mBlockSize - 1) / mBlockSize)
+                throw std::runtime_error("invalid compressed records index");
+
+            std::vector<uint32_t> blockSizes (blockCount);
+            if (blockCount)
+                mSource->read(reinterpret_cast<char*>(&blockSizes[0]), blockCount*sizeof(uint32_t));
+
+            mDataStart = mSource->tellg();
+
+            mBlockOffsets.resize(blockCount+1);
+            mBlockOffsets[0] = 0;
+            uint64_t end = indexSize;
+            for (uint32_t i=0; i<blockCount; ++i)
+            {
+                // zlib never produces an empty stream
+                end += blockSizes[i];
+                if (blockSizes[i] == 0 || end > size)
+                    throw std::runtime_error("invalid compressed records index");
+                mBlockOffsets[i+1] = mBlockOffsets[i] + blockSizes[i];
+            }
+
+            if (!mSource->good())
+                throw std::runtime_error("invalid compressed records index");
+        }
+
+        void loadBlock (int block)
+        {
+            uint32_t compressedSize = mBlockOffsets[block+1] - mBlockOffsets[block];
+            mCompressed.resize(compressedSize);
+
+            mSource->seekg(mDataStart + std::streamoff(mBlockOffsets[block]));
+            mSource->read(&mCompressed[0], compressedSize);
+            if (!mSource->good())
+                throw std::runtime_error("failed to read compressed records");
+
+            mBufferStart = size_t(block) * mBlockSize;
+            uLongf size = std::min(mBlockSize, uint32_t(mSize - mBufferStart));
+            uLongf expected = size;
+            if (uncompress(reinterpret_cast<Bytef*>(&mBuffer[0]), &size,
+                           reinterpret_cast<const Bytef*>(&mCompressed[0]), compressedSize) != Z_OK
+                    || size != expected)
+                throw std::runtime_error("failed to decompress records");
+
+            mCurrentBlock = block;
+            setg(&mBuffer[0], &mBuffer[0], &mBuffer[0]+size);
+        }
+
+    public:
+        CompressedRecordsBuf (Files::IStreamPtr source, size_t size)
+            : mSource(source), mBlockSize(0), mSize(0), mCurrentBlock(-1), mBufferStart(0)
+        {
+            readIndex(size);
+
+            mBuffer.resize(mBlockSize);
+            setg(0,0,0);
+        }
+
+        virtual int_type underflow()
+        {
+            if (gptr() == egptr())
+            {
+                int next = mCurrentBlock+1;
+                if (next >= static_cast<int>(mBlockOffsets.size())-1)
+                    return traits_type::eof();
+                loadBlock(next);
+            }
+
+            return traits_type::to_int_type(*gptr());
+        }
+
+        virtual pos_type seekoff(off_type offset, std::ios_base::seekdir whence, std::ios_base::openmode mode)
+        {
+            off_type newPos;
+            switch (whence)
+            {
+                case std::ios_base::beg:
+                    newPos = offset;
+                    break;
+                case std::ios_base::cur:
+                    newPos = off_type(mBufferStart + (gptr() - eback())) + offset;
+                    break;
+                case std::ios_base::end:
+                    newPos = off_type(mSize) + offset;
+                    break;
+                default:
+                    return pos_type(off_type(-1));
+            }
+            return seekpos(newPos, mode);
+        }
+
+        virtual pos_type seekpos(pos_type pos, std::ios_base::openmode mode)
+        {
+            if ((mode&std::ios_base::out) || !(mode&std::ios_base::in))
+                return pos_type(off_type(-1));
+
+            off_type newPos = pos;
+            if (newPos < 0 || newPos > off_type(mSize))
+                return pos_type(off_type(-1));
+
+            if (newPos == off_type(mSize))
+            {
+                // At the end; the next read attempt returns eof
+                mCurrentBlock = static_cast<int>(mBlockOffsets.size())-1;
+                mBufferStart = mSize;
+                setg(0,0,0);
+                return pos;
+            }
+
+            int block = static_cast<int>(newPos / mBlockSize);
+            if (block != mCurrentBlock || !eback())
+                loadBlock(block);
+
+            setg(eback(), eback() + (newPos - mBufferStart), egptr());
+            return pos;
+        }
+    };
+
+    class CompressedRecordsStream : public std::istream
+    {
+    public:
+        CompressedRecordsStream (Files::IStreamPtr source, size_t size)
+            : std::istream(new CompressedRecordsBuf(source, size))
+        {
+            // Let decompression errors through to ESMReader
+            exceptions(std::ios_base::badbit);
+        }
+
+        virtual ~CompressedRecordsStream()
+        {
+            delete rdbuf();
+        }
+    };
+}
+
+namespace ESM
+{
+
+void writeCompressedRecords (ESMWriter& esm, const char* data, size_t size)
+{
+    if (size > 0xffffffffu)
+        throw std::runtime_error("too much data to compress");
+
+    uint32_t blockCount = static_cast<uint32_t>((size + sBlockSize - 1) / sBlockSize);
+
+    std::vector<std::vector<char> > blocks (blockCount);
+    for (uint32_t i=0; i<blockCount; ++i)
+    {
+        size_t start = size_t(i) * sBlockSize;
+        uLong sourceSize = static_cast<uLong>(std::min(size_t(sBlockSize), size - start));
+
+        uLongf compressedSize = compressBound(sourceSize);
+        blocks[i].resize(compressedSize);
+        if (compress(reinterpret_cast<Bytef*>(&blocks[i][0]), &compressedSize,
+                     reinterpret_cast<const Bytef*>(data + start), sourceSize) != Z_OK)
+            throw std::runtime_error("failed to compress records");
+        blocks[i].resize(compressedSize);
+    }
+
+    esm.writeT(sBlockSize);
+    esm.writeT(blockCount);
+    esm.writeT(static_cast<uint32_t>(size));
+
+    for (uint32_t i=0; i<blockCount; ++i)
+        esm.writeT(static_cast<uint32_t>(blocks[i].size()));
+
+    for (uint32_t i=0; i<blockCount; ++i)
+        esm.write(&blocks[i][0], blocks[i].size());
+}
+
+Files::IStreamPtr openCompressedRecords (Files::IStreamPtr stream, size_t size)
+{
+    return Files::IStreamPtr(new CompressedRecordsStream(stream, size));
+}
+
+}
@@ -0,0 +1,29 @@
+#ifndef OPENMW_ESM_COMPRESSEDRECORDS_H
+#define OPENMW_ESM_COMPRESSEDRECORDS_H
+
+#include <cstddef>
+
+#include <components/files/constrainedfilestream.hpp>
+
+namespace ESM
+{
+    class ESMWriter;
+
+    // format 2, saved games only
+    //
+    // A sequence of records, compressed in independent zlib blocks. The blocks are preceded by a small index:
+    //   uint32 uncompressed block size, uint32 block count, uint32 uncompressed size,
+    //   uint32 compressed size of each block.
+    // Any position in the uncompressed data can be reached by decompressing a single block.
+
+    /// Write \a size bytes of \a data, usually a sequence of records, as compressed blocks.
+    /// \note Meant to be used as the content of a REC_CMPR record.
+    void writeCompressedRecords (ESMWriter& esm, const char* data, size_t size);
+
+    /// Open a stream that decompresses the blocks written by writeCompressedRecords on the fly.
+    /// \param stream Stream positioned at the start of the compressed data.
+    /// \param size Size of the compressed data in \a stream.
+    Files::IStreamPtr openCompressedRecords (Files::IStreamPtr stream, size_t size);
+}
+
+#endif
@@ -2,6 +2,8 @@
 
 #include <stdexcept>
 
+#include "compressedrecords.hpp"
+
 namespace ESM
 {
 
@@ -278,6 +280,26 @@ void ESMReader::skipRecord()
     mCtx.leftRec = 0;
 }
 
+void ESMReader::decompressRecord()
+{
+    if (mCtx.leftFile)
+        fail("Compressed record is not the last record");
+
+    try
+    {
+        mEsm = openCompressedRecords(mEsm, mCtx.leftRec);
+    }
+    catch (std::exception& e)
+    {
+        fail(std::string("Read error: ") + e.what());
+    }
+
+    mCtx.leftRec = 0;
+    mEsm->seekg(0, mEsm->end);
+    mCtx.leftFile = mFileSize = mEsm->tellg();
+    mEsm->seekg(0, mEsm->beg);
+}
+
 void ESMReader::getRecHeader(uint32_t &flags)
 {
     // General error checking
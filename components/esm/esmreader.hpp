@@ -231,6 +231,11 @@ public:
   void getRecHeader() { getRecHeader(mRecordFlags); }
   void getRecHeader(uint32_t &flags);
 
+  /// Continue with the records compressed in the current record (see compressedrecords.hpp), which must
+  /// be the last record in the file. Assumes the name and header have already been read.
+  /// \note File offsets and size refer to the decompressed records afterwards.
+  void decompressRecord();
+
   bool hasMoreRecs() const { return mCtx.leftFile > 0; }
   bool hasMoreSubs() const { return mCtx.leftRec > 0; }
 
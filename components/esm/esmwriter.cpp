@@ -65,10 +65,7 @@ namespace ESM
 
     void ESMWriter::save(std::ostream& file)
     {
-        mRecordCount = 0;
-        mRecords.clear();
-        mCounting = true;
-        mStream = &file;
+        saveRecords(file);
 
         startRecord("TES3", 0);
 
@@ -77,6 +74,14 @@ namespace ESM
         endRecord("TES3");
     }
 
+    void ESMWriter::saveRecords(std::ostream& file)
+    {
+        mRecordCount = 0;
+        mRecords.clear();
+        mCounting = true;
+        mStream = &file;
+    }
+
     void ESMWriter::close()
     {
         if (!mRecords.empty())
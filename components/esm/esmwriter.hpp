@@ -52,6 +52,10 @@ class ESMWriter
         void save(std::ostream& file);
         ///< Start saving a file by writing the TES3 header.
 
+        void saveRecords(std::ostream& file);
+        ///< Start writing records to \a file without a TES3 header, e.g. to append them to a file
+        /// that is started by another writer later on.
+
         void close();
         ///< \note Does not close the stream.
 
@@ -3,21 +3,66 @@
 #include "esmreader.hpp"
 #include "esmwriter.hpp"
 
+ESM::FogTexture::FogTexture()
+    : mX(0), mY(0), mRunLength(false)
+{
+}
+
+void ESM::FogTexture::encodeAlpha (const std::vector<unsigned char>& alpha)
+{
+    mImageData.clear();
+    mRunLength = true;
+
+    for (size_t i=0; i<alpha.size();)
+    {
+        unsigned char value = alpha[i];
+        size_t run = 1;
+        while (run < 255 && i+run < alpha.size() && alpha[i+run] == value)
+            ++run;
+
+        mImageData.push_back(static_cast<char>(run));
+        mImageData.push_back(static_cast<char>(value));
+        i += run;
+    }
+}
+
+bool ESM::FogTexture::decodeAlpha (std::vector<unsigned char>& alpha, size_t count) const
+{
+    alpha.clear();
+    alpha.reserve(count);
+
+    if (mImageData.size() % 2)
+        return false;
+
+    for (size_t i=0; i<mImageData.size(); i+=2)
+    {
+        size_t run = static_cast<unsigned char>(mImageData[i]);
+        if (run == 0 || alpha.size() + run > count)
+            return false;
+        alpha.insert(alpha.end(), run, static_cast<unsigned char>(mImageData[i+1]));
+    }
+
+    return alpha.size() == count;
+}
+
 void ESM::FogState::load (ESMReader &esm)
 {
     esm.getHNOT(mBounds, "BOUN");
     esm.getHNOT(mNorthMarkerAngle, "ANGL");
-    while (esm.isNextSub("FTEX"))
+    while (esm.isNextSub("FTEX") || esm.isNextSub("FRLE"))
     {
-        esm.getSubHeader();
         FogTexture tex;
+        tex.mRunLength = (esm.retSubName().toString() == "FRLE");
+
+        esm.getSubHeader();
 
         esm.getT(tex.mX);
         esm.getT(tex.mY);
 
         size_t imageSize = esm.getSubSize()-sizeof(int)*2;
         tex.mImageData.resize(imageSize);
-        esm.getExact(&tex.mImageData[0], imageSize);
+        if (imageSize)
+            esm.getExact(&tex.mImageData[0], imageSize);
         mFogTextures.push_back(tex);
     }
 }
@@ -31,10 +76,11 @@ void ESM::FogState::save (ESMWriter &esm, bool interiorCell) const
     }
     for (std::vector<FogTexture>::const_iterator it = mFogTextures.begin(); it != mFogTextures.end(); ++it)
     {
-        esm.startSubRecord("FTEX");
+        esm.startSubRecord(it->mRunLength ? "FRLE" : "FTEX");
         esm.writeT(it->mX);
         esm.writeT(it->mY);
-        esm.write(&it->mImageData[0], it->mImageData.size());
+        if (!it->mImageData.empty())
+            esm.write(&it->mImageData[0], it->mImageData.size());
         esm.endRecord("FTEX");
     }
 }
@@ -1,6 +1,7 @@
 #ifndef OPENMW_ESM_FOGSTATE_H
 #define OPENMW_ESM_FOGSTATE_H
 
+#include <cstddef>
 #include <vector>
 
 namespace ESM
@@ -11,7 +12,20 @@ namespace ESM
     struct FogTexture
     {
         int mX, mY; // Only used for interior cells
+
+        /// TGA image as written by saved game format 1 and older, or run-length encoded
+        /// alpha values (one byte per texel) if mRunLength is set.
         std::vector<char> mImageData;
+        bool mRunLength;
+
+        FogTexture();
+
+        /// Store \a alpha run-length encoded in mImageData.
+        void encodeAlpha (const std::vector<unsigned char>& alpha);
+
+        /// Decode \a count alpha values from run-length encoded mImageData.
+        /// \return Was the data valid?
+        bool decodeAlpha (std::vector<unsigned char>& alpha, size_t count) const;
     };
 
     // format 0, saved games only
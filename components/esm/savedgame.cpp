@@ -6,7 +6,7 @@
 #include "defs.hpp"
 
 unsigned int ESM::SavedGame::sRecordId = ESM::REC_SAVE;
-int ESM::SavedGame::sCurrentFormat = 1;
+int ESM::SavedGame::sCurrentFormat = 2;
 
 void ESM::SavedGame::load (ESMReader &esm)
 {
@@ -27,7 +27,8 @@ void ESM::SavedGame::load (ESMReader &esm)
     esm.getSubNameIs("SCRN");
     esm.getSubHeader();
     mScreenshot.resize(esm.getSubSize());
-    esm.getExact(&mScreenshot[0], mScreenshot.size());
+    if (!mScreenshot.empty())
+        esm.getExact(&mScreenshot[0], mScreenshot.size());
 }
 
 void ESM::SavedGame::save (ESMWriter &esm) const
@@ -50,6 +51,7 @@ void ESM::SavedGame::save (ESMWriter &esm) const
          esm.writeHNString ("DEPE", *iter);
 
     esm.startSubRecord("SCRN");
-    esm.write(&mScreenshot[0], mScreenshot.size());
+    if (!mScreenshot.empty())
+        esm.write(&mScreenshot[0], mScreenshot.size());
     esm.endRecord("SCRN");
 }
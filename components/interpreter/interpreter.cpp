@@ -199,11 +199,12 @@ namespace Interpreter
         mSegment5.insert (std::make_pair (code, opcode));
     }
 
-    void Interpreter::run (const Type_Code *code, int codeSize, Context& context)
+    void Interpreter::run (const Type_Code *code, int codeSize, Context& context,
+        const std::vector<int> *stringLiteralOffsets)
     {
         assert (codeSize>=4);
 
-        mRuntime.configure (code, codeSize, context);
+        mRuntime.configure (code, codeSize, context, stringLiteralOffsets);
 
         int opcodes = static_cast<int> (code[0]);
 
@@ -56,7 +56,9 @@ namespace Interpreter
             void installSegment5 (int code, Opcode0 *opcode);
             ///< ownership of \a opcode is transferred to *this.
 
-            void run (const Type_Code *code, int codeSize, Context& context);
+            void run (const Type_Code *code, int codeSize, Context& context,
+                const std::vector<int> *stringLiteralOffsets = 0);
+            ///< \a stringLiteralOffsets is optional, see Runtime::configure.
     };
 }
 
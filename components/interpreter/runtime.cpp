@@ -7,7 +7,7 @@
 
 namespace Interpreter
 {
-    Runtime::Runtime() : mContext (0), mCode (0), mCodeSize(0), mPC (0) {}
+    Runtime::Runtime() : mContext (0), mCode (0), mCodeSize(0), mPC (0), mStringLiteralOffsets (0) {}
 
     int Runtime::getPC() const
     {
@@ -34,23 +34,31 @@ namespace Interpreter
 
     std::string Runtime::getStringLiteral (int index) const
     {
-        assert (index>=0 && static_cast<int> (mCode[3])>0);
+        assert (mStringLiteralOffsets);
+        assert (index>=0 && index<static_cast<int> (mStringLiteralOffsets->size()));
 
         const char *literalBlock =
             reinterpret_cast<const char *> (mCode + 4 + mCode[0] + mCode[1] + mCode[2]);
 
-        int offset = 0;
+        return literalBlock+(*mStringLiteralOffsets)[index];
+    }
 
-        for (; index; --index)
-        {
-            offset += std::strlen (literalBlock+offset) + 1;
-            assert (offset/4<static_cast<int> (mCode[3]));
-        }
+    void Runtime::getStringLiteralOffsets (const Type_Code *code, std::vector<int>& offsets)
+    {
+        offsets.clear();
+
+        const char *literalBlock =
+            reinterpret_cast<const char *> (code + 4 + code[0] + code[1] + code[2]);
+
+        // The padding at the end of the block shows up as empty literals, which are never referenced
+        int size = static_cast<int> (code[3]) * 4;
 
-        return literalBlock+offset;
+        for (int offset = 0; offset<size; offset += std::strlen (literalBlock+offset) + 1)
+            offsets.push_back (offset);
     }
 
-    void Runtime::configure (const Type_Code *code, int codeSize, Context& context)
+    void Runtime::configure (const Type_Code *code, int codeSize, Context& context,
+        const std::vector<int> *stringLiteralOffsets)
     {
         clear();
 
@@ -58,6 +66,14 @@ namespace Interpreter
         mCode = code;
         mCodeSize = codeSize;
         mPC = 0;
+
+        if (stringLiteralOffsets)
+            mStringLiteralOffsets = stringLiteralOffsets;
+        else
+        {
+            getStringLiteralOffsets (code, mOwnStringLiteralOffsets);
+            mStringLiteralOffsets = &mOwnStringLiteralOffsets;
+        }
     }
 
     void Runtime::clear()
@@ -66,6 +82,7 @@ namespace Interpreter
         mCode = 0;
         mCodeSize = 0;
         mStack.clear();
+        mStringLiteralOffsets = 0;
     }
 
     void Runtime::setPC (int PC)
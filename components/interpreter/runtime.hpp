@@ -19,6 +19,8 @@ namespace Interpreter
             int mCodeSize;
             int mPC;
             std::vector<Data> mStack;
+            const std::vector<int> *mStringLiteralOffsets;
+            std::vector<int> mOwnStringLiteralOffsets;
 
         public:
 
@@ -33,9 +35,17 @@ namespace Interpreter
 
             std::string getStringLiteral (int index) const;
 
-            void configure (const Type_Code *code, int codeSize, Context& context);
+            static void getStringLiteralOffsets (const Type_Code *code, std::vector<int>& offsets);
+            ///< Fill \a offsets with the byte offset of each string literal within the literal block
+            /// of \a code, for passing to configure.
+
+            void configure (const Type_Code *code, int codeSize, Context& context,
+                const std::vector<int> *stringLiteralOffsets = 0);
             ///< \a context and \a code must exist as least until either configure, clear or
             /// the destructor is called. \a codeSize is given in 32-bit words.
+            ///
+            /// \a stringLiteralOffsets must have been created by getStringLiteralOffsets for \a code
+            /// and exist as long as \a code. If it is 0, the offsets are determined here.
 
             void clear();
 
@@ -0,0 +1,209 @@
+#include "profiler.hpp"
+
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <vector>
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/thread/tss.hpp>
+
+#include <OpenThreads/Mutex>
+#include <OpenThreads/ScopedLock>
+
+namespace
+{
+    struct Zone
+    {
+        const char* mName;
+        int mThread;
+        osg::Timer_t mStart;
+        osg::Timer_t mEnd;
+    };
+
+    // Index of each thread in traces, assigned on first use
+    boost::thread_specific_ptr<int> sThreadId;
+    OpenThreads::Atomic sNextThreadId;
+
+    // Shared between threads, guarded by sMutex
+    OpenThreads::Mutex sMutex;
+    std::map<int, std::string> sThreadNames;
+    std::vector<Zone> sZones;
+
+    // Main thread only
+    std::string sDirectory;
+    std::string sFile;
+    boost::filesystem::ofstream sStream;
+    osg::Timer_t sStartTick = 0;
+    bool sFirstEvent = true;
+    std::set<int> sWrittenThreadNames;
+
+    int getThreadId()
+    {
+        int* id = sThreadId.get();
+        if (!id)
+        {
+            id = new int(static_cast<int>(++sNextThreadId) - 1);
+            sThreadId.reset(id);
+        }
+        return *id;
+    }
+
+    void writeString(std::ostream& stream, const std::string& string)
+    {
+        stream << '"';
+        for (std::string::const_iterator it = string.begin(); it != string.end(); ++it)
+        {
+            if (*it == '"' || *it == '\\')
+                stream << '\\' << *it;
+            else if (static_cast<unsigned char>(*it) < 0x20)
+                stream << ' ';
+            else
+                stream << *it;
+        }
+        stream << '"';
+    }
+
+    void beginEvent()
+    {
+        if (!sFirstEvent)
+            sStream << ",\n";
+        sFirstEvent = false;
+    }
+
+    void writeThreadName(int thread, const std::string& name)
+    {
+        beginEvent();
+        sStream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << thread << ",\"args\":{\"name\":";
+        writeString(sStream, name);
+        sStream << "}}";
+    }
+
+    void writeZone(const Zone& zone)
+    {
+        // Started before the trace, with a stale enabled flag
+        if (zone.mStart < sStartTick)
+            return;
+
+        osg::Timer* timer = osg::Timer::instance();
+        beginEvent();
+        sStream << "{\"name\":";
+        writeString(sStream, zone.mName);
+        sStream << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << zone.mThread
+                << ",\"ts\":" << timer->delta_u(sStartTick, zone.mStart)
+                << ",\"dur\":" << timer->delta_u(zone.mStart, zone.mEnd) << "}";
+    }
+}
+
+namespace Misc
+{
+
+    OpenThreads::Atomic Profiler::sEnabled;
+
+    void Profiler::setTraceDirectory(const std::string& directory)
+    {
+        sDirectory = directory;
+    }
+
+    bool Profiler::toggle()
+    {
+        if (isEnabled())
+        {
+            flush();
+            sEnabled.exchange(0);
+
+            {
+                OpenThreads::ScopedLock<OpenThreads::Mutex> lock(sMutex);
+                sZones.clear();
+            }
+
+            sStream << "\n]\n";
+            sStream.close();
+            return false;
+        }
+
+        boost::filesystem::path path;
+        for (int count = 0; ; ++count)
+        {
+            std::ostringstream name;
+            name << "trace" << std::setw(3) << std::setfill('0') << count << ".json";
+            path = boost::filesystem::path(sDirectory) / name.str();
+            if (!boost::filesystem::exists(path))
+                break;
+        }
+
+        sStream.open(path, std::ios::out | std::ios::trunc);
+        if (!sStream.is_open())
+        {
+            std::cerr << "Can't write trace file " << path.string() << std::endl;
+            return false;
+        }
+        sFile = path.string();
+
+        // The array format allows the closing bracket to be missing, so that the trace of a crashed game is usable
+        sStream << std::fixed << std::setprecision(3) << "[\n";
+        sFirstEvent = true;
+        sWrittenThreadNames.clear();
+        sStartTick = osg::Timer::instance()->tick();
+        sEnabled.exchange(1);
+        return true;
+    }
+
+    std::string Profiler::getTraceFile()
+    {
+        return sFile;
+    }
+
+    void Profiler::flush()
+    {
+        if (!isEnabled())
+            return;
+
+        std::vector<Zone> zones;
+        std::map<int, std::string> threadNames;
+        {
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(sMutex);
+            zones.swap(sZones);
+            if (sWrittenThreadNames.size() != sThreadNames.size())
+                threadNames = sThreadNames;
+        }
+
+        for (std::map<int, std::string>::const_iterator it = threadNames.begin(); it != threadNames.end(); ++it)
+        {
+            if (sWrittenThreadNames.insert(it->first).second)
+                writeThreadName(it->first, it->second);
+        }
+
+        for (std::vector<Zone>::const_iterator it = zones.begin(); it != zones.end(); ++it)
+            writeZone(*it);
+
+        sStream.flush();
+    }
+
+    void Profiler::setThreadName(const std::string& name)
+    {
+        int thread = getThreadId();
+
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(sMutex);
+        sThreadNames[thread] = name;
+    }
+
+    void Profiler::recordZone(const char* name, osg::Timer_t start, osg::Timer_t end)
+    {
+        Zone zone;
+        zone.mName = name;
+        zone.mThread = getThreadId();
+        zone.mStart = start;
+        zone.mEnd = end;
+
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(sMutex);
+        if (!isEnabled())
+            return;
+
+        sZones.push_back(zone);
+    }
+
+}
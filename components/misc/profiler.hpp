@@ -0,0 +1,78 @@
+#ifndef OPENMW_COMPONENTS_MISC_PROFILER_H
+#define OPENMW_COMPONENTS_MISC_PROFILER_H
+
+#include <string>
+
+#include <osg/Timer>
+
+#include <OpenThreads/Atomic>
+
+namespace Misc
+{
+
+/*
+  Records the duration of ProfileZones on any thread and writes them to a trace file in the Chrome trace
+  event format, which can be viewed in chrome://tracing or https://ui.perfetto.dev.
+  While no trace is being written, a ProfileZone costs a single check of a flag.
+*/
+class Profiler
+{
+public:
+
+    /// Directory to write trace files to.
+    static void setTraceDirectory(const std::string& directory);
+
+    /// Start writing a new trace file, or stop writing the current one.
+    /// @return Is a trace being written now?
+    /// @note Main thread only.
+    static bool toggle();
+
+    /// Name of the trace file currently or last written.
+    static std::string getTraceFile();
+
+    /// Write the zones recorded since the last flush to the trace file. Call once per frame.
+    /// @note Main thread only.
+    static void flush();
+
+    /// Name the calling thread in traces.
+    static void setThreadName(const std::string& name);
+
+    static bool isEnabled() { return sEnabled > 0; }
+
+    /// @param name Must be a string literal, or otherwise outlive the trace.
+    static void recordZone(const char* name, osg::Timer_t start, osg::Timer_t end);
+
+private:
+    // Zones recorded while the flag changes are dropped by recordZone or when writing the trace
+    static OpenThreads::Atomic sEnabled;
+};
+
+/// @brief Records the time from construction to destruction with the Profiler, if a trace is being written.
+class ProfileZone
+{
+public:
+    /// @param name Must be a string literal.
+    explicit ProfileZone(const char* name)
+        : mName(name)
+        , mStart(Profiler::isEnabled() ? osg::Timer::instance()->tick() : 0)
+    {
+    }
+
+    ~ProfileZone()
+    {
+        if (mStart)
+            Profiler::recordZone(mName, mStart, osg::Timer::instance()->tick());
+    }
+
+private:
+    const char* mName;
+    osg::Timer_t mStart;
+
+    // not implemented
+    ProfileZone(const ProfileZone&);
+    ProfileZone& operator=(const ProfileZone&);
+};
+
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define MISC_STRINGOPS_H
 
 #include <cctype>
+#include <cstring>
 #include <string>
 #include <algorithm>
 #include <locale>
@@ -11,33 +12,89 @@ namespace Misc
 class StringUtils
 {
 
-    static std::locale mLocale;
-    struct ci
+    static const unsigned char sLowerCase[256];
+
+    /// Lower case the sizeof(size_t) characters at str, as one word
+    static size_t lowerCaseWord(const char *str)
     {
-        bool operator()(char x, char y) const {
-            return std::tolower(x, StringUtils::mLocale) < std::tolower(y, StringUtils::mLocale);
-        }
-    };
+        const size_t ones = static_cast<size_t>(-1) / 0xff;
+        const size_t highBits = ones * 0x80;
+
+        size_t word;
+        std::memcpy(&word, str, sizeof(word));
+
+        // Sets the high bit of each byte from 'A' to 'Z', without carries between bytes
+        size_t ascii = word & ~highBits;
+        size_t aboveA = ascii + ones * (0x80 - 'A');
+        size_t aboveZ = ascii + ones * (0x80 - 'Z' - 1);
+        size_t upper = aboveA & ~aboveZ & ~word & highBits;
+
+        return word | (upper >> 2);
+    }
 
 public:
-    static bool ciLess(const std::string &x, const std::string &y) {
-        return std::lexicographical_compare(x.begin(), x.end(), y.begin(), y.end(), ci());
+    /// Returns lower case of an ASCII character, other characters are returned unchanged
+    static char toLower(char c)
+    {
+        return static_cast<char>(sLowerCase[static_cast<unsigned char>(c)]);
     }
 
-    static bool ciEqual(const std::string &x, const std::string &y) {
-        if (x.size() != y.size()) {
+    /// Case insensitive comparison of ASCII strings, without allocating
+    static bool ciLess(const char *x, size_t xsize, const char *y, size_t ysize)
+    {
+        size_t len = std::min(xsize, ysize);
+        size_t i = 0;
+
+        // IDs often share long prefixes, skip over equal characters a word at a time
+        for (; i + sizeof(size_t) <= len; i += sizeof(size_t))
+        {
+            if (lowerCaseWord(x + i) != lowerCaseWord(y + i))
+                break;
+        }
+
+        for (; i<len; ++i)
+        {
+            if (x[i] == y[i])
+                continue;
+            // compared as unsigned characters, so that lower case strings are ordered like by std::less
+            unsigned char xc = sLowerCase[static_cast<unsigned char>(x[i])];
+            unsigned char yc = sLowerCase[static_cast<unsigned char>(y[i])];
+            if (xc != yc)
+                return xc < yc;
+        }
+        return xsize < ysize;
+    }
+
+    static bool ciEqual(const char *x, size_t xsize, const char *y, size_t ysize)
+    {
+        if (xsize != ysize)
             return false;
+        size_t i = 0;
+        for (; i + sizeof(size_t) <= xsize; i += sizeof(size_t))
+        {
+            if (lowerCaseWord(x + i) != lowerCaseWord(y + i))
+                return false;
         }
-        std::string::const_iterator xit = x.begin();
-        std::string::const_iterator yit = y.begin();
-        for (; xit != x.end(); ++xit, ++yit) {
-            if (std::tolower(*xit, mLocale) != std::tolower(*yit, mLocale)) {
+        for (; i<xsize; ++i)
+        {
+            if (x[i] != y[i] && sLowerCase[static_cast<unsigned char>(x[i])] != sLowerCase[static_cast<unsigned char>(y[i])])
                 return false;
-            }
         }
         return true;
     }
 
+    static bool ciLess(const std::string &x, const std::string &y) {
+        return ciLess(x.data(), x.size(), y.data(), y.size());
+    }
+
+    static bool ciLess(const char *x, const char *y) {
+        return ciLess(x, std::strlen(x), y, std::strlen(y));
+    }
+
+    static bool ciEqual(const std::string &x, const std::string &y) {
+        return ciEqual(x.data(), x.size(), y.data(), y.size());
+    }
+
     static int ciCompareLen(const std::string &x, const std::string &y, size_t len)
     {
         std::string::const_iterator xit = x.begin();
@@ -45,7 +102,7 @@ public:
         for(;xit != x.end() && yit != y.end() && len > 0;++xit,++yit,--len)
         {
             int res = *xit - *yit;
-            if(res != 0 && std::tolower(*xit, mLocale) != std::tolower(*yit, mLocale))
+            if(res != 0 && toLower(*xit) != toLower(*yit))
                 return (res > 0) ? 1 : -1;
         }
         if(len > 0)
@@ -58,10 +115,50 @@ public:
         return 0;
     }
 
+    /// Case insensitive hash of an ASCII string (FNV-1a of the lower case string), without allocating
+    static size_t ciHash(const char *x, size_t size)
+    {
+        size_t hash = 2166136261u;
+        for (size_t i=0; i<size; ++i)
+        {
+            hash ^= sLowerCase[static_cast<unsigned char>(x[i])];
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    static size_t ciHash(const std::string &x) {
+        return ciHash(x.data(), x.size());
+    }
+
+    /// Comparator for ordered containers with case insensitive keys, which can then be searched with a key of any
+    /// case, without making a lower case copy first. Lower case keys are ordered like with std::less.
+    struct CiLess
+    {
+        bool operator()(const std::string &x, const std::string &y) const {
+            return ciLess(x, y);
+        }
+    };
+
+    /// Equality and hash functors for unordered containers with case insensitive keys
+    struct CiEqual
+    {
+        bool operator()(const std::string &x, const std::string &y) const {
+            return ciEqual(x, y);
+        }
+    };
+
+    struct CiHash
+    {
+        size_t operator()(const std::string &x) const {
+            return ciHash(x);
+        }
+    };
+
     /// Transforms input string to lower case w/o copy
     static std::string &toLower(std::string &inout) {
         for (unsigned int i=0; i<inout.size(); ++i)
-            inout[i] = std::tolower(inout[i], mLocale);
+            inout[i] = toLower(inout[i]);
         return inout;
     }
 
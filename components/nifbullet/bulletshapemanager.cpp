@@ -23,11 +23,11 @@ osg::ref_ptr<BulletShapeInstance> BulletShapeManager::createInstance(const std::
     std::string normalized = name;
     mVFS->normalizeFilename(normalized);
 
-    osg::ref_ptr<BulletShape> shape;
-    Index::iterator it = mIndex.find(normalized);
-    if (it == mIndex.end())
+    osg::ref_ptr<BulletShape> shape = mIndex.get(normalized);
+    if (!shape)
     {
         Files::IStreamPtr file = mVFS->get(normalized);
+        size_t cost = Resource::getFileCost(*file);
 
         // TODO: add support for non-NIF formats
 
@@ -35,13 +35,27 @@ osg::ref_ptr<BulletShapeInstance> BulletShapeManager::createInstance(const std::
         // might be worth sharing NIFFiles with SceneManager in some way
         shape = loader.load(Nif::NIFFilePtr(new Nif::NIFFile(file, normalized)));
 
-        mIndex[normalized] = shape;
+        mIndex.add(normalized, shape.get(), cost);
     }
-    else
-        shape = it->second;
 
     osg::ref_ptr<BulletShapeInstance> instance = shape->makeInstance();
     return instance;
 }
 
+void BulletShapeManager::setCacheLimits(double expiryDelay, size_t budget)
+{
+    mIndex.setExpiryDelay(expiryDelay);
+    mIndex.setBudget(budget);
+}
+
+void BulletShapeManager::updateCache(double time)
+{
+    mIndex.update(time);
+}
+
+const Resource::CacheStats& BulletShapeManager::getCacheStats() const
+{
+    return mIndex.getStats();
+}
+
 }
@@ -6,6 +6,8 @@
 
 #include <osg/ref_ptr>
 
+#include <components/resource/objectcache.hpp>
+
 namespace VFS
 {
     class Manager;
@@ -30,10 +32,18 @@ namespace NifBullet
 
         osg::ref_ptr<BulletShapeInstance> createInstance(const std::string& name);
 
+        /// @see Resource::ObjectCache
+        void setCacheLimits(double expiryDelay, size_t budget);
+
+        /// Expire shapes that have no instances left.
+        void updateCache(double time);
+
+        const Resource::CacheStats& getCacheStats() const;
+
     private:
         const VFS::Manager* mVFS;
 
-        typedef std::map<std::string, osg::ref_ptr<BulletShape> > Index;
+        typedef Resource::ObjectCache<std::string, BulletShape> Index;
         Index mIndex;
     };
 
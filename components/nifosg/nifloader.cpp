@@ -9,6 +9,7 @@
 // resource
 #include <components/misc/stringops.hpp>
 #include <components/misc/resourcehelpers.hpp>
+#include <components/misc/profiler.hpp>
 #include <components/resource/texturemanager.hpp>
 
 // skel
@@ -172,6 +173,7 @@ namespace
 
         virtual bool cull(osg::NodeVisitor *, osg::Drawable * drw, osg::State *) const
         {
+            Misc::ProfileZone zone("UpdateMorphGeometry");
             osgAnimation::MorphGeometry* geom = static_cast<osgAnimation::MorphGeometry*>(drw);
             if (!geom)
                 return false;
@@ -1452,6 +1454,7 @@ namespace NifOsg
     {
         LoaderImpl impl(kf->getFilename());
         impl.loadKf(kf, target);
+        target.mTextKeyEvents.build(target.mTextKeys);
     }
 
 }
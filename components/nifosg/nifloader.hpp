@@ -7,6 +7,7 @@
 #include <osg/Referenced>
 
 #include "controller.hpp"
+#include "textkeys.hpp"
 
 namespace osg
 {
@@ -20,8 +21,6 @@ namespace Resource
 
 namespace NifOsg
 {
-    typedef std::multimap<float,std::string> TextKeyMap;
-
     struct TextKeyMapHolder : public osg::Object
     {
     public:
@@ -42,6 +41,9 @@ namespace NifOsg
     public:
         TextKeyMap mTextKeys;
 
+        /// mTextKeys parsed for playback
+        TextKeyEvents mTextKeyEvents;
+
         typedef std::map<std::string, osg::ref_ptr<const KeyframeController> > KeyframeControllerMap;
         KeyframeControllerMap mKeyframeControllers;
     };
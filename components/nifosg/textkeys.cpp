@@ -0,0 +1,177 @@
+#include "textkeys.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+namespace
+{
+    struct TypeName
+    {
+        const char* mName;
+        NifOsg::TextKeyEvent::Type mType;
+    };
+
+    const TypeName sTypeNames[] = {
+        { "start", NifOsg::TextKeyEvent::Type_Start },
+        { "stop", NifOsg::TextKeyEvent::Type_Stop },
+        { "loop start", NifOsg::TextKeyEvent::Type_LoopStart },
+        { "loop stop", NifOsg::TextKeyEvent::Type_LoopStop },
+        { "equip attach", NifOsg::TextKeyEvent::Type_EquipAttach },
+        { "unequip detach", NifOsg::TextKeyEvent::Type_UnequipDetach },
+        { "chop hit", NifOsg::TextKeyEvent::Type_ChopHit },
+        { "slash hit", NifOsg::TextKeyEvent::Type_SlashHit },
+        { "thrust hit", NifOsg::TextKeyEvent::Type_ThrustHit },
+        { "hit", NifOsg::TextKeyEvent::Type_Hit },
+        { "shoot attach", NifOsg::TextKeyEvent::Type_ShootAttach },
+        { "shoot release", NifOsg::TextKeyEvent::Type_ShootRelease },
+        { "shoot follow attach", NifOsg::TextKeyEvent::Type_ShootFollowAttach },
+        { "block hit", NifOsg::TextKeyEvent::Type_BlockHit }
+    };
+
+    NifOsg::TextKeyEvent::Type getGroupKeyType(const std::string& name)
+    {
+        for (size_t i=0; i<sizeof(sTypeNames)/sizeof(sTypeNames[0]); ++i)
+            if (name == sTypeNames[i].mName)
+                return sTypeNames[i].mType;
+
+        if (name.size() >= 7 && name.compare(name.size()-7, 7, "release") == 0)
+            return NifOsg::TextKeyEvent::Type_Release;
+
+        return NifOsg::TextKeyEvent::Type_Other;
+    }
+
+    void parseSoundGen(const std::string& text, NifOsg::TextKeyEvent& event)
+    {
+        event.mName = text;
+
+        // The key can optionally contain volume and pitch modifiers
+        if (text.find(' ') != std::string::npos)
+        {
+            std::vector<std::string> tokens;
+            std::stringstream stream(text);
+            std::string item;
+            while (std::getline(stream, item, ' '))
+                tokens.push_back(item);
+
+            event.mName = tokens[0];
+            if (tokens.size() >= 2)
+            {
+                std::stringstream volume;
+                volume << tokens[1];
+                volume >> event.mVolume;
+            }
+            if (tokens.size() >= 3)
+            {
+                std::stringstream pitch;
+                pitch << tokens[2];
+                pitch >> event.mPitch;
+            }
+        }
+
+        event.mFootstep = (text == "left" || text == "right" || text == "land");
+    }
+
+    struct CompareTime
+    {
+        bool operator()(const NifOsg::TextKeyEvent& event, float time) const
+        {
+            return event.mTime < time;
+        }
+
+        bool operator()(float time, const NifOsg::TextKeyEvent& event) const
+        {
+            return time < event.mTime;
+        }
+    };
+
+    struct CompareGroupName
+    {
+        bool operator()(const NifOsg::TextKeyEvents::Group& group, const std::string& name) const
+        {
+            return group.mName < name;
+        }
+    };
+}
+
+namespace NifOsg
+{
+
+    TextKeyEvent::TextKeyEvent()
+        : mTime(0.f), mType(Type_Unknown), mGroup(-1), mVolume(1.f), mPitch(1.f), mFootstep(false)
+    {
+    }
+
+    void TextKeyEvents::build(const TextKeyMap& keys)
+    {
+        mEvents.clear();
+        mGroups.clear();
+        mEvents.reserve(keys.size());
+
+        std::map<std::string, std::vector<size_t> > groups;
+
+        for (TextKeyMap::const_iterator it = keys.begin(); it != keys.end(); ++it)
+        {
+            const std::string& text = it->second;
+
+            TextKeyEvent event;
+            event.mTime = it->first;
+
+            if (text.compare(0, 7, "sound: ") == 0)
+            {
+                event.mType = TextKeyEvent::Type_Sound;
+                event.mName = text.substr(7);
+            }
+            else if (text.compare(0, 10, "soundgen: ") == 0)
+            {
+                event.mType = TextKeyEvent::Type_SoundGen;
+                parseSoundGen(text.substr(10), event);
+            }
+            else
+            {
+                size_t separator = text.find(": ");
+                if (separator != std::string::npos)
+                {
+                    event.mName = text.substr(separator+2);
+                    event.mType = getGroupKeyType(event.mName);
+                    groups[text.substr(0, separator)].push_back(mEvents.size());
+                }
+                else
+                    event.mName = text;
+            }
+
+            mEvents.push_back(event);
+        }
+
+        mGroups.reserve(groups.size());
+        for (std::map<std::string, std::vector<size_t> >::iterator it = groups.begin(); it != groups.end(); ++it)
+        {
+            mGroups.push_back(Group());
+            mGroups.back().mName = it->first;
+            mGroups.back().mEvents.swap(it->second);
+
+            int index = static_cast<int>(mGroups.size()-1);
+            const std::vector<size_t>& events = mGroups.back().mEvents;
+            for (std::vector<size_t>::const_iterator event = events.begin(); event != events.end(); ++event)
+                mEvents[*event].mGroup = index;
+        }
+    }
+
+    int TextKeyEvents::findGroup(const std::string& name) const
+    {
+        std::vector<Group>::const_iterator found = std::lower_bound(mGroups.begin(), mGroups.end(), name, CompareGroupName());
+        if (found == mGroups.end() || found->mName != name)
+            return -1;
+        return static_cast<int>(found - mGroups.begin());
+    }
+
+    size_t TextKeyEvents::lowerBound(float time) const
+    {
+        return std::lower_bound(mEvents.begin(), mEvents.end(), time, CompareTime()) - mEvents.begin();
+    }
+
+    size_t TextKeyEvents::upperBound(float time) const
+    {
+        return std::upper_bound(mEvents.begin(), mEvents.end(), time, CompareTime()) - mEvents.begin();
+    }
+
+}
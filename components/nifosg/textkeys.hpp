@@ -0,0 +1,96 @@
+#ifndef OPENMW_COMPONENTS_NIFOSG_TEXTKEYS_H
+#define OPENMW_COMPONENTS_NIFOSG_TEXTKEYS_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace NifOsg
+{
+
+    typedef std::multimap<float,std::string> TextKeyMap;
+
+    /// @brief A text key parsed into what it means for animation playback.
+    struct TextKeyEvent
+    {
+        enum Type
+        {
+            Type_Other,             ///< Group key without a special meaning, see mName
+            Type_Start,
+            Type_Stop,              ///< Exactly "stop"; stop keys with trailing garbage are Type_Other
+            Type_LoopStart,
+            Type_LoopStop,
+            Type_EquipAttach,
+            Type_UnequipDetach,
+            Type_ChopHit,
+            Type_SlashHit,
+            Type_ThrustHit,
+            Type_Hit,
+            Type_ShootAttach,
+            Type_ShootRelease,
+            Type_ShootFollowAttach,
+            Type_Release,           ///< "<range type> release", see mName
+            Type_BlockHit,
+            Type_Sound,             ///< "sound: <id>", mName is the sound ID
+            Type_SoundGen,          ///< "soundgen: <type> [volume [pitch]]", mName is the SoundGen type
+            Type_Unknown            ///< Key without a group
+        };
+
+        float mTime;
+        Type mType;
+
+        /// Index of the group in TextKeyEvents::getGroups(), -1 for sound and unknown keys.
+        int mGroup;
+
+        /// Text after "<group>: " for group keys, the sound ID or SoundGen type for sound keys.
+        std::string mName;
+
+        float mVolume;
+        float mPitch;
+
+        /// Is this a SoundGen key for a footstep or landing?
+        bool mFootstep;
+
+        TextKeyEvent();
+    };
+
+    /// @brief The text keys of a keyframe file, parsed once at load time.
+    /// @note Keys are expected to be lower case, as the NIF loader provides them.
+    class TextKeyEvents
+    {
+    public:
+        struct Group
+        {
+            std::string mName;
+
+            /// Indices into getEvents() of this group's keys, in order of time.
+            std::vector<size_t> mEvents;
+        };
+
+        void build(const TextKeyMap& keys);
+
+        /// All keys in order of time, in the same order as the TextKeyMap they were built from.
+        const std::vector<TextKeyEvent>& getEvents() const { return mEvents; }
+
+        /// Groups sorted by name.
+        const std::vector<Group>& getGroups() const { return mGroups; }
+
+        /// @return Index of the group with the given name, or -1 if there are no keys for it.
+        int findGroup(const std::string& name) const;
+
+        /// @return Index of the first event with a time not less than \a time.
+        size_t lowerBound(float time) const;
+
+        /// @return Index of the first event with a time greater than \a time.
+        size_t upperBound(float time) const;
+
+        bool empty() const { return mEvents.empty(); }
+
+    private:
+        std::vector<TextKeyEvent> mEvents;
+        std::vector<Group> mGroups;
+    };
+
+}
+
+#endif
@@ -0,0 +1,22 @@
+#include "objectcache.hpp"
+
+#include <istream>
+
+namespace Resource
+{
+
+    CacheStats::CacheStats()
+        : mHits(0), mMisses(0), mEvictions(0), mObjects(0), mCost(0), mUnusedCost(0)
+    {
+    }
+
+    size_t getFileCost(std::istream& file)
+    {
+        file.seekg(0, std::ios_base::end);
+        std::streamoff size = file.tellg();
+        file.clear();
+        file.seekg(0, std::ios_base::beg);
+        return size > 0 ? static_cast<size_t>(size) : 0;
+    }
+
+}
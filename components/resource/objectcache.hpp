@@ -0,0 +1,190 @@
+#ifndef OPENMW_COMPONENTS_RESOURCE_OBJECTCACHE_H
+#define OPENMW_COMPONENTS_RESOURCE_OBJECTCACHE_H
+
+#include <algorithm>
+#include <iosfwd>
+#include <map>
+#include <vector>
+
+#include <osg/ref_ptr>
+#include <osg/Referenced>
+
+namespace Resource
+{
+
+    struct CacheStats
+    {
+        unsigned int mHits;
+        unsigned int mMisses;
+        unsigned int mEvictions;
+
+        size_t mObjects;
+
+        /// Approximate memory cost of all cached objects, in bytes
+        size_t mCost;
+
+        /// Approximate memory cost of the cached objects that are not used outside of the cache, in bytes
+        size_t mUnusedCost;
+
+        CacheStats();
+    };
+
+    /// @return Size of the given file, as a rough estimate of the memory cost of a resource loaded from it.
+    /// @note Leaves the read position at the start of the file.
+    size_t getFileCost(std::istream& file);
+
+    /// @brief Cache of shared resources that keeps objects no longer used outside of the cache for a while,
+    /// in case they are needed again.
+    /// @par An object is unused once the cache holds the only reference to it. update() expires objects that have been
+    /// unused for longer than the expiry delay, and while the unused objects cost more than the budget, the least
+    /// recently used of them. Objects are also considered used when they are retrieved with get().
+    template <class Key, class T>
+    class ObjectCache
+    {
+    public:
+        struct Entry
+        {
+            osg::ref_ptr<T> mObject;
+            size_t mCost;
+            double mLastUsed;
+        };
+
+        typedef std::map<Key, Entry> Map;
+        typedef typename Map::const_iterator const_iterator;
+
+        ObjectCache()
+            : mExpiryDelay(60.0)
+            , mBudget(0)
+            , mTime(0.0)
+        {
+        }
+
+        /// @param seconds How long unused objects are kept
+        void setExpiryDelay(double seconds)
+        {
+            mExpiryDelay = seconds;
+        }
+
+        /// @param budget Approximate memory cost in bytes that unused objects may have in total, 0 for no limit
+        void setBudget(size_t budget)
+        {
+            mBudget = budget;
+        }
+
+        /// @return The cached object, or NULL if there is none
+        T* get(const Key& key)
+        {
+            typename Map::iterator found = mObjects.find(key);
+            if (found == mObjects.end())
+            {
+                ++mStats.mMisses;
+                return NULL;
+            }
+
+            ++mStats.mHits;
+            found->second.mLastUsed = mTime;
+            return found->second.mObject.get();
+        }
+
+        /// @param cost Approximate memory cost of the object in bytes
+        void add(const Key& key, T* object, size_t cost)
+        {
+            Entry& entry = mObjects[key];
+            if (entry.mObject.valid())
+                mStats.mCost -= entry.mCost;
+            entry.mObject = object;
+            entry.mCost = cost;
+            entry.mLastUsed = mTime;
+            mStats.mCost += cost;
+            mStats.mObjects = mObjects.size();
+        }
+
+        /// Expire unused objects.
+        /// @param time Current time in seconds, from any monotonic clock
+        void update(double time)
+        {
+            mTime = time;
+
+            std::vector<std::pair<double, typename Map::iterator> > unused;
+            size_t unusedCost = 0;
+            for (typename Map::iterator it = mObjects.begin(); it != mObjects.end();)
+            {
+                Entry& entry = it->second;
+                if (entry.mObject->referenceCount() > 1)
+                    entry.mLastUsed = time;
+                else if (time - entry.mLastUsed > mExpiryDelay)
+                {
+                    erase(it++);
+                    continue;
+                }
+                else
+                {
+                    unused.push_back(std::make_pair(entry.mLastUsed, it));
+                    unusedCost += entry.mCost;
+                }
+                ++it;
+            }
+
+            if (mBudget && unusedCost > mBudget)
+            {
+                std::sort(unused.begin(), unused.end(), compareLastUsed);
+                for (size_t i=0; i<unused.size() && unusedCost > mBudget; ++i)
+                {
+                    unusedCost -= unused[i].second->second.mCost;
+                    erase(unused[i].second);
+                }
+            }
+
+            mStats.mUnusedCost = unusedCost;
+        }
+
+        void clear()
+        {
+            mObjects.clear();
+            mStats.mObjects = 0;
+            mStats.mCost = 0;
+            mStats.mUnusedCost = 0;
+        }
+
+        const CacheStats& getStats() const
+        {
+            return mStats;
+        }
+
+        const_iterator begin() const
+        {
+            return mObjects.begin();
+        }
+
+        const_iterator end() const
+        {
+            return mObjects.end();
+        }
+
+    private:
+        static bool compareLastUsed(const std::pair<double, typename Map::iterator>& left,
+                                    const std::pair<double, typename Map::iterator>& right)
+        {
+            return left.first < right.first;
+        }
+
+        void erase(typename Map::iterator it)
+        {
+            mStats.mCost -= it->second.mCost;
+            ++mStats.mEvictions;
+            mObjects.erase(it);
+            mStats.mObjects = mObjects.size();
+        }
+
+        Map mObjects;
+
+        double mExpiryDelay;
+        size_t mBudget;
+        double mTime;
+
+        CacheStats mStats;
+    };
+
+}
+
+#endif
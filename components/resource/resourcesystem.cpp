@@ -33,4 +33,24 @@ namespace Resource
         return mVFS;
     }
 
+    void ResourceSystem::setCacheLimits(double expiryDelay, size_t budget)
+    {
+        mSceneManager->setCacheLimits(expiryDelay, budget);
+        mTextureManager->setCacheLimits(expiryDelay, budget);
+    }
+
+    void ResourceSystem::updateCache(double time)
+    {
+        // Scenes first, so that the textures of expired scenes can expire right away
+        mSceneManager->updateCache(time);
+        mTextureManager->updateCache(time);
+    }
+
+    void ResourceSystem::getCacheStats(std::map<std::string, CacheStats>& stats) const
+    {
+        stats["Meshes"] = mSceneManager->getTemplateCacheStats();
+        stats["Animations"] = mSceneManager->getKeyframeCacheStats();
+        stats["Textures"] = mTextureManager->getCacheStats();
+    }
+
 }
@@ -1,7 +1,9 @@
 #ifndef OPENMW_COMPONENTS_RESOURCE_RESOURCESYSTEM_H
 #define OPENMW_COMPONENTS_RESOURCE_RESOURCESYSTEM_H
 
+#include <map>
 #include <memory>
+#include <string>
 
 namespace VFS
 {
@@ -13,6 +15,7 @@ namespace Resource
 
     class SceneManager;
     class TextureManager;
+    struct CacheStats;
 
     /// @brief Wrapper class that constructs and provides access to the various resource subsystems.
     /// @par Resource subsystems can be used with multiple OpenGL contexts, just like the OSG equivalents, but
@@ -28,6 +31,17 @@ namespace Resource
 
         const VFS::Manager* getVFS() const;
 
+        /// @param expiryDelay Seconds that resources no longer in use are kept
+        /// @param budget Approximate memory cost in bytes that each cache may keep for resources no longer in use, 0 for no limit
+        void setCacheLimits(double expiryDelay, size_t budget);
+
+        /// Expire cached resources no longer in use. Call once per frame.
+        /// @param time Current time in seconds
+        void updateCache(double time);
+
+        /// Add the statistics of each cache, by cache name.
+        void getCacheStats(std::map<std::string, CacheStats>& stats) const;
+
     private:
         std::auto_ptr<SceneManager> mSceneManager;
         std::auto_ptr<TextureManager> mTextureManager;
@@ -14,6 +14,8 @@
 #include <components/nifosg/nifloader.hpp>
 #include <components/nif/niffile.hpp>
 
+#include <components/misc/profiler.hpp>
+
 #include <components/vfs/manager.hpp>
 
 #include <components/sceneutil/clone.hpp>
@@ -94,17 +96,20 @@ namespace Resource
 
     osg::ref_ptr<const osg::Node> SceneManager::getTemplate(const std::string &name)
     {
+        Misc::ProfileZone zone("SceneManager::getTemplate");
         std::string normalized = name;
         mVFS->normalizeFilename(normalized);
 
-        Index::iterator it = mIndex.find(normalized);
-        if (it == mIndex.end())
+        const osg::Node* cached = mIndex.get(normalized);
+        if (!cached)
         {
             // TODO: add support for non-NIF formats
             osg::ref_ptr<osg::Node> loaded;
+            size_t cost = 0;
             try
             {
                 Files::IStreamPtr file = mVFS->get(normalized);
+                cost = getFileCost(*file);
 
                 loaded = NifOsg::Loader::load(Nif::NIFFilePtr(new Nif::NIFFile(file, normalized)), mTextureManager);
             }
@@ -112,6 +117,7 @@ namespace Resource
             {
                 std::cerr << "Failed to load '" << name << "': " << e.what() << ", using marker_error.nif instead" << std::endl;
                 Files::IStreamPtr file = mVFS->get("meshes/marker_error.nif");
+                cost = getFileCost(*file);
                 loaded = NifOsg::Loader::load(Nif::NIFFilePtr(new Nif::NIFFile(file, normalized)), mTextureManager);
             }
 
@@ -121,11 +127,11 @@ namespace Resource
             if (mIncrementalCompileOperation)
                 mIncrementalCompileOperation->add(loaded);
 
-            mIndex[normalized] = loaded;
+            mIndex.add(normalized, loaded.get(), cost);
             return loaded;
         }
         else
-            return it->second;
+            return cached;
     }
 
     osg::ref_ptr<osg::Node> SceneManager::createInstance(const std::string &name)
@@ -147,19 +153,20 @@ namespace Resource
         std::string normalized = name;
         mVFS->normalizeFilename(normalized);
 
-        KeyframeIndex::iterator it = mKeyframeIndex.find(normalized);
-        if (it == mKeyframeIndex.end())
+        const NifOsg::KeyframeHolder* cached = mKeyframeIndex.get(normalized);
+        if (!cached)
         {
             Files::IStreamPtr file = mVFS->get(normalized);
+            size_t cost = getFileCost(*file);
 
             osg::ref_ptr<NifOsg::KeyframeHolder> loaded (new NifOsg::KeyframeHolder);
             NifOsg::Loader::loadKf(Nif::NIFFilePtr(new Nif::NIFFile(file, normalized)), *loaded.get());
 
-            mKeyframeIndex[normalized] = loaded;
+            mKeyframeIndex.add(normalized, loaded.get(), cost);
             return loaded;
         }
         else
-            return it->second;
+            return cached;
     }
 
     void SceneManager::attachTo(osg::Node *instance, osg::Group *parentNode) const
@@ -170,9 +177,9 @@ namespace Resource
 
     void SceneManager::releaseGLObjects(osg::State *state)
     {
-        for (Index::iterator it = mIndex.begin(); it != mIndex.end(); ++it)
+        for (Index::const_iterator it = mIndex.begin(); it != mIndex.end(); ++it)
         {
-            it->second->releaseGLObjects(state);
+            it->second.mObject->releaseGLObjects(state);
         }
     }
 
@@ -197,4 +204,28 @@ namespace Resource
         return mTextureManager;
     }
 
+    void SceneManager::setCacheLimits(double expiryDelay, size_t budget)
+    {
+        mIndex.setExpiryDelay(expiryDelay);
+        mIndex.setBudget(budget);
+        mKeyframeIndex.setExpiryDelay(expiryDelay);
+        mKeyframeIndex.setBudget(budget);
+    }
+
+    void SceneManager::updateCache(double time)
+    {
+        mIndex.update(time);
+        mKeyframeIndex.update(time);
+    }
+
+    const CacheStats& SceneManager::getTemplateCacheStats() const
+    {
+        return mIndex.getStats();
+    }
+
+    const CacheStats& SceneManager::getKeyframeCacheStats() const
+    {
+        return mKeyframeIndex.getStats();
+    }
+
 }
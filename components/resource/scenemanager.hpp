@@ -7,6 +7,8 @@
 #include <osg/ref_ptr>
 #include <osg/Node>
 
+#include "objectcache.hpp"
+
 namespace Resource
 {
     class TextureManager;
@@ -73,17 +75,26 @@ namespace Resource
 
         Resource::TextureManager* getTextureManager();
 
+        /// @see ObjectCache
+        void setCacheLimits(double expiryDelay, size_t budget);
+
+        /// Expire unused templates and keyframes.
+        /// @note Templates are not referenced by their instances, so they expire once they have not been requested for a while.
+        void updateCache(double time);
+
+        const CacheStats& getTemplateCacheStats() const;
+        const CacheStats& getKeyframeCacheStats() const;
+
     private:
         const VFS::Manager* mVFS;
         Resource::TextureManager* mTextureManager;
 
         osg::ref_ptr<osgUtil::IncrementalCompileOperation> mIncrementalCompileOperation;
 
-        // observer_ptr?
-        typedef std::map<std::string, osg::ref_ptr<const osg::Node> > Index;
+        typedef ObjectCache<std::string, const osg::Node> Index;
         Index mIndex;
 
-        typedef std::map<std::string, osg::ref_ptr<const NifOsg::KeyframeHolder> > KeyframeIndex;
+        typedef ObjectCache<std::string, const NifOsg::KeyframeHolder> KeyframeIndex;
         KeyframeIndex mKeyframeIndex;
 
         SceneManager(const SceneManager&);
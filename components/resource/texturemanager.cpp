@@ -70,9 +70,9 @@ namespace Resource
         mMagFilter = magFilter;
         mMaxAnisotropy = std::max(1, maxAnisotropy);
 
-        for (std::map<MapKey, osg::ref_ptr<osg::Texture2D> >::iterator it = mTextures.begin(); it != mTextures.end(); ++it)
+        for (ObjectCache<MapKey, osg::Texture2D>::const_iterator it = mTextures.begin(); it != mTextures.end(); ++it)
         {
-            osg::ref_ptr<osg::Texture2D> tex = it->second;
+            osg::ref_ptr<osg::Texture2D> tex = it->second.mObject;
 
             // Keep mip-mapping disabled if the texture creator explicitely requested no mipmapping.
             osg::Texture::FilterMode oldMin = tex->getFilter(osg::Texture::MIN_FILTER);
@@ -140,10 +140,10 @@ namespace Resource
         std::string normalized = filename;
         mVFS->normalizeFilename(normalized);
         MapKey key = std::make_pair(std::make_pair(wrapS, wrapT), normalized);
-        std::map<MapKey, osg::ref_ptr<osg::Texture2D> >::iterator found = mTextures.find(key);
-        if (found != mTextures.end())
+        osg::Texture2D* found = mTextures.get(key);
+        if (found)
         {
-            return found->second;
+            return found;
         }
         else
         {
@@ -202,7 +202,7 @@ namespace Resource
 
             texture->setUnRefImageDataAfterApply(mUnRefImageDataAfterApply);
 
-            mTextures.insert(std::make_pair(key, texture));
+            mTextures.add(key, texture.get(), image->getTotalSizeInBytesIncludingMipmaps());
             return texture;
         }
     }
@@ -212,4 +212,20 @@ namespace Resource
         return mWarningTexture.get();
     }
 
+    void TextureManager::setCacheLimits(double expiryDelay, size_t budget)
+    {
+        mTextures.setExpiryDelay(expiryDelay);
+        mTextures.setBudget(budget);
+    }
+
+    void TextureManager::updateCache(double time)
+    {
+        mTextures.update(time);
+    }
+
+    const CacheStats& TextureManager::getCacheStats() const
+    {
+        return mTextures.getStats();
+    }
+
 }
@@ -8,6 +8,8 @@
 #include <osg/Image>
 #include <osg/Texture2D>
 
+#include "objectcache.hpp"
+
 namespace VFS
 {
     class Manager;
@@ -40,6 +42,14 @@ namespace Resource
 
         osg::Texture2D* getWarningTexture();
 
+        /// @see ObjectCache
+        void setCacheLimits(double expiryDelay, size_t budget);
+
+        /// Expire textures no longer used by any StateSet.
+        void updateCache(double time);
+
+        const CacheStats& getCacheStats() const;
+
     private:
         const VFS::Manager* mVFS;
 
@@ -51,7 +61,7 @@ namespace Resource
 
         std::map<std::string, osg::observer_ptr<osg::Image> > mImages;
 
-        std::map<MapKey, osg::ref_ptr<osg::Texture2D> > mTextures;
+        ObjectCache<MapKey, osg::Texture2D> mTextures;
 
         osg::ref_ptr<osg::Texture2D> mWarningTexture;
 
@@ -1,5 +1,6 @@
 #include "clone.hpp"
 
+#include <osg/Geode>
 #include <osg/StateSet>
 
 #include <osgParticle/ParticleProcessor>
@@ -11,6 +12,39 @@
 
 #include <components/sceneutil/riggeometry.hpp>
 
+namespace
+{
+
+    bool isDynamic(const osg::StateSet* stateset)
+    {
+        return stateset && stateset->getDataVariance() == osg::Object::DYNAMIC;
+    }
+
+    /// Can the Geode be shared between instances instead of being copied?
+    /// @note User data is not considered, since the NIF loader only attaches immutable record information.
+    bool isShareable(const osg::Geode* geode)
+    {
+        if (geode->getDataVariance() == osg::Object::DYNAMIC || isDynamic(geode->getStateSet())
+                || geode->getUpdateCallback() || geode->getCullCallback() || geode->getEventCallback())
+            return false;
+
+        for (unsigned int i=0; i<geode->getNumDrawables(); ++i)
+        {
+            const osg::Drawable* drawable = geode->getDrawable(i);
+            if (drawable->getUpdateCallback() || drawable->getCullCallback() || drawable->getEventCallback()
+                    || isDynamic(drawable->getStateSet()))
+                return false;
+
+            if (dynamic_cast<const osgParticle::ParticleSystem*>(drawable)
+                    || dynamic_cast<const osgAnimation::MorphGeometry*>(drawable)
+                    || dynamic_cast<const SceneUtil::RigGeometry*>(drawable))
+                return false;
+        }
+        return true;
+    }
+
+}
+
 namespace SceneUtil
 {
 
@@ -41,6 +75,11 @@ namespace SceneUtil
             mMap2[cloned] = updater->getParticleSystem(0);
             return cloned;
         }
+        if (const osg::Geode* geode = node->asGeode())
+        {
+            if (isShareable(geode))
+                return const_cast<osg::Geode*>(geode);
+        }
         return osg::CopyOp::operator()(node);
     }
 
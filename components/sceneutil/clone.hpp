@@ -19,6 +19,9 @@ namespace SceneUtil
     /// * Assigns updated ParticleSystem pointers on cloned emitters and programs.
     /// * Creates deep copy of StateSets if they have a DYNAMIC data variance.
     /// * Deep copies RigGeometry and MorphGeometry so they can animate without affecting clones.
+    /// * Shares Geodes that can not change per instance, i.e. Geodes without callbacks, DYNAMIC StateSets or animated
+    ///   drawables, between the original and the clone. Such a Geode has one parent per instance,
+    ///   so code operating on instances must not rely on getParent(0) of a Geode.
     /// @warning Do not use an object of this class for more than one copy operation.
     class CopyOp : public osg::CopyOp
     {
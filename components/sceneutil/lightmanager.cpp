@@ -9,6 +9,8 @@
 
 #include <components/sceneutil/util.hpp>
 
+#include <components/misc/profiler.hpp>
+
 #include <boost/functional/hash.hpp>
 
 namespace SceneUtil
@@ -248,6 +250,7 @@ namespace SceneUtil
 
     void LightListCallback::operator()(osg::Node *node, osg::NodeVisitor *nv)
     {
+        Misc::ProfileZone zone("LightListCallback");
         osgUtil::CullVisitor* cv = static_cast<osgUtil::CullVisitor*>(nv);
 
         if (!(cv->getCurrentCamera()->getCullMask()&Mask_Lit))
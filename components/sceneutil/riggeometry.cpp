@@ -7,6 +7,8 @@
 
 #include <osg/MatrixTransform>
 
+#include <components/misc/profiler.hpp>
+
 #include "skeleton.hpp"
 #include "util.hpp"
 
@@ -52,6 +54,7 @@ public:
 
     virtual bool cull(osg::NodeVisitor* nv, osg::Drawable* drw, osg::State*) const
     {
+        Misc::ProfileZone zone("UpdateRigGeometry");
         RigGeometry* geom = static_cast<RigGeometry*>(drw);
         geom->update(nv);
         return false;
@@ -1,5 +1,7 @@
 #include "workqueue.hpp"
 
+#include <components/misc/profiler.hpp>
+
 namespace SceneUtil
 {
 
@@ -15,6 +17,11 @@ void WorkTicket::waitTillDone()
     }
 }
 
+bool WorkTicket::isDone()
+{
+    return mDone > 0;
+}
+
 void WorkTicket::signalDone()
 {
     {
@@ -109,12 +116,16 @@ WorkThread::WorkThread(WorkQueue *workQueue)
 
 void WorkThread::run()
 {
+    Misc::Profiler::setThreadName("WorkQueue");
     while (true)
     {
         WorkItem* item = mWorkQueue->removeWorkItem();
         if (!item)
             return;
-        item->doWork();
+        {
+            Misc::ProfileZone zone("WorkItem");
+            item->doWork();
+        }
         delete item;
     }
 }
@@ -19,6 +19,9 @@ namespace SceneUtil
     public:
         void waitTillDone();
 
+        /// Check if the work is done, without blocking.
+        bool isDone();
+
         void signalDone();
 
     private:
@@ -0,0 +1,92 @@
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../to_utf8.hpp"
+
+/// Measure conversion throughput for the kinds of strings found in content files
+/// Not part of test.sh, since the results depend on the machine
+
+std::string getFirstLine(const std::string &filename)
+{
+    std::string line;
+    std::ifstream text (filename.c_str());
+
+    if (!text.is_open())
+    {
+        throw std::runtime_error("Unable to open file " + filename);
+    }
+
+    std::getline(text, line);
+    return line;
+}
+
+void benchmark(const std::string &name, ToUTF8::FromType encoding, const std::vector<std::string> &strings)
+{
+    ToUTF8::Utf8Encoder encoder (encoding);
+
+    size_t bytes = 0;
+    for (std::vector<std::string>::const_iterator it = strings.begin(); it != strings.end(); ++it)
+        bytes += it->size();
+
+    const int runs = 20;
+    size_t check = 0;
+
+    std::clock_t start = std::clock();
+    for (int run=0; run<runs; ++run)
+        for (std::vector<std::string>::const_iterator it = strings.begin(); it != strings.end(); ++it)
+            check += encoder.getUtf8(it->c_str(), it->size()).size();
+    double returned = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+
+    std::string output;
+    start = std::clock();
+    for (int run=0; run<runs; ++run)
+        for (std::vector<std::string>::const_iterator it = strings.begin(); it != strings.end(); ++it)
+        {
+            encoder.getUtf8(it->c_str(), it->size(), output);
+            check -= output.size();
+        }
+    double reused = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+
+    if (check != 0)
+        throw std::runtime_error("Conversion results differ for " + name);
+
+    double megabytes = static_cast<double>(bytes) * runs / (1024 * 1024);
+    std::cout << name << ": " << strings.size() << " strings, " << bytes / 1024 << " KB: "
+              << megabytes / returned << " MB/s returned, "
+              << megabytes / reused << " MB/s into a reused string" << std::endl;
+}
+
+int main()
+{
+    std::string french = getFirstLine("test_data/french-win1252.txt");
+    std::string russian = getFirstLine("test_data/russian-win1251.txt");
+
+    // record IDs and names, pure ASCII
+    std::vector<std::string> ids;
+    for (int i=0; i<100000; ++i)
+        ids.push_back("misc_com_bottle_" + std::string(1, static_cast<char>('a' + i % 26)));
+
+    // books and dialogue, mostly ASCII with a few quotation marks
+    std::vector<std::string> books;
+    for (int i=0; i<200; ++i)
+    {
+        std::string book;
+        while (book.size() < 8192)
+            book += std::string(300, 'a') + french;
+        books.push_back(book);
+    }
+
+    // translated text, mostly non-ASCII
+    std::vector<std::string> cyrillic;
+    for (int i=0; i<2000; ++i)
+        cyrillic.push_back(russian + russian + russian);
+
+    benchmark("ids", ToUTF8::WINDOWS_1252, ids);
+    benchmark("books", ToUTF8::WINDOWS_1252, books);
+    benchmark("cyrillic", ToUTF8::WINDOWS_1251, cyrillic);
+    return 0;
+}
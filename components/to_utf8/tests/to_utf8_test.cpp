@@ -8,6 +8,8 @@
 std::string getFirstLine(const std::string &filename);
 void testEncoder(ToUTF8::FromType encoding, const std::string &legacyEncFile,
                  const std::string &utf8File);
+void testLongText(ToUTF8::FromType encoding, const std::string &legacyEncFile,
+                  const std::string &utf8File);
 
 /// Test character encoding conversion to and from UTF-8
 void testEncoder(ToUTF8::FromType encoding, const std::string &legacyEncFile,
@@ -35,6 +37,42 @@ void testEncoder(ToUTF8::FromType encoding, const std::string &legacyEncFile,
     assert(convertedLegacyEncLine == legacyEncLine);
 }
 
+/// Test conversion of text spanning many blocks, with ASCII runs of every
+/// alignment and an embedded null terminator
+void testLongText(ToUTF8::FromType encoding, const std::string &legacyEncFile,
+                  const std::string &utf8File)
+{
+    std::string legacyEncLine = getFirstLine(legacyEncFile);
+    std::string utf8Line = getFirstLine(utf8File);
+
+    std::string legacyEncText;
+    std::string utf8Text;
+    for (int i=0; i<40; ++i)
+    {
+        std::string padding (i, 'x');
+        legacyEncText += padding + legacyEncLine;
+        utf8Text += padding + utf8Line;
+    }
+
+    ToUTF8::Utf8Encoder encoder (encoding);
+    assert(encoder.getUtf8(legacyEncText) == utf8Text);
+
+    // convert into a reused output string
+    std::string output = "previous content";
+    encoder.getUtf8(legacyEncText.c_str(), legacyEncText.size(), output);
+    assert(output == utf8Text);
+    encoder.getUtf8(legacyEncLine.c_str(), legacyEncLine.size(), output);
+    assert(output == utf8Line);
+
+    // conversion stops at the first null terminator
+    std::string terminated = legacyEncText;
+    terminated[legacyEncLine.size() + 1] = '\0';
+    encoder.getUtf8(terminated.c_str(), terminated.size(), output);
+    assert(output == encoder.getUtf8(legacyEncLine.c_str(), legacyEncLine.size()) + "x");
+
+    assert(encoder.getLegacyEnc(utf8Text) == legacyEncText);
+}
+
 std::string getFirstLine(const std::string &filename)
 {
     std::string line;
@@ -55,5 +93,7 @@ int main()
 {
     testEncoder(ToUTF8::WINDOWS_1251, "test_data/russian-win1251.txt", "test_data/russian-utf8.txt");
     testEncoder(ToUTF8::WINDOWS_1252, "test_data/french-win1252.txt", "test_data/french-utf8.txt");
+    testLongText(ToUTF8::WINDOWS_1251, "test_data/russian-win1251.txt", "test_data/russian-utf8.txt");
+    testLongText(ToUTF8::WINDOWS_1252, "test_data/french-win1252.txt", "test_data/french-utf8.txt");
     return 0;
 }
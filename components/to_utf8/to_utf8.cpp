@@ -2,10 +2,20 @@
 
 #include <vector>
 #include <cassert>
+#include <cstddef>
+#include <cstring>
 #include <iostream>
 #include <iomanip>
 #include <stdexcept>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TO_UTF8_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define TO_UTF8_NEON
+#include <arm_neon.h>
+#endif
+
 /* This file contains the code to translate from WINDOWS-1252 (native
    charset used in English version of Morrowind) to UTF-8. The library
    is designed to be extened to support more source encodings later,
@@ -36,6 +46,10 @@
    marks.) Within these, almost all the characters are ASCII. For this
    purpose, the library is also optimized for mostly-ASCII contents
    even in the cases where some conversion is necessary.
+
+   ASCII runs are found 16 bytes at a time with SSE2 or NEON where
+   available (or a machine word at a time otherwise), and copied with
+   memcpy. Only the non-ASCII characters go through the lookup table.
  */
 
 
@@ -44,6 +58,59 @@
 
 using namespace ToUTF8;
 
+namespace
+{
+#if defined(TO_UTF8_SSE2) || defined(TO_UTF8_NEON)
+    const std::ptrdiff_t BlockSize = 16;
+#else
+    const std::ptrdiff_t BlockSize = sizeof(size_t);
+#endif
+
+    enum BlockFlags
+    {
+        Block_NonAscii = 1,     // Contains characters that need translation
+        Block_Terminated = 2    // Contains a null terminator
+    };
+
+    // Classify the BlockSize characters at ptr, returning a combination
+    // of BlockFlags, or 0 for a block of ASCII characters only.
+    inline int getBlockFlags(const char* ptr)
+    {
+#if defined(TO_UTF8_SSE2)
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+        // The high bit of each byte is set for non-ASCII characters
+        return (_mm_movemask_epi8(block) ? Block_NonAscii : 0)
+             | (_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_setzero_si128())) ? Block_Terminated : 0);
+#elif defined(TO_UTF8_NEON)
+        uint8x16_t block = vld1q_u8(reinterpret_cast<const uint8_t*>(ptr));
+        uint64x2_t high = vreinterpretq_u64_u8(vcgeq_u8(block, vdupq_n_u8(128)));
+        uint64x2_t zero = vreinterpretq_u64_u8(vceqq_u8(block, vdupq_n_u8(0)));
+        return ((vgetq_lane_u64(high, 0) | vgetq_lane_u64(high, 1)) ? Block_NonAscii : 0)
+             | ((vgetq_lane_u64(zero, 0) | vgetq_lane_u64(zero, 1)) ? Block_Terminated : 0);
+#else
+        const size_t ones = static_cast<size_t>(-1) / 0xff;
+        const size_t highBits = ones * 0x80;
+        size_t word;
+        std::memcpy(&word, ptr, sizeof(word));
+        return ((word & highBits) ? Block_NonAscii : 0)
+             | (((word - ones) & ~word & highBits) ? Block_Terminated : 0);
+#endif
+    }
+
+    // Return a pointer to the first character in [ptr, end) that is
+    // either non-ASCII or a null terminator, or end if there is none.
+    const char* skipAscii(const char* ptr, const char* end)
+    {
+        while (end - ptr >= BlockSize && getBlockFlags(ptr) == 0)
+            ptr += BlockSize;
+
+        // Find the exact position in the last block
+        while (ptr != end && static_cast<unsigned char>(*ptr) - 1u < 127u)
+            ++ptr;
+        return ptr;
+    }
+}
+
 Utf8Encoder::Utf8Encoder(const FromType sourceEncoding):
     mOutput(50*1024)
 {
@@ -78,6 +145,13 @@ Utf8Encoder::Utf8Encoder(const FromType sourceEncoding):
 }
 
 std::string Utf8Encoder::getUtf8(const char* input, size_t size)
+{
+    std::string output;
+    getUtf8(input, size, output);
+    return output;
+}
+
+void Utf8Encoder::getUtf8(const char* input, size_t size, std::string& output)
 {
     // Double check that the input string stops at some point (it might
     // contain zero terminators before this, inside its own data, which
@@ -93,29 +167,36 @@ std::string Utf8Encoder::getUtf8(const char* input, size_t size)
     // Compute output length, and check for pure ascii input at the same
     // time.
     bool ascii;
-    size_t outlen = getLength(input, ascii);
+    size_t outlen = getLength(input, size, ascii);
 
     // If we're pure ascii, then don't bother converting anything.
     if(ascii)
-        return std::string(input, outlen);
+    {
+        output.assign(input, outlen);
+        return;
+    }
 
-    // Make sure the output is large enough
-    resize(outlen);
-    char *out = &mOutput[0];
+    // Translate directly into the output, copying ASCII runs in one go
+    output.resize(outlen);
+    char *out = &output[0];
+    const char* end = input + size;
+    while (input != end && *input)
+    {
+        unsigned char ch = *input;
+        if (ch < 128 && end - input >= BlockSize && getBlockFlags(input) == 0)
+        {
+            std::memcpy(out, input, BlockSize);
+            out += BlockSize;
+            input += BlockSize;
+            continue;
+        }
 
-    // Translate
-    while (*input)
-        copyFromArray(*(input++), out);
+        copyFromArray(ch, out);
+        ++input;
+    }
 
     // Make sure that we wrote the correct number of bytes
-    assert((out-&mOutput[0]) == (int)outlen);
-
-    // And make extra sure the output is null terminated
-    assert(mOutput.size() > outlen);
-    assert(mOutput[outlen] == 0);
-
-    // Return a string
-    return std::string(&mOutput[0], outlen);
+    assert((out-&output[0]) == (int)outlen);
 }
 
 std::string Utf8Encoder::getLegacyEnc(const char *input, size_t size)
@@ -134,7 +215,7 @@ std::string Utf8Encoder::getLegacyEnc(const char *input, size_t size)
     // Compute output length, and check for pure ascii input at the same
     // time.
     bool ascii;
-    size_t outlen = getLength2(input, ascii);
+    size_t outlen = getLength2(input, size, ascii);
 
     // If we're pure ascii, then don't bother converting anything.
     if(ascii)
@@ -182,31 +263,47 @@ void Utf8Encoder::resize(size_t size)
   is the case, then the ascii parameter is set to true, and the
   caller can optimize for this case.
  */
-size_t Utf8Encoder::getLength(const char* input, bool &ascii)
+size_t Utf8Encoder::getLength(const char* input, size_t size, bool &ascii)
 {
     ascii = true;
-    size_t len = 0;
-    const char* ptr = input;
-    unsigned char inp = *ptr;
+    const char* end = input + size;
 
     // Do away with the ascii part of the string first (this is almost
     // always the entire string.)
-    while (inp && inp < 128)
-        inp = *(++ptr);
-    len += (ptr-input);
+    const char* ptr = skipAscii(input, end);
+    size_t len = ptr-input;
 
     // If we're not at the null terminator at this point, then there
     // were some non-ascii characters to deal with. Go to slow-mode for
     // the rest of the string.
-    if (inp)
+    if (ptr != end && *ptr)
     {
         ascii = false;
-        while (inp)
+        while (ptr != end && *ptr)
         {
-            // Find the translated length of this character in the
-            // lookup table.
-            len += translationArray[inp*6];
-            inp = *(++ptr);
+            if (end - ptr >= BlockSize)
+            {
+                int flags = getBlockFlags(ptr);
+                if (flags == 0)
+                {
+                    len += BlockSize;
+                    ptr += BlockSize;
+                    continue;
+                }
+                if (flags == Block_NonAscii)
+                {
+                    // Find the translated length of these characters in
+                    // the lookup table.
+                    for (std::ptrdiff_t i=0; i<BlockSize; ++i)
+                        len += translationArray[static_cast<unsigned char>(ptr[i])*6];
+                    ptr += BlockSize;
+                    continue;
+                }
+            }
+
+            // The end of the string
+            for (unsigned char inp = *ptr; ptr != end && inp; inp = *(++ptr))
+                len += translationArray[inp*6];
         }
     }
     return len;
@@ -229,17 +326,15 @@ void Utf8Encoder::copyFromArray(unsigned char ch, char* &out)
         *(out++) = *(in++);
 }
 
-size_t Utf8Encoder::getLength2(const char* input, bool &ascii)
+size_t Utf8Encoder::getLength2(const char* input, size_t size, bool &ascii)
 {
     ascii = true;
     size_t len = 0;
-    const char* ptr = input;
-    unsigned char inp = *ptr;
 
     // Do away with the ascii part of the string first (this is almost
     // always the entire string.)
-    while (inp && inp < 128)
-        inp = *(++ptr);
+    const char* ptr = skipAscii(input, input + size);
+    unsigned char inp = *ptr;
     len += (ptr-input);
 
     // If we're not at the null terminator at this point, then there
@@ -34,6 +34,10 @@ namespace ToUTF8
                 return getUtf8(str.c_str(), str.size());
             }
 
+            // Convert to UTF8 into a caller provided string, reusing its
+            // memory. The output must not be the input string.
+            void getUtf8(const char *input, size_t size, std::string &output);
+
             std::string getLegacyEnc(const char *input, size_t size);
             inline std::string getLegacyEnc(const std::string &str)
             {
@@ -42,9 +46,9 @@ namespace ToUTF8
 
         private:
             void resize(size_t size);
-            size_t getLength(const char* input, bool &ascii);
+            size_t getLength(const char* input, size_t size, bool &ascii);
             void copyFromArray(unsigned char chp, char* &out);
-            size_t getLength2(const char* input, bool &ascii);
+            size_t getLength2(const char* input, size_t size, bool &ascii);
             void copyFromArray2(const char*& chp, char* &out);
 
             std::vector<char> mOutput;
@@ -0,0 +1,28 @@
+#include "accesstrace.hpp"
+
+#include <stdexcept>
+
+#include <OpenThreads/ScopedLock>
+
+namespace VFS
+{
+
+    AccessTrace::AccessTrace(const boost::filesystem::path &file)
+        : mStream(file)
+    {
+        if (!mStream.is_open())
+            throw std::runtime_error("Unable to create VFS access trace " + file.string());
+    }
+
+    void AccessTrace::fileOpened(const std::string &normalizedName)
+    {
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+
+        if (!mFiles.insert(normalizedName).second)
+            return;
+
+        // Flush, so that the trace is complete even if the process does not exit cleanly
+        mStream << normalizedName << std::endl;
+    }
+
+}
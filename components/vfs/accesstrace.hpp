@@ -0,0 +1,36 @@
+#ifndef OPENMW_COMPONENTS_VFS_ACCESSTRACE_H
+#define OPENMW_COMPONENTS_VFS_ACCESSTRACE_H
+
+#include <set>
+#include <string>
+
+#include <boost/filesystem/fstream.hpp>
+
+#include <OpenThreads/Mutex>
+
+#include "manager.hpp"
+
+namespace VFS
+{
+
+    /// @brief Writes the names of opened files to a text file, one per line, in the order they were first opened.
+    /// @par The trace can be used by "bsatool pack" to place files that are loaded together next to each other.
+    class AccessTrace : public AccessListener
+    {
+    public:
+        /// @note Throws an exception if the file can not be created.
+        AccessTrace(const boost::filesystem::path& file);
+
+        virtual void fileOpened(const std::string& normalizedName);
+
+    private:
+        OpenThreads::Mutex mMutex;
+
+        boost::filesystem::ofstream mStream;
+
+        std::set<std::string> mFiles;
+    };
+
+}
+
+#endif
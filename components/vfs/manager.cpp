@@ -31,6 +31,7 @@ namespace VFS
 
     Manager::Manager(bool strict)
         : mStrict(strict)
+        , mAccessListener(NULL)
     {
 
     }
@@ -68,6 +69,8 @@ namespace VFS
         std::map<std::string, File*>::const_iterator found = mIndex.find(normalizedName);
         if (found == mIndex.end())
             throw std::runtime_error("Resource '" + normalizedName + "' not found");
+        if (mAccessListener)
+            mAccessListener->fileOpened(normalizedName);
         return found->second->open();
     }
 
@@ -79,6 +82,11 @@ namespace VFS
         return mIndex.find(normalized) != mIndex.end();
     }
 
+    void Manager::setAccessListener(AccessListener *listener)
+    {
+        mAccessListener = listener;
+    }
+
     const std::map<std::string, File*>& Manager::getIndex() const
     {
         return mIndex;
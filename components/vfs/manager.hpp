@@ -3,6 +3,7 @@
 
 #include <components/files/constrainedfilestream.hpp>
 
+#include <string>
 #include <vector>
 #include <map>
 
@@ -12,6 +13,16 @@ namespace VFS
     class Archive;
     class File;
 
+    /// @brief Gets notified of the files opened through a Manager, e.g. to record the order in which they are used.
+    class AccessListener
+    {
+    public:
+        virtual ~AccessListener() {}
+
+        /// @note May be called from any thread opening files through the Manager.
+        virtual void fileOpened(const std::string& normalizedName) = 0;
+    };
+
     /// @brief The main class responsible for loading files from a virtual file system.
     /// @par Various archive types (e.g. directories on the filesystem, or compressed archives)
     /// can be registered, and will be merged into a single file tree. If the same filename is
@@ -49,9 +60,15 @@ namespace VFS
         /// @note Throws an exception if the file can not be found.
         Files::IStreamPtr getNormalized(const std::string& normalizedName) const;
 
+        /// Set a listener to notify of opened files, or NULL to disable.
+        /// @note Does not take ownership of the given pointer.
+        void setAccessListener(AccessListener* listener);
+
     private:
         bool mStrict;
 
+        AccessListener* mAccessListener;
+
         std::vector<Archive*> mArchives;
 
         std::map<std::string, File*> mIndex;